@@ -0,0 +1,327 @@
+// vks-cook: converts source meshes to the runtime .vksmesh format offline.
+//
+//   vks-cook [options] <input>...
+//
+// Inputs are OBJ/glTF files or procedural meshes (e.g. torus:96x48).
+// Run without arguments for the option list.
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Cook.hpp>
+#include <vks/Mesh/Import.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Bump when the cooked output changes for identical inputs and settings
+constexpr uint32_t CookerVersion = 1;
+
+const char *CacheFileName = ".vks-cook-cache";
+
+void printUsage() {
+  std::cout
+      << "Usage: vks-cook [options] <input>...\n"
+         "\n"
+         "Inputs:\n"
+         "  mesh.obj, mesh.gltf, mesh.glb   source files (glTF: one output per primitive)\n"
+         "  sphere:SECTORSxSTACKS           procedural meshes\n"
+         "  icosphere:FREQUENCY\n"
+         "  cubesphere:DIVISIONS\n"
+         "  plane:XxY\n"
+         "  torus:RINGSxSIDES\n"
+         "  cylinder:SECTORSxSTACKS\n"
+         "\n"
+         "Options:\n"
+         "  -o DIR          output directory (default: .)\n"
+         "  --format F      vertex format: compact (default), float, split-compact\n"
+         "                  or split-float (positions in their own stream)\n"
+         "  --lods N        maximum LOD count, 1 disables the chain (default: 5)\n"
+         "  --overdraw      also sort triangle clusters for overdraw\n"
+         "  --no-optimize   keep the source vertex and triangle order\n"
+         "  --normals       regenerate normals even when the source has them\n"
+         "  --force         cook every input, even unchanged ones\n";
+}
+
+struct CacheEntry {
+  uint64_t hash = 0;
+  uint32_t outputCount = 0;
+};
+
+std::map<std::string, CacheEntry> readCache(const std::string &path) {
+  std::map<std::string, CacheEntry> cache;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    CacheEntry entry;
+    std::string input;
+    fields >> std::hex >> entry.hash >> std::dec >> entry.outputCount >> std::ws;
+    if (fields && std::getline(fields, input)) {
+      cache[input] = entry;
+    }
+  }
+  return cache;
+}
+
+void writeCache(const std::string &path,
+                const std::map<std::string, CacheEntry> &cache) {
+  std::ofstream file(path, std::ios::trunc);
+  for (const auto &entry : cache) {
+    file << std::hex << entry.second.hash << std::dec << ' '
+         << entry.second.outputCount << ' ' << entry.first << '\n';
+  }
+}
+
+bool fileExists(const std::string &path) {
+  return static_cast<bool>(std::ifstream(path));
+}
+
+// "torus:96x48" -> ("torus", {96, 48}); empty name if not procedural
+std::string parseProcedural(const std::string &input,
+                            std::vector<uint32_t> &parameters) {
+  size_t colon = input.find(':');
+  if (colon == std::string::npos || colon == 1) {
+    return ""; // Also skips Windows drive letters
+  }
+
+  std::string name = input.substr(0, colon);
+  std::istringstream values(input.substr(colon + 1));
+  uint32_t value = 0;
+  char separator = 0;
+  while (values >> value) {
+    parameters.push_back(value);
+    if (!(values >> separator) || separator != 'x') {
+      break;
+    }
+  }
+  return name;
+}
+
+bool createProcedural(const std::string &name,
+                      const std::vector<uint32_t> &p,
+                      vks::mesh::SourceMesh &mesh) {
+  using namespace vks::geometry;
+  auto has = [&](size_t count) { return p.size() == count; };
+
+  if (name == "sphere" && has(2)) {
+    createSphere(mesh.vertices, mesh.indices, 1.0f, p[0], p[1]);
+  } else if (name == "icosphere" && has(1)) {
+    createIcosphere(mesh.vertices, mesh.indices, 1.0f, p[0]);
+  } else if (name == "cubesphere" && has(1)) {
+    createCubeSphere(mesh.vertices, mesh.indices, 1.0f, p[0]);
+  } else if (name == "plane" && has(2)) {
+    createPlane(mesh.vertices, mesh.indices, 1.0f, 1.0f, p[0], p[1]);
+  } else if (name == "torus" && has(2)) {
+    createTorus(mesh.vertices, mesh.indices, 0.7f, 0.3f, p[0], p[1]);
+  } else if (name == "cylinder" && has(2)) {
+    createCylinder(mesh.vertices, mesh.indices, 0.5f, 1.0f, p[0], p[1]);
+  } else {
+    return false;
+  }
+  mesh.name = name;
+  mesh.hasNormals = true;
+  return true;
+}
+
+std::string stemOf(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  return name.substr(0, name.find_last_of('.'));
+}
+
+std::string outputPath(const std::string &directory, const std::string &stem,
+                       uint32_t index, uint32_t count) {
+  std::string name = count > 1 ? stem + "." + std::to_string(index) : stem;
+  return directory + "/" + name + ".vksmesh";
+}
+
+struct Job {
+  std::string input;
+  CacheEntry entry;
+  bool skipped = false;
+  std::string log;
+};
+
+void cook(Job &job, const vks::mesh::CookSettings &settings,
+          uint64_t settingsHash, const std::string &outputDirectory,
+          const std::map<std::string, CacheEntry> &cache, bool force) {
+  std::vector<vks::mesh::SourceMesh> meshes;
+  std::vector<uint32_t> parameters;
+  std::string stem;
+
+  // 1. Content hash of the input, with the settings as seed
+  std::string procedural = parseProcedural(job.input, parameters);
+  if (!procedural.empty()) {
+    stem = procedural;
+    job.entry.hash = vks::mesh::hashContent(job.input.data(),
+                                            job.input.size(), settingsHash);
+  } else {
+    std::ifstream file(job.input, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("cannot open the file");
+    }
+    std::stringstream bytes;
+    bytes << file.rdbuf();
+    const std::string content = bytes.str();
+    stem = stemOf(job.input);
+    job.entry.hash = vks::mesh::hashContent(content.data(), content.size(),
+                                            settingsHash);
+  }
+
+  // 2. Unchanged input whose outputs are still there
+  auto cached = cache.find(job.input);
+  if (!force && cached != cache.end() &&
+      cached->second.hash == job.entry.hash) {
+    bool complete = true;
+    for (uint32_t i = 0; i < cached->second.outputCount; ++i) {
+      complete = complete &&
+                 fileExists(outputPath(outputDirectory, stem, i,
+                                       cached->second.outputCount));
+    }
+    if (complete) {
+      job.entry.outputCount = cached->second.outputCount;
+      job.skipped = true;
+      return;
+    }
+  }
+
+  // 3. Import, cook and write every mesh
+  if (procedural.empty()) {
+    meshes = vks::mesh::importMeshes(job.input);
+  } else {
+    meshes.emplace_back();
+    if (!createProcedural(procedural, parameters, meshes.back())) {
+      throw std::runtime_error("unknown procedural mesh");
+    }
+  }
+
+  std::ostringstream log;
+  job.entry.outputCount = static_cast<uint32_t>(meshes.size());
+  for (uint32_t i = 0; i < meshes.size(); ++i) {
+    vks::mesh::SourceMesh &source = meshes[i];
+    size_t sourceTriangles = source.indices.size() / 3;
+    vks::mesh::CookedMesh cooked =
+        vks::mesh::cookMesh(std::move(source.vertices),
+                            std::move(source.indices), source.hasNormals,
+                            settings);
+
+    std::string output =
+        outputPath(outputDirectory, stem, i, job.entry.outputCount);
+    vks::mesh::writeMeshFile(output, cooked.view());
+    log << "  " << output << ": " << sourceTriangles << " triangles, "
+        << cooked.vertexCount << " vertices, " << cooked.lods.size()
+        << " LODs, " << (cooked.vertexData.size() + cooked.indexData.size()) / 1024
+        << " KiB\n";
+  }
+  job.log = log.str();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  vks::mesh::CookSettings settings;
+  std::string outputDirectory = ".";
+  bool force = false;
+  std::vector<Job> jobs;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "-o" && hasValue) {
+      outputDirectory = argv[++i];
+    } else if (arg == "--format" && hasValue) {
+      std::string format = argv[++i];
+      if (format == "float") {
+        settings.vertexFormat = vks::geometry::VertexFormat::Float;
+      } else if (format == "split-float") {
+        settings.vertexFormat = vks::geometry::VertexFormat::SplitFloat;
+      } else if (format == "split-compact") {
+        settings.vertexFormat = vks::geometry::VertexFormat::SplitCompact;
+      } else {
+        settings.vertexFormat = vks::geometry::VertexFormat::Compact;
+      }
+    } else if (arg == "--lods" && hasValue) {
+      settings.maxLods = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--overdraw") {
+      settings.optimizations |= vks::mesh::MeshOptimizeOverdraw;
+    } else if (arg == "--no-optimize") {
+      settings.optimizations = 0;
+    } else if (arg == "--normals") {
+      settings.regenerateNormals = true;
+    } else if (arg == "--force") {
+      force = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      printUsage();
+      return EXIT_FAILURE;
+    } else {
+      jobs.push_back({arg});
+    }
+  }
+
+  if (jobs.empty()) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  std::ostringstream settingsKey;
+  settingsKey << CookerVersion << ' '
+              << static_cast<uint32_t>(settings.vertexFormat) << ' '
+              << settings.maxLods << ' ' << settings.optimizations << ' '
+              << settings.regenerateNormals;
+  const std::string key = settingsKey.str();
+  const uint64_t settingsHash = vks::mesh::hashContent(key.data(), key.size());
+
+  const std::string cachePath = outputDirectory + "/" + CacheFileName;
+  std::map<std::string, CacheEntry> cache = readCache(cachePath);
+
+  // One input per task: inputs cook in parallel, and each mesh's own
+  // parallel steps (vertex compression) share the same pool
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::string> errors(jobs.size());
+  vks::ThreadPool::global().parallelFor(
+      0, jobs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          try {
+            cook(jobs[i], settings, settingsHash, outputDirectory, cache,
+                 force);
+          } catch (const std::exception &e) {
+            errors[i] = e.what();
+          }
+        }
+      });
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  size_t cooked = 0, skipped = 0, failed = 0;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (!errors[i].empty()) {
+      std::cerr << jobs[i].input << ": " << errors[i] << "\n";
+      cache.erase(jobs[i].input);
+      ++failed;
+    } else if (jobs[i].skipped) {
+      ++skipped;
+    } else {
+      std::cout << jobs[i].input << "\n" << jobs[i].log;
+      cache[jobs[i].input] = jobs[i].entry;
+      ++cooked;
+    }
+  }
+  writeCache(cachePath, cache);
+
+  std::printf("%zu cooked, %zu unchanged, %zu failed in %.2f s\n", cooked,
+              skipped, failed, seconds);
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
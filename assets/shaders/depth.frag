@@ -0,0 +1,5 @@
+#version 450
+
+// Depth is written by the fixed-function stage, no color output
+void main() {
+}
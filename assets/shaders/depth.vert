@@ -0,0 +1,27 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Depth-only pass of the scene models: reads location 0 alone, so split
+// vertex formats (vks::geometry::VertexFormat::SplitFloat, SplitCompact)
+// fetch their position stream and nothing else
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// Same block as sphere.vert, both pipelines take the same push constants
+layout(push_constant) uniform ObjectTransform {
+    mat4 model;
+    mat3x4 normal;
+} object;
+
+layout(location = 0) in vec3 inPosition;
+
+// Must match the main pass bit for bit (see sphere.vert)
+invariant gl_Position;
+
+void main() {
+    vec4 worldPos = object.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * worldPos;
+}
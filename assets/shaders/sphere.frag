@@ -1,17 +1,62 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec3 fragNormal;
 layout(location = 1) in vec3 fragPos;
 layout(location = 2) in vec2 fragUV;
 
-layout(set = 1, binding = 0) uniform MaterialUBO {
+// vks::CameraUBO, shared with the vertex stage
+layout(set = 0, binding = 0) uniform CameraUBO {
+    mat4 view;
+    mat4 proj;
+    vec4 eye; // World space
+} camera;
+
+// vks::MaterialParams of every material (vks::MaterialBuffer)
+struct MaterialParams {
     vec4 baseColorFactor;
-} matUBO;
+    uint baseColorTexture; // Index in textures
+    uint sampler;          // Index in samplers
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Materials {
+    MaterialParams materials[];
+};
+
+// Every texture and sampler (vks::BindlessTable), picked by the material.
+// The indices are the same for the whole draw, no nonuniformEXT needed.
+layout(set = 2, binding = 0) uniform texture2D textures[];
+layout(set = 2, binding = 1) uniform sampler samplers[];
+
+// Pushed after the vertex stage's ObjectTransform (vks::MaterialBuffer::IndexOffset)
+layout(push_constant) uniform DrawData {
+    layout(offset = 112) uint materialIndex;
+} draw;
+
+// Material features (vks::MaterialFeature), resolved when the pipeline variant is compiled
+layout(constant_id = 0) const bool UNLIT = false;
+layout(constant_id = 1) const bool SPECULAR = false;
+layout(constant_id = 2) const bool ALPHA_TEST = false;
 
 layout(location = 0) out vec4 outColor;
 
+const float ALPHA_CUTOFF = 0.5;
+
 void main() {
+    MaterialParams material = materials[draw.materialIndex];
+    vec4 baseColor = material.baseColorFactor *
+        texture(sampler2D(textures[material.baseColorTexture], samplers[material.sampler]), fragUV);
+
+    if (ALPHA_TEST && baseColor.a < ALPHA_CUTOFF) {
+        discard;
+    }
+
+    if (UNLIT) {
+        outColor = vec4(baseColor.rgb, 1.0);
+        return;
+    }
+
     vec3 lightPos = vec3(2.0, 2.0, 2.0);
     vec3 lightColor = vec3(1.0, 1.0, 1.0);
     vec3 ambient = 0.1 * lightColor;
@@ -22,6 +67,14 @@ void main() {
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = diff * lightColor;
 
-    vec3 result = (ambient + diffuse) * matUBO.baseColorFactor.rgb;
+    vec3 result = (ambient + diffuse) * baseColor.rgb;
+
+    if (SPECULAR) {
+        // Blinn-Phong
+        vec3 viewDir = normalize(camera.eye.xyz - fragPos);
+        vec3 halfDir = normalize(lightDir + viewDir);
+        result += pow(max(dot(norm, halfDir), 0.0), 32.0) * lightColor;
+    }
+
     outColor = vec4(result, 1.0);
-}
\ No newline at end of file
+}
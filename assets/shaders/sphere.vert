@@ -6,9 +6,20 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
-layout(push_constant) uniform PushConstants {
+// Per-object transform block (vks::ObjectTransform), the normal matrix is
+// computed once per object on the CPU
+layout(push_constant) uniform ObjectTransform {
     mat4 model;
-} pushConst;
+    mat3x4 normal;
+} object;
+
+// Reference path (vks::MaterialFeatureInverseNormals): invert the model matrix
+// for every vertex, kept to compare GPU timings
+layout(constant_id = 3) const bool INVERSE_NORMALS = false;
+
+// Quantized vertices (vks::geometry::CompactVertex): the position
+// dequantization is folded into the model matrix, normals are octahedral
+layout(constant_id = 4) const bool COMPACT_VERTEX = false;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
@@ -18,10 +29,32 @@ layout(location = 0) out vec3 fragNormal;
 layout(location = 1) out vec3 fragPos;
 layout(location = 2) out vec2 fragUV;
 
+// Computed exactly like depth.vert, so fragments pass the EQUAL test over the
+// depth pre-pass
+invariant gl_Position;
+
+// Inverse of vks::mesh::encodeOctahedral()
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main() {
-    vec4 worldPos = pushConst.model * vec4(inPosition, 1.0);
+    vec4 worldPos = object.model * vec4(inPosition, 1.0);
     gl_Position = ubo.proj * ubo.view * worldPos;
 
-    fragPos = vec3(pushConst.model * vec4(inPosition, 1.0));
-    fragNormal = mat3(transpose(inverse(pushConst.model))) * inNormal;
+    fragPos = worldPos.xyz;
+    fragUV = inUV;
+
+    // An R16G16 normal reads as (x, y, 0)
+    vec3 normal = COMPACT_VERTEX ? octDecode(inNormal.xy) : inNormal;
+
+    if (INVERSE_NORMALS) {
+        fragNormal = mat3(transpose(inverse(object.model))) * normal;
+    } else {
+        fragNormal = mat3(object.normal) * normal;
+    }
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bench {
+
+/**
+ * @brief Runs func iterations times and prints the best and mean wall time.
+ * @return The best time in milliseconds.
+ */
+template <typename Func> double run(const char *name, int iterations, Func &&func) {
+  double best = 1e300;
+  double total = 0.0;
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    best = std::min(best, ms);
+    total += ms;
+  }
+
+  std::printf("%-48s best %9.3f ms   mean %9.3f ms\n", name, best,
+              total / iterations);
+  return best;
+}
+
+#if defined(_MSC_VER)
+// MSVC has no inline asm on x64: the value escapes through a volatile sink
+inline const void *volatile sink = nullptr;
+#endif
+
+// Keeps the optimizer from dropping unused results
+template <typename T> void doNotOptimize(const T &value) {
+#if defined(_MSC_VER)
+  sink = &value;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+} // namespace bench
@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vks/Bvh.hpp>
+#include <vks/Transform.hpp>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Spheres scattered on a ground plane like the application's field, the
+// camera looking across it
+static void benchmarkBvh(uint32_t count) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+  std::uniform_real_distribution<float> radius(0.3f, 1.0f);
+  std::vector<vks::mesh::BoundingSphere> spheres(count);
+  for (vks::mesh::BoundingSphere &sphere : spheres) {
+    sphere.center = {position(random), position(random), 0.0f};
+    sphere.radius = radius(random);
+  }
+
+  std::string size = std::to_string(count / 1000) + "k";
+  vks::Bvh bvh;
+  bench::run(("BVH build, " + size).c_str(), 5, [&] {
+    bvh.build(spheres.data(), count);
+  });
+
+  std::vector<vks::mesh::BoundingSphere> moved = spheres;
+  for (vks::mesh::BoundingSphere &sphere : moved) {
+    sphere.center.x += 0.5f;
+  }
+  bench::run(("BVH refit, " + size).c_str(), 10, [&] {
+    bvh.refit(moved.data());
+  });
+
+  glm::mat4 viewProjection =
+      glm::perspectiveRH_ZO(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 300.0f) *
+      glm::lookAt(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(100.0f, 100.0f, 0.0f),
+                  glm::vec3(0.0f, 0.0f, 1.0f));
+  glm::vec4 planes[6];
+  vks::transform::extractFrustumPlanes(viewProjection, planes);
+
+  std::vector<uint32_t> visible;
+  double linear = bench::run(("linear frustum test, " + size).c_str(), 10, [&] {
+    visible.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+      bool inside = true;
+      for (int p = 0; p < 6 && inside; ++p) {
+        inside = glm::dot(glm::vec3(planes[p]), moved[i].center) + planes[p].w >= -moved[i].radius;
+      }
+      if (inside) {
+        visible.push_back(i);
+      }
+    }
+    bench::doNotOptimize(visible.data());
+  });
+  size_t linearVisible = visible.size();
+  double hierarchical = bench::run(("BVH frustum query, " + size).c_str(), 10, [&] {
+    visible.clear();
+    bvh.queryFrustum(planes, visible);
+    bench::doNotOptimize(visible.data());
+  });
+  CHECK(visible.size() == linearVisible);
+  std::printf("  %zu visible, BVH speedup: %.1fx\n", visible.size(), linear / hierarchical);
+
+  // Picking rays from the camera through the field
+  std::vector<glm::vec3> directions(1000);
+  for (glm::vec3 &direction : directions) {
+    direction = glm::normalize(glm::vec3(position(random), position(random), 0.0f) -
+                               glm::vec3(0.0f, 0.0f, 20.0f));
+  }
+  uint32_t hits = 0;
+  bench::run(("BVH 1000 raycasts, " + size).c_str(), 10, [&] {
+    hits = 0;
+    for (const glm::vec3 &direction : directions) {
+      hits += bvh.raycast(glm::vec3(0.0f, 0.0f, 20.0f), direction).item != vks::Bvh::InvalidIndex;
+    }
+    bench::doNotOptimize(hits);
+  });
+  std::printf("  %u of %zu rays hit\n", hits, directions.size());
+}
+
+TEST_CASE("bvh 100k spheres") { benchmarkBvh(100000); }
+
+TEST_CASE("bvh 1M spheres") { benchmarkBvh(1000000); }
@@ -0,0 +1,109 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/Geometry.hpp>
+#include <vks/ThreadPool.hpp>
+
+#include <cmath>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using vks::geometry::Vertex;
+
+// Baseline: the scalar generator (sin/cos per vertex, growing vectors)
+static void scalarSphere(std::vector<Vertex> &vertices,
+                         std::vector<uint32_t> &indices, float radius,
+                         uint32_t sectors, uint32_t stacks) {
+  vertices.clear();
+  indices.clear();
+
+  float lengthInv = 1.0f / radius;
+  float sectorStep = 2 * M_PI / sectors;
+  float stackStep = M_PI / stacks;
+
+  for (uint32_t i = 0; i <= stacks; ++i) {
+    float stackAngle = M_PI / 2 - i * stackStep;
+    float xy = radius * cosf(stackAngle);
+    float z = radius * sinf(stackAngle);
+
+    for (uint32_t j = 0; j <= sectors; ++j) {
+      float sectorAngle = j * sectorStep;
+      float x = xy * cosf(sectorAngle);
+      float y = xy * sinf(sectorAngle);
+      vertices.push_back({{x, y, z},
+                          {x * lengthInv, y * lengthInv, z * lengthInv},
+                          {(float)j / sectors, (float)i / stacks}});
+    }
+  }
+
+  for (uint32_t i = 0; i < stacks; ++i) {
+    uint32_t k1 = i * (sectors + 1);
+    uint32_t k2 = k1 + sectors + 1;
+    for (uint32_t j = 0; j < sectors; ++j, ++k1, ++k2) {
+      if (i != 0) {
+        indices.insert(indices.end(), {k1, k2, k1 + 1});
+      }
+      if (i != (stacks - 1)) {
+        indices.insert(indices.end(), {k1 + 1, k2, k2 + 1});
+      }
+    }
+  }
+}
+
+static const int Iterations = 10;
+
+TEST_CASE("sphere 2048x1024") {
+  std::printf("-- %zu worker threads (+ caller)\n",
+              vks::ThreadPool::global().threadCount());
+
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  double scalar = bench::run("sphere scalar (baseline)", Iterations, [&] {
+    scalarSphere(vertices, indices, 1.0f, 2048, 1024);
+    bench::doNotOptimize(vertices.data());
+  });
+
+  double vectors = bench::run("sphere createSphere (vectors)", Iterations, [&] {
+    std::vector<Vertex> v;
+    std::vector<uint32_t> i;
+    vks::geometry::createSphere(v, i, 1.0f, 2048, 1024);
+    bench::doNotOptimize(v.data());
+  });
+
+  // Preallocated destination, as when writing into a mapped staging buffer
+  vks::geometry::MeshSize size = vks::geometry::sphereSize(2048, 1024);
+  vertices.resize(size.vertexCount);
+  indices.resize(size.indexCount);
+  double preallocated = bench::run("sphere writeSphere (preallocated)", Iterations, [&] {
+    vks::geometry::writeSphere(vertices.data(), indices.data(), 1.0f, 2048, 1024);
+    bench::doNotOptimize(vertices.data());
+  });
+
+  std::printf("speedup vs scalar: %.1fx (vectors), %.1fx (preallocated)\n",
+              scalar / vectors, scalar / preallocated);
+}
+
+TEST_CASE("other generators") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+
+  bench::run("icosphere frequency 512", Iterations, [&] {
+    vks::geometry::createIcosphere(vertices, indices, 1.0f, 512);
+  });
+  bench::run("cube sphere 512 divisions", Iterations, [&] {
+    vks::geometry::createCubeSphere(vertices, indices, 1.0f, 512);
+  });
+  bench::run("plane 2048x2048", Iterations, [&] {
+    vks::geometry::createPlane(vertices, indices, 1.0f, 1.0f, 2048, 2048);
+  });
+  bench::run("torus 2048x1024", Iterations, [&] {
+    vks::geometry::createTorus(vertices, indices, 1.0f, 0.25f, 2048, 1024);
+  });
+  bench::run("cylinder 2048x1024", Iterations, [&] {
+    vks::geometry::createCylinder(vertices, indices, 1.0f, 2.0f, 2048, 1024);
+  });
+}
@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Lod.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Same field as Application::buildScene(): spheres of radius 0.3 to 1
+// scattered up to 84 units away, seen from (5, 5, 5) at 45 degrees in 800x600
+TEST_CASE("lod scattered spheres") {
+  std::vector<vks::mesh::MeshLod> lods;
+  for (uint32_t i = 0; i < 5; ++i) {
+    uint32_t sectors = 128 >> i, stacks = 64 >> i;
+    vks::mesh::MeshLod lod;
+    lod.indexCount = vks::geometry::sphereSize(sectors, stacks).indexCount;
+    lod.error = i == 0 ? 0.0f : vks::geometry::sphereTessellationError(sectors, stacks);
+    lods.push_back(lod);
+  }
+
+  struct Object {
+    glm::vec3 center;
+    float radius;
+    uint32_t lod;
+  };
+  std::vector<Object> objects;
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  for (uint32_t i = 0; i < 2000; ++i) {
+    float angle = unit(random) * 6.2831853f;
+    float distance = 4.0f + std::sqrt(unit(random)) * 80.0f;
+    float scale = 0.3f + 0.7f * unit(random);
+    objects.push_back({{distance * std::cos(angle), distance * std::sin(angle), 0.0f}, scale, 0});
+  }
+
+  const glm::vec3 camera(5.0f, 5.0f, 5.0f);
+  const float projectionScale = 1.0f / std::tan(0.5f * 0.785398f) * 0.5f * 600.0f;
+
+  for (float threshold : {0.5f, 1.0f, 2.0f}) {
+    uint64_t drawn = 0, full = 0;
+    auto select = [&] {
+      drawn = full = 0;
+      for (Object &object : objects) {
+        float radius = vks::mesh::projectedRadius(
+            object.radius, glm::length(object.center - camera), projectionScale);
+        object.lod = vks::mesh::selectLod(lods.data(), 5, radius, object.lod,
+                                          threshold, 0.2f);
+        drawn += lods[object.lod].indexCount / 3;
+        full += lods[0].indexCount / 3;
+      }
+    };
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "select 2000 LODs (%.1f px)", threshold);
+    bench::run(name, 20, select);
+    std::printf("  triangles per frame: %llu of %llu (%.1f%% saved)\n",
+                (unsigned long long)drawn, (unsigned long long)full,
+                100.0 * (1.0 - double(drawn) / double(full)));
+  }
+}
@@ -0,0 +1,69 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/MaterialTable.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// A frame of material edits over 100k materials: copying what each slot
+// missed against rewriting the whole buffer, into plain memory standing in
+// for the mapped slot buffers
+TEST_CASE("material table 100k materials, 100 edits per frame") {
+  const uint32_t count = 100000;
+  const uint32_t slotCount = 3;
+  const uint32_t editsPerFrame = 100;
+
+  vks::MaterialTable table(slotCount);
+  for (uint32_t i = 0; i < count; ++i) {
+    table.add(vks::MaterialParams{glm::vec4(float(i))});
+  }
+  std::vector<std::vector<vks::MaterialParams>> slots(slotCount, std::vector<vks::MaterialParams>(count));
+  std::vector<vks::MaterialTable::Range> ranges;
+  for (uint32_t slot = 0; slot < slotCount; ++slot) {
+    table.takeDirtyRanges(slot, ranges);
+  }
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<uint32_t> material(0, count - 1);
+  uint32_t frame = 0;
+  size_t copied = 0;
+  double dirty = bench::run("dirty ranges: 100 edits, 3 slots", 300, [&] {
+    for (uint32_t i = 0; i < editsPerFrame; ++i) {
+      table.set(material(random), vks::MaterialParams{glm::vec4(float(frame))});
+    }
+    uint32_t slot = frame++ % slotCount;
+    table.takeDirtyRanges(slot, ranges, 2); // A 64-byte flush atom
+    for (const vks::MaterialTable::Range &range : ranges) {
+      std::memcpy(slots[slot].data() + range.first, table.data() + range.first,
+                  sizeof(vks::MaterialParams) * range.count);
+      copied += range.count;
+    }
+    bench::doNotOptimize(slots[slot][0]);
+  });
+  std::printf("  %.1f materials copied per frame\n", double(copied) / frame);
+
+  frame = 0;
+  double full = bench::run("whole table: 100 edits, 3 slots", 300, [&] {
+    for (uint32_t i = 0; i < editsPerFrame; ++i) {
+      table.set(material(random), vks::MaterialParams{glm::vec4(float(frame))});
+    }
+    uint32_t slot = frame++ % slotCount;
+    std::memcpy(slots[slot].data(), table.data(), sizeof(vks::MaterialParams) * count);
+    bench::doNotOptimize(slots[slot][0]);
+  });
+  std::printf("  Dirty ranges speedup: %.2fx\n", full / dirty);
+
+  // Every slot ends up with the table
+  for (uint32_t slot = 0; slot < slotCount; ++slot) {
+    table.takeDirtyRanges(slot, ranges);
+    for (const vks::MaterialTable::Range &range : ranges) {
+      std::memcpy(slots[slot].data() + range.first, table.data() + range.first,
+                  sizeof(vks::MaterialParams) * range.count);
+    }
+    CHECK(std::memcmp(slots[slot].data(), table.data(), sizeof(vks::MaterialParams) * count) == 0);
+  }
+}
@@ -0,0 +1,140 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Asset set size in MiB (VKS_BENCH_MESH_MB) and location (VKS_BENCH_DIR)
+static size_t assetSetMegabytes() {
+  const char *value = std::getenv("VKS_BENCH_MESH_MB");
+  return value ? std::strtoul(value, nullptr, 10) : 1024;
+}
+
+static std::string assetDirectory() {
+  const char *value = std::getenv("VKS_BENCH_DIR");
+  return value ? value : ".";
+}
+
+#ifdef __linux__
+// Flushes the file and evicts it from the page cache
+static void dropFromPageCache(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+#endif
+
+// Mapped file -> staging memory, as Model::loadMesh() does
+static size_t loadMapped(const std::string &path, uint8_t *staging) {
+  vks::mesh::MeshFile file(path);
+  std::memcpy(staging, file.vertexData(), file.vertexDataSize());
+  std::memcpy(staging + file.vertexDataSize(), file.indexData(),
+              file.indexDataSize());
+  return file.vertexDataSize() + file.indexDataSize();
+}
+
+// Reference: stream read into a std::vector, then copied to staging memory
+static size_t loadStream(const std::string &path, uint8_t *staging) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  std::vector<uint8_t> bytes(static_cast<size_t>(in.tellg()));
+  in.seekg(0);
+  in.read(reinterpret_cast<char *>(bytes.data()),
+          static_cast<std::streamsize>(bytes.size()));
+
+  vks::mesh::MeshFileHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  size_t vertexSize = header.indexDataOffset - header.vertexDataOffset;
+  size_t indexSize = header.fileSize - header.indexDataOffset;
+  std::memcpy(staging, bytes.data() + header.vertexDataOffset, vertexSize);
+  std::memcpy(staging + vertexSize, bytes.data() + header.indexDataOffset,
+              indexSize);
+  return vertexSize + indexSize;
+}
+
+TEST_CASE("mesh file load") {
+  // ~59 MiB per file: 1M float vertices and 6M 32-bit indices
+  std::vector<vks::geometry::Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 1024, 1024);
+
+  vks::mesh::MeshData mesh;
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+
+  size_t fileBytes = vertices.size() * sizeof(vks::geometry::Vertex) +
+                     indices.size() * sizeof(uint32_t);
+  size_t fileCount =
+      (assetSetMegabytes() * 1024 * 1024 + fileBytes - 1) / fileBytes;
+
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < fileCount; ++i) {
+    paths.push_back(assetDirectory() + "/vks_bench_" + std::to_string(i) +
+                    ".vksmesh");
+    vks::mesh::writeMeshFile(paths.back(), mesh);
+  }
+  std::printf("asset set: %zu files, %.1f MiB\n", fileCount,
+              fileCount * fileBytes / (1024.0 * 1024.0));
+
+  // Pre-touched, like the persistently mapped staging memory
+  std::vector<uint8_t> staging(fileBytes, 1);
+
+  auto loadAll = [&](size_t (*load)(const std::string &, uint8_t *)) {
+    size_t total = 0;
+    for (const std::string &path : paths) {
+      total += load(path, staging.data());
+    }
+    bench::doNotOptimize(total);
+  };
+
+#ifdef __linux__
+  auto runCold = [&](const char *name,
+                     size_t (*load)(const std::string &, uint8_t *)) {
+    double best = 1e300;
+    for (int i = 0; i < 3; ++i) {
+      for (const std::string &path : paths) {
+        dropFromPageCache(path);
+      }
+      auto start = std::chrono::steady_clock::now();
+      loadAll(load);
+      double ms = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+      best = std::min(best, ms);
+    }
+    std::printf("%-48s best %9.3f ms   %6.2f GiB/s\n", name, best,
+                fileCount * fileBytes / (best * 1e-3) / (1u << 30));
+  };
+
+  runCold("cold: mmap -> staging", loadMapped);
+  runCold("cold: ifstream -> vector -> staging", loadStream);
+#endif
+
+  // Warm: the set fits in the page cache after the first pass
+  loadAll(loadMapped);
+  bench::run("warm: mmap -> staging", 5, [&] { loadAll(loadMapped); });
+  bench::run("warm: ifstream -> vector -> staging", 5,
+             [&] { loadAll(loadStream); });
+
+  for (const std::string &path : paths) {
+    std::remove(path.c_str());
+  }
+}
@@ -0,0 +1,126 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Scene.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// The scene layout Application used before vks::Scene: one struct per
+// object with pointers into the registries, hot and cold fields mixed
+namespace {
+struct Model {
+  vks::mesh::BoundingSphere bounds;
+  std::vector<vks::mesh::MeshLod> lods;
+};
+
+struct Material {
+  std::string pipelineName;
+  uint32_t features = 0;
+};
+
+struct RenderObject {
+  Model *model;
+  Material *material;
+  glm::mat4 transform;
+  uint32_t transformIndex = 0;
+  uint32_t lod = 0;
+  uint32_t variant = 0;
+  uint32_t depthVariant = 0;
+};
+} // namespace
+
+static glm::mat4 randomTransform(std::mt19937 &random) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  glm::mat4 m(unit(random) + 0.5f);
+  m[3] = glm::vec4(unit(random) * 200.0f - 100.0f, unit(random) * 200.0f - 100.0f, 0.0f, 1.0f);
+  return m;
+}
+
+// Per-frame passes over 1M objects: the world bounds from the transforms,
+// then the LOD distances from the bounds only
+TEST_CASE("scene 1M objects AoS vs SoA") {
+  const uint32_t count = 1000000;
+  const glm::vec3 camera(5.0f, 5.0f, 5.0f);
+
+  std::vector<Model> models(2);
+  models[0].bounds = {glm::vec3(0.0f), 1.0f};
+  models[1].bounds = {glm::vec3(0.0f), 1.0f};
+  std::vector<Material> materials(2);
+
+  std::mt19937 random(42);
+  std::vector<RenderObject> objects(count);
+  vks::Scene scene;
+  scene.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    glm::mat4 transform = randomTransform(random);
+    objects[i] = {&models[i % 2], &materials[i % 2], transform, i};
+    scene.create(transform, i % 2, i % 2);
+  }
+  std::vector<vks::mesh::BoundingSphere> aosBounds(count);
+  std::vector<float> aosDistances(count), soaDistances(count);
+
+  double aos = bench::run("AoS: world bounds + distances, 1M", 10, [&] {
+    for (const RenderObject &obj : objects) {
+      const glm::mat4 &m = obj.transform;
+      aosBounds[obj.transformIndex].center = glm::vec3(m * glm::vec4(obj.model->bounds.center, 1.0f));
+      aosBounds[obj.transformIndex].radius = obj.model->bounds.radius * glm::length(glm::vec3(m[0]));
+    }
+    for (const RenderObject &obj : objects) {
+      aosDistances[obj.transformIndex] = glm::length(aosBounds[obj.transformIndex].center - camera);
+    }
+    bench::doNotOptimize(aosDistances[count - 1]);
+  });
+
+  double soa = bench::run("SoA: world bounds + distances, 1M", 10, [&] {
+    const glm::mat4 *transforms = scene.transforms();
+    const vks::Scene::MeshId *meshes = scene.meshes();
+    vks::mesh::BoundingSphere *bounds = scene.bounds();
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+      const glm::mat4 &m = transforms[i];
+      const vks::mesh::BoundingSphere &local = models[meshes[i]].bounds;
+      bounds[i].center = glm::vec3(m * glm::vec4(local.center, 1.0f));
+      bounds[i].radius = local.radius * glm::length(glm::vec3(m[0]));
+    }
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+      soaDistances[i] = glm::length(bounds[i].center - camera);
+    }
+    bench::doNotOptimize(soaDistances[count - 1]);
+  });
+  std::printf("  SoA speedup: %.2fx\n", aos / soa);
+
+  // A pass reading one cold field: the objects using material 1
+  uint32_t aosCount = 0, soaCount = 0;
+  double aosScan = bench::run("AoS: count objects of a material, 1M", 10, [&] {
+    aosCount = 0;
+    for (const RenderObject &obj : objects) {
+      aosCount += obj.material == &materials[1];
+    }
+    bench::doNotOptimize(aosCount);
+  });
+  double soaScan = bench::run("SoA: count objects of a material, 1M", 10, [&] {
+    soaCount = static_cast<uint32_t>(
+        std::count(scene.materials(), scene.materials() + scene.size(), 1u));
+    bench::doNotOptimize(soaCount);
+  });
+  std::printf("  SoA speedup: %.2fx\n", aosScan / soaScan);
+  CHECK(aosCount == soaCount);
+
+  // O(1) churn: destroy and recreate 10% of the objects through their handles
+  std::vector<vks::SceneHandle> handles(count / 10);
+  for (uint32_t i = 0; i < handles.size(); ++i) {
+    handles[i] = scene.handleAt(i * 10);
+  }
+  bench::run("SoA: destroy + create 100k objects", 10, [&] {
+    for (vks::SceneHandle &handle : handles) {
+      scene.destroy(handle);
+      handle = scene.create(glm::mat4(1.0f), 0, 0);
+    }
+  });
+  CHECK(scene.size() == count);
+}
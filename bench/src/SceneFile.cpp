@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/SceneFile.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Location of the scene file (VKS_BENCH_DIR)
+static std::string sceneDirectory() {
+  const char *value = std::getenv("VKS_BENCH_DIR");
+  return value ? value : ".";
+}
+
+// 1M objects, each on its own node under one of 1000 groups: ~125 MiB.
+// Warm page cache: what is left is the copy out of the mapping.
+TEST_CASE("scene file 1M objects load") {
+  const uint32_t groups = 1000;
+  const uint32_t count = 1000000;
+
+  vks::Scene scene;
+  vks::TransformHierarchy hierarchy;
+  {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(-100.0f, 100.0f);
+    std::vector<vks::TransformHierarchy::NodeId> parents;
+    for (uint32_t i = 0; i < groups; ++i) {
+      parents.push_back(hierarchy.create());
+    }
+    scene.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      vks::LocalTransform local;
+      local.translation = {unit(random), unit(random), 0.0f};
+      vks::TransformHierarchy::NodeId node =
+          hierarchy.create(parents[i % groups], local);
+      scene.create(glm::mat4(1.0f), i % 4, i % 16, 0, node);
+    }
+    hierarchy.update();
+  }
+
+  std::vector<std::string> meshNames{"sphere", "torus", "cube", "plane"};
+  std::vector<std::string> materialNames;
+  for (int i = 0; i < 16; ++i) {
+    materialNames.push_back("material_" + std::to_string(i));
+  }
+  std::string path = sceneDirectory() + "/vks_bench.vksscene";
+  vks::writeSceneFile(path, scene, hierarchy, meshNames, materialNames);
+
+  std::vector<vks::Scene::MeshId> meshes{0, 1, 2, 3};
+  std::vector<vks::Scene::MaterialId> materials(16);
+  for (uint32_t i = 0; i < 16; ++i) {
+    materials[i] = i;
+  }
+
+  // Reference: the file's bytes into memory that was already touched
+  size_t fileSize = vks::SceneFile(path).header().fileSize;
+  std::printf("scene file: %.1f MiB\n", fileSize / (1024.0 * 1024.0));
+  std::vector<uint8_t> copy(fileSize, 1);
+  bench::run("memcpy of the mapped file", 5, [&] {
+    vks::MappedFile file(path);
+    std::memcpy(copy.data(), file.data(), fileSize);
+    bench::doNotOptimize(copy[fileSize / 2]);
+  });
+
+  vks::Scene loaded;
+  vks::TransformHierarchy loadedHierarchy;
+  bench::run("open + loadScene()", 5, [&] {
+    vks::SceneFile file(path);
+    vks::loadScene(file, meshes.data(), materials.data(), loaded,
+                   loadedHierarchy);
+    bench::doNotOptimize(loaded.transforms()[count / 2]);
+  });
+
+  // What building it object by object costs
+  bench::run("create() per object", 3, [&] {
+    vks::SceneFile file(path);
+    vks::Scene rebuilt;
+    vks::TransformHierarchy rebuiltHierarchy;
+    std::vector<vks::TransformHierarchy::NodeId> ids(file.nodeCount());
+    for (uint32_t i = 0; i < file.nodeCount(); ++i) {
+      uint32_t parent = file.parents()[i];
+      ids[i] = rebuiltHierarchy.create(
+          parent == vks::SceneFileNoIndex ? vks::TransformHierarchy::NoNode
+                                          : ids[parent],
+          file.locals()[i]);
+    }
+    for (uint32_t i = 0; i < file.objectCount(); ++i) {
+      uint32_t node = file.nodes()[i];
+      rebuilt.create(file.transforms()[i], meshes[file.meshes()[i]],
+                     materials[file.materials()[i]], file.flags()[i],
+                     node == vks::SceneFileNoIndex
+                         ? vks::TransformHierarchy::NoNode
+                         : ids[node]);
+    }
+    bench::doNotOptimize(rebuilt.transforms()[count / 2]);
+  });
+
+  std::remove(path.c_str());
+}
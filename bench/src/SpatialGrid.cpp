@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vks/Bvh.hpp>
+#include <vks/SpatialGrid.hpp>
+#include <vks/Transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Spheres orbiting the origin at their own speed, like the animated red
+// sphere times count: after a while the BVH built on frame 0 groups
+// spheres that drifted apart, its refit boxes grow and queries slow down
+static void benchmarkMovingSpheres(uint32_t count) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::vector<float> orbit(count), phase(count), speed(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    orbit[i] = 5.0f + std::sqrt(unit(random)) * 500.0f;
+    phase[i] = unit(random) * 6.2832f;
+    speed[i] = 0.5f + unit(random);
+  }
+  std::vector<vks::mesh::BoundingSphere> spheres(count);
+  auto animate = [&](float time) {
+    for (uint32_t i = 0; i < count; ++i) {
+      float angle = phase[i] + speed[i] * time;
+      spheres[i].center = {orbit[i] * std::cos(angle), orbit[i] * std::sin(angle), 0.0f};
+      spheres[i].radius = 0.5f;
+    }
+  };
+
+  glm::mat4 viewProjection =
+      glm::perspectiveRH_ZO(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 200.0f) *
+      glm::lookAt(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(100.0f, 100.0f, 0.0f),
+                  glm::vec3(0.0f, 0.0f, 1.0f));
+  glm::vec4 planes[6];
+  vks::transform::extractFrustumPlanes(viewProjection, planes);
+
+  animate(0.0f);
+  vks::Bvh bvh;
+  bvh.build(spheres.data(), count);
+  // A few seconds later
+  animate(3.0f);
+
+  std::string size = std::to_string(count / 1000) + "k";
+  std::vector<uint32_t> visible;
+  double refit = bench::run(("BVH refit + frustum query, " + size).c_str(), 10, [&] {
+    bvh.refit(spheres.data());
+    visible.clear();
+    bvh.queryFrustum(planes, visible);
+    bench::doNotOptimize(visible.data());
+  });
+  size_t bvhVisible = visible.size();
+
+  bench::run(("BVH rebuild + frustum query, " + size).c_str(), 3, [&] {
+    bvh.build(spheres.data(), count);
+    visible.clear();
+    bvh.queryFrustum(planes, visible);
+    bench::doNotOptimize(visible.data());
+  });
+
+  vks::SpatialGrid grid;
+  double rebuild = bench::run(("grid rebuild + frustum query, " + size).c_str(), 10, [&] {
+    grid.rebuild(spheres.data(), count, 2.0f);
+    visible.clear();
+    grid.queryFrustum(planes, visible);
+    bench::doNotOptimize(visible.data());
+  });
+  CHECK(visible.size() == bvhVisible);
+  std::printf("  %zu visible, grid vs refit BVH: %.2fx\n", visible.size(), refit / rebuild);
+
+  std::vector<uint32_t> found;
+  bench::run(("grid 1000 radius queries (r = 5), " + size).c_str(), 10, [&] {
+    found.clear();
+    for (uint32_t i = 0; i < 1000; ++i) {
+      grid.queryRadius(spheres[i * (count / 1000)].center, 5.0f, found);
+    }
+    bench::doNotOptimize(found.data());
+  });
+}
+
+TEST_CASE("spatial grid 100k moving spheres") { benchmarkMovingSpheres(100000); }
+
+TEST_CASE("spatial grid 1M moving spheres") { benchmarkMovingSpheres(1000000); }
@@ -0,0 +1,64 @@
+#include <doctest/doctest.h>
+
+#include "Bench.hpp"
+
+#include <vks/TransformHierarchy.hpp>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static vks::LocalTransform randomLocal(std::mt19937 &random) {
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  vks::LocalTransform local;
+  local.translation = {unit(random) * 50.0f, unit(random) * 50.0f, 0.0f};
+  local.rotation = glm::angleAxis(unit(random) * 3.14f, glm::vec3(0.0f, 0.0f, 1.0f));
+  local.scale = glm::vec3(1.0f + 0.5f * unit(random));
+  return local;
+}
+
+// 1000 roots with 1000 children each. Moving one root only recomputes its
+// children; moving every root is the full update, parallel per level.
+TEST_CASE("transform hierarchy 1M nodes") {
+  const uint32_t roots = 1000;
+  const uint32_t children = 1000;
+
+  std::mt19937 random(42);
+  vks::TransformHierarchy hierarchy;
+  std::vector<vks::TransformHierarchy::NodeId> rootNodes;
+  for (uint32_t i = 0; i < roots; ++i) {
+    rootNodes.push_back(hierarchy.create(vks::TransformHierarchy::NoNode, randomLocal(random)));
+  }
+  std::vector<vks::TransformHierarchy::NodeId> childNodes;
+  for (uint32_t i = 0; i < roots * children; ++i) {
+    childNodes.push_back(hierarchy.create(rootNodes[i % roots], randomLocal(random)));
+  }
+  hierarchy.update();
+
+  // What recomputing every node each frame costs without the hierarchy,
+  // single threaded, composing the parent again for every child
+  std::vector<glm::mat4> naive(childNodes.size());
+  double full = bench::run("naive: compose + multiply all, 1M", 10, [&] {
+    for (uint32_t i = 0; i < childNodes.size(); ++i) {
+      naive[i] = vks::transform::compose(hierarchy.getLocal(rootNodes[i % roots])) *
+                 vks::transform::compose(hierarchy.getLocal(childNodes[i]));
+    }
+    bench::doNotOptimize(naive[0]);
+  });
+
+  size_t updated = 0;
+  double one = bench::run("hierarchy: move 1 root of 1000", 10, [&] {
+    hierarchy.setLocal(rootNodes[0], randomLocal(random));
+    updated = hierarchy.update();
+  });
+  CHECK(updated == children + 1);
+
+  double all = bench::run("hierarchy: move every root", 10, [&] {
+    for (vks::TransformHierarchy::NodeId root : rootNodes) {
+      hierarchy.setLocal(root, randomLocal(random));
+    }
+    updated = hierarchy.update();
+  });
+  CHECK(updated == hierarchy.size());
+  std::printf("  dirty subtree speedup: %.0fx, full update speedup: %.2fx\n", full / one, full / all);
+}
@@ -2,6 +2,11 @@
 # This function compile any GLSL shader into SPIR-V shader and embed it in a C header file.
 # Example:
 #	compile_shaders(TARGETS "assets/shader/basic.frag" "assets/shader/basic.vert")
+#
+# Each shader "name.ext" produces a header "name_ext.h" declaring the SPIR-V words as
+#	const uint32_t NAME_EXT[] = { 0x07230203, ... };
+# The array is constant-initialized, so it lives in read-only data with no startup cost,
+# and can be passed anywhere a vks::ShaderCode is expected.
 ####################################################################################################
 
 function(compile_shaders)
@@ -10,7 +15,7 @@ function(compile_shaders)
     cmake_parse_arguments(SHADERS "" "" "TARGETS" ${ARGN})
 
 	# Note: if it remains unparsed arguments, here, they can be found in variable PARSED_ARGS_UNPARSED_ARGUMENTS
-	if(NOT SHADERS)
+	if(NOT SHADERS_TARGETS)
 		message(FATAL_ERROR "You must provide targets.")
 	endif()
 
@@ -21,31 +26,53 @@ function(compile_shaders)
 		set(glslCompiler "glslangValidator")
 	endif()
 
+	# Generated headers live in the build tree
+	set(SHADER_INCLUDE_DIR "${CMAKE_BINARY_DIR}/generated/shaders")
+	file(MAKE_DIRECTORY "${SHADER_INCLUDE_DIR}")
+
+	set(SHADER_HEADERS "")
+
 	# For each shader, we create a header file
-	foreach(SHADER ${SHADERS})
+	foreach(SHADER ${SHADERS_TARGETS})
 
 		# Prepare a header name and a global variable for this shader
 		get_filename_component(SHADER_NAME ${SHADER} NAME)
 		string(REPLACE "." "_" HEADER_NAME ${SHADER_NAME})
 		string(TOUPPER ${HEADER_NAME} GLOBAL_SHADER_VAR)
 
-		set(SHADER_HEADER "${PROJECT_SOURCE_DIR}/include/${HEADER_NAME}.h")
+		set(SHADER_WORDS "${SHADER_INCLUDE_DIR}/${HEADER_NAME}.inl")
+		set(SHADER_HEADER "${SHADER_INCLUDE_DIR}/${HEADER_NAME}.h")
 
-		add_custom_target(
-			${HEADER_NAME}
-			# Compile any GLSL shader into SPIR-V shader
-			COMMAND ${glslCompiler} -V ${SHADER} -o ${SHADER}.spv
-			# Make a C header file with the SPIR-V shader
-			COMMAND ${CMAKE_COMMAND} -DPATH="${SHADER}.spv" -DHEADER="${SHADER_HEADER}" -DGLOBAL="${GLOBAL_SHADER_VAR}" -P "${CMAKE_SOURCE_DIR}/cmake/scripts/embed-data.cmake"
-			# Rebuild the header file if the shader is updated
+		# The wrapper only depends on the shader name, write it once at configure time
+		file(CONFIGURE OUTPUT "${SHADER_HEADER}" CONTENT
+"/**
+ * @file ${HEADER_NAME}.h
+ * @brief Auto generated file.
+ */
+#pragma once
+#include <cstdint>
+#include \"${HEADER_NAME}.inl\"
+")
+
+		# glslang writes the SPIR-V words as a C array itself (--vn), no CMake
+		# side conversion is needed. As a real output, it is only rebuilt when
+		# the shader changes and the build tool can run shaders in parallel.
+		add_custom_command(
+			OUTPUT ${SHADER_WORDS}
+			COMMAND ${glslCompiler} -V --vn ${GLOBAL_SHADER_VAR} ${SHADER} -o ${SHADER_WORDS}
 			DEPENDS ${SHADER}
-			COMMENT "Building ${SHADER}.spv and embedding it into ${SHADER_HEADER}"
+			COMMENT "Building ${SHADER} into ${SHADER_WORDS}"
+			VERBATIM
 		)
 
-		# Add the custom target like a dependencies of the project
-		add_dependencies(${PROJECT_NAME} ${HEADER_NAME})
+		list(APPEND SHADER_HEADERS ${SHADER_WORDS})
 
 		message(STATUS "Generating build commands for ${SHADER}")
 	endforeach()
 
+	# One target drives all the shader commands
+	add_custom_target(${PROJECT_NAME}Shaders DEPENDS ${SHADER_HEADERS})
+	add_dependencies(${PROJECT_NAME} ${PROJECT_NAME}Shaders)
+	target_include_directories(${PROJECT_NAME} PUBLIC ${SHADER_INCLUDE_DIR})
+
 endfunction()
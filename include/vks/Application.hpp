@@ -9,6 +9,7 @@
 #include <iostream>
 #include <optional>
 #include <set>
+#include <utility>
 #include <stdexcept>
 #include <vector>
 
@@ -21,42 +22,41 @@
 
 #include <vks/Basic/BasicRenderPass.hpp>
 #include <vks/Basic/BasicCommandBuffers.hpp>
+#include <vks/BindlessTable.hpp>
 #include <vks/DebugUtilsMessenger.hpp>
+#include <vks/DescriptorAllocator.hpp>
 #include <vks/Device.hpp>
 #include <vks/GraphicsPipeline.hpp>
 #include <vks/ImGui/ImGuiApp.hpp>
 #include <vks/Instance.hpp>
 #include <vks/SwapChain.hpp>
 #include <vks/SyncObjects.hpp>
+#include <vks/Texture.hpp>
 #include <vks/Window.hpp>
+#include <vks/GeometryArena.hpp>
+#include <vks/GeometryCache.hpp>
 #include <vks/Model.hpp>
+#include <vks/ModelLoader.hpp>
 #include <vks/Material.hpp>
+#include <vks/MaterialBuffer.hpp>
 #include <vks/Descriptors.hpp>
+#include <vks/Transform.hpp>
+#include <vks/Bvh.hpp>
+#include <vks/Scene.hpp>
+#include <vks/SceneFile.hpp>
+#include <vks/SpatialGrid.hpp>
+#include <vks/TransformHierarchy.hpp>
+#include <vks/WorldPartition.hpp>
 
 
 namespace vks
 {
-    // A struct to define a "thing" in your scene
-    // (This is from your Application.hpp (Updated) file)
-    struct RenderObject
-    {
-        vks::Model* model;
-        vks::Material* material;
-        glm::mat4 transform;
-
-        uint64_t getSortKey() const
-        {
-            uint64_t pipelineKey = (uint64_t)&material->getPipelineName();
-            uint64_t materialKey = (uint64_t)material->getDescriptorSet();
-            return (pipelineKey << 32) | materialKey;
-        }
-    };
-
     // UBO for camera (matches sphere_mesh.vert, Set 0)
     struct CameraUBO
     {
         glm::mat4 view;
         glm::mat4 proj;
+        glm::vec4 eye; // World space camera position (w = 1), read by sphere.frag
     };
 
 
@@ -70,9 +70,34 @@ namespace vks
         static Application& getInstance() { return *m_app; };
 
         // --- Getters for the CommandBuffer ---
-        const std::vector<RenderObject>& getRenderObjects() const { return m_renderObjects; }
+        const Scene& getScene() const { return m_scene; }
+        // Transform blocks of the scene objects, by scene index
+        const std::vector<ObjectTransform>& getObjectTransforms() const { return m_objectTransforms; }
+        // By scene index, 0 for the objects outside the view frustum
+        const std::vector<uint8_t>& getObjectVisibility() const { return m_objectVisible; }
+
+        // The registry entries behind the scene's mesh and material IDs
+        const vks::Model* getSceneMesh(Scene::MeshId mesh) const
+        {
+            return mesh == Scene::NoMesh ? nullptr : m_sceneMeshes[mesh];
+        }
+        const vks::Material& getSceneMaterial(Scene::MaterialId material) const
+        {
+            return *m_sceneMaterials[material];
+        }
         VkDescriptorSet getCameraDescriptorSet() const { return m_cameraDescriptorSet; }
+        // The parameters of every material, indexed by Material::getIndex()
+        VkDescriptorSet getMaterialDescriptorSet(uint32_t imageIndex) const
+        {
+            return m_materialBuffer->descriptorSet(imageIndex);
+        }
+        // Every texture and sampler, indexed by the material parameters
+        VkDescriptorSet getBindlessDescriptorSet() const { return m_bindless->descriptorSet(); }
         const CommandPool& getCommandPool() const { return commandPool; };
+        GeometryArena& getGeometryArena() { return *m_geometryArena; }
+        const CameraUBO& getCamera() const { return m_camera; }
+        bool isClusterCullingEnabled() const { return m_clusterCulling; }
+        bool isDepthPrepassEnabled() const { return m_depthPrepass; }
 
     private:
         void mainLoop();
@@ -86,14 +111,75 @@ namespace vks
         void loadAssets();
 
         /**
-         * @brief Populates the m_renderObjects list.
+         * @brief Populates the scene, from SCENE_FILE when there is one.
          */
         void buildScene();
 
+        /**
+         * @brief Replaces the scene and the hierarchy with a scene file's,
+         * resolving its asset names through the registries.
+         */
+        void loadSceneFile(const std::string& path);
+        void saveSceneFile(const std::string& path) const;
+
+        /**
+         * @brief Streams the world cells of WORLD_DIRECTORY around the
+         * camera, their meshes registered as "world/<file>" models.
+         */
+        void createWorld();
+
+        /**
+         * @brief The scene ID of a registry entry, assigned on first use.
+         */
+        Scene::MeshId getMeshId(const std::string& name);
+        Scene::MaterialId getMaterialId(const std::string& name);
+
         /**
          * @brief Updates scene data (e.g., camera matrices).
+         * @param frameIndex The frame in flight, owner of the camera slice and set.
+         */
+        void updateUBOs(uint32_t frameIndex);
+
+        /**
+         * @brief Recomputes the transform blocks (model + normal matrix) and
+         * the world bounds of all scene objects, and refits the BVH.
+         */
+        void updateObjectTransforms();
+
+        /**
+         * @brief Resolves the pipeline variants of every scene object, after
+         * the scene or a material's features changed.
+         */
+        void updateVariants();
+
+        /**
+         * @brief (Re)creates the generated models in the vertex formats of
+         * the current settings, in place so render objects keep pointing at them.
+         * @warning The GPU must be done with the previous geometry.
+         */
+        void createGeneratedModels();
+
+        /**
+         * @brief Adds a new checker texture to the bindless table and moves
+         * the materials using the previous one over to it.
+         */
+        void createCheckerTexture(const glm::vec4& color);
+
+        /**
+         * @brief Picks the LOD of every scene object from its projected bounding sphere.
+         */
+        void updateLods(const CameraUBO& camera);
+
+        /**
+         * @brief Flags the scene objects in the view frustum, from the BVH.
+         */
+        void updateVisibility(const CameraUBO& camera);
+
+        /**
+         * @brief Picks the scene object under a point of the screen.
+         * @param x, y Normalized device coordinates.
          */
-        void updateUBOs(uint32_t currentImage);
+        void pickObject(float x, float y);
 
         // Static Application Instance
         inline static Application* m_app = nullptr;
@@ -115,13 +201,66 @@ namespace vks
         int currentFrame = 0;
 
         // --- New Asset Registries ---
-        Ref<vks::DescriptorPool> m_globalDescriptorPool;
+        std::vector<std::unique_ptr<vks::DescriptorAllocator>> m_frameDescriptors; // Per frame in flight
+        std::unique_ptr<vks::GeometryArena> m_geometryArena; // Outlives the models
+        std::unique_ptr<vks::GeometryCache> m_geometryCache; // Shares geometry between models
         std::map<std::string, vks::Model> m_models;
+        std::unique_ptr<vks::BindlessTable> m_bindless; // Every texture and sampler, by index
+        std::unique_ptr<vks::Sampler> m_sampler;
+        std::unique_ptr<vks::Texture> m_whiteTexture; // Image 0, the default of MaterialParams
+        std::unique_ptr<vks::Texture> m_checkerTexture;
+        uint32_t m_checkerImage = vks::SlotAllocator::InvalidSlot;
+        glm::vec4 m_checkerColor{0.5f, 0.5f, 0.5f, 1.0f}; // Its dark squares
+        std::vector<std::pair<uint64_t, std::unique_ptr<vks::Texture>>> m_retiredTextures; // Like m_retiredModels
+        std::unique_ptr<vks::MaterialBuffer> m_materialBuffer; // Parameters of the materials, outlives them
         std::map<std::string, vks::Material> m_materials;
+        std::unique_ptr<vks::ModelLoader> m_modelLoader; // Streams models into m_models
 
         // --- New Scene Data ---
-        std::vector<RenderObject> m_renderObjects;
-        std::unique_ptr<vks::Buffer> m_cameraUboBuffer;
-        VkDescriptorSet m_cameraDescriptorSet = VK_NULL_HANDLE;
+        vks::Scene m_scene;
+        std::vector<vks::Model*> m_sceneMeshes;       // Scene::MeshId -> entry of m_models
+        std::vector<vks::Material*> m_sceneMaterials; // Scene::MaterialId -> entry of m_materials
+        vks::TransformHierarchy m_hierarchy;          // World matrices of the scene objects' nodes
+        vks::TransformHierarchy::NodeId m_redSphereNode = vks::TransformHierarchy::NoNode; // Animated by updateUBOs()
+        vks::TransformHierarchy::NodeId m_fieldNode = vks::TransformHierarchy::NoNode;     // Parent of the scattered objects
+        bool m_spinField = false;
+        size_t m_transformsUpdated = 0; // World matrices recomputed last frame
+        bool m_sceneChanged = false;    // Objects came or went since the BVH was built
+
+        // --- World streaming ---
+        std::unique_ptr<vks::WorldPartition> m_world; // Null without WORLD_DIRECTORY
+        std::vector<std::pair<uint64_t, vks::Model>> m_retiredModels; // Released on that frame, destroyed once the GPU is done
+        uint64_t m_frameNumber = 0;
+        glm::vec2 m_cameraPan{0.0f}; // Moves the camera across the world
+
+        // --- Spatial queries ---
+        vks::Bvh m_bvh; // Over the scene's world bounds, by scene index
+        vks::SpatialGrid m_grid; // Rebuilt every frame while culling with it
+        bool m_frustumCulling = true;
+        bool m_gridCulling = false;
+        std::vector<uint32_t> m_visibleObjects;
+        std::vector<uint8_t> m_objectVisible;
+        vks::SceneHandle m_pickedObject;
+        std::vector<glm::mat4> m_modelMatrices; // Gathered transforms, input of the batch
+        std::vector<ObjectTransform> m_objectTransforms;
+        std::unique_ptr<vks::Buffer> m_cameraUboBuffer; // A slice per frame in flight
+        VkDeviceSize m_cameraUboStride = 0;
+        VkDescriptorSet m_cameraDescriptorSet = VK_NULL_HANDLE; // This frame's, from m_frameDescriptors
+        CameraUBO m_camera{}; // Last camera written to the UBO
+
+        // --- Level of detail ---
+        bool m_lodEnabled = true;
+        float m_lodThreshold = 1.0f;  // Max screen space error, in pixels
+        float m_lodHysteresis = 0.2f; // Relative band around the threshold
+        uint64_t m_trianglesDrawn = 0;
+        uint64_t m_trianglesFull = 0; // What LOD 0 everywhere would draw
+
+        // --- Cluster culling ---
+        bool m_clusterCulling = true;
+
+        // --- Depth pre-pass ---
+        bool m_depthPrepass = false;
+        bool m_splitStreams = true; // Generated models keep positions in their own stream
+        bool m_cookedTorus = false; // Streamed from COOKED_TORUS, its format is baked in the file
     };
 } // namespace vks
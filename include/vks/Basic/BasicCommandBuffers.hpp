@@ -1,6 +1,11 @@
 #pragma once // Use pragma once
 
 #include <vks/CommandBuffers.hpp>
+#include <vks/ClusterCuller.hpp>
+#include <vks/GpuTimer.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
 // #include <vks/Model.hpp> // No longer needed here
 // #include <memory> // No longer needed here
 
@@ -30,11 +35,28 @@ public:
 
     void createCommandBuffers() override;
 
+    // GPU time of the scene pass
+    const GpuTimer& timer() const { return m_timer; }
+
+    // Meshlets tested by the cluster culling pass of the last frame
+    uint32_t testedMeshletCount() const { return m_culler.meshletCount(); }
+
 private:
     // This function is being removed, its logic moves to recordCommands
     // void createCommandBuffers();
 
     // We need this to get the scene data
     Application& m_app;
+
+    GpuTimer m_timer;
+    ClusterCuller m_culler;
+
+    // (sort key, scene index) of the objects drawn this frame
+    std::vector<std::pair<uint64_t, uint32_t>> m_drawOrder;
+
+    // Indirect draws written by the cluster culling pass, by scene index,
+    // valid where m_clustered is set. Kept to reuse their storage.
+    std::vector<ClusterCuller::Draw> m_clusterDraws;
+    std::vector<uint8_t> m_clustered;
 };
 } // namespace vks
@@ -11,7 +11,8 @@ public:
   BasicRenderPass(const Device &device, const SwapChain &swapChain);
 
 private:
-  void createRenderPass();
+  VkAttachmentDescription colorAttachment() const override;
+  void createRenderPass() override;
 };
 } // namespace vks
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/Descriptors.hpp>
+#include <vks/SlotAllocator.hpp>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace vks {
+
+class Device;
+
+/**
+ * @brief One global descriptor set (GraphicsPipeline::BindlessSet) holding
+ * every sampled image, sampler and storage buffer in large arrays, so shaders
+ * pick resources by index instead of the renderer binding a set per material.
+ *
+ * The arrays are partially bound and update-after-bind: adding a resource
+ * writes its element right away, even while frames in flight use the set.
+ * A removed element is only reused once those frames are done with it
+ * (retireFrames calls to nextFrame()), the resource itself must live as long.
+ */
+class BindlessTable : public NonCopyable {
+public:
+    // Bindings of the set, matching sphere.frag
+    static constexpr uint32_t ImageBinding = 0;   // texture2D textures[]
+    static constexpr uint32_t SamplerBinding = 1; // sampler samplers[]
+    static constexpr uint32_t BufferBinding = 2;  // Storage buffers
+
+    // Array sizes, clamped to the device's update-after-bind limits
+    static constexpr uint32_t MaxImages = 16384;
+    static constexpr uint32_t MaxSamplers = 64;
+    static constexpr uint32_t MaxBuffers = 16384;
+
+    /**
+     * @brief Creates the set layout shared by the table and the pipelines.
+     * @warning The device must support descriptor indexing.
+     */
+    static Ref<DescriptorSetLayout> createSetLayout(const Device& device);
+
+    BindlessTable(const Device& device, Ref<DescriptorSetLayout> setLayout, uint32_t retireFrames);
+
+    /**
+     * @return The index of the image in the textures array.
+     * @throws std::runtime_error if the array is full.
+     */
+    uint32_t addImage(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint32_t addSampler(VkSampler sampler);
+    uint32_t addBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    void removeImage(uint32_t index) { m_images.free(index); }
+    void removeSampler(uint32_t index) { m_samplers.free(index); }
+    void removeBuffer(uint32_t index) { m_buffers.free(index); }
+
+    /**
+     * @brief Called once per frame, after waiting for the oldest frame in
+     * flight: recycles the elements it may have read.
+     */
+    void nextFrame();
+
+    VkDescriptorSet descriptorSet() const { return m_descriptorSet; }
+    Ref<DescriptorSetLayout> setLayout() const { return m_setLayout; }
+
+    uint32_t imageCount() const { return m_images.used(); }
+    uint32_t samplerCount() const { return m_samplers.used(); }
+    uint32_t bufferCount() const { return m_buffers.used(); }
+
+private:
+    static uint32_t allocate(SlotAllocator& slots, const char* kind);
+
+    Ref<DescriptorSetLayout> m_setLayout;
+    Ref<DescriptorPool> m_descriptorPool;
+    VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+
+    SlotAllocator m_images;
+    SlotAllocator m_samplers;
+    SlotAllocator m_buffers;
+};
+
+} // namespace vks
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <vks/Mesh/Lod.hpp>
+
+namespace vks {
+
+struct Aabb
+{
+    glm::vec3 min{FLT_MAX};
+    glm::vec3 max{-FLT_MAX};
+
+    void grow(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    void grow(const Aabb& box)
+    {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+
+    // Half the surface area, 0 for an empty box
+    float area() const
+    {
+        glm::vec3 e = glm::max(max - min, glm::vec3(0.0f));
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+};
+
+/**
+ * @brief Bounding volume hierarchy over bounding spheres, for frustum culling
+ * and ray picking in O(log n).
+ * build() splits the items with the surface area heuristic evaluated over
+ * binned centers: the top levels with parallel binning, then independent
+ * subtrees on the thread pool. Moving items only need refit(), which
+ * recomputes the boxes without changing the tree; rebuild when the items
+ * change, or once they moved far enough for the tree to degrade.
+ *
+ * Items are the indices of the spheres given to build(), e.g. scene indices.
+ */
+class Bvh {
+public:
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    // 32 bytes. Leaves have items [first, first + count) of the item order,
+    // inner nodes have count 0 and their children at first and first + 1.
+    struct Node
+    {
+        glm::vec3 min;
+        uint32_t first = 0;
+        glm::vec3 max;
+        uint32_t count = 0;
+    };
+
+    struct Hit
+    {
+        uint32_t item = InvalidIndex;
+        float distance = FLT_MAX;
+    };
+
+    void build(const vks::mesh::BoundingSphere* spheres, uint32_t count);
+
+    /**
+     * @brief Updates the boxes after the spheres moved.
+     * @param spheres The same number of items as the last build().
+     */
+    void refit(const vks::mesh::BoundingSphere* spheres);
+
+    /**
+     * @brief Appends the items whose sphere is at least partly inside a
+     * frustum, see transform::extractFrustumPlanes().
+     */
+    void queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Nearest item whose sphere a ray hits, closer than maxDistance.
+     * @return Hit::item is InvalidIndex when nothing is hit. A ray starting
+     * inside a sphere hits it at distance 0.
+     */
+    Hit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX) const;
+
+    uint32_t size() const { return static_cast<uint32_t>(m_items.size()); }
+    bool empty() const { return m_items.empty(); }
+    const std::vector<Node>& nodes() const { return m_nodes; }
+
+private:
+    // Fits a node to its items, then makes it a leaf or splits it and
+    // pushes its children on the stack
+    void subdivide(std::vector<Node>& nodes, uint32_t node, std::vector<uint32_t>& stack, bool parallel);
+    void refitNode(uint32_t node);
+    // Items below a node, contiguous in the item order
+    void appendItems(uint32_t node, std::vector<uint32_t>& out) const;
+
+    // Built as a task: root in the top levels, descendants in
+    // [firstNode, firstNode + nodeCount)
+    struct Subtree
+    {
+        uint32_t root;
+        uint32_t firstNode;
+        uint32_t nodeCount;
+    };
+
+    std::vector<Node> m_nodes;      // Root first, children after their parent
+    std::vector<uint32_t> m_items;  // Item indices in leaf order
+    std::vector<glm::vec4> m_spheres; // Center and radius, in leaf order
+    std::vector<Subtree> m_subtrees;
+    uint32_t m_topNodeCount = 0;
+};
+
+} // namespace vks
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/Buffer.hpp>
+#include <vks/Descriptors.hpp>
+#include <vks/Mesh/Meshlet.hpp>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vks {
+
+class Device;
+
+/**
+ * @brief Culls the meshlets of objects on the GPU before they are drawn.
+ * A compute pass (cluster_cull.comp) tests every meshlet against the view
+ * frustum and its normal cone, and writes one VkDrawIndexedIndirectCommand
+ * per meshlet, with no index for the culled ones. Each object then draws its
+ * fixed range of commands with vkCmdDrawIndexedIndirect: one call with
+ * multiDrawIndirect, one per meshlet without. No mesh shaders are involved.
+ *
+ * Like GpuTimer, the buffers are held per slot (swapchain image): a slot is
+ * only rewritten once its previous submission has completed.
+ */
+class ClusterCuller : public NonCopyable {
+public:
+    // Per object input of the compute pass (std430 CullObject of cluster_cull.comp)
+    struct Object {
+        glm::mat4 model;
+        uint32_t firstMeshlet;
+        uint32_t meshletCount;
+        uint32_t firstCommand;
+        uint32_t padding;
+    };
+
+    // Push constants of the compute pass
+    struct Camera {
+        glm::vec4 planes[6]; // See transform::extractFrustumPlanes()
+        glm::vec4 position;  // w > 0 enables the normal cone test
+    };
+
+    // Range of draw commands of one object
+    struct Draw {
+        uint32_t firstCommand = 0;
+        uint32_t commandCount = 0;
+    };
+
+    ClusterCuller(const Device& device, uint32_t slotCount);
+    ~ClusterCuller();
+
+    /**
+     * @brief Recreates the per slot resources (e.g. after a swapchain resize).
+     */
+    void resize(uint32_t slotCount);
+
+    static Camera makeCamera(const glm::mat4& view, const glm::mat4& projection, bool coneCulling = true);
+
+    // Starts a new object list
+    void begin();
+
+    /**
+     * @brief Queues the meshlets of an object.
+     * @param model World matrix of the space the meshlet bounds are in.
+     */
+    Draw add(const glm::mat4& model, const vks::mesh::MeshletRange& meshlets);
+
+    /**
+     * @brief Uploads the object list to the slot and records the compute
+     * pass, followed by the barrier for the indirect reads.
+     * Must be recorded outside of a render pass.
+     */
+    void record(VkCommandBuffer cmd, uint32_t slot, VkBuffer meshletBuffer, const Camera& camera);
+
+    // Records the draws of an object, with its geometry buffers bound
+    void draw(VkCommandBuffer cmd, uint32_t slot, const Draw& draw) const;
+
+    // Meshlets tested by the last record() (for statistics)
+    uint32_t meshletCount() const { return m_commandCount; }
+
+private:
+    struct Slot {
+        std::unique_ptr<vks::Buffer> objects;  // Host visible, persistently mapped
+        std::unique_ptr<vks::Buffer> commands; // Indirect draw commands
+        uint32_t objectCapacity = 0;
+        uint32_t commandCapacity = 0;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkBuffer boundMeshlets = VK_NULL_HANDLE; // Meshlet buffer in the descriptor set
+    };
+
+    void createPipeline();
+    void createSlots(uint32_t slotCount);
+
+    const Device& m_device;
+    Ref<DescriptorSetLayout> m_setLayout;
+    Ref<DescriptorPool> m_descriptorPool;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    VkPushConstantRange m_pushConstants{};
+
+    std::vector<Slot> m_slots;
+    std::vector<Object> m_objects;
+    uint32_t m_commandCount = 0;
+};
+
+} // namespace vks
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/Descriptors.hpp>
+#include <vks/DescriptorUsage.hpp>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace vks {
+
+class Device;
+
+/**
+ * @brief Allocates descriptor sets from a growing list of pools.
+ * When a pool runs out (VK_ERROR_OUT_OF_POOL_MEMORY or
+ * VK_ERROR_FRAGMENTED_POOL), the next one is created with twice the sets,
+ * its descriptor types in the ratios the sets allocated so far used, so the
+ * number of sets is never capped.
+ *
+ * Sets are never freed one by one: reset() returns all of them at once and
+ * keeps the pools for the next allocations. Keeping one allocator per frame
+ * in flight, reset once the frame's fence is signaled, makes per-frame sets
+ * a bump of the current pool.
+ */
+class DescriptorAllocator : public NonCopyable {
+public:
+    /**
+     * @param setsPerPool The sets of the first pool.
+     * @param maxSetsPerPool The pools stop doubling past it.
+     */
+    explicit DescriptorAllocator(const Device& device, uint32_t setsPerPool = 16, uint32_t maxSetsPerPool = 4096);
+
+    /**
+     * @brief Allocates a set, valid until the next reset().
+     * @throws std::runtime_error if even a new pool can't hold it.
+     */
+    VkDescriptorSet allocate(const DescriptorSetLayout& layout);
+
+    /**
+     * @brief Returns all the sets to their pools.
+     * @warning The GPU must be done with them.
+     */
+    void reset();
+
+    size_t poolCount() const { return m_full.size() + m_ready.size() + (m_current ? 1 : 0); }
+
+private:
+    /**
+     * @brief Makes a reset pool or a new one the current pool.
+     */
+    void nextPool(const std::vector<VkDescriptorPoolSize>& atLeast);
+
+    const Device& m_device;
+    uint32_t m_setsPerPool;
+    uint32_t m_maxSetsPerPool;
+    DescriptorUsage m_usage;
+
+    Ref<DescriptorPool> m_current;
+    std::vector<Ref<DescriptorPool>> m_full;  // Exhausted since the last reset()
+    std::vector<Ref<DescriptorPool>> m_ready; // Reset, used before creating new ones
+};
+
+} // namespace vks
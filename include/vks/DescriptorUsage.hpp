@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace vks {
+
+/**
+ * @brief Counts the descriptors of each type the allocated sets needed, so
+ * the next descriptor pools hold the types in the same ratios instead of a
+ * fixed guess.
+ */
+class DescriptorUsage {
+public:
+    /**
+     * @brief Records one allocated set.
+     * @param setSizes The descriptors of each type in the set.
+     */
+    void record(const std::vector<VkDescriptorPoolSize>& setSizes);
+
+    /**
+     * @brief The pool sizes for maxSets sets in the observed ratios, rounded
+     * up, and never fewer than atLeast (the set about to be allocated).
+     * Without observations, the ratios of atLeast.
+     */
+    std::vector<VkDescriptorPoolSize> poolSizes(uint32_t maxSets,
+                                                const std::vector<VkDescriptorPoolSize>& atLeast = {}) const;
+
+    uint64_t setCount() const { return m_sets; }
+
+private:
+    std::map<VkDescriptorType, uint64_t> m_descriptors; // Recorded descriptors by type
+    uint64_t m_sets = 0;
+};
+
+} // namespace vks
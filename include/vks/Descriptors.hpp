@@ -14,6 +14,7 @@ using Ref = std::shared_ptr<T>;
 class DescriptorSetLayout;
 class DescriptorPool;
 class DescriptorWriter;
+class DescriptorAllocator;
 
 class DescriptorSetLayout {
 public:
@@ -22,31 +23,43 @@ public:
         // Pass in the device instead of using a singleton
         Builder(const vks::Device& device) : m_device(device) {}
 
+        // bindingFlags: VkDescriptorBindingFlagBits (partially bound,
+        // update after bind...), they need descriptor indexing
         Builder& addBinding(
             uint32_t binding,
             VkDescriptorType descriptorType,
             VkShaderStageFlags stageFlags,
-            uint32_t count = 1);
+            uint32_t count = 1,
+            VkDescriptorBindingFlags bindingFlags = 0);
+        Builder& setLayoutFlags(VkDescriptorSetLayoutCreateFlags flags);
         Ref<DescriptorSetLayout> build() const;
 
     private:
         const vks::Device& m_device; // Store a reference
         std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> m_bindings{};
+        std::unordered_map<uint32_t, VkDescriptorBindingFlags> m_bindingFlags{};
+        VkDescriptorSetLayoutCreateFlags m_layoutFlags = 0;
     };
 
     DescriptorSetLayout(
         const vks::Device& device, // Pass in device
-        std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings);
+        std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+        const std::unordered_map<uint32_t, VkDescriptorBindingFlags>& bindingFlags = {},
+        VkDescriptorSetLayoutCreateFlags layoutFlags = 0);
     ~DescriptorSetLayout();
     DescriptorSetLayout(const DescriptorSetLayout&) = delete;
     DescriptorSetLayout& operator=(const DescriptorSetLayout&) = delete;
 
     VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout; }
 
+    // The descriptors of each type a set of this layout holds
+    const std::vector<VkDescriptorPoolSize>& poolSizes() const { return m_poolSizes; }
+
 private:
     const vks::Device& m_device; // Store a reference
     VkDescriptorSetLayout m_descriptorSetLayout;
     std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> m_bindings;
+    std::vector<VkDescriptorPoolSize> m_poolSizes;
 
     friend class DescriptorWriter;
 };
@@ -83,6 +96,10 @@ public:
     bool allocateDescriptor(
         const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor) const;
 
+    // Like allocateDescriptor(), VK_ERROR_OUT_OF_POOL_MEMORY or
+    // VK_ERROR_FRAGMENTED_POOL when the pool is exhausted
+    VkResult allocate(const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor) const;
+
     void freeDescriptors(std::vector<VkDescriptorSet>& descriptors) const;
 
     void resetPool();
@@ -99,9 +116,12 @@ private:
 class DescriptorWriter {
 public:
     DescriptorWriter(Ref<DescriptorSetLayout> setLayout, Ref<DescriptorPool> pool);
+    // build() allocates from the allocator, growing it as needed
+    DescriptorWriter(Ref<DescriptorSetLayout> setLayout, DescriptorAllocator& allocator);
 
-    DescriptorWriter& writeBuffer(uint32_t binding, VkDescriptorBufferInfo* bufferInfo);
-    DescriptorWriter& writeImage(uint32_t binding, VkDescriptorImageInfo* imageInfo);
+    // arrayElement: the element of an array binding to write
+    DescriptorWriter& writeBuffer(uint32_t binding, VkDescriptorBufferInfo* bufferInfo, uint32_t arrayElement = 0);
+    DescriptorWriter& writeImage(uint32_t binding, VkDescriptorImageInfo* imageInfo, uint32_t arrayElement = 0);
 
     bool build(VkDescriptorSet& set);
     void overwrite(VkDescriptorSet& set);
@@ -109,6 +129,7 @@ public:
 private:
     Ref<DescriptorSetLayout> m_setLayout;
     Ref<DescriptorPool> m_pool; // Changed from reference
+    DescriptorAllocator* m_allocator = nullptr; // Used instead of m_pool when set
     std::vector<VkWriteDescriptorSet> m_writes;
 };
 
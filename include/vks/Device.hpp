@@ -26,6 +26,24 @@ public:
   inline const VkQueue &graphicsQueue() const { return m_graphicsQueue; }
   inline const VkQueue &presentQueue() const { return m_presentQueue; }
 
+  // Vulkan version usable with this device (instance and device minimum)
+  inline uint32_t apiVersion() const { return m_apiVersion; }
+
+  // True when passes are recorded with vkCmdBeginRendering (Vulkan 1.3 or
+  // VK_KHR_dynamic_rendering) instead of VkRenderPass/VkFramebuffer objects
+  inline bool dynamicRendering() const { return m_dynamicRendering; }
+
+  // True when vkCmdDrawIndexedIndirect accepts more than one draw per call
+  inline bool multiDrawIndirect() const { return m_multiDrawIndirect; }
+
+  // True when descriptor sets can hold partially bound, update-after-bind
+  // arrays of runtime size (Vulkan 1.2 descriptor indexing, see BindlessTable)
+  inline bool descriptorIndexing() const { return m_descriptorIndexing; }
+
+  void cmdBeginRendering(VkCommandBuffer cmd,
+                         const VkRenderingInfo &renderingInfo) const;
+  void cmdEndRendering(VkCommandBuffer cmd) const;
+
 private:
   VkPhysicalDevice m_physical;
   VkDevice m_logical;
@@ -37,6 +55,14 @@ private:
   VkQueue m_graphicsQueue;
   VkQueue m_presentQueue;
 
+  uint32_t m_apiVersion;
+  bool m_dynamicRendering;
+  bool m_multiDrawIndirect;
+  bool m_descriptorIndexing;
+  // Core or KHR entry points, depending on how dynamic rendering is enabled
+  PFN_vkCmdBeginRendering m_vkCmdBeginRendering;
+  PFN_vkCmdEndRendering m_vkCmdEndRendering;
+
   static bool
   CheckDeviceExtensionSupport(const VkPhysicalDevice &device,
                               const std::vector<const char *> &extensions);
@@ -45,6 +71,12 @@ private:
   PickPhysicalDevice(const VkInstance &instance, const VkSurfaceKHR &surface,
                      const std::vector<const char *> &requiredExtensions);
 
+  static bool SupportsDynamicRendering(const VkPhysicalDevice &device,
+                                       uint32_t apiVersion);
+
+  static bool SupportsDescriptorIndexing(const VkPhysicalDevice &device,
+                                         uint32_t apiVersion);
+
   static bool IsDeviceSuitable(const VkPhysicalDevice &device,
                                const VkSurfaceKHR &surface);
 };
@@ -1,10 +1,13 @@
 #ifndef GEOMETRY_HPP
 #define GEOMETRY_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
-#include "Descriptors.hpp"
+#include <vulkan/vulkan.h>
 
 namespace vks {
 namespace geometry {
@@ -22,8 +25,155 @@ struct Vertex
     static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
 };
 
-    void createSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius, uint32_t sectors,
-                      uint32_t stacks);
+/**
+ * @brief 16-byte quantized vertex (see vks::mesh::compressVertices()).
+ * Positions are unorm16 inside the mesh bounds, the dequantization transform
+ * is folded into the model matrix. Normals are octahedral-encoded.
+ */
+struct CompactVertex
+{
+    uint16_t pos[4]; // layout(location = 0), R16G16B16A16_UNORM, w unused
+    int16_t normal[2]; // layout(location = 1), R16G16_SNORM, octahedral
+    uint16_t uv[2]; // layout(location = 2), R16G16_SFLOAT
+
+    static VkVertexInputBindingDescription getBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+};
+
+/**
+ * @brief Vertex layout of a Model's vertex buffers.
+ * Split formats keep positions in their own stream (binding 0) and the other
+ * attributes in a second one (binding 1), so depth-only passes fetch just the
+ * positions. Their vertex data is planar: every position, then every
+ * attribute, both in vertex order (see splitVertices()).
+ */
+enum class VertexFormat : uint32_t
+{
+    Float,        // Vertex, 32 bytes
+    Compact,      // CompactVertex, 16 bytes
+    SplitFloat,   // Vertex as 12 bytes of position + 20 bytes of attributes
+    SplitCompact, // CompactVertex as 8 bytes of position + 8 bytes of attributes
+};
+
+constexpr size_t VertexFormatCount = 4;
+
+struct VertexInputDescription
+{
+    std::array<VkVertexInputBindingDescription, 2> bindings;
+    uint32_t bindingCount = 1;
+    std::array<VkVertexInputAttributeDescription, 3> attributes;
+    uint32_t attributeCount = 3;
+};
+
+/**
+ * @brief Pipeline vertex input of a vertex format.
+ * @param positionOnly Only location 0, for depth and shadow passes: with a
+ * split format it reads binding 0 alone.
+ */
+VertexInputDescription getVertexInput(VertexFormat format, bool positionOnly = false);
+
+/**
+ * @brief Size in bytes of one vertex of a format, all streams together.
+ */
+uint32_t vertexSize(VertexFormat format);
+
+/**
+ * @brief Size in bytes of one vertex in binding 0: the position of a split
+ * format, the whole vertex of an interleaved one.
+ */
+uint32_t positionStreamSize(VertexFormat format);
+
+inline bool isSplit(VertexFormat format)
+{
+    return format == VertexFormat::SplitFloat || format == VertexFormat::SplitCompact;
+}
+
+// Positions quantized to unorm16 (see vks::mesh::compressVertices())
+inline bool isCompact(VertexFormat format)
+{
+    return format == VertexFormat::Compact || format == VertexFormat::SplitCompact;
+}
+
+/**
+ * @brief Writes interleaved vertices (Vertex for SplitFloat, CompactVertex for
+ * SplitCompact) as the planar streams of a split format.
+ * @param out vertexSize(format) * vertexCount bytes, not overlapping the input.
+ */
+void splitVertices(const void* interleaved, VertexFormat format, size_t vertexCount, void* out);
+
+/**
+ * @brief Exact vertex and index counts of a generated mesh.
+ * Each generator has a *Size() function so callers can allocate (or map a
+ * staging buffer) once, then a write*() function filling that memory in
+ * parallel on the global ThreadPool, and a create*() convenience wrapper
+ * filling std::vectors.
+ * All meshes are Z-up, triangle lists, counter-clockwise seen from outside.
+ */
+struct MeshSize
+{
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+};
+
+/**
+ * @brief UV sphere: (sectors + 1) x (stacks + 1) vertices, north pole first.
+ */
+MeshSize sphereSize(uint32_t sectors, uint32_t stacks);
+void writeSphere(Vertex* vertices, uint32_t* indices, float radius, uint32_t sectors, uint32_t stacks);
+void createSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius, uint32_t sectors,
+                  uint32_t stacks);
+
+/**
+ * @brief Largest distance between a unit sphere and its UV tessellation,
+ * i.e. the geometric error of a procedural sphere LOD relative to its radius.
+ */
+float sphereTessellationError(uint32_t sectors, uint32_t stacks);
+
+/**
+ * @brief Geodesic sphere: every icosahedron face split in frequency^2 triangles.
+ * Faces don't share vertices, but seam vertices are computed bit-identically.
+ */
+MeshSize icosphereSize(uint32_t frequency);
+void writeIcosphere(Vertex* vertices, uint32_t* indices, float radius, uint32_t frequency);
+void createIcosphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius,
+                     uint32_t frequency);
+
+/**
+ * @brief Cube projected on a sphere: 6 faces of divisions x divisions quads,
+ * with an area-preserving mapping (more uniform than a UV sphere).
+ */
+MeshSize cubeSphereSize(uint32_t divisions);
+void writeCubeSphere(Vertex* vertices, uint32_t* indices, float radius, uint32_t divisions);
+void createCubeSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius,
+                      uint32_t divisions);
+
+/**
+ * @brief Plane in XY centered on the origin, facing +Z.
+ */
+MeshSize planeSize(uint32_t xSegments, uint32_t ySegments);
+void writePlane(Vertex* vertices, uint32_t* indices, float width, float height, uint32_t xSegments,
+                uint32_t ySegments);
+void createPlane(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float width, float height,
+                 uint32_t xSegments, uint32_t ySegments);
+
+/**
+ * @brief Torus around Z: rings segments along the main circle, sides around the tube.
+ */
+MeshSize torusSize(uint32_t rings, uint32_t sides);
+void writeTorus(Vertex* vertices, uint32_t* indices, float majorRadius, float minorRadius, uint32_t rings,
+                uint32_t sides);
+void createTorus(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float majorRadius,
+                 float minorRadius, uint32_t rings, uint32_t sides);
+
+/**
+ * @brief Capped cylinder along Z, centered on the origin.
+ */
+MeshSize cylinderSize(uint32_t sectors, uint32_t stacks);
+void writeCylinder(Vertex* vertices, uint32_t* indices, float radius, float height, uint32_t sectors,
+                   uint32_t stacks);
+void createCylinder(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius, float height,
+                    uint32_t sectors, uint32_t stacks);
+
 } // namespace geometry
 } // namespace vks
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/Buffer.hpp>
+#include <vks/CommandPool.hpp>
+#include <vks/Device.hpp>
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Meshlet.hpp>
+#include <vks/RangeAllocator.hpp>
+#include <vulkan/vulkan.h>
+#include <array>
+#include <memory>
+
+namespace vks
+{
+    /**
+     * @brief The vertex and index ranges of one mesh inside a GeometryArena.
+     * vertexOffset and firstIndex are the values to pass to vkCmdDrawIndexed
+     * (indices stay relative to the mesh's first vertex).
+     */
+    struct GeometryAllocation
+    {
+        vks::geometry::VertexFormat vertexFormat = vks::geometry::VertexFormat::Float;
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+        uint32_t vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        uint32_t firstMeshlet = 0; // In getMeshletBuffer()
+        uint32_t meshletCount = 0;
+    };
+
+    /**
+     * @brief Shared DEVICE_LOCAL vertex and index buffers all models
+     * sub-allocate their geometry from.
+     * There is one vertex buffer per vertex format (two for split formats,
+     * sharing the same vertex offsets) and one index buffer per index type,
+     * created on first use, so a frame binds each pair once and
+     * draws only differ by their offsets (the layout multi-draw indirect needs).
+     * Models split into meshlets also keep them here, in a storage buffer the
+     * cluster culler reads.
+     *
+     * Full buffers grow geometrically: a larger buffer is created and the old
+     * contents are copied over on the GPU. This changes the VkBuffer handles,
+     * so they must be fetched again when recording commands, never cached.
+     */
+    class GeometryArena : public NonCopyable
+    {
+    public:
+        /**
+         * @param initialVertices Capacity of each vertex buffer, in vertices.
+         * @param initialIndices Capacity of each index buffer, in indices.
+         */
+        GeometryArena(const vks::Device& device, const vks::CommandPool& commandPool,
+                      uint32_t initialVertices = 1u << 18, uint32_t initialIndices = 1u << 20);
+
+        /**
+         * @brief Reserves the ranges of a mesh, growing the buffers if needed.
+         */
+        GeometryAllocation allocate(vks::geometry::VertexFormat vertexFormat, uint32_t vertexCount,
+                                    VkIndexType indexType, uint32_t indexCount, uint32_t meshletCount = 0);
+
+        /**
+         * @brief Returns the ranges of a mesh to the arena.
+         * @warning The GPU must be done with the mesh (e.g. after vkDeviceWaitIdle).
+         */
+        void free(const GeometryAllocation& allocation);
+
+        /**
+         * @brief Copies the tightly packed data of staging buffers to the ranges
+         * of an allocation, in a single submission.
+         * Vertices of split formats are planar (see vks::geometry::splitVertices()).
+         * @param meshletStaging vks::mesh::Meshlet array, when meshletCount > 0.
+         */
+        void upload(const GeometryAllocation& allocation, const vks::Buffer& vertexStaging,
+                    const vks::Buffer& indexStaging, const vks::Buffer* meshletStaging = nullptr);
+
+        /**
+         * @return The buffer for a vertex format / index type, or VK_NULL_HANDLE
+         * while nothing was allocated from it.
+         */
+        VkBuffer getVertexBuffer(vks::geometry::VertexFormat vertexFormat) const;
+        // Binding 1 of a split vertex format, VK_NULL_HANDLE for interleaved ones
+        VkBuffer getAttributeBuffer(vks::geometry::VertexFormat vertexFormat) const;
+        VkBuffer getIndexBuffer(VkIndexType indexType) const;
+        VkBuffer getMeshletBuffer() const;
+
+        // --- Statistics, in bytes ---
+        VkDeviceSize getCapacity() const;
+        VkDeviceSize getUsed() const;
+
+    private:
+        // One growable buffer and the allocator of its elements
+        struct Pool
+        {
+            std::unique_ptr<vks::Buffer> buffer;
+            vks::RangeAllocator allocator;
+            VkDeviceSize elementSize = 0;
+            VkBufferUsageFlags usage = 0;
+
+            // Second stream of split vertex formats, indexed like the first
+            std::unique_ptr<vks::Buffer> attributeBuffer;
+            VkDeviceSize attributeSize = 0;
+        };
+
+        uint32_t allocateFrom(Pool& pool, uint32_t count, uint32_t initialCapacity);
+
+        /**
+         * @brief Moves a pool to a buffer of newCapacity elements.
+         */
+        void grow(Pool& pool, uint32_t newCapacity);
+
+        Pool& vertexPool(vks::geometry::VertexFormat vertexFormat);
+        const Pool& vertexPool(vks::geometry::VertexFormat vertexFormat) const;
+        Pool& indexPool(VkIndexType indexType);
+        const Pool& indexPool(VkIndexType indexType) const;
+
+        const vks::Device& m_device;
+        const vks::CommandPool& m_commandPool;
+
+        uint32_t m_initialVertices;
+        uint32_t m_initialIndices;
+
+        std::array<Pool, vks::geometry::VertexFormatCount> m_vertexPools;
+        std::array<Pool, 2> m_indexPools;  // UINT16, UINT32
+        Pool m_meshletPool;
+    };
+} // namespace vks
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/CommandPool.hpp>
+#include <vks/Device.hpp>
+#include <vks/Mesh/MeshCache.hpp>
+#include <vks/Model.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace vks
+{
+    /**
+     * @brief Deduplicates model geometry in the GeometryArena.
+     * Procedural meshes are keyed by their generator and parameters, loaded
+     * meshes by a hash of their content; both also by the processing the
+     * model applies. The first request of a key uploads the geometry, the
+     * next ones return models sharing its ranges (see Model::share()).
+     *
+     * With a directory, generator output is also kept on disk
+     * (vks::mesh::MeshDiskCache), so heavy tessellations and simplifications
+     * run once across runs; only the model's processing runs at startup.
+     *
+     * The cache lives on the main thread, like the uploads.
+     */
+    class GeometryCache : public NonCopyable
+    {
+    public:
+        using Generator = std::function<void(vks::mesh::GeneratedMesh&)>;
+
+        /**
+         * @param directory Disk cache of generated meshes, empty for none.
+         */
+        GeometryCache(const vks::Device& device, const vks::CommandPool& commandPool,
+                      const std::string& directory = {});
+
+        /**
+         * @brief A model of generated geometry.
+         * @param key vks::mesh::MeshKey::procedural() of the generator.
+         * @param generate Only called when the key is in neither cache.
+         */
+        Model acquire(const vks::mesh::MeshKey& key, vks::geometry::VertexFormat vertexFormat,
+                      uint32_t optimizations, const Generator& generate);
+
+        /**
+         * @brief A model of loaded data (a mesh file or a cooked mesh), uploaded as is.
+         * @param key vks::mesh::MeshKey::content() of the mesh, which can be
+         * computed off the main thread.
+         */
+        Model acquire(const vks::mesh::MeshKey& key, const vks::mesh::MeshData& mesh);
+
+        // --- Procedural shapes (see vks::geometry and Model) ---
+        Model sphere(float radius, uint32_t sectors, uint32_t stacks,
+                     vks::geometry::VertexFormat vertexFormat = vks::geometry::VertexFormat::Float,
+                     uint32_t optimizations = ModelOptimizeDefault);
+
+        Model torus(float majorRadius, float minorRadius, uint32_t rings, uint32_t sides,
+                    vks::geometry::VertexFormat vertexFormat = vks::geometry::VertexFormat::Float,
+                    uint32_t optimizations = ModelOptimizeDefault);
+
+        // See Model::createSphereLods()
+        Model sphereLods(float radius, uint32_t sectors, uint32_t stacks, uint32_t lodCount,
+                         vks::geometry::VertexFormat vertexFormat = vks::geometry::VertexFormat::Float,
+                         uint32_t optimizations = ModelOptimizeDefault);
+
+        // Torus LODs from the quadric simplifier, see Model::createSimplifiedLods()
+        Model torusLods(float majorRadius, float minorRadius, uint32_t rings, uint32_t sides, uint32_t maxLods,
+                        vks::geometry::VertexFormat vertexFormat = vks::geometry::VertexFormat::Float,
+                        uint32_t optimizations = ModelOptimizeDefault);
+
+        /**
+         * @brief Returns the geometry no model uses anymore to the arena.
+         * @warning The GPU must be done with it (e.g. after vkDeviceWaitIdle).
+         * @return The number of entries dropped.
+         */
+        size_t trim();
+
+        // --- Statistics ---
+        size_t getEntryCount() const { return m_entries.size(); }
+        uint64_t getHitCount() const { return m_hits; }
+
+    private:
+        const vks::Device& m_device;
+        const vks::CommandPool& m_commandPool;
+        std::unique_ptr<vks::mesh::MeshDiskCache> m_disk;
+
+        // One model per key, every other model of the key shares its ranges
+        std::unordered_map<uint64_t, Model> m_entries;
+        uint64_t m_hits = 0;
+    };
+} // namespace vks
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace vks {
+
+class Device;
+
+/**
+ * @brief Measures GPU time of a command buffer section with timestamp queries.
+ * Holds a begin/end query pair per swapchain image. The result of a slot is
+ * read back the next time the same image is recorded, by then its previous
+ * submission has completed (the image fence was waited on).
+ */
+class GpuTimer : public NonCopyable {
+public:
+    GpuTimer(const Device& device, uint32_t slotCount);
+    ~GpuTimer();
+
+    /**
+     * @brief Recreates the query pool for a new slot count (e.g. after a swapchain resize).
+     */
+    void resize(uint32_t slotCount);
+
+    // False when the graphics queue does not support timestamps
+    bool supported() const { return m_queryPool != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Collects the previous result of the slot and writes the begin timestamp.
+     * Must be recorded outside of a render pass.
+     */
+    void begin(VkCommandBuffer cmd, uint32_t slot);
+
+    // Writes the end timestamp of the slot
+    void end(VkCommandBuffer cmd, uint32_t slot);
+
+    // Last measured duration, in milliseconds
+    double lastMilliseconds() const { return m_lastMs; }
+
+    // Exponential moving average of the measured durations, in milliseconds
+    double averageMilliseconds() const { return m_averageMs; }
+
+private:
+    void createQueryPool(uint32_t slotCount);
+    void destroyQueryPool();
+    void collect(uint32_t slot);
+
+    const Device& m_device;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    // Nanoseconds per timestamp tick
+    double m_period = 0.0;
+    uint64_t m_validMask = 0;
+    // Slots that have timestamps written and not read back yet
+    std::vector<bool> m_pending;
+
+    double m_lastMs = 0.0;
+    double m_averageMs = 0.0;
+};
+
+} // namespace vks
@@ -8,6 +8,8 @@
 #include <memory>
 
 #include <vks/Descriptors.hpp>
+#include <vks/ShaderCode.hpp>
+#include <vks/ShaderReflection.hpp>
 
 namespace vks {
 
@@ -16,31 +18,94 @@ class Device;
 class SwapChain;
 class RenderPass;
 
+/**
+ * @brief The fixed-function "recipe" a pipeline is compiled from.
+ * All variants of a recipe share its shaders and layout, they only differ by
+ * their specialization constants.
+ */
+struct PipelineDesc
+{
+    ShaderCode vertexShader;
+    ShaderCode fragmentShader;
+
+    bool meshVertexInput = false; // Consumes vks::geometry::Vertex (or CompactVertex)
+    bool positionOnly = false;    // Only location 0: binding 0 alone for split vertex formats
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+    bool depthTest = false;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+    bool colorWrite = true;       // false for depth-only passes
+};
+
 /**
  * @brief Manages the creation and storage of all VkPipeline objects.
  * This class acts as a factory and registry for:
  * - VkPipelines (the "recipes")
  * - VkPipelineLayouts
  * - Ref<DescriptorSetLayout> (the shader interface layouts)
+ *
+ * Pipeline and descriptor set layouts are derived from the shaders through
+ * SPIR-V reflection. Identical set layouts are shared between pipelines, so a
+ * descriptor set built for one pipeline can be bound with any other.
+ *
+ * Each recipe can be compiled into several variants: bit i of the variant's
+ * feature mask is passed to the shaders as the boolean specialization
+ * constant `constant_id = i`. Variants are cached, so a feature mask is only
+ * ever compiled once per recipe.
  */
 class GraphicsPipeline : public NonCopyable {
 public:
+    // Descriptor set indices shared by every scene shader
+    static constexpr uint32_t GlobalSet = 0;   // Camera data
+    static constexpr uint32_t MaterialSet = 1; // Per-material data
+    static constexpr uint32_t BindlessSet = 2; // Every texture and sampler (BindlessTable)
+
+    // Number of feature bits a variant can specialize
+    static constexpr uint32_t MaxFeatureBits = 32;
+
+    // Feature bit (constant_id = 4) selecting the geometry::CompactVertex
+    // input. It comes from the drawn Model's vertex format, not from materials.
+    static constexpr uint32_t CompactVertexFeature = 1u << 4;
+
+    // Feature bit (constant_id = 5) reading positions and the other
+    // attributes from two bindings (the split vertex formats)
+    static constexpr uint32_t SplitVertexFeature = 1u << 5;
+
     GraphicsPipeline(const Device &device, const SwapChain &swapChain,
                        const RenderPass &renderPass);
     ~GraphicsPipeline();
 
     /**
-     * @brief Recreates all pipelines and layouts (e.g., on swapchain resize).
+     * @brief Recompiles the pipelines after a swapchain recreation, when they
+     * depend on the recreated render pass or on a changed color format.
      */
     void recreate();
 
     /**
-     * @brief Gets a compiled pipeline by its registered name.
+     * @brief Gets the default variant of a pipeline by its registered name.
      * @param name The name given during creation (e.g., "sphere").
      * @return A VkPipeline handle.
      */
     VkPipeline getPipeline(const std::string &name) const;
 
+    /**
+     * @brief Gets a compiled variant by the id returned from requestVariant().
+     * @return A VkPipeline handle (valid until the next recreate()).
+     */
+    VkPipeline getPipeline(uint32_t variantId) const;
+
+    /**
+     * @brief Compiles (once) the variant of a pipeline for a feature mask.
+     * @param name The pipeline name (e.g., "sphere").
+     * @param features The specialization constant bits.
+     * @return A variant id, stable across recreate().
+     */
+    uint32_t requestVariant(const std::string &name, uint32_t features);
+
+    /**
+     * @brief Number of compiled variants (for statistics).
+     */
+    size_t variantCount() const { return m_variants.size(); }
+
     /**
      * @brief Gets a pipeline layout by its registered name.
      * @param name The name given during creation (e.g., "sphere").
@@ -49,20 +114,51 @@ public:
     VkPipelineLayout getLayout(const std::string &name) const;
 
     /**
-     * @brief Gets a descriptor set layout by its registered name.
+     * @brief Gets the descriptor set layout a pipeline expects for a set.
      * This is used by the Material class to create matching descriptor sets.
-     * @param name The name given during creation (e.g., "global", "material").
+     * @param name The pipeline name (e.g., "sphere").
+     * @param set The descriptor set index (e.g., GlobalSet, MaterialSet).
      * @return A shared_ptr to the DescriptorSetLayout.
      */
-    Ref<DescriptorSetLayout> getDescriptorSetLayout(const std::string &name) const;
+    Ref<DescriptorSetLayout> getDescriptorSetLayout(const std::string &name, uint32_t set) const;
 
+    /**
+     * @brief Gets the merged shader interface of a pipeline.
+     * @param name The pipeline name (e.g., "sphere").
+     * @return The reflection of all the pipeline's shader stages.
+     */
+    const ShaderReflection &getReflection(const std::string &name) const;
+
+    /**
+     * @brief Gets the layout of the BindlessSet, shared by all pipelines.
+     * @return nullptr when the device lacks descriptor indexing.
+     */
+    Ref<DescriptorSetLayout> getBindlessSetLayout() const { return m_bindlessLayout; }
 
 private:
+    struct PipelineVariant
+    {
+        std::string name;
+        uint32_t features;
+        VkPipeline pipeline;
+    };
+
     // --- Registries ---
     // These maps hold all the assets this manager creates.
-    std::map<std::string, VkPipeline> m_pipelines;
+    std::map<std::string, PipelineDesc> m_recipes;
+    std::vector<PipelineVariant> m_variants;
+    std::map<std::pair<std::string, uint32_t>, uint32_t> m_variantIds;
     std::map<std::string, VkPipelineLayout> m_pipelineLayouts;
-    std::map<std::string, Ref<DescriptorSetLayout>> m_descriptorSetLayouts;
+    std::map<std::string, ShaderReflection> m_reflections;
+    std::map<std::string, std::vector<Ref<DescriptorSetLayout>>> m_pipelineSetLayouts;
+
+    // Set layouts keyed by their bindings, shared by all pipelines.
+    // They don't depend on the swapchain, so they survive recreate().
+    std::map<std::vector<uint32_t>, Ref<DescriptorSetLayout>> m_descriptorSetLayouts;
+
+    // Fixed layout of the BindlessSet: the shaders declare unsized arrays,
+    // the reflection can't tell their size nor binding flags
+    Ref<DescriptorSetLayout> m_bindlessLayout;
 
     VkPipelineLayout m_oldLayout; // From your original file
 
@@ -71,6 +167,9 @@ private:
     const SwapChain &m_swapChain;
     const RenderPass &m_renderPass;
 
+    // Swapchain format the pipelines were compiled for
+    VkFormat m_colorFormat;
+
     // --- Private Helper Functions ---
     /**
      * @brief Main function to create all pipeline types.
@@ -78,18 +177,36 @@ private:
     void createPipelines();
 
     /**
-     * @brief Creates the "base" pipeline (no vertex input).
+     * @brief Registers a recipe and creates its layout from the shaders.
+     */
+    void registerPipeline(const std::string &name, const PipelineDesc &desc);
+
+    /**
+     * @brief Compiles one variant of a registered recipe.
+     */
+    VkPipeline compileVariant(const std::string &name, uint32_t features);
+
+    /**
+     * @brief Returns the cached set layout matching the reflected bindings,
+     * creating it on first use.
+     */
+    Ref<DescriptorSetLayout> getOrCreateSetLayout(const ReflectedSet &set);
+
+    /**
+     * @brief Checks the bindings a shader declares in the BindlessSet
+     * against the BindlessTable and returns its layout.
      */
-    void createBasePipeline();
+    Ref<DescriptorSetLayout> bindlessSetLayout(const std::string &name, const ReflectedSet &set) const;
 
     /**
-     * @brief Creates the "sphere" pipeline (3D mesh vertex input).
+     * @brief Creates a pipeline layout matching the reflected shader interface
+     * and registers the reflection and set layouts under the pipeline name.
      */
-    void createSpherePipeline();
+    VkPipelineLayout createPipelineLayout(const std::string &name, const ShaderReflection &reflection);
 
     /**
      * @brief Helper to create a shader module from byte code.
      */
-    VkShaderModule createShaderModule(const std::vector<unsigned char> &code);
+    VkShaderModule createShaderModule(ShaderCode code);
 };
 } // namespace vks
@@ -40,6 +40,8 @@ public:
 
 private:
   VkDescriptorPool imGuiDescriptorPool;
+  // Referenced by ImGui's pipeline rendering info with dynamic rendering
+  VkFormat colorFormat;
 
   ImGuiRenderPass renderPass;
   CommandPool commandPool;
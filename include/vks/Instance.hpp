@@ -22,6 +22,8 @@ public:
   inline bool validationLayersEnabled() const {
     return m_enableValidationLayers;
   }
+  // Vulkan version the instance was created with (1.0 up to 1.3)
+  inline uint32_t apiVersion() const { return m_apiVersion; }
 
   static const std::vector<const char *> ValidationLayers;
   static const std::vector<const char *> DeviceExtensions;
@@ -29,8 +31,10 @@ public:
 private:
   VkInstance m_instance;
   bool m_enableValidationLayers;
+  uint32_t m_apiVersion;
 
   static bool CheckValidationLayerSupport();
+  static uint32_t ChooseApiVersion();
   static void GetRequiredExtensions(std::vector<const char *> &extensions,
                                     bool validationLayers);
 };
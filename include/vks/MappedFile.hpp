@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vks {
+
+/**
+ * @brief A whole file mapped read-only in memory.
+ * Pages are read in by the first access that touches them, ahead of the
+ * accesses for sequential reads: the containers built on it (mesh and scene
+ * files) are read front to back, once.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be opened or mapped,
+     * e.g. an empty file.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Reads a range of the file into memory now, so later accesses
+     * (e.g. an upload copy on another thread) don't wait on the disk.
+     * Blocks until the pages are resident. The range is clamped to the file.
+     */
+    void prefetch(size_t offset, size_t size) const;
+
+private:
+    void unmap();
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+} // namespace vks
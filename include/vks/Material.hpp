@@ -1,83 +1,57 @@
 #pragma once
 
-#include <vks/Device.hpp>
 #include <vks/GraphicsPipeline.hpp> // Your manager class
-#include <vks/Descriptors.hpp>      // Your descriptor system
-#include "Buffer.hpp"               // Your buffer helper class
+#include <vks/MaterialTable.hpp>
 #include <vulkan/vulkan.h>
 #include <string>
-#include <stdexcept>
-#include <memory>
 #include <glm/glm.hpp>
 
 namespace vks {
 
-// UBO struct for material data
-// This MUST match the layout in the shader (Set 1, Binding 0)
-struct MaterialUBO {
-    alignas(16) glm::vec4 color;
+/**
+ * @brief Feature bits a material can enable.
+ * Bit i is the boolean specialization constant `constant_id = i` of the
+ * material's shaders, so each combination compiles to its own pipeline variant.
+ */
+enum MaterialFeature : uint32_t {
+    MaterialFeatureUnlit = 1u << 0,     // No lighting, flat base color
+    MaterialFeatureSpecular = 1u << 1,  // Blinn-Phong highlight on top of Lambert
+    MaterialFeatureAlphaTest = 1u << 2, // Discard when base color alpha < 0.5
+    MaterialFeatureInverseNormals = 1u << 3, // Invert the model matrix per vertex (reference timing path)
+    // Bit 4 is GraphicsPipeline::CompactVertexFeature, set per Model
 };
 
 /**
  * @brief Represents a "Material Instance."
- * This class links a Pipeline's *name* with its unique data (Descriptor Set).
- * It creates and owns its own VkDescriptorSet and the UBO that holds its data.
+ * This class links a Pipeline's *name* with its parameters, which live in
+ * a MaterialTable shared by all materials (see MaterialBuffer): draws only
+ * push the material's index, there is no descriptor set per material.
  */
 class Material {
 public:
     /**
      * @brief Creates a new Material instance.
-     * @param device The logical device.
-     * @param pipelineManager The pipeline manager (to get layout info).
-     * @param descriptorPool The global pool to allocate this material's set from.
+     * @param table The table holding the parameters of all materials.
+     * @param pipelineManager The pipeline manager (to request the variant).
      * @param pipelineName The name of the pipeline this material uses (e.g., "sphere").
      * @param color The unique color for this material.
+     * @param features The MaterialFeature bits selecting the pipeline variant.
      */
     Material(
-        const vks::Device& device,
-        const vks::GraphicsPipeline& pipelineManager,
-        Ref<vks::DescriptorPool> descriptorPool,
+        vks::MaterialTable& table,
+        vks::GraphicsPipeline& pipelineManager,
         const std::string& pipelineName,
-        glm::vec4 color
+        glm::vec4 color,
+        uint32_t features = 0
     ) :
+        m_table(&table),
+        m_index(table.add(MaterialParams{color})),
         m_pipelineName(pipelineName),
-        m_materialDescriptorSet(VK_NULL_HANDLE)
+        m_features(features),
+        m_variantId(pipelineManager.requestVariant(pipelineName, features))
     {
-        // Get the Material Descriptor Set Layout (for Set 1)
-        // We get this from the manager to ensure we match what the pipeline expects.
-        Ref<vks::DescriptorSetLayout> materialLayout =
-            pipelineManager.getDescriptorSetLayout("material");
-
-        // Create a unique UBO for this material instance's color
-        m_uboBuffer = std::make_unique<vks::Buffer>(
-            device,
-            sizeof(MaterialUBO),
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
-
-        // Map and write the color data
-        m_uboBuffer->map();
-        uboData = MaterialUBO{color};
-        m_uboBuffer->writeToBuffer(&uboData);
-        m_uboBuffer->unmap();
-
-        // Use DescriptorWriter to build this material's Descriptor Set
-        auto bufferInfo = m_uboBuffer->descriptorInfo();
-        DescriptorWriter writer(materialLayout, descriptorPool);
-        writer.writeBuffer(0, &bufferInfo); // Binds UBO to binding 0
-
-        if (!writer.build(m_materialDescriptorSet)) {
-            throw std::runtime_error("Failed to build material descriptor set!");
-        }
     }
 
-    /**
-     * @brief Destructor
-     * Cleans up resources owned by this material.
-     */
-    ~Material() = default; // m_uboBuffer is a unique_ptr, so it cleans itself up.
-
     // Materials are unique: delete copy operations
     Material(const Material&) = delete;
     Material& operator=(const Material&) = delete;
@@ -94,32 +68,46 @@ public:
     const std::string& getPipelineName() const { return m_pipelineName; }
 
     /**
-     * @brief Gets this material's unique VkDescriptorSet (Set 1).
-     * This set contains the material's color, textures, etc.
+     * @brief Gets the pipeline variant compiled for this material's features.
      */
-    VkDescriptorSet getDescriptorSet() const { return m_materialDescriptorSet; }
+    uint32_t getVariant() const { return m_variantId; }
+    uint32_t getFeatures() const { return m_features; }
 
-    void updateUBO(const MaterialUBO& newUbo) {
-        uboData = newUbo;
-        m_uboBuffer->map();
-        m_uboBuffer->writeToBuffer(&uboData);
-        m_uboBuffer->unmap();
+    /**
+     * @brief Switches the material to another feature set.
+     * The variant is compiled on first use and cached by the pipeline manager.
+     */
+    void setFeatures(vks::GraphicsPipeline& pipelineManager, uint32_t features) {
+        m_variantId = pipelineManager.requestVariant(m_pipelineName, features);
+        m_features = features;
     }
 
-    MaterialUBO uboData;
+    /**
+     * @brief Gets this material's index in the table, pushed by its draws.
+     */
+    uint32_t getIndex() const { return m_index; }
+
+    const MaterialParams& getParams() const { return m_table->get(m_index); }
+
+    /**
+     * @brief Edits the material's parameters. The frames in flight keep the
+     * previous ones, the next frames read the new ones.
+     */
+    void setParams(const MaterialParams& params) { m_table->set(m_index, params); }
 
 private:
     // --- Stored Data ---
 
+    // The table holding this material's parameters, at m_index.
+    vks::MaterialTable* m_table;
+    uint32_t m_index;
+
     // The name of the pipeline (e.g., "sphere").
     std::string m_pipelineName;
 
-    // This material's unique descriptor set (Set 1).
-    VkDescriptorSet m_materialDescriptorSet;
-
-    // This material OWNS its Uniform Buffer.
-    // std::unique_ptr handles automatic cleanup.
-    std::unique_ptr<vks::Buffer> m_uboBuffer;
+    // Specialization bits and the variant compiled for them.
+    uint32_t m_features;
+    uint32_t m_variantId;
 };
 
 } // namespace vks
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/Buffer.hpp>
+#include <vks/Descriptors.hpp>
+#include <vks/MaterialTable.hpp>
+#include <vks/Transform.hpp>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vks {
+
+class Device;
+class GraphicsPipeline;
+
+/**
+ * @brief The parameters of all materials in one storage buffer, the
+ * material set (Set 1) of a pipeline, bound once instead of one set per
+ * material. Draws push their material index after their ObjectTransform.
+ *
+ * Like ClusterCuller, the buffers are held per slot (swapchain image):
+ * upload() copies the ranges of the table a slot is missing to its mapped
+ * buffer and only flushes those, once the slot's previous submission has
+ * completed.
+ */
+class MaterialBuffer : public NonCopyable {
+public:
+    // Push constant offset of the material index (DrawData of sphere.frag)
+    static constexpr uint32_t IndexOffset = sizeof(ObjectTransform);
+
+    /**
+     * @brief Creates the slots for the material set of a pipeline.
+     * @throws std::runtime_error if the set is not a single storage buffer.
+     */
+    MaterialBuffer(const Device& device, const GraphicsPipeline& pipelineManager, const std::string& pipelineName,
+                   uint32_t slotCount);
+
+    /**
+     * @brief Recreates the per slot resources (e.g. after a swapchain resize).
+     * @warning The GPU must be done with the previous ones.
+     */
+    void resize(uint32_t slotCount);
+
+    MaterialTable& table() { return m_table; }
+    const MaterialTable& table() const { return m_table; }
+
+    /**
+     * @brief Brings a slot up to date with the table, before recording the
+     * frame that reads it.
+     */
+    void upload(uint32_t slot);
+
+    VkDescriptorSet descriptorSet(uint32_t slot) const { return m_slots[slot].descriptorSet; }
+
+private:
+    struct Slot {
+        std::unique_ptr<vks::Buffer> buffer; // Host visible, persistently mapped
+        uint32_t capacity = 0;               // In materials
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    };
+
+    void createSlots(uint32_t slotCount);
+
+    const Device& m_device;
+    Ref<DescriptorSetLayout> m_setLayout;
+    Ref<DescriptorPool> m_descriptorPool;
+    VkDeviceSize m_atomSize = 1; // nonCoherentAtomSize, flushed ranges are aligned to it
+
+    MaterialTable m_table;
+    std::vector<Slot> m_slots;
+    std::vector<MaterialTable::Range> m_ranges;
+    std::vector<VkMappedMemoryRange> m_flushes;
+};
+
+} // namespace vks
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace vks {
+
+// Parameters of one material, an element of the material storage buffer
+// (std430 MaterialParams of sphere.frag)
+struct MaterialParams {
+    glm::vec4 color;
+    uint32_t baseColorTexture = 0; // BindlessTable image index, multiplies color
+    uint32_t sampler = 0;          // BindlessTable sampler index
+    uint32_t padding[2] = {};
+};
+
+/**
+ * @brief The parameters of every material by material index, and the edits
+ * each GPU copy of them is missing.
+ * There is one copy per slot (see MaterialBuffer), only written once the
+ * slot's previous submission has completed, so an edit never changes what a
+ * frame in flight reads: each slot catches up when it is next uploaded.
+ */
+class MaterialTable {
+public:
+    // Materials [first, first + count)
+    struct Range {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    explicit MaterialTable(uint32_t slotCount = 0);
+
+    /**
+     * @brief Changes the number of slots, which all start out of date.
+     */
+    void resize(uint32_t slotCount);
+
+    // Returns the index of the new material
+    uint32_t add(const MaterialParams& params);
+    void set(uint32_t index, const MaterialParams& params);
+    const MaterialParams& get(uint32_t index) const { return m_params[index]; }
+
+    uint32_t size() const { return static_cast<uint32_t>(m_params.size()); }
+    const MaterialParams* data() const { return m_params.data(); }
+
+    /**
+     * @brief The materials added or edited since a slot was last brought up
+     * to date (all of them for a new slot), then marks it up to date.
+     * @param ranges Sorted, disjoint ranges.
+     * @param gap Ranges at most this many materials apart are merged.
+     */
+    void takeDirtyRanges(uint32_t slot, std::vector<Range>& ranges, uint32_t gap = 0);
+
+private:
+    std::vector<MaterialParams> m_params;
+    std::vector<uint32_t> m_edits;   // Edited indices, since the slots' oldest update
+    std::vector<size_t> m_slotEdits; // Per slot, edits it has seen, OutOfDate for a new slot
+    std::vector<uint32_t> m_sorted;
+};
+
+} // namespace vks
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/Mesh/Optimize.hpp>
+#include <vks/Mesh/Quantize.hpp>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * @brief Merges bitwise identical vertices and rewrites the indices.
+ * Vertices that no triangle uses are dropped.
+ */
+void weldVertices(std::vector<geometry::Vertex>& vertices, std::vector<uint32_t>& indices);
+
+/**
+ * @brief Replaces the normals with the area-weighted average of the normals
+ * of the triangles around each vertex.
+ */
+void generateNormals(std::vector<geometry::Vertex>& vertices, const std::vector<uint32_t>& indices);
+
+/**
+ * @brief Fast non-cryptographic 64-bit hash of a byte range (change detection).
+ */
+uint64_t hashContent(const void* data, size_t size, uint64_t seed = 0);
+
+struct CookSettings
+{
+    geometry::VertexFormat vertexFormat = geometry::VertexFormat::Compact;
+    uint32_t optimizations = MeshOptimizeVertexCache | MeshOptimizeVertexFetch; // MeshOptimization bits
+    uint32_t maxLods = 5;          // 1 keeps the source mesh only
+    bool regenerateNormals = false; // Also when the source has normals
+};
+
+/**
+ * @brief A mesh processed into its runtime layout.
+ */
+struct CookedMesh
+{
+    geometry::VertexFormat vertexFormat = geometry::VertexFormat::Float;
+    uint32_t indexSize = 4;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    std::vector<uint8_t> vertexData;
+    std::vector<uint8_t> indexData;
+    std::vector<MeshLod> lods;
+    BoundingSphere bounds;
+    Quantization quantization;
+
+    // View for writeMeshFile()
+    MeshData view() const;
+};
+
+/**
+ * @brief Runs the offline pipeline: welding, normals (when missing or
+ * requested), LOD chain, LOD optimization, quantization and 16-bit indices
+ * when the vertex count allows them.
+ */
+CookedMesh cookMesh(std::vector<geometry::Vertex> vertices, std::vector<uint32_t> indices, bool hasNormals,
+                    const CookSettings& settings);
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <vks/Geometry.hpp>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * @brief A triangle mesh read from a source asset, in the float vertex layout.
+ */
+struct SourceMesh
+{
+    std::string name;
+    std::vector<geometry::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    bool hasNormals = false;
+};
+
+/**
+ * @brief Reads a Wavefront OBJ file as one mesh (polygons are fanned into
+ * triangles, UVs flipped to a top-left origin).
+ * @throws std::runtime_error if the file cannot be read or is malformed.
+ */
+SourceMesh importObj(const std::string& path);
+
+/**
+ * @brief Receives each mesh of a file as soon as it is decoded, with its
+ * position in the file. Called concurrently from the worker threads.
+ */
+using MeshCallback = std::function<void(size_t index, SourceMesh&& mesh)>;
+
+/**
+ * @brief Reads the triangle primitives of a glTF 2.0 file (.gltf or .glb),
+ * one mesh per primitive, in the space of their mesh.
+ * Primitives are decoded in parallel on the global ThreadPool, and so are the
+ * vertices of large primitives.
+ * @throws std::runtime_error if the file cannot be parsed.
+ */
+void importGltf(const std::string& path, const MeshCallback& onMesh);
+std::vector<SourceMesh> importGltf(const std::string& path);
+
+/**
+ * @brief Dispatches on the extension (.obj, .gltf, .glb).
+ */
+void importMeshes(const std::string& path, const MeshCallback& onMesh);
+std::vector<SourceMesh> importMeshes(const std::string& path);
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * @brief One level of detail: a range of a shared index buffer.
+ * LOD 0 is the finest, errors increase with the LOD index.
+ */
+struct MeshLod
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t vertexOffset = 0;
+    // Geometric deviation from the full mesh, relative to the bounding radius
+    float error = 0.0f;
+};
+
+struct BoundingSphere
+{
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+};
+
+/**
+ * @brief Bounding sphere centered on the bounding box of the positions.
+ */
+BoundingSphere computeBoundingSphere(const float* positions, size_t vertexCount, size_t stride);
+
+/**
+ * @brief Builds a LOD chain by repeatedly simplifying a mesh.
+ * Every level halves the triangle count of the previous one, until
+ * maxLods levels exist or the simplifier cannot make progress
+ * (e.g. only locked border/seam vertices remain).
+ *
+ * @param indices Finest level (LOD 0).
+ * @param lodIndices Receives the indices of all levels, back to back.
+ * @return One range of lodIndices per level, all with a vertexOffset of 0.
+ */
+std::vector<MeshLod> buildLodChain(const std::vector<uint32_t>& indices, const float* positions,
+                                   size_t vertexCount, size_t stride, uint32_t maxLods,
+                                   std::vector<uint32_t>& lodIndices);
+
+/**
+ * @brief Radius of a bounding sphere on screen, in pixels.
+ * @param radius World space radius.
+ * @param distance Distance from the camera to the sphere center.
+ * @param projectionScale proj[1][1] * viewportHeight / 2 (pixels at distance 1).
+ * @return The projected radius, or +infinity when the camera is inside.
+ */
+float projectedRadius(float radius, float distance, float projectionScale);
+
+/**
+ * @brief Picks the coarsest LOD whose error stays below a pixel threshold.
+ *
+ * The screen space error of a level is its relative error times the
+ * projected radius. To avoid popping when an object sits at a transition
+ * distance, a coarser level is only entered below threshold * (1 - hysteresis)
+ * and the current level is only left for a finer one above
+ * threshold * (1 + hysteresis).
+ *
+ * @param current The level selected for this object last frame.
+ */
+uint32_t selectLod(const MeshLod* lods, uint32_t lodCount, float projectedRadius, uint32_t current,
+                   float thresholdPixels, float hysteresis);
+
+} // namespace mesh
+} // namespace vks
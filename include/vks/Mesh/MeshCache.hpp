@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+
+namespace vks {
+namespace mesh {
+
+// Bump when a generator changes its output, so stale disk caches are ignored
+constexpr uint32_t GeneratedMeshVersion = 1;
+
+/**
+ * @brief A mesh as a generator writes it: float vertices, 32-bit indices and
+ * LOD ranges local to the mesh, before any Model processing.
+ */
+struct GeneratedMesh
+{
+    std::vector<geometry::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshLod> lods; // Empty for a single level
+    BoundingSphere bounds;
+
+    // View for writeMeshFile() and Model::createMesh()
+    MeshData view() const;
+};
+
+/**
+ * @brief UV sphere LODs: level i halves the tessellation of level i - 1
+ * (down to 4 x 2), each level with its own vertices, one after the other.
+ */
+void generateSphereLods(GeneratedMesh& mesh, float radius, uint32_t sectors, uint32_t stacks, uint32_t lodCount);
+
+/**
+ * @brief LODs of an arbitrary mesh from the quadric simplifier (see
+ * buildLodChain()), all levels sharing the vertices of the full mesh.
+ */
+void generateSimplifiedLods(GeneratedMesh& mesh, std::vector<geometry::Vertex> vertices,
+                            const std::vector<uint32_t>& indices, uint32_t maxLods);
+
+/**
+ * @brief Identity of a mesh in the geometry caches: a hash of a generator
+ * and its parameters, or of the content of a loaded mesh.
+ */
+struct MeshKey
+{
+    uint64_t hash = 0;
+
+    static MeshKey procedural(const std::string& generator, std::initializer_list<float> parameters);
+    static MeshKey content(const MeshData& mesh);
+
+    // The same mesh after a given processing (vertex format, optimizations)
+    MeshKey with(uint64_t value) const;
+
+    bool operator==(const MeshKey& other) const { return hash == other.hash; }
+    bool operator!=(const MeshKey& other) const { return hash != other.hash; }
+};
+
+/**
+ * @brief Generated meshes stored across runs, one mesh file per key.
+ * Writes go through a temporary file renamed in place, so concurrent runs
+ * never map a partial file.
+ */
+class MeshDiskCache
+{
+public:
+    /**
+     * @brief Creates the directory when missing.
+     * @throws std::runtime_error if it cannot be created.
+     */
+    explicit MeshDiskCache(std::string directory);
+
+    std::string path(const MeshKey& key) const;
+
+    /**
+     * @brief The mapped mesh of a key, or nullptr when it is not cached (or
+     * the file is not a valid generated mesh).
+     */
+    std::unique_ptr<MeshFile> load(const MeshKey& key) const;
+
+    /**
+     * @brief Stores a generated mesh.
+     * @return false if the file could not be written (the cache is optional).
+     */
+    bool store(const MeshKey& key, const MeshData& mesh) const;
+
+private:
+    std::string m_directory;
+};
+
+} // namespace mesh
+} // namespace vks
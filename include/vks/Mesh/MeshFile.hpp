@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <vks/Geometry.hpp>
+#include <vks/MappedFile.hpp>
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Mesh/Quantize.hpp>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * Binary mesh container (.vksmesh), little-endian:
+ *
+ *   MeshFileHeader
+ *   MeshLod[lodCount]              (index ranges local to the mesh)
+ *   vertex blob                    (vertexCount vertices of vertexFormat,
+ *                                   planar for split formats)
+ *   index blob                     (indexCount indices of indexSize bytes)
+ *
+ * Every section starts on a MeshFileAlignment boundary and the blobs are
+ * already in the layout the GPU reads, so loading is a copy from the mapped
+ * file to the staging memory.
+ */
+constexpr uint32_t MeshFileMagic = 0x4D534B56; // "VKSM"
+constexpr uint32_t MeshFileVersion = 1;
+constexpr uint64_t MeshFileAlignment = 64;
+
+struct MeshFileHeader
+{
+    uint32_t magic = MeshFileMagic;
+    uint32_t version = MeshFileVersion;
+    uint32_t vertexFormat = 0; // geometry::VertexFormat
+    uint32_t indexSize = 4;    // Bytes per index, 2 or 4
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t lodCount = 0;
+    uint32_t reserved = 0;
+    float bounds[4] = {};       // Bounding sphere center, radius
+    float quantization[4] = {}; // Quantization offset, scale (Compact vertices)
+    uint64_t lodTableOffset = 0;
+    uint64_t vertexDataOffset = 0;
+    uint64_t indexDataOffset = 0;
+    uint64_t fileSize = 0;
+};
+static_assert(sizeof(MeshFileHeader) == 96, "MeshFileHeader is part of the file format");
+static_assert(sizeof(MeshLod) == 16, "MeshLod is part of the file format");
+
+/**
+ * @brief A mesh in GPU layout, as written to a mesh file.
+ */
+struct MeshData
+{
+    geometry::VertexFormat vertexFormat = geometry::VertexFormat::Float;
+    uint32_t indexSize = 4;
+    const void* vertices = nullptr;
+    uint32_t vertexCount = 0;
+    const void* indices = nullptr;
+    uint32_t indexCount = 0;
+    const MeshLod* lods = nullptr;
+    uint32_t lodCount = 0;
+    BoundingSphere bounds;
+    Quantization quantization;
+};
+
+/**
+ * @brief Writes a mesh file, throwing std::runtime_error on I/O errors.
+ */
+void writeMeshFile(const std::string& path, const MeshData& mesh);
+
+/**
+ * @brief A mesh file mapped read-only in memory.
+ * Opening only validates the header and the section bounds: the blobs are
+ * paged in from the file by the first copy that touches them, or by
+ * prefetch().
+ */
+class MeshFile
+{
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be mapped or is not a
+     * valid mesh file of this version.
+     */
+    explicit MeshFile(const std::string& path);
+
+    const MeshFileHeader& header() const { return *reinterpret_cast<const MeshFileHeader*>(m_file.data()); }
+
+    geometry::VertexFormat vertexFormat() const { return static_cast<geometry::VertexFormat>(header().vertexFormat); }
+    uint32_t indexSize() const { return header().indexSize; }
+    uint32_t vertexCount() const { return header().vertexCount; }
+    uint32_t indexCount() const { return header().indexCount; }
+    uint32_t lodCount() const { return header().lodCount; }
+
+    const MeshLod* lods() const { return reinterpret_cast<const MeshLod*>(m_file.data() + header().lodTableOffset); }
+    BoundingSphere bounds() const;
+    Quantization quantization() const;
+
+    const void* vertexData() const { return m_file.data() + header().vertexDataOffset; }
+    size_t vertexDataSize() const;
+    const void* indexData() const { return m_file.data() + header().indexDataOffset; }
+    size_t indexDataSize() const;
+
+    // Reads the vertex and index data in (see MappedFile::prefetch())
+    void prefetch() const;
+
+    // The whole mesh, pointing into the mapping
+    MeshData view() const;
+
+private:
+    MappedFile m_file;
+};
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <vks/Mesh/Lod.hpp>
+
+namespace vks {
+namespace mesh {
+
+// Cluster limits (the common mesh shader output sizes, so the clusters also
+// suit a mesh shader path)
+constexpr uint32_t MaxMeshletVertices = 64;
+constexpr uint32_t MaxMeshletTriangles = 124;
+
+/**
+ * @brief A cluster of triangles, stored contiguously in the index buffer.
+ * The layout matches the std430 Meshlet of cluster_cull.comp.
+ */
+struct Meshlet
+{
+    glm::vec3 center{0.0f}; // Bounding sphere of the vertices
+    float radius = 0.0f;
+    glm::vec3 coneAxis{0.0f, 0.0f, 1.0f}; // Average triangle normal
+    float coneCutoff = 1.0f;              // Sine of the normal cone angle, 1 never culls
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t vertexOffset = 0;
+    uint32_t vertexCount = 0; // Unique vertices
+};
+static_assert(sizeof(Meshlet) == 48, "Meshlet is shared with cluster_cull.comp");
+
+/**
+ * @brief The meshlets of one LOD, in the array returned by buildLodMeshlets().
+ */
+struct MeshletRange
+{
+    uint32_t firstMeshlet = 0;
+    uint32_t meshletCount = 0;
+};
+
+/**
+ * @brief Splits a triangle list into meshlets of at most MaxMeshletVertices
+ * vertices and MaxMeshletTriangles triangles, and reorders the triangles so
+ * that each meshlet is a contiguous index range.
+ * Meshlets grow greedily from the first triangle not placed yet, taking the
+ * neighbouring triangle that adds the fewest new vertices, which keeps them
+ * compact (tight spheres, narrow normal cones). Triangle windings are kept.
+ * @return The meshlets, firstIndex relative to indices and vertexOffset 0.
+ */
+std::vector<Meshlet> buildMeshlets(uint32_t* indices, size_t indexCount, const float* positions,
+                                   size_t vertexCount, size_t stride);
+
+/**
+ * @brief buildMeshlets() on every LOD of a mesh. Meshlets take the firstIndex
+ * and vertexOffset of their LOD, so they draw like the LOD's own ranges.
+ * @param ranges Receives the meshlets of each LOD.
+ */
+std::vector<Meshlet> buildLodMeshlets(uint32_t* indices, const float* positions, size_t vertexCount, size_t stride,
+                                      const MeshLod* lods, size_t lodCount, std::vector<MeshletRange>& ranges);
+
+/**
+ * @brief True when no triangle of the meshlet can face a camera at
+ * cameraPosition (same space as the meshlet). CPU reference of the test in
+ * cluster_cull.comp; conservative, using the bounding sphere as cone apex.
+ */
+bool isMeshletBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition);
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vks/Mesh/Lod.hpp>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * @brief Steps of optimizeLods().
+ */
+enum MeshOptimization : uint32_t {
+    MeshOptimizeVertexCache = 1u << 0, // Triangle order for the post-transform cache
+    MeshOptimizeVertexFetch = 1u << 1, // Vertices in first-use order
+    MeshOptimizeOverdraw = 1u << 2,    // Outward-facing triangle clusters first
+};
+
+/**
+ * @brief Post-transform vertex cache efficiency of an index buffer.
+ */
+struct VertexCacheStatistics
+{
+    float acmr = 0.0f; // Average cache miss ratio: vertex shader runs per triangle (0.5 is ideal)
+    float atvr = 0.0f; // Average transformed vertex ratio: runs per used vertex (1 is ideal)
+};
+
+/**
+ * @brief Simulates a FIFO post-transform cache of cacheSize entries.
+ */
+VertexCacheStatistics analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                         uint32_t cacheSize = 16);
+
+/**
+ * @brief Reorders triangles for post-transform cache locality (Tom Forsyth's
+ * "Linear-Speed Vertex Cache Optimisation"). Triangle windings are kept.
+ */
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+/**
+ * @brief Reorders clusters of cache-optimized triangles so that the ones
+ * facing away from the mesh center are drawn first (Sander et al. 2007),
+ * which lets them occlude the rest of the mesh.
+ * Clusters start where the cache simulation misses all three vertices, so
+ * the vertex cache efficiency is mostly preserved. Run after optimizeVertexCache().
+ */
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+                      size_t stride);
+
+/**
+ * @brief Reorders vertices in first-use order for vertex fetch locality and
+ * rewrites the indices. Unused vertices are moved to the end.
+ * @return The number of used vertices.
+ */
+size_t optimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, uint32_t* indices,
+                           size_t indexCount);
+
+/**
+ * @brief Runs the MeshOptimization steps on every LOD of a mesh.
+ * Triangles are reordered per LOD; vertices per group of consecutive LODs
+ * sharing a vertexOffset (a LOD owns the vertices up to the next greater
+ * offset). Vertices must start with their float position.
+ */
+void optimizeLods(void* vertices, size_t vertexCount, size_t vertexSize, uint32_t* indices, const MeshLod* lods,
+                  size_t lodCount, uint32_t optimizations);
+
+/**
+ * @brief Copies indices to 16 bits; every index must be below 65536.
+ */
+void narrowIndices(const uint32_t* indices, size_t indexCount, uint16_t* narrowed);
+
+} // namespace mesh
+} // namespace vks
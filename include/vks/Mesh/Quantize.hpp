@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <vks/Geometry.hpp>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * @brief IEEE 754 binary16 conversion, round to nearest even.
+ * Values out of the half range become infinities, NaNs stay NaNs.
+ */
+uint16_t quantizeHalf(float value);
+float dequantizeHalf(uint16_t value);
+
+/**
+ * @brief Octahedral unit vector encoding in 2 x snorm16 (Cigolle et al. 2014).
+ * The sphere is folded on the octahedron |x| + |y| + |z| = 1 and its lower
+ * half unfolded on the corners of the [-1, 1]^2 square.
+ */
+void encodeOctahedral(const float normal[3], int16_t encoded[2]);
+void decodeOctahedral(const int16_t encoded[2], float normal[3]);
+
+/**
+ * @brief Maps positions to [0, 1]^3: p = offset + scale * unorm.
+ * The scale is uniform (the largest extent of the bounding box), so the
+ * dequantization can be folded into a model matrix without skewing normals.
+ */
+struct Quantization
+{
+    glm::vec3 offset{0.0f};
+    float scale = 1.0f;
+
+    // Transform taking unorm positions back to object space
+    glm::mat4 dequantization() const;
+};
+
+/**
+ * @brief Quantization covering the bounding box of the positions.
+ */
+Quantization computeQuantization(const float* positions, size_t vertexCount, size_t stride);
+
+/**
+ * @brief Encodes float vertices into CompactVertex (in parallel on the global ThreadPool).
+ */
+void compressVertices(const geometry::Vertex* vertices, size_t vertexCount, const Quantization& quantization,
+                      geometry::CompactVertex* compressed);
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vks {
+namespace mesh {
+
+/**
+ * @brief Reduces the triangle count of an indexed triangle list with quadric
+ * error metric edge collapses (Garland & Heckbert).
+ *
+ * Vertices are only collapsed onto existing vertices, so the result indexes
+ * the same vertex buffer and can share it with the original mesh.
+ * Border vertices (edges used by a single triangle) and attribute seams
+ * (several vertices at the same position) are locked, which keeps UV seams
+ * and mesh outlines intact.
+ *
+ * @param indices Triangle list to simplify.
+ * @param positions First vertex position (3 floats).
+ * @param vertexCount Number of vertices.
+ * @param stride Distance in bytes between two positions.
+ * @param targetIndexCount Stops once the result has at most this many indices.
+ * @param maxError Stops before a collapse moving the surface further than
+ * this (object space units).
+ * @param resultError If not null, receives the largest error introduced.
+ * @return The simplified triangle list.
+ */
+std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, const float* positions, size_t vertexCount,
+                               size_t stride, size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+} // namespace mesh
+} // namespace vks
@@ -3,16 +3,52 @@
 #include <vks/Device.hpp>
 #include <vks/Buffer.hpp>
 #include <vks/Geometry.hpp>
+#include <vks/GeometryArena.hpp>
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Mesh/MeshCache.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/Mesh/Meshlet.hpp>
+#include <vks/Mesh/Optimize.hpp>
 #include <vulkan/vulkan.h>
+#include <functional>
 #include <memory>
+#include <string>
 
 
 namespace vks
 {
+    /**
+     * @brief Mesh processing a Model applies to its geometry before the upload
+     * (see vks::mesh::optimizeLods()). Each step runs per LOD. Indices are narrowed to 16 bits whenever the
+     * vertex count allows it, independently of these bits.
+     */
+    enum ModelOptimization : uint32_t {
+        ModelOptimizeVertexCache = vks::mesh::MeshOptimizeVertexCache,
+        ModelOptimizeVertexFetch = vks::mesh::MeshOptimizeVertexFetch,
+        ModelOptimizeOverdraw = vks::mesh::MeshOptimizeOverdraw,
+        // Split each LOD into meshlets for the cluster culler (vks::mesh::buildLodMeshlets()),
+        // generated meshes only
+        ModelOptimizeMeshlets = 1u << 3,
+        ModelOptimizeDefault = ModelOptimizeVertexCache | ModelOptimizeVertexFetch,
+    };
+
     /**
      * @brief Manages a 3D model's geometry on the GPU.
-     * This class owns the VkBuffer for vertices and indices.
+     * The vertices and indices live in ranges of the application's
+     * GeometryArena, returned when the model is destroyed. Models made with
+     * share() draw the same ranges, which go back to the arena with the last
+     * of them (see GeometryCache).
      * It's designed to be stored in a registry (e.g., std::map<string, Model>)
+     *
+     * A model can carry a chain of LODs sharing its ranges: each level is a
+     * draw range of the arena (see vks::mesh::MeshLod), with firstIndex and
+     * vertexOffset already relative to the arena buffers. Single-level models
+     * have one LOD covering the whole mesh.
+     *
+     * The vertex format is chosen per model: CompactVertex models halve the
+     * vertex memory and fetch bandwidth, split formats keep positions in their
+     * own stream for depth-only passes. Each draws with the pipeline variant
+     * including getVariantFeatures().
      */
     class Model
     {
@@ -21,45 +57,189 @@ namespace vks
          * @brief Default constructor for creating an empty model.
          */
         Model() = default;
-        ~Model() = default;
+        ~Model();
+
+        /**
+         * @brief Creates an empty model storing its vertices in a given format.
+         * @param optimizations ModelOptimization bits (0 writes generated meshes
+         * straight into the staging buffers).
+         */
+        explicit Model(vks::geometry::VertexFormat vertexFormat,
+                       uint32_t optimizations = ModelOptimizeDefault)
+            : m_vertexFormat(vertexFormat), m_optimizations(optimizations) {}
 
-        void Model::createSphere(
+        // --- Procedural shapes (see vks::geometry for the parameters) ---
+        void createSphere(
             const vks::Device& device,
             VkCommandPool commandPool,
             float radius,
             uint32_t sectors,
             uint32_t stacks);
 
+        void createIcosphere(const vks::Device& device, VkCommandPool commandPool,
+                             float radius, uint32_t frequency);
+
+        void createCubeSphere(const vks::Device& device, VkCommandPool commandPool,
+                              float radius, uint32_t divisions);
+
+        void createPlane(const vks::Device& device, VkCommandPool commandPool,
+                         float width, float height, uint32_t xSegments, uint32_t ySegments);
+
+        void createTorus(const vks::Device& device, VkCommandPool commandPool,
+                         float majorRadius, float minorRadius, uint32_t rings, uint32_t sides);
+
+        void createCylinder(const vks::Device& device, VkCommandPool commandPool,
+                            float radius, float height, uint32_t sectors, uint32_t stacks);
+
+        // --- LOD chains ---
+        /**
+         * @brief UV sphere LODs from the generator: level i halves the
+         * tessellation of level i - 1 (down to 4 x 2).
+         */
+        void createSphereLods(const vks::Device& device, VkCommandPool commandPool,
+                              float radius, uint32_t sectors, uint32_t stacks, uint32_t lodCount);
+
+        /**
+         * @brief LODs of an arbitrary mesh, from the quadric simplifier.
+         * All levels share the vertices of the full mesh.
+         */
+        void createSimplifiedLods(const vks::Device& device, VkCommandPool commandPool,
+                                  const std::vector<vks::geometry::Vertex>& vertices,
+                                  const std::vector<uint32_t>& indices, uint32_t maxLods);
+
+        /**
+         * @brief Processes a generated mesh (see vks::mesh::GeneratedMesh:
+         * float vertices, 32-bit indices, local LODs) like the procedural
+         * shapes, with the model's format and optimizations.
+         * @throws std::runtime_error for any other layout.
+         */
+        void createMesh(const vks::Device& device, VkCommandPool commandPool, const vks::mesh::MeshData& mesh);
+
+        // --- Mesh files ---
+        /**
+         * @brief Uploads a mesh file (see vks::mesh::MeshFile). Its vertex
+         * format, index type and LODs replace the model's settings, the data
+         * being copied as is from the mapped file to the staging buffers.
+         */
+        void loadMesh(const vks::Device& device, VkCommandPool commandPool, const std::string& path);
+        void loadMesh(const vks::Device& device, VkCommandPool commandPool, const vks::mesh::MeshFile& file);
+
+        /**
+         * @brief Uploads a mesh already in GPU layout (a mapped file or a
+         * vks::mesh::CookedMesh), with the same rules as a mesh file.
+         */
+        void loadMesh(const vks::Device& device, VkCommandPool commandPool, const vks::mesh::MeshData& mesh);
+
         // Models are unique assets, so delete copy operations.
         Model(const Model&) = delete;
         Model& operator=(const Model&) = delete;
 
-        // Models can be moved (e.g., when placing in a std::map)
-        Model(Model&&) = default;
-        Model& operator=(Model&&) = default;
+        // Models can be moved (e.g., when placing in a std::map),
+        // the ranges follow the moved-to model
+        Model(Model&& other) noexcept;
+        Model& operator=(Model&& other) noexcept;
+
+        /**
+         * @brief A model drawing the same geometry, sharing the arena ranges
+         * instead of uploading them again.
+         */
+        Model share() const;
+
+        // Number of models drawing this model's ranges (0 when not resident)
+        long getShareCount() const { return m_geometry.use_count(); }
 
         // --- Getters for the Render Loop ---
-        VkBuffer getVertexBuffer() const { return m_vertexBuffer->getBuffer(); }
-        VkBuffer getIndexBuffer() const { return m_indexBuffer->getBuffer(); }
-        uint32_t getIndexCount() const { return m_indexCount; }
+        /**
+         * @brief True once the geometry is in the arena. Models streamed in by
+         * a ModelLoader are registered early and only become drawable then.
+         */
+        bool isResident() const { return m_geometry != nullptr; }
+
+        // Draw ranges of LOD 0; the buffers are bound once per frame from the arena
+        uint32_t getFirstIndex() const { return m_lods.empty() ? 0 : m_lods[0].firstIndex; }
+        int32_t getVertexOffset() const { return m_lods.empty() ? 0 : m_lods[0].vertexOffset; }
+        uint32_t getIndexCount() const { return m_lods.empty() ? 0 : m_lods[0].indexCount; }
+        VkIndexType getIndexType() const { return m_indexType; }
+        const GeometryAllocation& getAllocation() const;
+
+        // --- Level of detail ---
+        const std::vector<vks::mesh::MeshLod>& getLods() const { return m_lods; }
+        uint32_t getLodCount() const { return static_cast<uint32_t>(m_lods.size()); }
+        const vks::mesh::BoundingSphere& getBounds() const { return m_bounds; }
+
+        // --- Meshlets (ModelOptimizeMeshlets) ---
+        bool hasMeshlets() const { return m_geometry != nullptr && m_geometry->meshletCount > 0; }
+
+        /**
+         * @brief The meshlets of a LOD, as indices into the arena's meshlet buffer.
+         * Their bounds are in the model's space before dequantization.
+         */
+        vks::mesh::MeshletRange getMeshlets(uint32_t lod) const;
+
+        // --- Vertex format ---
+        vks::geometry::VertexFormat getVertexFormat() const { return m_vertexFormat; }
+        bool isQuantized() const { return vks::geometry::isCompact(m_vertexFormat); }
+        bool hasSplitStreams() const { return vks::geometry::isSplit(m_vertexFormat); }
+
+        /**
+         * @brief Transform from quantized positions to object space, to apply
+         * after the object's model matrix (identity for float vertices).
+         */
+        const glm::mat4& getDequantization() const { return m_dequantization; }
+
+        /**
+         * @brief Pipeline feature bits required by the vertex format.
+         */
+        uint32_t getVariantFeatures() const;
 
     private:
         /**
-         * @brief Helper to create and fill a vertex/index buffer using a staging buffer.
-         * This is the correct way to upload data to fast DEVICE_LOCAL memory.
+         * @brief Drops the model's share of its ranges, returned to the arena
+         * with the last share.
+         */
+        void release();
+
+        using GeometryWriter = std::function<void(vks::geometry::Vertex*, uint32_t*)>;
+        using StagingWriter = std::function<void(void* vertexData, void* indexData)>;
+
+        /**
+         * @brief Uploads a generated mesh of a known size to the arena.
+         * The writer generates the mesh straight into the mapped staging buffers
+         * (no intermediate std::vector). Models that quantize, optimize or
+         * narrow their data generate it in memory first, then process it into
+         * the staging buffers.
+         * @param lods The index ranges written, or empty for a single level.
          */
-        void createBufferFromData(
+        void createGeometry(
             const vks::Device& device,
             VkCommandPool commandPool,
-            void* data,
-            VkDeviceSize size,
-            VkBufferUsageFlags usage,
-            std::unique_ptr<vks::Buffer>& outBuffer);
+            vks::geometry::MeshSize size,
+            const GeometryWriter& writer,
+            const vks::mesh::BoundingSphere& bounds,
+            std::vector<vks::mesh::MeshLod> lods = {});
+
+        /**
+         * @brief Fills staging buffers sized for the model's counts, format and
+         * index type, copies them to the model's ranges of the arena and
+         * rebases the LODs (and meshlets) on the arena buffers.
+         */
+        void uploadGeometry(const vks::Device& device, const StagingWriter& writer);
 
-        std::unique_ptr<vks::Buffer> m_vertexBuffer;
-        std::unique_ptr<vks::Buffer> m_indexBuffer;
+        // Arena ranges, freed by the deleter of the last share
+        std::shared_ptr<const vks::GeometryAllocation> m_geometry;
 
         uint32_t m_vertexCount = 0;
         uint32_t m_indexCount = 0;
+
+        vks::geometry::VertexFormat m_vertexFormat = vks::geometry::VertexFormat::Float;
+        uint32_t m_optimizations = ModelOptimizeDefault;
+        VkIndexType m_indexType = VK_INDEX_TYPE_UINT32;
+        glm::mat4 m_dequantization{1.0f};
+
+        std::vector<vks::mesh::MeshLod> m_lods;
+        vks::mesh::BoundingSphere m_bounds;
+
+        std::vector<vks::mesh::Meshlet> m_meshlets; // Until uploaded
+        std::vector<vks::mesh::MeshletRange> m_meshletLods;
     };
 } // namespace vks
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vks/CommandPool.hpp>
+#include <vks/Device.hpp>
+#include <vks/GeometryCache.hpp>
+#include <vks/Mesh/Cook.hpp>
+#include <vks/Model.hpp>
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace vks
+{
+    /**
+     * @brief Streams models in from disk without stalling the frame loop.
+     * load() only queues a job on the global ThreadPool: mesh files are mapped
+     * and paged in there, OBJ/glTF files are parsed, decoded and cooked there
+     * (one primitive per task, see vks::mesh::importMeshes()). update(),
+     * called once per frame on the main thread, uploads what is ready.
+     *
+     * The models of a file are named after the load() name: the first mesh
+     * takes the name itself, mesh i > 0 takes "name.i". Their entries in the
+     * registry stay empty (Model::isResident() is false) until uploaded, so
+     * render objects can point at them from the start.
+     *
+     * With a GeometryCache, meshes are hashed on the workers and a mesh whose
+     * content is already resident shares its geometry instead of being
+     * uploaded again.
+     */
+    class ModelLoader : public NonCopyable
+    {
+    public:
+        // Staging bytes update() uploads per call by default
+        static constexpr VkDeviceSize DefaultUploadBudget = VkDeviceSize(64) << 20;
+
+        ModelLoader(const vks::Device& device, const vks::CommandPool& commandPool,
+                    vks::GeometryCache* geometryCache = nullptr);
+
+        /**
+         * @brief Waits for the jobs in flight; meshes not uploaded yet are dropped.
+         */
+        ~ModelLoader();
+
+        /**
+         * @brief Queues the loading of a .vksmesh, .obj, .gltf or .glb file.
+         * @param settings How source files are cooked (mesh files are used as is).
+         */
+        void load(const std::string& path, const std::string& name,
+                  const vks::mesh::CookSettings& settings = {});
+
+        /**
+         * @brief Uploads ready meshes into their models, up to byteBudget
+         * bytes of geometry (always at least one mesh), and reports the
+         * failed loads on std::cerr.
+         * @warning A model replaced by a new load must not be in use by the GPU.
+         * @return The number of models that became resident.
+         */
+        size_t update(std::map<std::string, vks::Model>& models, VkDeviceSize byteBudget = DefaultUploadBudget);
+
+        /**
+         * @brief Files still loading plus meshes waiting for their upload.
+         */
+        size_t pendingCount() const;
+
+    private:
+        // Queues shared with the jobs running on the pool
+        struct State;
+
+        const vks::Device& m_device;
+        const vks::CommandPool& m_commandPool;
+        vks::GeometryCache* m_geometryCache;
+        std::shared_ptr<State> m_state;
+    };
+} // namespace vks
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace vks {
+
+/**
+ * @brief Sub-allocates ranges of a linear resource (e.g. the elements of a
+ * buffer) with a best-fit free list.
+ * Freed ranges are merged with their free neighbours, and grow() appends
+ * free space at the end so the owner can resize the underlying resource.
+ * Offsets and sizes are in arbitrary units (vertices, indices, bytes...).
+ */
+class RangeAllocator {
+public:
+    static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+    explicit RangeAllocator(uint32_t capacity = 0);
+
+    /**
+     * @brief Allocates size contiguous units.
+     * @return The offset of the range, or InvalidOffset when no free block is
+     * large enough (grow() and retry).
+     */
+    uint32_t allocate(uint32_t size);
+
+    /**
+     * @brief Returns a range obtained from allocate() with the same size.
+     */
+    void free(uint32_t offset, uint32_t size);
+
+    /**
+     * @brief Extends the managed space to newCapacity units (never shrinks).
+     */
+    void grow(uint32_t newCapacity);
+
+    uint32_t capacity() const { return m_capacity; }
+    uint32_t used() const { return m_used; }
+    uint32_t largestFreeBlock() const;
+    size_t freeBlockCount() const { return m_freeByOffset.size(); }
+
+private:
+    void insertFreeBlock(uint32_t offset, uint32_t size);
+    void eraseFreeBlock(std::map<uint32_t, uint32_t>::iterator block);
+
+    uint32_t m_capacity = 0;
+    uint32_t m_used = 0;
+
+    // The same free blocks, by offset (merging) and by (size, offset) (best fit)
+    std::map<uint32_t, uint32_t> m_freeByOffset;
+    std::set<std::pair<uint32_t, uint32_t>> m_freeBySize;
+};
+
+} // namespace vks
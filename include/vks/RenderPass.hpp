@@ -9,16 +9,47 @@ namespace vks {
 class Device;
 class SwapChain;
 
+/**
+ * @brief A pass rendering into the swapchain image.
+ * With dynamic rendering (Device::dynamicRendering()) the pass is described
+ * at record time from colorAttachment() and no VkRenderPass or VkFramebuffer
+ * exists. Otherwise a render pass and one framebuffer per swapchain image are
+ * created, and rebuilt on resize.
+ *
+ * A pass created with a depth target also owns a depth image of the
+ * swapchain extent, shared by all swapchain images (the frames' passes are
+ * ordered on the queue). It is cleared by begin() and not stored.
+ */
 class RenderPass : public NonCopyable {
 public:
-  RenderPass(const Device &device, const SwapChain &swapChain);
+  RenderPass(const Device &device, const SwapChain &swapChain,
+             bool depthTarget = false);
   ~RenderPass();
 
+  // VK_NULL_HANDLE with dynamic rendering
   inline const VkRenderPass &handle() const { return m_renderPass; }
   inline const VkFramebuffer &frameBuffer(uint32_t index) const {
     return m_frameBuffers[index];
   }
-  inline size_t size() const { return m_frameBuffers.size(); }
+  size_t size() const;
+
+  inline bool dynamic() const { return m_dynamic; }
+  VkFormat colorFormat() const;
+  // VK_FORMAT_UNDEFINED without a depth target
+  inline VkFormat depthFormat() const { return m_depthFormat; }
+
+  /**
+   * @brief Begins the pass on a swapchain image.
+   * With dynamic rendering this also transitions the image from the
+   * attachment's initial layout.
+   */
+  void begin(VkCommandBuffer cmd, uint32_t imageIndex,
+             const VkClearValue &clearValue) const;
+
+  /**
+   * @brief Ends the pass, leaving the image in the attachment's final layout.
+   */
+  void end(VkCommandBuffer cmd, uint32_t imageIndex) const;
 
   void recreate();
   void cleanupOld();
@@ -31,11 +62,30 @@ protected:
 
   const Device &m_device;
   const SwapChain &m_swapChain;
+  const bool m_dynamic;
+
+  VkFormat m_depthFormat;
+  VkImage m_depthImage;
+  VkDeviceMemory m_depthMemory;
+  VkImageView m_depthView;
+
+  // The swapchain attachment: format, load/store ops and layouts
+  virtual VkAttachmentDescription colorAttachment() const = 0;
+  // The depth target attachment: cleared, not stored
+  VkAttachmentDescription depthAttachment() const;
 
   virtual void createRenderPass() = 0;
   void createFrameBuffers();
 
   void destroyFrameBuffers();
+
+private:
+  void createDepthTarget();
+  void destroyDepthTarget();
+  void transitionDepth(VkCommandBuffer cmd) const;
+
+  void transitionImage(VkCommandBuffer cmd, uint32_t imageIndex,
+                       VkImageLayout oldLayout, VkImageLayout newLayout) const;
 };
 } // namespace vks
 
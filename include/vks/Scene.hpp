@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <vks/Mesh/Lod.hpp>
+#include <vks/TransformHierarchy.hpp>
+
+namespace vks {
+
+/**
+ * @brief Stable reference to a Scene object.
+ * The generation tells a destroyed object's handle from the handle of the
+ * object that later reuses its slot, so stale handles are detected.
+ */
+struct SceneHandle
+{
+    static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+    uint32_t slot = InvalidSlot;
+    uint32_t generation = 0;
+
+    bool operator==(const SceneHandle& other) const
+    {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const SceneHandle& other) const { return !(*this == other); }
+};
+
+enum SceneObjectFlags : uint32_t
+{
+    SceneObjectHidden = 1u << 0, // Kept in the scene, but not drawn
+};
+
+/**
+ * @brief Scene objects stored as structure of arrays.
+ * Every component lives in its own dense array, index i of each array
+ * belonging to the same object, so a pass only streams the components it
+ * reads (e.g. the LOD selection touches bounds and LODs, not materials).
+ *
+ * Objects are created and destroyed in O(1): a destroyed object is replaced
+ * by the last one, which keeps the arrays dense but changes that object's
+ * index. Indices are only valid until the next destroy(); keep a SceneHandle
+ * to refer to an object across frames.
+ *
+ * Meshes and materials are referenced by IDs into the application's
+ * registries, the scene owns no resources.
+ */
+class Scene {
+public:
+    using MeshId = uint32_t;
+    using MaterialId = uint32_t;
+
+    static constexpr MeshId NoMesh = UINT32_MAX; // Pipelines without vertex input
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    /**
+     * @param node The object's node when it moves with a TransformHierarchy,
+     * whose world matrix the owner copies into its transform.
+     */
+    SceneHandle create(const glm::mat4& transform, MeshId mesh, MaterialId material, uint32_t flags = 0,
+                       TransformHierarchy::NodeId node = TransformHierarchy::NoNode);
+
+    /**
+     * @brief Creates count objects at once, e.g. when loading a scene file.
+     * Their transforms, meshes, materials and nodes are left for the caller
+     * to fill in the component arrays, their flags are 0.
+     * @return The index of the first one, the others follow.
+     */
+    uint32_t createBatch(uint32_t count);
+
+    /**
+     * @brief Destroys an object, its handle becomes stale.
+     * @return false if the handle was already stale.
+     */
+    bool destroy(SceneHandle handle);
+
+    bool alive(SceneHandle handle) const { return indexOf(handle) != InvalidIndex; }
+
+    /**
+     * @return The current index of an object in the component arrays, or
+     * InvalidIndex for a stale handle.
+     */
+    uint32_t indexOf(SceneHandle handle) const;
+
+    SceneHandle handleAt(uint32_t index) const;
+
+    /**
+     * @brief The transform of a live object.
+     * @throws std::runtime_error for a stale handle.
+     */
+    glm::mat4& transform(SceneHandle handle);
+
+    void reserve(size_t count);
+    void clear();
+
+    // Number of live objects, the length of every component array
+    uint32_t size() const { return static_cast<uint32_t>(m_transforms.size()); }
+    bool empty() const { return m_transforms.empty(); }
+
+    // --- Component arrays ---
+    glm::mat4* transforms() { return m_transforms.data(); }
+    const glm::mat4* transforms() const { return m_transforms.data(); }
+
+    // World space bounds, kept up to date by the owner of the meshes
+    vks::mesh::BoundingSphere* bounds() { return m_bounds.data(); }
+    const vks::mesh::BoundingSphere* bounds() const { return m_bounds.data(); }
+
+    const MeshId* meshes() const { return m_meshes.data(); }
+    MeshId* meshes() { return m_meshes.data(); }
+    const MaterialId* materials() const { return m_materials.data(); }
+    MaterialId* materials() { return m_materials.data(); }
+
+    const TransformHierarchy::NodeId* nodes() const { return m_nodes.data(); }
+    TransformHierarchy::NodeId* nodes() { return m_nodes.data(); }
+
+    // SceneObjectFlags bits
+    const uint32_t* flags() const { return m_flags.data(); }
+    uint32_t* flags() { return m_flags.data(); }
+
+    // --- Per-frame draw state ---
+    // Level of detail drawn this frame
+    const uint32_t* lods() const { return m_lods.data(); }
+    uint32_t* lods() { return m_lods.data(); }
+
+    // Pipeline variants for the material features and the mesh's vertex
+    // format, and of the "depth" pipeline
+    const uint32_t* variants() const { return m_variants.data(); }
+    uint32_t* variants() { return m_variants.data(); }
+    const uint32_t* depthVariants() const { return m_depthVariants.data(); }
+    uint32_t* depthVariants() { return m_depthVariants.data(); }
+
+private:
+    struct Slot
+    {
+        uint32_t generation = 0;
+        uint32_t index = InvalidIndex; // In the arrays when alive, next free slot otherwise
+    };
+
+    std::vector<Slot> m_slots;
+    uint32_t m_freeSlot = InvalidIndex;
+
+    // Components, plus the slot of each object to fix it up when moved
+    std::vector<glm::mat4> m_transforms;
+    std::vector<vks::mesh::BoundingSphere> m_bounds;
+    std::vector<MeshId> m_meshes;
+    std::vector<MaterialId> m_materials;
+    std::vector<TransformHierarchy::NodeId> m_nodes;
+    std::vector<uint32_t> m_flags;
+    std::vector<uint32_t> m_lods;
+    std::vector<uint32_t> m_variants;
+    std::vector<uint32_t> m_depthVariants;
+    std::vector<uint32_t> m_slotOf;
+};
+
+} // namespace vks
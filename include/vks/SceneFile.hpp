@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <vks/MappedFile.hpp>
+#include <vks/Scene.hpp>
+#include <vks/Transform.hpp>
+#include <vks/TransformHierarchy.hpp>
+
+namespace vks {
+
+/**
+ * Binary scene container (.vksscene), little-endian:
+ *
+ *   SceneFileHeader
+ *   SceneFileAsset[meshCount + materialCount]   meshes, then materials
+ *   name blob                  asset names, not null-terminated
+ *   LocalTransform[nodeCount]  hierarchy nodes, parents before children
+ *   uint32_t[nodeCount]        parent node, SceneFileNoIndex for roots
+ *   glm::mat4[objectCount]     object transforms
+ *   uint32_t[objectCount]      mesh asset, SceneFileNoIndex for none
+ *   uint32_t[objectCount]      material asset
+ *   uint32_t[objectCount]      SceneObjectFlags
+ *   uint32_t[objectCount]      node, SceneFileNoIndex for none
+ *
+ * Every section starts on a SceneFileAlignment boundary and holds the
+ * arrays in the layout Scene and TransformHierarchy keep in memory: loading
+ * copies them out of the mapped file, only the mesh and material references
+ * go through the table of the application's IDs.
+ */
+constexpr uint32_t SceneFileMagic = 0x53534B56; // "VKSS"
+constexpr uint32_t SceneFileVersion = 1;
+constexpr uint64_t SceneFileAlignment = 64;
+constexpr uint32_t SceneFileNoIndex = UINT32_MAX;
+
+struct SceneFileHeader
+{
+    uint32_t magic = SceneFileMagic;
+    uint32_t version = SceneFileVersion;
+    uint32_t objectCount = 0;
+    uint32_t nodeCount = 0;
+    uint32_t meshCount = 0;
+    uint32_t materialCount = 0;
+    uint64_t assetTableOffset = 0;
+    uint64_t nameDataOffset = 0;
+    uint64_t localsOffset = 0;
+    uint64_t parentsOffset = 0;
+    uint64_t transformsOffset = 0;
+    uint64_t meshesOffset = 0;
+    uint64_t materialsOffset = 0;
+    uint64_t flagsOffset = 0;
+    uint64_t nodesOffset = 0;
+    uint64_t fileSize = 0;
+};
+static_assert(sizeof(SceneFileHeader) == 104, "SceneFileHeader is part of the file format");
+
+// An asset referenced by name, the application resolves it to its own ID
+struct SceneFileAsset
+{
+    uint64_t nameOffset = 0; // In the name blob
+    uint32_t nameSize = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(SceneFileAsset) == 16, "SceneFileAsset is part of the file format");
+static_assert(sizeof(LocalTransform) == 40, "LocalTransform is part of the file format");
+static_assert(sizeof(glm::mat4) == 64, "glm::mat4 is part of the file format");
+
+/**
+ * @brief Writes a scene and its hierarchy to a scene file, throwing
+ * std::runtime_error on I/O errors.
+ * @param meshNames Name of each Scene::MeshId the objects use.
+ * @param materialNames Name of each Scene::MaterialId the objects use.
+ */
+void writeSceneFile(const std::string& path, const Scene& scene, const TransformHierarchy& hierarchy,
+                    const std::vector<std::string>& meshNames, const std::vector<std::string>& materialNames);
+
+/**
+ * @brief A scene file mapped read-only in memory.
+ * Opening validates the header, the section bounds and every index, so
+ * loading can trust the arrays.
+ */
+class SceneFile
+{
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be mapped or is not a
+     * valid scene file of this version.
+     */
+    explicit SceneFile(const std::string& path);
+
+    const SceneFileHeader& header() const { return *reinterpret_cast<const SceneFileHeader*>(m_file.data()); }
+
+    uint32_t objectCount() const { return header().objectCount; }
+    uint32_t nodeCount() const { return header().nodeCount; }
+    uint32_t meshCount() const { return header().meshCount; }
+    uint32_t materialCount() const { return header().materialCount; }
+
+    std::string_view meshName(uint32_t mesh) const { return assetName(mesh); }
+    std::string_view materialName(uint32_t material) const { return assetName(meshCount() + material); }
+
+    const LocalTransform* locals() const { return section<LocalTransform>(header().localsOffset); }
+    const uint32_t* parents() const { return section<uint32_t>(header().parentsOffset); }
+    const glm::mat4* transforms() const { return section<glm::mat4>(header().transformsOffset); }
+    const uint32_t* meshes() const { return section<uint32_t>(header().meshesOffset); }
+    const uint32_t* materials() const { return section<uint32_t>(header().materialsOffset); }
+    const uint32_t* flags() const { return section<uint32_t>(header().flagsOffset); }
+    const uint32_t* nodes() const { return section<uint32_t>(header().nodesOffset); }
+
+    // Reads the whole file in (see MappedFile::prefetch())
+    void prefetch() const { m_file.prefetch(0, m_file.size()); }
+
+private:
+    template <typename T>
+    const T* section(uint64_t offset) const { return reinterpret_cast<const T*>(m_file.data() + offset); }
+    std::string_view assetName(uint32_t asset) const;
+
+    MappedFile m_file;
+};
+
+/**
+ * @brief Replaces the objects of a scene and the nodes of a hierarchy with
+ * the contents of a scene file. Object nodes refer to the new hierarchy:
+ * node i of the file becomes NodeId i.
+ * @param meshes The Scene::MeshId of each mesh of the file (meshCount()).
+ * @param materials The Scene::MaterialId of each material of the file.
+ */
+void loadScene(const SceneFile& file, const Scene::MeshId* meshes, const Scene::MaterialId* materials,
+               Scene& scene, TransformHierarchy& hierarchy);
+
+/**
+ * @brief Adds the objects of a scene file to a scene, without its
+ * hierarchy: the objects keep the transforms stored in the file and get no
+ * node. See loadScene() for the tables.
+ * @return The index of the first object, the others follow.
+ */
+uint32_t appendScene(const SceneFile& file, const Scene::MeshId* meshes, const Scene::MaterialId* materials,
+                     Scene& scene);
+
+} // namespace vks
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vks {
+
+/**
+ * @brief Non-owning view over SPIR-V words.
+ * Stands in for std::span<const uint32_t> while the project targets C++17.
+ * The generated shader arrays (e.g. SPHERE_VERT) convert to it implicitly, so
+ * shader code is never copied out of read-only data.
+ */
+class ShaderCode {
+public:
+    constexpr ShaderCode() = default;
+    constexpr ShaderCode(const uint32_t* words, size_t wordCount)
+        : m_words(words), m_wordCount(wordCount) {}
+
+    template <size_t N>
+    constexpr ShaderCode(const uint32_t (&words)[N]) : m_words(words), m_wordCount(N) {}
+
+    constexpr const uint32_t* data() const { return m_words; }
+    constexpr size_t size() const { return m_wordCount; }
+    constexpr size_t sizeBytes() const { return m_wordCount * sizeof(uint32_t); }
+    constexpr bool empty() const { return m_wordCount == 0; }
+
+    constexpr const uint32_t* begin() const { return m_words; }
+    constexpr const uint32_t* end() const { return m_words + m_wordCount; }
+
+private:
+    const uint32_t* m_words = nullptr;
+    size_t m_wordCount = 0;
+};
+
+} // namespace vks
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vks/ShaderCode.hpp>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vks {
+
+/**
+ * @brief A single descriptor binding as declared by a shader.
+ */
+struct ReflectedBinding {
+    uint32_t binding = 0;
+    VkDescriptorType descriptorType = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+    // 0 means an unbounded (runtime sized) array
+    uint32_t descriptorCount = 1;
+    VkShaderStageFlags stageFlags = 0;
+    // Size in bytes of a uniform/storage block (0 for images and samplers)
+    uint32_t blockSize = 0;
+    std::string name;
+};
+
+// Bindings of one descriptor set, keyed by binding number
+using ReflectedSet = std::map<uint32_t, ReflectedBinding>;
+
+/**
+ * @brief Minimal SPIR-V reflection.
+ * Walks a SPIR-V module and extracts the resource interface the pipeline
+ * layout must match: descriptor sets, binding types, stage flags and the
+ * push-constant range. Reflections of several stages can be merged to
+ * describe a whole pipeline.
+ */
+class ShaderReflection {
+public:
+    ShaderReflection() = default;
+
+    /**
+     * @brief Reflects a SPIR-V module.
+     * @param code The SPIR-V words (must start with the SPIR-V magic number).
+     * @param wordCount The number of 32-bit words in code.
+     */
+    ShaderReflection(const uint32_t* code, size_t wordCount);
+    explicit ShaderReflection(ShaderCode code) : ShaderReflection(code.data(), code.size()) {}
+
+    /**
+     * @brief Merges another stage into this reflection.
+     * Bindings declared by both stages get their stage flags combined and the
+     * push-constant ranges are unioned. Throws if the two stages declare the
+     * same binding with different types.
+     */
+    ShaderReflection& merge(const ShaderReflection& other);
+
+    VkShaderStageFlags stages() const { return m_stages; }
+
+    // Descriptor sets keyed by set index
+    const std::map<uint32_t, ReflectedSet>& sets() const { return m_sets; }
+
+    bool hasPushConstants() const { return m_pushConstants.size > 0; }
+    const VkPushConstantRange& pushConstantRange() const { return m_pushConstants; }
+
+private:
+    VkShaderStageFlags m_stages = 0;
+    std::map<uint32_t, ReflectedSet> m_sets;
+    VkPushConstantRange m_pushConstants{0, 0, 0};
+};
+
+} // namespace vks
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace vks {
+
+/**
+ * @brief Hands out integer slots (e.g. the elements of a descriptor array)
+ * from a free list.
+ * A freed slot may still be read by the frames in flight: it only returns
+ * to the free list after retireFrames calls to nextFrame(). Freed slots are
+ * reused before new ones, so the slots in use stay packed at the bottom.
+ */
+class SlotAllocator {
+public:
+    static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+    explicit SlotAllocator(uint32_t capacity = 0, uint32_t retireFrames = 0);
+
+    /**
+     * @return A free slot, or InvalidSlot when all of them are in use or
+     * retiring.
+     */
+    uint32_t allocate();
+
+    /**
+     * @brief Returns a slot obtained from allocate(), reusable after
+     * retireFrames calls to nextFrame().
+     */
+    void free(uint32_t slot);
+
+    /**
+     * @brief Called once per frame, after waiting for the oldest frame in
+     * flight.
+     */
+    void nextFrame();
+
+    uint32_t capacity() const { return m_capacity; }
+    uint32_t used() const { return m_used; } // Retiring slots included
+    uint32_t retiringCount() const { return static_cast<uint32_t>(m_retiring.size()); }
+
+private:
+    uint32_t m_capacity;
+    uint32_t m_retireFrames;
+    uint32_t m_used = 0;
+    uint32_t m_highWater = 0; // Slots above it were never allocated
+    uint64_t m_frame = 0;
+
+    std::vector<uint32_t> m_free;
+    std::deque<std::pair<uint64_t, uint32_t>> m_retiring; // (frame freed, slot), oldest first
+};
+
+} // namespace vks
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <vks/Mesh/Lod.hpp>
+
+namespace vks {
+
+/**
+ * @brief Loose uniform grid over bounding spheres, hashed so the world needs
+ * no fixed extent.
+ * Every sphere belongs to the cell of its center; queries reach out by the
+ * largest radius, which is what makes the grid loose. rebuild() is O(n) and
+ * parallel (a counting sort of the items by bucket), cheap enough to run
+ * every frame when most objects move, where a BVH's refit would degrade.
+ *
+ * The items are stored sorted by bucket, contiguous for the queries.
+ * Items are the indices of the spheres given to rebuild(), e.g. scene indices.
+ */
+class SpatialGrid {
+public:
+    /**
+     * @param cellSize Edge of a cell, about the diameter of a typical
+     * object: a large cell tests many spheres, a small one visits many cells.
+     */
+    void rebuild(const vks::mesh::BoundingSphere* spheres, uint32_t count, float cellSize);
+
+    /**
+     * @brief Appends the items whose sphere is at least partly inside a
+     * frustum, see transform::extractFrustumPlanes().
+     */
+    void queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Appends the items whose sphere overlaps a sphere.
+     */
+    void queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+    uint32_t size() const { return static_cast<uint32_t>(m_items.size()); }
+    bool empty() const { return m_items.empty(); }
+    float getCellSize() const { return m_cellSize; }
+
+private:
+    struct CellRange
+    {
+        glm::ivec3 min;
+        glm::ivec3 max; // Inclusive
+    };
+
+    glm::ivec3 cellOf(const glm::vec3& position) const;
+    // Items of the cells of a range; tested against the frustum unless inside
+    void appendCells(const CellRange& range, const glm::vec4* planes, std::vector<uint32_t>& out) const;
+
+    float m_cellSize = 1.0f;
+    float m_maxRadius = 0.0f;
+    CellRange m_occupied{}; // Cells holding at least one center
+    uint32_t m_bucketMask = 0;
+
+    // Bucket b holds [m_bucketStart[b], m_bucketStart[b + 1]) of the sorted items
+    std::vector<uint32_t> m_bucketStart;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_cursors; // Counts, then scatter positions
+    size_t m_cursorCount = 0;
+
+    std::vector<uint64_t> m_itemCells; // Cell key of each item, in item order
+
+    // Sorted by bucket
+    std::vector<uint32_t> m_items;
+    std::vector<glm::vec4> m_spheres; // Center and radius
+    std::vector<uint64_t> m_cells;    // Tells apart the cells sharing a bucket
+};
+
+} // namespace vks
@@ -33,6 +33,7 @@ public:
   inline const SwapChainSupportDetails &supportDetails() const {
     return m_supportDetails;
   }
+  inline VkImage image(uint32_t index) const { return m_images[index]; }
   inline VkImageView imageView(uint32_t index) const {
     return m_imageViews[index];
   }
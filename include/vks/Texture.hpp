@@ -0,0 +1,59 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace vks {
+
+class CommandPool;
+class Device;
+
+/**
+ * @brief A device-local 2D image with its view, ready to be sampled (e.g.
+ * added to the BindlessTable).
+ */
+class Texture : public NonCopyable {
+public:
+    /**
+     * @brief Creates the image and uploads its pixels through a staging
+     * buffer. Waits for the upload to complete.
+     * @param pixels width * height texels in the image format (RGBA8 by default).
+     */
+    Texture(const Device& device, const CommandPool& commandPool, uint32_t width, uint32_t height,
+            const void* pixels, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB);
+    ~Texture();
+
+    VkImage image() const { return m_image; }
+    VkImageView view() const { return m_view; }
+    uint32_t width() const { return m_width; }
+    uint32_t height() const { return m_height; }
+
+private:
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+    const Device& m_device;
+    uint32_t m_width;
+    uint32_t m_height;
+    VkImage m_image = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkImageView m_view = VK_NULL_HANDLE;
+};
+
+/**
+ * @brief A VkSampler, linear filtering by default.
+ */
+class Sampler : public NonCopyable {
+public:
+    explicit Sampler(const Device& device, VkFilter filter = VK_FILTER_LINEAR,
+                     VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT);
+    ~Sampler();
+
+    VkSampler handle() const { return m_sampler; }
+
+private:
+    const Device& m_device;
+    VkSampler m_sampler = VK_NULL_HANDLE;
+};
+
+} // namespace vks
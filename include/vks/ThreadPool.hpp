@@ -0,0 +1,67 @@
+#pragma once
+
+#include <NonCopyable.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vks {
+
+/**
+ * @brief A fixed set of worker threads running CPU jobs (geometry generation,
+ * asset processing, ...).
+ * parallelFor() is the main entry point: the calling thread takes part in the
+ * work and returns once every range is done, so it can be nested or called
+ * from a worker without deadlocking.
+ */
+class ThreadPool : public NonCopyable {
+public:
+    // Range callback: processes [begin, end)
+    using RangeFunc = std::function<void(size_t begin, size_t end)>;
+
+    /**
+     * @param threadCount Number of workers, 0 picks hardware_concurrency() - 1
+     * (the calling thread is the remaining one).
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    // Process-wide pool, created on first use
+    static ThreadPool& global();
+
+    size_t threadCount() const { return m_workers.size(); }
+
+    /**
+     * @brief Queues a job for the workers (runs inline when there are none).
+     */
+    void submit(std::function<void()> job);
+
+    /**
+     * @brief Splits [begin, end) in chunks of at least grainSize items and
+     * runs func over them on the workers and the calling thread.
+     * The first exception thrown by func is rethrown here.
+     */
+    void parallelFor(size_t begin, size_t end, size_t grainSize, const RangeFunc& func);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+/**
+ * @brief parallelFor() on the global pool.
+ */
+inline void parallelFor(size_t begin, size_t end, size_t grainSize, const ThreadPool::RangeFunc& func) {
+    ThreadPool::global().parallelFor(begin, end, grainSize, func);
+}
+
+} // namespace vks
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace vks {
+
+/**
+ * @brief Per-object transform block, matches the push constants of sphere.vert.
+ * The normal matrix is the inverse-transpose of the model's upper 3x3, stored
+ * as three vec4 columns (std430 layout of a GLSL mat3x4).
+ */
+struct ObjectTransform {
+    glm::mat4 model;
+    glm::mat3x4 normal;
+};
+
+static_assert(sizeof(ObjectTransform) == 112, "ObjectTransform must match the shader block");
+
+/**
+ * @brief Transform relative to a parent: scale, then rotation, then translation.
+ */
+struct LocalTransform {
+    glm::vec3 translation{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+};
+
+namespace transform {
+
+/**
+ * @brief Computes the transform blocks of a batch of objects.
+ * The normal matrices are built from the cofactors of each model matrix
+ * (three cross products and a reciprocal), using SSE when available.
+ * @param models The world matrices, contiguous.
+ * @param out The transform blocks to fill, same count as models.
+ * @param count The number of objects.
+ */
+void computeObjectTransforms(const glm::mat4* models, ObjectTransform* out, size_t count);
+
+/**
+ * @brief The matrix of a local transform (T * R * S).
+ */
+glm::mat4 compose(const LocalTransform& local);
+
+/**
+ * @brief out = a * b, using SSE when available. out may alias a or b.
+ */
+void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out);
+
+/**
+ * @brief Extracts the world space planes of a view frustum (Gribb-Hartmann),
+ * for the [0, 1] clip depth range: left, right, bottom, top, near, far.
+ * Normals point inside and are normalized, so dot(plane.xyz, p) + plane.w is
+ * the signed distance of p.
+ */
+void extractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+enum class FrustumOverlap
+{
+    Outside,
+    Intersects,
+    Inside,
+};
+
+/**
+ * @brief Where an axis aligned box is relative to frustum planes.
+ * Conservative: a box near a corner of the frustum can be reported as
+ * intersecting while it is outside.
+ */
+FrustumOverlap testBox(const glm::vec4 planes[6], const glm::vec3& min, const glm::vec3& max);
+
+} // namespace transform
+} // namespace vks
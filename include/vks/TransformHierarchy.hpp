@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <vks/Transform.hpp>
+
+namespace vks {
+
+/**
+ * @brief Scene graph of local transforms, producing world matrices.
+ * Nodes are stored breadth-first: every level of the tree is a contiguous
+ * range, after the levels above it. update() walks the levels in order and
+ * recomputes, in parallel within a level, the nodes whose local transform
+ * changed and everything below them; untouched subtrees keep their matrices.
+ *
+ * The world matrices form one contiguous array in that order (see
+ * worldMatrices() and indexOf()), ready to be gathered or uploaded.
+ *
+ * Nodes are referenced by NodeId, stable while the node exists. Creating a
+ * node under a parent shallower than the last level, or destroying one,
+ * re-sorts the arrays on the next update().
+ */
+class TransformHierarchy {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId NoNode = UINT32_MAX;
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    /**
+     * @throws std::runtime_error if parent is not a node of the hierarchy.
+     */
+    NodeId create(NodeId parent = NoNode, const LocalTransform& local = {});
+
+    /**
+     * @brief Replaces the hierarchy with count nodes given by index, as
+     * locals() and parents() return them: node i gets NodeId i. Copies the
+     * arrays, then one pass computes the levels.
+     * @param parents Index of each node's parent, lower than the node's own,
+     * InvalidIndex for roots.
+     * @throws std::runtime_error if a parent comes after its child.
+     */
+    void assign(const LocalTransform* locals, const uint32_t* parents, uint32_t count);
+
+    /**
+     * @brief Destroys a node and its whole subtree (O(n)).
+     */
+    void destroy(NodeId node);
+
+    bool contains(NodeId node) const { return node < m_indexOf.size() && m_indexOf[node] != InvalidIndex; }
+
+    // These throw std::runtime_error if node is not a node of the hierarchy
+    // (e.g. destroyed), like create() for its parent
+    void setLocal(NodeId node, const LocalTransform& local);
+    const LocalTransform& getLocal(NodeId node) const { return m_local[checkedIndex(node)]; }
+    NodeId getParent(NodeId node) const;
+
+    /**
+     * @brief Recomputes the world matrices of the dirty subtrees.
+     * @return The number of matrices recomputed.
+     */
+    size_t update();
+
+    // World matrix as of the last update()
+    const glm::mat4& world(NodeId node) const { return m_world[checkedIndex(node)]; }
+
+    /**
+     * @return The position of a node in worldMatrices(), valid until the
+     * next create() or destroy().
+     */
+    uint32_t indexOf(NodeId node) const { return contains(node) ? m_indexOf[node] : InvalidIndex; }
+
+    const glm::mat4* worldMatrices() const { return m_world.data(); }
+    // By index like worldMatrices(), parents before their children
+    const LocalTransform* locals() const { return m_local.data(); }
+    const uint32_t* parents() const { return m_parent.data(); }
+    uint32_t size() const { return static_cast<uint32_t>(m_world.size()); }
+    uint32_t levelCount() const;
+
+private:
+    // indexOf(), throwing for the nodes not in the hierarchy
+    uint32_t checkedIndex(NodeId node) const;
+
+    // Stable sort by depth, so every level is contiguous again
+    void sortLevels();
+
+    // Per node, breadth-first. A parent always comes before its children.
+    std::vector<LocalTransform> m_local;
+    std::vector<glm::mat4> m_world;
+    std::vector<uint32_t> m_parent; // Index, InvalidIndex for roots
+    std::vector<uint32_t> m_depth;
+    std::vector<uint8_t> m_dirty;   // Bytes, written concurrently by update()
+    std::vector<NodeId> m_ids;
+
+    // Level i spans [m_levelStart[i], m_levelStart[i + 1])
+    std::vector<uint32_t> m_levelStart;
+
+    std::vector<uint32_t> m_indexOf; // By NodeId
+    std::vector<NodeId> m_freeIds;
+
+    bool m_unsorted = false;
+    bool m_anyDirty = false;
+};
+
+} // namespace vks
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/Scene.hpp>
+#include <vks/SceneFile.hpp>
+
+namespace vks {
+
+/**
+ * @brief Streams a world too large for memory, cut into square cells on
+ * disk, in and out of a Scene around the camera.
+ * A world is a directory of cell files, "cell_<x>_<y>.vksscene" (see
+ * writeWorldPartition()), cell (x, y) covering [x, x + 1) * cellSize by
+ * [y, y + 1) * cellSize of the ground plane (world x and y). Their mesh
+ * names are .vksmesh files relative to the directory, their material names
+ * are resolved by the owner.
+ *
+ * update(), called once per frame on the main thread, never waits for I/O:
+ * cells closer than loadRadius are mapped and paged in by jobs on the global
+ * ThreadPool, then the mesh files they need; meshes are uploaded through
+ * Callbacks::uploadMesh up to uploadBudget bytes per update; a cell's objects
+ * join the scene once all its meshes are uploaded. Cells farther than
+ * unloadRadius leave the scene, and the meshes no cell uses are released.
+ *
+ * Cells between the two radii stay, so a camera moving back and forth
+ * across a cell border doesn't reload them, unless the memory budgets need
+ * room: those cells are evicted farthest first. Loads wait when nothing can
+ * be evicted.
+ */
+class WorldPartition {
+public:
+    struct Settings
+    {
+        float cellSize = 64.0f;
+        float loadRadius = 128.0f;
+        float unloadRadius = 192.0f;          // Beyond loadRadius
+        size_t cpuBudget = size_t(256) << 20; // Cell and mesh files in memory
+        size_t gpuBudget = size_t(256) << 20; // Uploaded geometry
+        size_t uploadBudget = size_t(16) << 20; // Per update, at least one mesh
+        uint32_t maxLoadsInFlight = 4;        // Cell files being read
+    };
+
+    struct Callbacks
+    {
+        // Uploads a mesh for the scene, returns its Scene::MeshId
+        std::function<Scene::MeshId(const std::string& name, const mesh::MeshData& mesh)> uploadMesh;
+        // No cell uses an uploaded mesh anymore. The GPU may still be drawing
+        // it this frame.
+        std::function<void(const std::string& name, Scene::MeshId mesh)> releaseMesh;
+        std::function<Scene::MaterialId(const std::string& name)> resolveMaterial;
+    };
+
+    struct Stats
+    {
+        uint32_t cellCount = 0;     // On disk
+        uint32_t residentCells = 0; // Objects in the scene
+        uint32_t loadingCells = 0;  // Reading files or waiting for uploads
+        uint32_t meshCount = 0;     // Uploaded
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+    };
+
+    /**
+     * @brief Lists the cells of a world directory, no file is read yet.
+     * @throws std::runtime_error if the directory cannot be listed.
+     */
+    WorldPartition(const std::string& directory, const Settings& settings, Callbacks callbacks);
+
+    /**
+     * @brief Waits for the jobs in flight.
+     */
+    ~WorldPartition();
+
+    WorldPartition(const WorldPartition&) = delete;
+    WorldPartition& operator=(const WorldPartition&) = delete;
+
+    /**
+     * @brief Streams the cells around a camera position, and reports failed
+     * loads on std::cerr.
+     * @return true if objects were added to or removed from the scene.
+     */
+    bool update(const glm::vec3& camera, Scene& scene);
+
+    /**
+     * @brief Removes every cell from the scene and releases their meshes.
+     */
+    void unloadAll(Scene& scene);
+
+    const Settings& getSettings() const { return m_settings; }
+    Stats getStats() const;
+
+private:
+    enum class CellState
+    {
+        Unloaded,
+        Loading,  // Cell file job in flight
+        Waiting,  // Mapped, waiting for its meshes
+        Resident, // Objects in the scene
+        Failed,   // Not retried
+    };
+
+    enum class MeshState
+    {
+        Loading,  // Mesh file job in flight
+        Ready,    // Mapped, waiting for its upload
+        Uploaded,
+        Failed,
+    };
+
+    struct MeshEntry
+    {
+        std::string name;
+        MeshState state = MeshState::Loading;
+        uint32_t refs = 0; // Waiting and resident cells using it
+        std::unique_ptr<mesh::MeshFile> file;
+        Scene::MeshId id = Scene::NoMesh;
+        size_t fileBytes = 0;
+        size_t gpuBytes = 0;
+    };
+
+    struct Cell
+    {
+        glm::ivec2 coord;
+        std::string path;
+        size_t bytes = 0; // File size, about what its objects take in the scene
+        CellState state = CellState::Unloaded;
+        std::unique_ptr<SceneFile> file;   // While waiting
+        std::vector<MeshEntry*> meshes;    // Of the file's mesh table
+        std::vector<SceneHandle> objects;  // While resident
+    };
+
+    // Results handed over by the jobs
+    struct State;
+
+    float distanceTo(const Cell& cell) const;
+    void collectResults();
+    void requestMeshes(Cell& cell);
+    void releaseMesh(MeshEntry* entry);
+    void evict(Cell& cell, Scene& scene);
+    // Evicts cells beyond loadRadius, farthest first, until bytes more fit
+    bool makeRoom(size_t bytes, bool gpu, Scene& scene);
+    void uploadMeshes(Scene& scene);
+    bool instantiate(Cell& cell, Scene& scene);
+
+    std::string m_directory;
+    Settings m_settings;
+    Callbacks m_callbacks;
+    std::shared_ptr<State> m_state;
+
+    std::vector<Cell> m_cells;
+    std::map<std::string, MeshEntry> m_meshes; // By name, entries never move
+    std::deque<std::string> m_uploads;         // Ready meshes, in arrival order
+    glm::vec2 m_camera{0.0f};
+    uint32_t m_loadsInFlight = 0;
+    size_t m_cpuBytes = 0;
+    size_t m_gpuBytes = 0;
+};
+
+/**
+ * @brief Writes the objects of a scene as the cells of a world, with their
+ * world transforms and no hierarchy. Each cell's tables only name the meshes
+ * and materials its objects use.
+ * @param meshNames Mesh file of each Scene::MeshId, relative to the directory.
+ * @param materialNames Name of each Scene::MaterialId.
+ * @return The number of cells written.
+ */
+uint32_t writeWorldPartition(const std::string& directory, float cellSize, const Scene& scene,
+                             const std::vector<std::string>& meshNames,
+                             const std::vector<std::string>& materialNames);
+
+} // namespace vks
@@ -11,7 +11,10 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
 #include <chrono>
+#include <filesystem>
+#include <random>
 
 using namespace vks;
 
@@ -20,6 +23,26 @@ const uint32_t HEIGHT = 600;
 
 const int MAX_FRAMES_IN_FLIGHT = 2;
 
+// Spheres scattered around the origin to exercise the LODs
+const uint32_t SCATTERED_OBJECTS = 2000;
+const float SCATTER_RADIUS = 80.0f;
+// About the diameter of the scattered objects
+const float GRID_CELL_SIZE = 4.0f;
+
+// Torus LODs cooked offline (streamed in after startup), simplified at
+// startup when missing:
+//   vks-cook -o assets/cooked --format float --overdraw torus:96x48
+const char* COOKED_TORUS = "assets/cooked/torus.vksmesh";
+
+// Generated meshes kept across runs (see vks::GeometryCache)
+const char* GEOMETRY_CACHE = "assets/cache";
+
+// Loaded instead of building the scene when present, written by "Save scene"
+const char* SCENE_FILE = "assets/scene.vksscene";
+
+// Streamed around the camera when present (see vks::writeWorldPartition())
+const char* WORLD_DIRECTORY = "assets/world";
+
 vks::Application::Application()
     : instance("Hello Triangle", "No Engine", true),
       debugMessenger(instance),
@@ -42,50 +65,73 @@ vks::Application::Application()
     // Now that all core systems are up, load assets
     loadAssets();
     buildScene();
+    if (std::filesystem::is_directory(WORLD_DIRECTORY)) {
+        createWorld();
+    }
 }
 
 /**
  * @brief Creates all asset registries (pools, models, materials).
  */
 void Application::loadAssets() {
-    // 1. Create Global Descriptor Pool
-    m_globalDescriptorPool = vks::DescriptorPool::Builder(device)
-        .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100) // For camera + materials
-        .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100) // For textures
-        .setMaxSets(200)
-        .build();
+    // 1. Create the per-frame descriptor allocators
+    // Their sets live for one frame, all returned once its fence is signaled
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        m_frameDescriptors.push_back(std::make_unique<vks::DescriptorAllocator>(device));
+    }
 
     // 2. Create the Camera UBO Buffer
+    // One slice per frame in flight, so a frame never overwrites the camera
+    // the previous one still reads
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device.physical(), &properties);
+    VkDeviceSize alignment = std::max<VkDeviceSize>(1, properties.limits.minUniformBufferOffsetAlignment);
+    m_cameraUboStride = (sizeof(CameraUBO) + alignment - 1) / alignment * alignment;
     m_cameraUboBuffer = std::make_unique<vks::Buffer>(
         device,
-        sizeof(CameraUBO),
+        m_cameraUboStride * MAX_FRAMES_IN_FLIGHT,
         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     );
     // Map it persistently. We can write to it at any time.
     m_cameraUboBuffer->map();
 
-    // 3. Create the Camera Descriptor Set (Set 0)
-    // (This was the other fix: we create the set that points to the buffer)
-    {
-        auto globalSetLayout = graphicsPipeline.getDescriptorSetLayout("global");
-        auto bufferInfo = m_cameraUboBuffer->descriptorInfo();
-        vks::DescriptorWriter(globalSetLayout, m_globalDescriptorPool)
-            .writeBuffer(0, &bufferInfo)
-            .build(m_cameraDescriptorSet); // m_cameraDescriptorSet is now valid!
-    }
+    // 3. The Camera Descriptor Set (Set 0) points to the frame's slice, it
+    // is allocated every frame by updateUBOs()
 
     // 4. Create Models
-    // This calls Model::createSphere, which uses your sphere generation code
-    // and uploads it to the GPU.
-    m_models["sphere"].createSphere(device, commandPool.handle(), 1.0f, 32, 16);
-
-    // 5. Create Materials
+    // All models sub-allocate their geometry from the shared arena
+    m_geometryArena = std::make_unique<vks::GeometryArena>(device, commandPool);
+    // Identical geometry is uploaded once, whatever the model's name
+    m_geometryCache = std::make_unique<vks::GeometryCache>(device, commandPool, GEOMETRY_CACHE);
+    m_modelLoader = std::make_unique<vks::ModelLoader>(device, commandPool, m_geometryCache.get());
+    m_cookedTorus = static_cast<bool>(std::ifstream(COOKED_TORUS));
+    if (m_cookedTorus) {
+        // The tori are skipped until the loader uploads the file
+        m_models.emplace("torus", vks::Model());
+        m_modelLoader->load(COOKED_TORUS, "torus");
+    }
+    createGeneratedModels();
+
+    // 5. Create the bindless textures
+    // A removed element may be read until the frames in flight are done
+    m_bindless = std::make_unique<vks::BindlessTable>(device, graphicsPipeline.getBindlessSetLayout(),
+                                                      MAX_FRAMES_IN_FLIGHT + 1);
+    m_sampler = std::make_unique<vks::Sampler>(device);
+    m_bindless->addSampler(m_sampler->handle());
+    const uint32_t white = 0xffffffff;
+    m_whiteTexture = std::make_unique<vks::Texture>(device, commandPool, 1, 1, &white);
+    m_bindless->addImage(m_whiteTexture->view());
+    createCheckerTexture(m_checkerColor);
+
+    // 6. Create Materials
+    // Their parameters share one storage buffer per swapchain image
+    m_materialBuffer = std::make_unique<vks::MaterialBuffer>(device, graphicsPipeline, "sphere",
+                                                             swapChain.numImages());
     m_materials.emplace("red_sphere",
         vks::Material{
-            device,
+            m_materialBuffer->table(),
             graphicsPipeline,
-            m_globalDescriptorPool,
             "sphere", // The name of the pipeline to use
             {1.0f, 0.0f, 0.0f, 1.0f} // Red
         }
@@ -93,35 +139,211 @@ void Application::loadAssets() {
 
     m_materials.emplace("blue_sphere",
         vks::Material{
-            device,
+            m_materialBuffer->table(),
             graphicsPipeline,
-            m_globalDescriptorPool,
-            "sphere", // Same pipeline
-            {0.0f, 0.2f, 0.8f, 1.0f} // Blue
+            "sphere", // Same pipeline, specialized variant
+            {0.0f, 0.2f, 0.8f, 1.0f}, // Blue
+            MaterialFeatureSpecular
         }
     );
 }
 
+void Application::createCheckerTexture(const glm::vec4& color) {
+    const uint32_t size = 64;
+    const uint32_t squareSize = 8;
+    // RGBA8, red in the low byte
+    glm::uvec4 channels = glm::uvec4(glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t dark = channels.r | (channels.g << 8) | (channels.b << 16) | (channels.a << 24);
+    std::vector<uint32_t> pixels(size * size);
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            bool odd = ((x / squareSize) + (y / squareSize)) % 2;
+            pixels[y * size + x] = odd ? dark : 0xffffffff;
+        }
+    }
+
+    // Written right away, while the frames in flight read the other elements
+    auto texture = std::make_unique<vks::Texture>(device, commandPool, size, size, pixels.data());
+    uint32_t image = m_bindless->addImage(texture->view());
+
+    uint32_t previous = m_checkerImage;
+    if (previous != vks::SlotAllocator::InvalidSlot) {
+        for (auto& pair : m_materials) {
+            MaterialParams params = pair.second.getParams();
+            if (params.baseColorTexture == previous) {
+                params.baseColorTexture = image;
+                pair.second.setParams(params);
+            }
+        }
+        m_bindless->removeImage(previous);
+        m_retiredTextures.emplace_back(m_frameNumber, std::move(m_checkerTexture));
+    }
+    m_checkerTexture = std::move(texture);
+    m_checkerImage = image;
+}
+
 /**
- * @brief Populates the m_renderObjects list.
+ * @brief Populates the scene, from SCENE_FILE when there is one.
  */
 void Application::buildScene() {
-    // Create a red sphere at (0, 0, 0)
-    RenderObject redSphere;
-    redSphere.model = &m_models.at("sphere"); // Use .at() to avoid default constructor
-    redSphere.material = &m_materials.at("red_sphere");
-    redSphere.transform = glm::translate(glm::mat4(1.0f), {0.0f, 0.0f, 0.0f});
-    m_renderObjects.push_back(redSphere);
-
-    // Create a blue sphere at (2, 0, 0)
-    RenderObject blueSphere;
-    blueSphere.model = &m_models.at("sphere");
-    blueSphere.material = &m_materials.at("blue_sphere");
-    blueSphere.transform = glm::translate(glm::mat4(1.0f), {2.0f, 0.0f, 0.0f});
-    m_renderObjects.push_back(blueSphere);
+    if (std::ifstream(SCENE_FILE)) {
+        loadSceneFile(SCENE_FILE);
+        updateVariants();
+        return;
+    }
+
+    Scene::MeshId sphere = getMeshId("sphere");
+    Scene::MeshId torus = getMeshId("torus");
+    Scene::MaterialId red = getMaterialId("red_sphere");
+    Scene::MaterialId blue = getMaterialId("blue_sphere");
+    m_scene.reserve(2 + SCATTERED_OBJECTS);
+
+    // Every object follows a node of the hierarchy, whose world matrix
+    // updateObjectTransforms() copies into the scene
+    auto createObject = [this](TransformHierarchy::NodeId parent, const LocalTransform& local,
+                               Scene::MeshId mesh, Scene::MaterialId material)
+    {
+        TransformHierarchy::NodeId node = m_hierarchy.create(parent, local);
+        m_scene.create(glm::mat4(1.0f), mesh, material, 0, node);
+        return node;
+    };
+
+    // A red sphere at (0, 0, 0) and a blue one at (2, 0, 0)
+    m_redSphereNode = createObject(TransformHierarchy::NoNode, {}, sphere, red);
+    LocalTransform blueSphere;
+    blueSphere.translation = {2.0f, 0.0f, 0.0f};
+    createObject(TransformHierarchy::NoNode, blueSphere, sphere, blue);
+
+    // A field of spheres (and a few tori) on the ground plane, under one
+    // node so it can be moved as a whole
+    m_fieldNode = m_hierarchy.create();
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (uint32_t i = 0; i < SCATTERED_OBJECTS; ++i) {
+        float angle = unit(random) * 2.0f * glm::pi<float>();
+        float distance = 4.0f + std::sqrt(unit(random)) * SCATTER_RADIUS;
+        float scale = 0.3f + 0.7f * unit(random);
+
+        LocalTransform local;
+        local.translation = {distance * std::cos(angle), distance * std::sin(angle), 0.0f};
+        local.scale = glm::vec3(scale);
+        createObject(m_fieldNode, local, i % 8 == 0 ? torus : sphere, i % 2 ? red : blue);
+    }
+
+    updateVariants();
 }
 
-void Application::updateUBOs(uint32_t currentImage) {
+void Application::loadSceneFile(const std::string& path) {
+    vks::SceneFile file(path);
+    std::vector<Scene::MeshId> meshes;
+    for (uint32_t i = 0; i < file.meshCount(); ++i) {
+        meshes.push_back(getMeshId(std::string(file.meshName(i))));
+    }
+    std::vector<Scene::MaterialId> materials;
+    for (uint32_t i = 0; i < file.materialCount(); ++i) {
+        materials.push_back(getMaterialId(std::string(file.materialName(i))));
+    }
+    vks::loadScene(file, meshes.data(), materials.data(), m_scene, m_hierarchy);
+
+    // The file doesn't say which nodes to animate
+    m_redSphereNode = TransformHierarchy::NoNode;
+    m_fieldNode = TransformHierarchy::NoNode;
+}
+
+void Application::saveSceneFile(const std::string& path) const {
+    // Registry names of the scene IDs
+    std::vector<std::string> meshNames;
+    for (const vks::Model* model : m_sceneMeshes) {
+        for (const auto& pair : m_models) {
+            if (&pair.second == model) {
+                meshNames.push_back(pair.first);
+            }
+        }
+    }
+    std::vector<std::string> materialNames;
+    for (const vks::Material* material : m_sceneMaterials) {
+        for (const auto& pair : m_materials) {
+            if (&pair.second == material) {
+                materialNames.push_back(pair.first);
+            }
+        }
+    }
+    vks::writeSceneFile(path, m_scene, m_hierarchy, meshNames, materialNames);
+}
+
+void Application::createWorld() {
+    vks::WorldPartition::Callbacks callbacks;
+    callbacks.uploadMesh = [this](const std::string& name, const vks::mesh::MeshData& mesh) {
+        std::string model = "world/" + name;
+        m_models[model].loadMesh(device, commandPool.handle(), mesh);
+        return getMeshId(model);
+    };
+    callbacks.releaseMesh = [this](const std::string& name, Scene::MeshId) {
+        // The frames in flight may still draw it, the entry stays for its ID
+        vks::Model& model = m_models.at("world/" + name);
+        m_retiredModels.emplace_back(m_frameNumber, std::move(model));
+        model = vks::Model();
+    };
+    callbacks.resolveMaterial = [this](const std::string& name) {
+        return getMaterialId(m_materials.count(name) ? name : m_materials.begin()->first);
+    };
+    m_world = std::make_unique<vks::WorldPartition>(WORLD_DIRECTORY, vks::WorldPartition::Settings{},
+                                                    std::move(callbacks));
+}
+
+Scene::MeshId Application::getMeshId(const std::string& name) {
+    vks::Model* model = &m_models.at(name);
+    auto it = std::find(m_sceneMeshes.begin(), m_sceneMeshes.end(), model);
+    if (it != m_sceneMeshes.end()) {
+        return static_cast<Scene::MeshId>(it - m_sceneMeshes.begin());
+    }
+    m_sceneMeshes.push_back(model);
+    return static_cast<Scene::MeshId>(m_sceneMeshes.size() - 1);
+}
+
+Scene::MaterialId Application::getMaterialId(const std::string& name) {
+    vks::Material* material = &m_materials.at(name);
+    auto it = std::find(m_sceneMaterials.begin(), m_sceneMaterials.end(), material);
+    if (it != m_sceneMaterials.end()) {
+        return static_cast<Scene::MaterialId>(it - m_sceneMaterials.begin());
+    }
+    m_sceneMaterials.push_back(material);
+    return static_cast<Scene::MaterialId>(m_sceneMaterials.size() - 1);
+}
+
+void Application::createGeneratedModels() {
+    // The sphere LODs come from the generator (128x64 down to 8x4),
+    // the torus LODs from the quadric simplifier.
+    // Spheres use 16-byte quantized vertices, tori the 32-byte float layout
+    // (which can overdraw itself, so its triangle clusters are sorted too).
+    // Generated meshes are split into meshlets for the cluster culling pass.
+    using vks::geometry::VertexFormat;
+    VertexFormat compact = m_splitStreams ? VertexFormat::SplitCompact : VertexFormat::Compact;
+    VertexFormat full = m_splitStreams ? VertexFormat::SplitFloat : VertexFormat::Float;
+
+    m_models["sphere"] = m_geometryCache->sphereLods(1.0f, 128, 64, 5, compact,
+                                                     vks::ModelOptimizeDefault | vks::ModelOptimizeMeshlets);
+    if (!m_cookedTorus) {
+        m_models["torus"] = m_geometryCache->torusLods(0.7f, 0.3f, 96, 48, 5, full,
+                                                       vks::ModelOptimizeDefault | vks::ModelOptimizeOverdraw |
+                                                       vks::ModelOptimizeMeshlets);
+    }
+}
+
+void Application::updateVariants() {
+    for (uint32_t i = 0; i < m_scene.size(); ++i) {
+        const vks::Material& material = getSceneMaterial(m_scene.materials()[i]);
+        const vks::Model* model = getSceneMesh(m_scene.meshes()[i]);
+        uint32_t features = material.getFeatures();
+        if (model != nullptr) {
+            features |= model->getVariantFeatures();
+            m_scene.depthVariants()[i] = graphicsPipeline.requestVariant("depth", model->getVariantFeatures());
+        }
+        m_scene.variants()[i] = graphicsPipeline.requestVariant(material.getPipelineName(), features);
+    }
+}
+
+void Application::updateUBOs(uint32_t frameIndex) {
     // --- Update Camera UBO ---
     static auto startTime = std::chrono::high_resolution_clock::now();
     auto currentTime = std::chrono::high_resolution_clock::now();
@@ -132,11 +354,14 @@ void Application::updateUBOs(uint32_t currentImage) {
     // --- CAMERA FIX ---
     // Let's pull the camera back to (5, 5, 5) to get a wider view
     // and keep the Up vector as (0, 0, 1) (Z-up)
+    glm::vec3 pan(m_cameraPan, 0.0f);
+    glm::vec3 eye = glm::vec3(5.0f, 5.0f, 5.0f) + pan; // <-- Pulled camera back
     ubo.view = glm::lookAt(
-        glm::vec3(5.0f, 5.0f, 5.0f), // <-- Pulled camera back
-        glm::vec3(0.0f, 0.0f, 0.0f), // <-- Looking at the origin
-        glm::vec3(0.0f, 0.0f, 1.0f)  // <-- Z-up
+        eye,
+        glm::vec3(0.0f, 0.0f, 0.0f) + pan, // <-- Looking at the origin
+        glm::vec3(0.0f, 0.0f, 1.0f)        // <-- Z-up
     );
+    ubo.eye = glm::vec4(eye, 1.0f);
 
     ubo.proj = glm::perspective(
         glm::radians(45.0f),
@@ -148,15 +373,159 @@ void Application::updateUBOs(uint32_t currentImage) {
     // Flip Y for Vulkan
     ubo.proj[1][1] *= -1;
 
-    // Write to the mapped buffer
-    m_cameraUboBuffer->writeToBuffer(&ubo, sizeof(ubo));
+    // Write to the frame's slice of the mapped buffer
+    VkDeviceSize offset = m_cameraUboStride * frameIndex;
+    m_cameraUboBuffer->writeToBuffer(&ubo, sizeof(ubo), offset);
+    m_camera = ubo;
+
+    // A bump allocation from the frame's descriptors, reset by drawFrame()
+    auto globalSetLayout = graphicsPipeline.getDescriptorSetLayout("sphere", GraphicsPipeline::GlobalSet);
+    auto bufferInfo = m_cameraUboBuffer->descriptorInfo(sizeof(CameraUBO), offset);
+    vks::DescriptorWriter(globalSetLayout, *m_frameDescriptors[frameIndex])
+        .writeBuffer(0, &bufferInfo)
+        .build(m_cameraDescriptorSet);
+
+    // Cells stream in and out around the eye, never waiting for the disk
+    if (m_world && m_world->update(eye, m_scene)) {
+        m_sceneChanged = true;
+        updateVariants();
+    }
 
-    // Let's make the red sphere orbit
-    // get current transform
-    m_renderObjects[0].transform = glm::rotate(glm::mat4(1.0f), 1000 * time * glm::radians(45.0f), {0.0f, 0.0f, 1.0f});
+    // Let's make the red sphere orbit, the blue one stays where it was created
+    LocalTransform redSphere;
+    redSphere.rotation = glm::angleAxis(1000 * time * glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    if (m_redSphereNode != TransformHierarchy::NoNode) {
+        m_hierarchy.setLocal(m_redSphereNode, redSphere);
+    }
 
-    // Keep the blue sphere static
-    m_renderObjects[1].transform = glm::translate(glm::mat4(1.0f), {2.0f, 0.0f, 0.0f});
+    // Spinning the field moves every scattered object
+    if (m_spinField && m_fieldNode != TransformHierarchy::NoNode) {
+        LocalTransform field;
+        field.rotation = glm::angleAxis(time * glm::radians(10.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        m_hierarchy.setLocal(m_fieldNode, field);
+    }
+
+    updateObjectTransforms();
+    updateVisibility(ubo);
+    updateLods(ubo);
+}
+
+void Application::updateLods(const CameraUBO& camera) {
+    glm::vec3 cameraPosition = glm::vec3(camera.eye);
+    // Pixels covered by one unit at distance 1
+    float projectionScale = std::abs(camera.proj[1][1]) * 0.5f * static_cast<float>(swapChain.extent().height);
+
+    m_trianglesDrawn = 0;
+    m_trianglesFull = 0;
+
+    const vks::mesh::BoundingSphere* bounds = m_scene.bounds();
+    const Scene::MeshId* meshes = m_scene.meshes();
+    uint32_t* lods = m_scene.lods();
+    for (uint32_t i = 0; i < m_scene.size(); ++i) {
+        const vks::Model* model = getSceneMesh(meshes[i]);
+        if (model == nullptr || !model->isResident()) {
+            continue;
+        }
+
+        const std::vector<vks::mesh::MeshLod>& modelLods = model->getLods();
+        if (m_lodEnabled) {
+            float radius = vks::mesh::projectedRadius(bounds[i].radius, glm::length(bounds[i].center - cameraPosition),
+                                                      projectionScale);
+            lods[i] = vks::mesh::selectLod(modelLods.data(), model->getLodCount(), radius, lods[i],
+                                           m_lodThreshold, m_lodHysteresis);
+        } else {
+            lods[i] = 0;
+        }
+
+        m_trianglesDrawn += modelLods[lods[i]].indexCount / 3;
+        m_trianglesFull += modelLods[0].indexCount / 3;
+    }
+}
+
+void Application::updateObjectTransforms() {
+    // Only the subtrees under a changed node are recomputed
+    m_transformsUpdated = m_hierarchy.update();
+    const TransformHierarchy::NodeId* nodes = m_scene.nodes();
+    for (uint32_t i = 0; i < m_scene.size(); ++i) {
+        if (nodes[i] != TransformHierarchy::NoNode) {
+            m_scene.transforms()[i] = m_hierarchy.world(nodes[i]);
+        }
+    }
+
+    m_modelMatrices.resize(m_scene.size());
+    m_objectTransforms.resize(m_scene.size());
+
+    const glm::mat4* transforms = m_scene.transforms();
+    const Scene::MeshId* meshes = m_scene.meshes();
+    vks::mesh::BoundingSphere* bounds = m_scene.bounds();
+    for (uint32_t i = 0; i < m_scene.size(); ++i) {
+        const glm::mat4& m = transforms[i];
+        const vks::Model* model = getSceneMesh(meshes[i]);
+        if (model == nullptr) {
+            m_modelMatrices[i] = m;
+            continue;
+        }
+
+        // Quantized positions are dequantized by the model matrix. The scale
+        // is uniform, so the normal matrix only changes by a length the
+        // shaders normalize away.
+        m_modelMatrices[i] = model->isQuantized() ? m * model->getDequantization() : m;
+
+        // World bounds for the LOD selection and the BVH, from the float space bounds
+        const vks::mesh::BoundingSphere& local = model->getBounds();
+        float scale = std::max({glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])),
+                                glm::length(glm::vec3(m[2]))});
+        bounds[i].center = glm::vec3(m * glm::vec4(local.center, 1.0f));
+        bounds[i].radius = local.radius * scale;
+    }
+
+    // One batched pass for the normal matrices instead of an inverse() per vertex
+    transform::computeObjectTransforms(m_modelMatrices.data(), m_objectTransforms.data(),
+                                       m_modelMatrices.size());
+
+    // Rebuilt when objects come and go, refit otherwise: cheaper than
+    // tracking which bounds moved (animations, models streaming in)
+    if (m_sceneChanged || m_bvh.size() != m_scene.size()) {
+        m_bvh.build(bounds, m_scene.size());
+        m_sceneChanged = false;
+    } else {
+        m_bvh.refit(bounds);
+    }
+    // The grid has no tree to degrade, it is rebuilt from scratch
+    if (m_gridCulling) {
+        m_grid.rebuild(bounds, m_scene.size(), GRID_CELL_SIZE);
+    }
+}
+
+void Application::updateVisibility(const CameraUBO& camera) {
+    if (!m_frustumCulling) {
+        m_objectVisible.assign(m_scene.size(), 1);
+        return;
+    }
+
+    glm::vec4 planes[6];
+    transform::extractFrustumPlanes(camera.proj * camera.view, planes);
+    m_visibleObjects.clear();
+    if (m_gridCulling) {
+        m_grid.queryFrustum(planes, m_visibleObjects);
+    } else {
+        m_bvh.queryFrustum(planes, m_visibleObjects);
+    }
+
+    m_objectVisible.assign(m_scene.size(), 0);
+    for (uint32_t i : m_visibleObjects) {
+        m_objectVisible[i] = 1;
+    }
+}
+
+void Application::pickObject(float x, float y) {
+    // Through the camera and the point on the far plane
+    glm::vec3 origin = glm::vec3(m_camera.eye);
+    glm::vec4 target = glm::inverse(m_camera.proj * m_camera.view) * glm::vec4(x, y, 1.0f, 1.0f);
+    glm::vec3 direction = glm::vec3(target) / target.w - origin;
+
+    Bvh::Hit hit = m_bvh.raycast(origin, direction);
+    m_pickedObject = hit.item == Bvh::InvalidIndex ? SceneHandle{} : m_scene.handleAt(hit.item);
 }
 
 void Application::run() {
@@ -178,6 +547,21 @@ void Application::drawFrame(bool &framebufferResized) {
   vkWaitForFences(device.logical(), 1, &syncObjects.inFlightFence(currentFrame),
                     VK_TRUE, UINT64_MAX);
 
+  // The frames that could draw the models released before are done now
+  ++m_frameNumber;
+  m_retiredModels.erase(std::remove_if(m_retiredModels.begin(), m_retiredModels.end(),
+                                       [this](const std::pair<uint64_t, vks::Model>& retired) {
+                                         return retired.first + MAX_FRAMES_IN_FLIGHT < m_frameNumber;
+                                       }),
+                        m_retiredModels.end());
+  m_retiredTextures.erase(std::remove_if(m_retiredTextures.begin(), m_retiredTextures.end(),
+                                         [this](const std::pair<uint64_t, std::unique_ptr<vks::Texture>>& retired) {
+                                           return retired.first + MAX_FRAMES_IN_FLIGHT < m_frameNumber;
+                                         }),
+                          m_retiredTextures.end());
+  m_bindless->nextFrame();
+  m_frameDescriptors[currentFrame]->reset(); // The sets of this frame's previous use
+
   uint32_t imageIndex;
   VkResult result = vkAcquireNextImageKHR(
       device.logical(), swapChain.handle(), UINT64_MAX,
@@ -190,6 +574,12 @@ void Application::drawFrame(bool &framebufferResized) {
     throw std::runtime_error("Failed to acquire swapchain image");
   }
 
+  // Upload the models streamed in since the last frame (their vertex
+  // format decides the pipeline variant)
+  if (m_modelLoader->update(m_models) > 0) {
+    updateVariants();
+  }
+
   // Update all UBOs with fresh data for this frame
   // *before* we record the command buffer.
   updateUBOs(currentFrame);
@@ -201,6 +591,9 @@ void Application::drawFrame(bool &framebufferResized) {
   syncObjects.imageInFlight(imageIndex) =
       syncObjects.inFlightFence(currentFrame);
 
+  // The material edits this image's previous frame didn't see
+  m_materialBuffer->upload(imageIndex);
+
   // --- Record the command buffers ---
   // (This will now read the UBO data we just wrote)
   commandBuffers.recordCommands(imageIndex); // Your BasicCommandBuffers
@@ -270,6 +663,104 @@ void Application::drawImGui() {
 
 // --- NEW MATERIAL EDITOR ---
     ImGui::Begin("Material Editor");
+    ImGui::Text("Pipeline variants: %zu", graphicsPipeline.variantCount());
+
+    // GPU timestamp comparison of the normal matrix paths
+    if (commandBuffers.timer().supported()) {
+        ImGui::Text("Scene GPU time: %.3f ms", commandBuffers.timer().averageMilliseconds());
+    } else {
+        ImGui::TextDisabled("Scene GPU time: timestamps not supported");
+    }
+
+    // Level of detail
+    ImGui::Checkbox("LOD", &m_lodEnabled);
+    ImGui::SliderFloat("LOD max error (px)", &m_lodThreshold, 0.25f, 8.0f);
+    ImGui::Text("Triangles: %llu of %llu (%.1f%% saved)", (unsigned long long) m_trianglesDrawn,
+                (unsigned long long) m_trianglesFull,
+                m_trianglesFull ? 100.0 * (1.0 - double(m_trianglesDrawn) / double(m_trianglesFull)) : 0.0);
+    ImGui::Text("Geometry arena: %.1f of %.1f MiB", m_geometryArena->getUsed() / (1024.0 * 1024.0),
+                m_geometryArena->getCapacity() / (1024.0 * 1024.0));
+    ImGui::Text("Models loading: %zu", m_modelLoader->pendingCount());
+    ImGui::Text("Geometry cache: %zu meshes, %llu hits", m_geometryCache->getEntryCount(),
+                (unsigned long long) m_geometryCache->getHitCount());
+
+    // Compute pass culling the meshlets of the generated models
+    ImGui::Checkbox("Cluster culling", &m_clusterCulling);
+    ImGui::Text("Meshlets tested: %u", commandBuffers.testedMeshletCount());
+
+    // Position-only depth pass, compare its GPU time with interleaved and
+    // split vertex streams
+    ImGui::Checkbox("Depth pre-pass", &m_depthPrepass);
+    if (ImGui::Checkbox("Split vertex streams", &m_splitStreams)) {
+        vkDeviceWaitIdle(device.logical());
+        createGeneratedModels();
+        m_geometryCache->trim();
+        updateVariants();
+    }
+
+    // Hierarchical culling, the BVH is refit as the objects move
+    ImGui::Checkbox("Frustum culling (BVH)", &m_frustumCulling);
+    // Same culling through the grid instead, picking stays on the BVH
+    ImGui::Checkbox("Cull with spatial grid", &m_gridCulling);
+    ImGui::Text("Objects in view: %zu of %u", m_frustumCulling ? m_visibleObjects.size() : size_t(m_scene.size()),
+                m_scene.size());
+
+    // Clicking outside the ImGui windows picks the object under the cursor
+    ImGuiIO& io = ImGui::GetIO();
+    if (!io.WantCaptureMouse && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+        pickObject(2.0f * io.MousePos.x / io.DisplaySize.x - 1.0f, 2.0f * io.MousePos.y / io.DisplaySize.y - 1.0f);
+    }
+    uint32_t picked = m_scene.indexOf(m_pickedObject);
+    if (picked != Scene::InvalidIndex) {
+        std::string material;
+        for (const auto& pair : m_materials) {
+            if (&pair.second == m_sceneMaterials[m_scene.materials()[picked]]) {
+                material = pair.first;
+            }
+        }
+        glm::vec3 position = m_scene.bounds()[picked].center;
+        ImGui::Text("Picked: object %u (%s) at (%.1f, %.1f, %.1f)", picked, material.c_str(),
+                    position.x, position.y, position.z);
+    } else {
+        ImGui::TextDisabled("Picked: click an object");
+    }
+
+    // The scattered objects are children of one node: spinning it
+    // recomputes all of them, otherwise only the red sphere
+    ImGui::Checkbox("Spin field", &m_spinField);
+    ImGui::Text("Transforms updated: %zu", m_transformsUpdated);
+
+    // Cells of WORLD_DIRECTORY, within the memory budgets
+    if (m_world) {
+        vks::WorldPartition::Stats world = m_world->getStats();
+        ImGui::DragFloat2("Camera pan", &m_cameraPan.x, 0.5f);
+        ImGui::Text("World cells: %u resident, %u loading of %u", world.residentCells, world.loadingCells,
+                    world.cellCount);
+        ImGui::Text("World memory: %.1f MiB CPU, %.1f MiB GPU", world.cpuBytes / (1024.0 * 1024.0),
+                    world.gpuBytes / (1024.0 * 1024.0));
+    }
+
+    // Loaded at the next start instead of building the scene
+    if (ImGui::Button("Save scene")) {
+        saveSceneFile(SCENE_FILE);
+    }
+
+    bool inverseNormals = !m_materials.empty() &&
+                          (m_materials.begin()->second.getFeatures() & MaterialFeatureInverseNormals);
+    if (ImGui::Checkbox("Per-vertex inverse() normals", &inverseNormals)) {
+        for (auto& pair : m_materials) {
+            uint32_t features = pair.second.getFeatures() & ~MaterialFeatureInverseNormals;
+            pair.second.setFeatures(graphicsPipeline, features | (inverseNormals ? MaterialFeatureInverseNormals : 0));
+        }
+        updateVariants();
+    }
+
+    // Replaces the checker texture while frames in flight still sample the old one
+    ImGui::ColorEdit4("Checker color", &m_checkerColor[0]);
+    if (ImGui::Button("New checker texture")) {
+        createCheckerTexture(m_checkerColor);
+    }
+    ImGui::Text("Bindless: %u images, %u samplers", m_bindless->imageCount(), m_bindless->samplerCount());
 
     // We get a reference to the application's map of materials
     // (This assumes m_materials is std::map<std::string, vks::Material>)
@@ -284,20 +775,39 @@ void Application::drawImGui() {
             bool changed = false;
 
             // Add a color picker for the baseColor
-            float color[4] = {
-                material.uboData.color.r,
-                material.uboData.color.g,
-                material.uboData.color.b,
-                material.uboData.color.a
-            };
+            const glm::vec4& baseColor = material.getParams().color;
+            float color[4] = {baseColor.r, baseColor.g, baseColor.b, baseColor.a};
 
             changed |= ImGui::ColorEdit4("Base Color", color);
 
-            // If any widget was changed, update the material's UBO
+            // Image 0 is white, the base color alone
+            bool checker = material.getParams().baseColorTexture == m_checkerImage;
+            changed |= ImGui::Checkbox("Checker texture", &checker);
+
+            // Feature bits select a specialized pipeline variant
+            uint32_t features = material.getFeatures();
+            bool unlit = features & MaterialFeatureUnlit;
+            bool specular = features & MaterialFeatureSpecular;
+            bool alphaTest = features & MaterialFeatureAlphaTest;
+            bool featuresChanged = ImGui::Checkbox("Unlit", &unlit);
+            featuresChanged |= ImGui::Checkbox("Specular", &specular);
+            featuresChanged |= ImGui::Checkbox("Alpha Test", &alphaTest);
+
+            if (featuresChanged) {
+                features &= ~(MaterialFeatureUnlit | MaterialFeatureSpecular | MaterialFeatureAlphaTest);
+                features |= (unlit ? MaterialFeatureUnlit : 0) |
+                            (specular ? MaterialFeatureSpecular : 0) |
+                            (alphaTest ? MaterialFeatureAlphaTest : 0);
+                material.setFeatures(graphicsPipeline, features);
+                updateVariants();
+            }
+
+            // If any widget was changed, update the material's parameters
             if (changed) {
-                MaterialUBO newUbo{};
-                newUbo.color = {color[0], color[1], color[2], color[3]};
-                material.updateUBO(newUbo);
+                MaterialParams params = material.getParams();
+                params.color = {color[0], color[1], color[2], color[3]};
+                params.baseColorTexture = checker ? m_checkerImage : 0;
+                material.setParams(params);
             }
 
             ImGui::TreePop();
@@ -327,6 +837,7 @@ void Application::recreateSwapChain(bool &framebufferResized) {
   graphicsPipeline.recreate(); // Recreates all pipeline "recipes"
   commandBuffers.recreate();   // Re-allocates the command buffers
   interface.recreate();
+  m_materialBuffer->resize(swapChain.numImages());
 
   renderPass.cleanupOld();
   swapChain.cleanupOld();
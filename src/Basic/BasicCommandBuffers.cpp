@@ -6,6 +6,27 @@
 
 using namespace vks;
 
+// Binds the arena buffers of a model unless they already are: both streams of
+// a split vertex format, or only its positions for a depth-only pass
+static void bindGeometry(VkCommandBuffer cmdBuffer, const GeometryArena& arena, const Model& model,
+                         bool positionOnly, VkBuffer& lastVertexBuffer, VkBuffer& lastIndexBuffer)
+{
+    VkBuffer vertexBuffer = arena.getVertexBuffer(model.getVertexFormat());
+    if (vertexBuffer != lastVertexBuffer) {
+        std::array<VkBuffer, 2> buffers = {vertexBuffer, arena.getAttributeBuffer(model.getVertexFormat())};
+        std::array<VkDeviceSize, 2> offsets = {0, 0};
+        uint32_t bindingCount = model.hasSplitStreams() && !positionOnly ? 2 : 1;
+        vkCmdBindVertexBuffers(cmdBuffer, 0, bindingCount, buffers.data(), offsets.data());
+        lastVertexBuffer = vertexBuffer;
+    }
+
+    VkBuffer indexBuffer = arena.getIndexBuffer(model.getIndexType());
+    if (indexBuffer != lastIndexBuffer) {
+        vkCmdBindIndexBuffer(cmdBuffer, indexBuffer, 0, model.getIndexType());
+        lastIndexBuffer = indexBuffer;
+    }
+}
+
 BasicCommandBuffers::BasicCommandBuffers(
     const Device &device, const RenderPass &renderPass,
     const SwapChain &swapChain, const GraphicsPipeline &graphicsPipeline,
@@ -13,7 +34,9 @@ BasicCommandBuffers::BasicCommandBuffers(
     Application& application // <-- ADD THIS
 )
     : CommandBuffers(device, renderPass, swapChain, graphicsPipeline, commandPool),
-      m_app(application) // <-- STORE THIS
+      m_app(application), // <-- STORE THIS
+      m_timer(device, renderPass.size()),
+      m_culler(device, renderPass.size())
 {
     BasicCommandBuffers::createCommandBuffers();
 }
@@ -21,6 +44,8 @@ BasicCommandBuffers::BasicCommandBuffers(
 void BasicCommandBuffers::recreate() {
     destroyCommandBuffers();
     createCommandBuffers();
+    m_timer.resize(m_renderPass.size());
+    m_culler.resize(m_renderPass.size());
 }
 
 void BasicCommandBuffers::createCommandBuffers()
@@ -55,90 +80,168 @@ void BasicCommandBuffers::recordCommands(uint32_t imageIndex) {
         throw std::runtime_error("failed to begin recording command buffer!");
     }
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_renderPass.handle();
-    renderPassInfo.framebuffer = m_renderPass.frameBuffer(imageIndex);
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = m_swapChain.extent();
-
-    // Set clear color AND depth
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color = {{0.01f, 0.01f, 0.01f, 1.0f}};
-    clearValues[1].depthStencil = {1.0f, 0}; // For depth buffer
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
-
-    vkCmdBeginRenderPass(cmdBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    m_timer.begin(cmdBuffer, imageIndex);
 
     // 1. Get the scene data from the application
-    auto renderObjects = m_app.getRenderObjects(); // Gets a copy
+    const Scene& scene = m_app.getScene();
+    const auto& objectTransforms = m_app.getObjectTransforms();
     VkDescriptorSet cameraSet = m_app.getCameraDescriptorSet();
+    VkDescriptorSet materialSet = m_app.getMaterialDescriptorSet(imageIndex);
+    VkDescriptorSet bindlessSet = m_app.getBindlessDescriptorSet();
+    const uint32_t* variants = scene.variants();
+    const uint32_t* lods = scene.lods();
+
+    // 2. Sort the visible objects for efficient binding: by pipeline variant,
+    // then material (its index only changes a push constant). Objects still streaming in are skipped (see ModelLoader),
+    // so are meshes outside the view frustum.
+    const std::vector<uint8_t>& visible = m_app.getObjectVisibility();
+    m_drawOrder.clear();
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+        const Model* model = m_app.getSceneMesh(scene.meshes()[i]);
+        if ((scene.flags()[i] & SceneObjectHidden) || (model != nullptr && (!model->isResident() || !visible[i]))) {
+            continue;
+        }
+        uint64_t pipelineKey = variants[i];
+        uint64_t materialKey = m_app.getSceneMaterial(scene.materials()[i]).getIndex();
+        m_drawOrder.emplace_back((pipelineKey << 32) | materialKey, i);
+    }
+    std::sort(m_drawOrder.begin(), m_drawOrder.end());
+
+    // Meshlet culling runs before the render pass, it writes the indirect
+    // draws of the objects that have meshlets
+    const GeometryArena& arena = m_app.getGeometryArena();
+    m_clusterDraws.resize(scene.size());
+    m_clustered.assign(scene.size(), 0);
+    m_culler.begin();
+    if (m_app.isClusterCullingEnabled()) {
+        for (const auto& [key, i] : m_drawOrder) {
+            const Model* model = m_app.getSceneMesh(scene.meshes()[i]);
+            if (model == nullptr || !model->hasMeshlets()) {
+                continue;
+            }
+            // The bounds are in the model's float space, before dequantization
+            m_clusterDraws[i] = m_culler.add(scene.transforms()[i], model->getMeshlets(lods[i]));
+            m_clustered[i] = 1;
+        }
+        const CameraUBO& camera = m_app.getCamera();
+        m_culler.record(cmdBuffer, imageIndex, arena.getMeshletBuffer(),
+                        ClusterCuller::makeCamera(camera.view, camera.proj));
+    }
+
+    VkClearValue clearColor{};
+    clearColor.color = {{0.01f, 0.01f, 0.01f, 1.0f}};
+
+    // Render pass object or dynamic rendering, depending on the device
+    m_renderPass.begin(cmdBuffer, imageIndex, clearColor);
+
+    // Viewport and scissor are dynamic so pipelines survive a resize
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(m_swapChain.extent().width);
+    viewport.height = static_cast<float>(m_swapChain.extent().height);
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.extent = m_swapChain.extent();
+    vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+
+    // The LOD picked by Application::updateLods() this frame
+    auto drawModel = [&](const Model& model, uint32_t i) {
+        if (m_clustered[i]) {
+            m_culler.draw(cmdBuffer, imageIndex, m_clusterDraws[i]);
+        } else {
+            const mesh::MeshLod& lod = model.getLods()[lods[i]];
+            vkCmdDrawIndexed(cmdBuffer, lod.indexCount, 1, lod.firstIndex, lod.vertexOffset, 0);
+        }
+    };
 
-    // 2. Sort the render objects for efficient binding
-    std::sort(renderObjects.begin(), renderObjects.end(),
-        [](const RenderObject& a, const RenderObject& b) {
-            return a.getSortKey() < b.getSortKey();
-    });
-
-    // 3. Bind the "global" camera descriptor set (Set 0) ONCE
-    if (cameraSet != VK_NULL_HANDLE && !renderObjects.empty()) {
-        // We can safely get the layout from the first renderable object
-        // (This assumes all scene objects use a compatible layout for Set 0)
-        auto layoutName = renderObjects[0].material->getPipelineName();
-        auto layout = m_graphicsPipeline.getLayout(layoutName);
+    // Depth pre-pass: the scene depth from the position streams alone, so the
+    // main pass (LESS_OR_EQUAL) shades every pixel once
+    if (m_app.isDepthPrepassEnabled() && cameraSet != VK_NULL_HANDLE) {
+        VkPipelineLayout depthLayout = m_graphicsPipeline.getLayout("depth");
+        const ShaderReflection& depthReflection = m_graphicsPipeline.getReflection("depth");
         vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-            layout, 0, 1, &cameraSet, 0, nullptr);
+            depthLayout, 0, 1, &cameraSet, 0, nullptr);
+
+        VkPipeline lastDepthPipeline = VK_NULL_HANDLE;
+        VkBuffer lastVertexBuffer = VK_NULL_HANDLE;
+        VkBuffer lastIndexBuffer = VK_NULL_HANDLE;
+        for (const auto& [key, i] : m_drawOrder) {
+            const Model* model = m_app.getSceneMesh(scene.meshes()[i]);
+            // Alpha-tested surfaces only know their coverage in the fragment shader
+            if (model == nullptr ||
+                (m_app.getSceneMaterial(scene.materials()[i]).getFeatures() & MaterialFeatureAlphaTest)) {
+                continue;
+            }
+
+            VkPipeline pipeline = m_graphicsPipeline.getPipeline(scene.depthVariants()[i]);
+            if (pipeline != lastDepthPipeline) {
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                lastDepthPipeline = pipeline;
+            }
+            vkCmdPushConstants(cmdBuffer, depthLayout, depthReflection.pushConstantRange().stageFlags,
+                               0, sizeof(ObjectTransform), &objectTransforms[i]);
+
+            bindGeometry(cmdBuffer, arena, *model, true, lastVertexBuffer, lastIndexBuffer);
+            drawModel(*model, i);
+        }
     }
 
-    // 4. Loop through the sorted objects and render them
+    // 3. Loop through the sorted objects and render them
     VkPipeline lastPipeline = VK_NULL_HANDLE;
     VkPipelineLayout lastLayout = VK_NULL_HANDLE;
-    VkDescriptorSet lastMaterialSet = VK_NULL_HANDLE;
 
-    for (const auto& obj : renderObjects) {
-        auto pipelineName = obj.material->getPipelineName();
-        VkPipeline pipeline = m_graphicsPipeline.getPipeline(pipelineName);
+    // All models share the arena buffers: they are only bound again when the
+    // vertex format or index type changes (variants already group formats)
+    VkBuffer lastVertexBuffer = VK_NULL_HANDLE;
+    VkBuffer lastIndexBuffer = VK_NULL_HANDLE;
+
+    for (const auto& [key, i] : m_drawOrder) {
+        const Model* model = m_app.getSceneMesh(scene.meshes()[i]);
+        const Material& material = m_app.getSceneMaterial(scene.materials()[i]);
+
+        auto pipelineName = material.getPipelineName();
+        VkPipeline pipeline = m_graphicsPipeline.getPipeline(variants[i]);
         VkPipelineLayout layout = m_graphicsPipeline.getLayout(pipelineName);
+        const ShaderReflection& reflection = m_graphicsPipeline.getReflection(pipelineName);
 
         // --- Bind Pipeline (if different) ---
         if (pipeline != lastPipeline) {
             vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
             lastPipeline = pipeline;
-            lastLayout = layout;
+        }
 
-            // Re-bind global set if layout changed
-             if (cameraSet != VK_NULL_HANDLE) {
+        // --- Bind the camera (Set 0), all materials (Set 1) and all textures (Set 2) once per layout ---
+        if (layout != lastLayout) {
+            lastLayout = layout;
+            if (cameraSet != VK_NULL_HANDLE) {
+                std::array<VkDescriptorSet, 3> sets = {cameraSet, materialSet, bindlessSet};
+                uint32_t setCount = reflection.sets().count(GraphicsPipeline::BindlessSet)   ? 3
+                                    : reflection.sets().count(GraphicsPipeline::MaterialSet) ? 2
+                                                                                              : 1;
                 vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    layout, 0, 1, &cameraSet, 0, nullptr);
+                    layout, 0, setCount, sets.data(), 0, nullptr);
             }
         }
 
-        // --- Bind Material (Set 1) (if different) ---
-        VkDescriptorSet materialSet = obj.material->getDescriptorSet();
-        if (materialSet != lastMaterialSet && materialSet != VK_NULL_HANDLE) {
-            vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                layout, 1, 1, &materialSet, 0, nullptr);
-            lastMaterialSet = materialSet;
-        }
-
         // --- Bind Instance Data (Push Constants) ---
-        // (Only if the layout has push constants)
-        if(obj.model != nullptr) { // Simple check
-            vkCmdPushConstants(cmdBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT,
-                               0, sizeof(glm::mat4), &obj.transform);
+        // (Only if the layout has push constants), the material index follows
+        // the transform when the shaders read it
+        if (reflection.hasPushConstants()) {
+            const VkPushConstantRange& range = reflection.pushConstantRange();
+            vkCmdPushConstants(cmdBuffer, layout, range.stageFlags,
+                               0, sizeof(ObjectTransform), &objectTransforms[i]);
+            if (range.offset + range.size >= MaterialBuffer::IndexOffset + sizeof(uint32_t)) {
+                uint32_t materialIndex = material.getIndex();
+                vkCmdPushConstants(cmdBuffer, layout, range.stageFlags,
+                                   MaterialBuffer::IndexOffset, sizeof(uint32_t), &materialIndex);
+            }
         }
 
         // --- Bind Geometry & Draw ---
-        if (obj.model != nullptr) {
-            VkBuffer vertexBuffers[] = { obj.model->getVertexBuffer() };
-            VkDeviceSize offsets[] = {0};
-            vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
-
-            vkCmdBindIndexBuffer(cmdBuffer, obj.model->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
-
-            vkCmdDrawIndexed(cmdBuffer, obj.model->getIndexCount(), 1, 0, 0, 0);
-
+        if (model != nullptr) {
+            bindGeometry(cmdBuffer, arena, *model, false, lastVertexBuffer, lastIndexBuffer);
+            drawModel(*model, i);
         } else {
             // This is for pipelines with no vertex input, like "base"
             vkCmdDraw(cmdBuffer, 3, 1, 0, 0);
@@ -146,7 +249,9 @@ void BasicCommandBuffers::recordCommands(uint32_t imageIndex) {
     }
     // --- End of new loop ---
 
-    vkCmdEndRenderPass(cmdBuffer);
+    m_renderPass.end(cmdBuffer, imageIndex);
+
+    m_timer.end(cmdBuffer, imageIndex);
 
     if (vkEndCommandBuffer(cmdBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
@@ -7,13 +7,14 @@ using namespace vks;
 
 BasicRenderPass::BasicRenderPass(const Device &device,
                                  const SwapChain &swapChain)
-    : RenderPass(device, swapChain) {
-  createRenderPass();
-  createFrameBuffers();
+    : RenderPass(device, swapChain, true) {
+  if (!m_dynamic) {
+    createRenderPass();
+    createFrameBuffers();
+  }
 }
 
-void BasicRenderPass::createRenderPass() {
-  // Create a new render pass as a color attachment
+VkAttachmentDescription BasicRenderPass::colorAttachment() const {
   VkAttachmentDescription colorAttachment = {};
   // Format should match the format of the swap chain
   colorAttachment.format = m_swapChain.imageFormat();
@@ -29,6 +30,13 @@ void BasicRenderPass::createRenderPass() {
   // be same as the presentation source
   colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
   colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  return colorAttachment;
+}
+
+void BasicRenderPass::createRenderPass() {
+  // Create a new render pass as a color attachment
+  VkAttachmentDescription attachments[] = {colorAttachment(),
+                                           depthAttachment()};
 
   // Post-rendering subpasses
 
@@ -39,6 +47,11 @@ void BasicRenderPass::createRenderPass() {
   // Use the optimal layout for color attachments
   colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+  // The depth target follows the color attachment
+  VkAttachmentReference depthRef = {};
+  depthRef.attachment = 1;
+  depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
   // Subpass description
   VkSubpassDescription subpass = {};
   // Using for graphics computation
@@ -46,6 +59,7 @@ void BasicRenderPass::createRenderPass() {
   // Attach the color attachment
   subpass.colorAttachmentCount = 1;
   subpass.pColorAttachments = &colorRef;
+  subpass.pDepthStencilAttachment = &depthRef;
 
   // Subpass dependencies
   VkSubpassDependency dependency = {};
@@ -55,20 +69,24 @@ void BasicRenderPass::createRenderPass() {
   dependency.dstSubpass = 0;
   // Wait for color attachment output before accessing image
   // This prevents the image being accessed by subpass and swap chain at the
-  // same time
-  dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  dependency.srcAccessMask = 0;
+  // same time. The depth clear also waits for the previous frame's depth
+  // tests, since all frames share the depth target
+  dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+  dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
   // Prevent transition from happening until after reading and writing of color
   // attachment
-  dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
   dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
-                             VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                             VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
   // Create the render pass
   VkRenderPassCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-  createInfo.attachmentCount = 1;
-  createInfo.pAttachments = &colorAttachment;
+  createInfo.attachmentCount = 2;
+  createInfo.pAttachments = attachments;
   createInfo.subpassCount = 1;
   createInfo.pSubpasses = &subpass;
   createInfo.dependencyCount = 1;
@@ -0,0 +1,120 @@
+#include <vks/BindlessTable.hpp>
+
+#include <vks/Device.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace vks;
+
+namespace {
+
+struct Capacities {
+    uint32_t images;
+    uint32_t samplers;
+    uint32_t buffers;
+};
+
+// The table sizes, within the device's update-after-bind limits
+Capacities capacities(const Device& device) {
+    VkPhysicalDeviceDescriptorIndexingProperties indexing{};
+    indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &indexing;
+    vkGetPhysicalDeviceProperties2(device.physical(), &properties);
+
+    Capacities result;
+    result.images = std::min({BindlessTable::MaxImages, indexing.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                              indexing.maxDescriptorSetUpdateAfterBindSampledImages});
+    result.samplers = std::min({BindlessTable::MaxSamplers, indexing.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                indexing.maxDescriptorSetUpdateAfterBindSamplers});
+    result.buffers = std::min({BindlessTable::MaxBuffers, indexing.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                               indexing.maxDescriptorSetUpdateAfterBindStorageBuffers});
+    return result;
+}
+
+} // namespace
+
+Ref<DescriptorSetLayout> BindlessTable::createSetLayout(const Device& device) {
+    if (!device.descriptorIndexing()) {
+        throw std::runtime_error("Bindless resources need descriptor indexing (Vulkan 1.2)!");
+    }
+    Capacities capacity = capacities(device);
+
+    // Elements are written while the set is bound and most are never written
+    const VkDescriptorBindingFlags flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                           VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                           VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    return vks::DescriptorSetLayout::Builder(device)
+        .addBinding(ImageBinding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_ALL, capacity.images, flags)
+        .addBinding(SamplerBinding, VK_DESCRIPTOR_TYPE_SAMPLER, VK_SHADER_STAGE_ALL, capacity.samplers, flags)
+        .addBinding(BufferBinding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL, capacity.buffers, flags)
+        .setLayoutFlags(VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT)
+        .build();
+}
+
+BindlessTable::BindlessTable(const Device& device, Ref<DescriptorSetLayout> setLayout, uint32_t retireFrames)
+    : m_setLayout(std::move(setLayout)) {
+    Capacities capacity = capacities(device);
+    m_images = SlotAllocator(capacity.images, retireFrames);
+    m_samplers = SlotAllocator(capacity.samplers, retireFrames);
+    m_buffers = SlotAllocator(capacity.buffers, retireFrames);
+
+    m_descriptorPool = vks::DescriptorPool::Builder(device)
+        .addPoolSize(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, capacity.images)
+        .addPoolSize(VK_DESCRIPTOR_TYPE_SAMPLER, capacity.samplers)
+        .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, capacity.buffers)
+        .setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+        .setMaxSets(1)
+        .build();
+    if (!m_descriptorPool->allocateDescriptor(m_setLayout->getDescriptorSetLayout(), m_descriptorSet)) {
+        throw std::runtime_error("failed to allocate the bindless descriptor set!");
+    }
+}
+
+uint32_t BindlessTable::allocate(SlotAllocator& slots, const char* kind) {
+    uint32_t index = slots.allocate();
+    if (index == SlotAllocator::InvalidSlot) {
+        throw std::runtime_error(std::string("The bindless table is out of ") + kind + " slots!");
+    }
+    return index;
+}
+
+uint32_t BindlessTable::addImage(VkImageView view, VkImageLayout layout) {
+    uint32_t index = allocate(m_images, "image");
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageView = view;
+    imageInfo.imageLayout = layout;
+    vks::DescriptorWriter(m_setLayout, m_descriptorPool)
+        .writeImage(ImageBinding, &imageInfo, index)
+        .overwrite(m_descriptorSet);
+    return index;
+}
+
+uint32_t BindlessTable::addSampler(VkSampler sampler) {
+    uint32_t index = allocate(m_samplers, "sampler");
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = sampler;
+    vks::DescriptorWriter(m_setLayout, m_descriptorPool)
+        .writeImage(SamplerBinding, &imageInfo, index)
+        .overwrite(m_descriptorSet);
+    return index;
+}
+
+uint32_t BindlessTable::addBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    uint32_t index = allocate(m_buffers, "buffer");
+    VkDescriptorBufferInfo bufferInfo{buffer, offset, range};
+    vks::DescriptorWriter(m_setLayout, m_descriptorPool)
+        .writeBuffer(BufferBinding, &bufferInfo, index)
+        .overwrite(m_descriptorSet);
+    return index;
+}
+
+void BindlessTable::nextFrame() {
+    m_images.nextFrame();
+    m_samplers.nextFrame();
+    m_buffers.nextFrame();
+}
@@ -0,0 +1,435 @@
+#include <vks/Bvh.hpp>
+
+#include <vks/ThreadPool.hpp>
+#include <vks/Transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace vks {
+
+static constexpr uint32_t BinCount = 16;
+static constexpr uint32_t MaxLeafItems = 4;
+// Ranges up to this many items are built by one task; larger ones are split
+// first, binning in parallel
+static constexpr uint32_t SubtreeItems = 4096;
+static constexpr size_t ItemsPerChunk = 16384;
+
+static Aabb sphereBox(const glm::vec4& sphere)
+{
+    return {glm::vec3(sphere) - sphere.w, glm::vec3(sphere) + sphere.w};
+}
+
+struct Bin
+{
+    Aabb bounds;
+    uint32_t count = 0;
+};
+
+using Bins = std::array<std::array<Bin, BinCount>, 3>;
+
+// Runs func(begin, end, partial) over chunks of a range and merges the
+// partial results, in parallel for large ranges
+template <typename T, typename Func, typename Merge>
+static T reduce(uint32_t begin, uint32_t end, bool parallel, Func&& func, Merge&& merge)
+{
+    T result{};
+    if (!parallel || end - begin <= ItemsPerChunk) {
+        func(begin, end, result);
+        return result;
+    }
+
+    size_t chunks = (end - begin + ItemsPerChunk - 1) / ItemsPerChunk;
+    std::vector<T> partial(chunks);
+    parallelFor(0, chunks, 1, [&](size_t first, size_t last)
+    {
+        for (size_t c = first; c < last; ++c) {
+            uint32_t chunkBegin = begin + static_cast<uint32_t>(c * ItemsPerChunk);
+            func(chunkBegin, std::min<uint32_t>(end, chunkBegin + ItemsPerChunk), partial[c]);
+        }
+    });
+    for (const T& p : partial) {
+        merge(result, p);
+    }
+    return result;
+}
+
+void Bvh::build(const vks::mesh::BoundingSphere* spheres, uint32_t count)
+{
+    m_nodes.clear();
+    m_subtrees.clear();
+    m_topNodeCount = 0;
+    m_items.resize(count);
+    m_spheres.resize(count);
+    parallelFor(0, count, ItemsPerChunk, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            m_items[i] = static_cast<uint32_t>(i);
+            m_spheres[i] = glm::vec4(spheres[i].center, spheres[i].radius);
+        }
+    });
+    if (count == 0) {
+        return;
+    }
+
+    // Top levels: split until there are enough ranges to keep every thread
+    // busy, each split binning in parallel
+    size_t tasks = (ThreadPool::global().threadCount() + 1) * 8;
+    uint32_t subtreeItems = std::max<uint32_t>(SubtreeItems, static_cast<uint32_t>(count / tasks));
+
+    // The root's box; every split then gets its children's from its bins
+    Aabb bounds = reduce<Aabb>(0, count, true, [&](uint32_t begin, uint32_t end, Aabb& out)
+    {
+        for (uint32_t i = begin; i < end; ++i) {
+            out.grow(sphereBox(m_spheres[i]));
+        }
+    }, [](Aabb& result, const Aabb& partial) { result.grow(partial); });
+
+    m_nodes.reserve(2 * size_t(count));
+    m_nodes.push_back({bounds.min, 0, bounds.max, count});
+    std::vector<uint32_t> pending;
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        uint32_t node = stack.back();
+        stack.pop_back();
+        if (m_nodes[node].count <= subtreeItems) {
+            pending.push_back(node);
+        } else {
+            subdivide(m_nodes, node, stack, true);
+        }
+    }
+    m_topNodeCount = static_cast<uint32_t>(m_nodes.size());
+
+    // Subtrees in parallel, each into its own array
+    std::vector<std::vector<Node>> subtrees(pending.size());
+    parallelFor(0, pending.size(), 1, [&](size_t begin, size_t end)
+    {
+        std::vector<uint32_t> subtreeStack;
+        for (size_t t = begin; t < end; ++t) {
+            std::vector<Node>& nodes = subtrees[t];
+            nodes.reserve(2 * size_t(m_nodes[pending[t]].count));
+            nodes.push_back(m_nodes[pending[t]]);
+            subtreeStack.assign(1, 0);
+            while (!subtreeStack.empty()) {
+                uint32_t node = subtreeStack.back();
+                subtreeStack.pop_back();
+                subdivide(nodes, node, subtreeStack, false);
+            }
+        }
+    });
+
+    // Appended after the top levels: the root replaces its placeholder,
+    // local index k > 0 lands at firstNode + k - 1
+    uint32_t nodeCount = m_topNodeCount;
+    for (size_t t = 0; t < pending.size(); ++t) {
+        uint32_t descendants = static_cast<uint32_t>(subtrees[t].size() - 1);
+        m_subtrees.push_back({pending[t], nodeCount, descendants});
+        nodeCount += descendants;
+    }
+    m_nodes.resize(nodeCount);
+    parallelFor(0, pending.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t t = begin; t < end; ++t) {
+            const Subtree& subtree = m_subtrees[t];
+            const std::vector<Node>& nodes = subtrees[t];
+            for (size_t k = 0; k < nodes.size(); ++k) {
+                Node node = nodes[k];
+                if (node.count == 0) {
+                    node.first += subtree.firstNode - 1;
+                }
+                m_nodes[k == 0 ? subtree.root : subtree.firstNode + k - 1] = node;
+            }
+        }
+    });
+}
+
+void Bvh::subdivide(std::vector<Node>& nodes, uint32_t node, std::vector<uint32_t>& stack, bool parallel)
+{
+    uint32_t first = nodes[node].first;
+    uint32_t count = nodes[node].count;
+    uint32_t end = first + count;
+    // Testing a few spheres costs less than another node
+    if (count <= MaxLeafItems) {
+        return;
+    }
+
+    // Bin the items along every axis of the node's box
+    Aabb box{nodes[node].min, nodes[node].max};
+    uint32_t binCount = BinCount;
+    glm::vec3 extent = box.max - box.min;
+    glm::vec3 scale;
+    for (int axis = 0; axis < 3; ++axis) {
+        scale[axis] = extent[axis] > 0.0f ? binCount / extent[axis] : 0.0f;
+    }
+    auto binOf = [&](const glm::vec4& sphere, int axis)
+    {
+        uint32_t bin = static_cast<uint32_t>((sphere[axis] - box.min[axis]) * scale[axis]);
+        return std::min(bin, binCount - 1);
+    };
+
+    Bins bins = reduce<Bins>(first, end, parallel, [&](uint32_t begin, uint32_t last, Bins& out)
+    {
+        for (uint32_t i = begin; i < last; ++i) {
+            Aabb itemBox = sphereBox(m_spheres[i]);
+            for (int axis = 0; axis < 3; ++axis) {
+                if (scale[axis] > 0.0f) {
+                    Bin& bin = out[axis][binOf(m_spheres[i], axis)];
+                    bin.bounds.grow(itemBox);
+                    ++bin.count;
+                }
+            }
+        }
+    }, [](Bins& result, const Bins& partial)
+    {
+        for (int axis = 0; axis < 3; ++axis) {
+            for (uint32_t b = 0; b < BinCount; ++b) {
+                result[axis][b].bounds.grow(partial[axis][b].bounds);
+                result[axis][b].count += partial[axis][b].count;
+            }
+        }
+    });
+
+    // Sweep the planes between the bins for the lowest SAH cost (the node's
+    // area is the same for every candidate, left out)
+    int bestAxis = -1;
+    uint32_t bestSplit = 0;
+    float bestCost = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (scale[axis] == 0.0f) {
+            continue;
+        }
+        std::array<float, BinCount> rightCost{};
+        Aabb right;
+        uint32_t rightCount = 0;
+        for (uint32_t b = binCount - 1; b > 0; --b) {
+            right.grow(bins[axis][b].bounds);
+            rightCount += bins[axis][b].count;
+            rightCost[b] = right.area() * rightCount;
+        }
+        Aabb left;
+        uint32_t leftCount = 0;
+        for (uint32_t b = 1; b < binCount; ++b) {
+            left.grow(bins[axis][b - 1].bounds);
+            leftCount += bins[axis][b - 1].count;
+            float cost = left.area() * leftCount + rightCost[b];
+            if (leftCount > 0 && leftCount < count && cost < bestCost) {
+                bestAxis = axis;
+                bestSplit = b;
+                bestCost = cost;
+            }
+        }
+    }
+
+    // Partition, the children's boxes are the union of their bins. When
+    // every center is in the same place, halve the range under the same box.
+    uint32_t middle = first + count / 2;
+    Aabb leftBox = box;
+    Aabb rightBox = box;
+    if (bestAxis >= 0) {
+        uint32_t i = first;
+        uint32_t j = end;
+        while (i < j) {
+            if (binOf(m_spheres[i], bestAxis) < bestSplit) {
+                ++i;
+            } else {
+                --j;
+                std::swap(m_spheres[i], m_spheres[j]);
+                std::swap(m_items[i], m_items[j]);
+            }
+        }
+        middle = i;
+
+        leftBox = rightBox = Aabb{};
+        for (uint32_t b = 0; b < binCount; ++b) {
+            (b < bestSplit ? leftBox : rightBox).grow(bins[bestAxis][b].bounds);
+        }
+    }
+
+    uint32_t left = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes.emplace_back();
+    nodes[left] = {leftBox.min, first, leftBox.max, middle - first};
+    nodes[left + 1] = {rightBox.min, middle, rightBox.max, end - middle};
+    nodes[node].first = left;
+    nodes[node].count = 0;
+    stack.push_back(left);
+    stack.push_back(left + 1);
+}
+
+void Bvh::refit(const vks::mesh::BoundingSphere* spheres)
+{
+    parallelFor(0, size(), ItemsPerChunk, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            const vks::mesh::BoundingSphere& sphere = spheres[m_items[i]];
+            m_spheres[i] = glm::vec4(sphere.center, sphere.radius);
+        }
+    });
+
+    // Children come after their parent, a backward walk fits them first.
+    // The subtrees are independent, then the top levels join them.
+    parallelFor(0, m_subtrees.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t t = begin; t < end; ++t) {
+            const Subtree& subtree = m_subtrees[t];
+            for (uint32_t node = subtree.firstNode + subtree.nodeCount; node-- > subtree.firstNode;) {
+                refitNode(node);
+            }
+        }
+    });
+    for (uint32_t node = m_topNodeCount; node-- > 0;) {
+        refitNode(node);
+    }
+}
+
+void Bvh::refitNode(uint32_t index)
+{
+    Node& node = m_nodes[index];
+    Aabb box;
+    if (node.count > 0) {
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            box.grow(sphereBox(m_spheres[i]));
+        }
+    } else {
+        box = {m_nodes[node.first].min, m_nodes[node.first].max};
+        box.grow(Aabb{m_nodes[node.first + 1].min, m_nodes[node.first + 1].max});
+    }
+    node.min = box.min;
+    node.max = box.max;
+}
+
+void Bvh::appendItems(uint32_t node, std::vector<uint32_t>& out) const
+{
+    uint32_t leftmost = node;
+    while (m_nodes[leftmost].count == 0) {
+        leftmost = m_nodes[leftmost].first;
+    }
+    uint32_t rightmost = node;
+    while (m_nodes[rightmost].count == 0) {
+        rightmost = m_nodes[rightmost].first + 1;
+    }
+    out.insert(out.end(), m_items.begin() + m_nodes[leftmost].first,
+               m_items.begin() + m_nodes[rightmost].first + m_nodes[rightmost].count);
+}
+
+void Bvh::queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& out) const
+{
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        uint32_t index = stack.back();
+        stack.pop_back();
+
+        transform::FrustumOverlap overlap = transform::testBox(planes, node.min, node.max);
+        if (overlap == transform::FrustumOverlap::Outside) {
+            continue;
+        }
+        if (overlap == transform::FrustumOverlap::Inside) {
+            appendItems(index, out);
+            continue;
+        }
+
+        if (node.count == 0) {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const glm::vec4& sphere = m_spheres[i];
+            bool visible = true;
+            for (int p = 0; p < 6 && visible; ++p) {
+                visible = glm::dot(glm::vec3(planes[p]), glm::vec3(sphere)) + planes[p].w >= -sphere.w;
+            }
+            if (visible) {
+                out.push_back(m_items[i]);
+            }
+        }
+    }
+}
+
+// Distance along the ray to the box, FLT_MAX when it misses
+static float rayBox(const glm::vec3& origin, const glm::vec3& inverseDirection, const Bvh::Node& node,
+                    float maxDistance)
+{
+    glm::vec3 t0 = (node.min - origin) * inverseDirection;
+    glm::vec3 t1 = (node.max - origin) * inverseDirection;
+    glm::vec3 entries = glm::min(t0, t1);
+    glm::vec3 exits = glm::max(t0, t1);
+    float enter = std::max({entries.x, entries.y, entries.z, 0.0f});
+    float exit = std::min({exits.x, exits.y, exits.z, maxDistance});
+    return enter <= exit ? enter : FLT_MAX;
+}
+
+Bvh::Hit Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+    Hit hit;
+    hit.distance = maxDistance;
+    if (m_nodes.empty()) {
+        return hit;
+    }
+
+    glm::vec3 d = glm::normalize(direction);
+    // No zero components, an axis parallel ray gets infinite slab distances
+    glm::vec3 safe = glm::mix(d, glm::vec3(1e-30f), glm::equal(d, glm::vec3(0.0f)));
+    glm::vec3 inverseDirection = 1.0f / safe;
+
+    // Nodes with their entry distance, the nearest child popped first
+    std::vector<std::pair<uint32_t, float>> stack;
+    float rootDistance = rayBox(origin, inverseDirection, m_nodes[0], hit.distance);
+    if (rootDistance != FLT_MAX) {
+        stack.emplace_back(0, rootDistance);
+    }
+    while (!stack.empty()) {
+        auto [index, distance] = stack.back();
+        stack.pop_back();
+        if (distance > hit.distance) {
+            continue;
+        }
+
+        const Node& node = m_nodes[index];
+        if (node.count == 0) {
+            float left = rayBox(origin, inverseDirection, m_nodes[node.first], hit.distance);
+            float right = rayBox(origin, inverseDirection, m_nodes[node.first + 1], hit.distance);
+            std::pair<uint32_t, float> first{node.first, left};
+            std::pair<uint32_t, float> second{node.first + 1, right};
+            if (right < left) {
+                std::swap(first, second);
+            }
+            if (second.second != FLT_MAX) {
+                stack.push_back(second);
+            }
+            if (first.second != FLT_MAX) {
+                stack.push_back(first);
+            }
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            glm::vec3 offset = origin - glm::vec3(m_spheres[i]);
+            float b = glm::dot(offset, d);
+            float c = glm::dot(offset, offset) - m_spheres[i].w * m_spheres[i].w;
+            float discriminant = b * b - c;
+            if (discriminant < 0.0f) {
+                continue;
+            }
+            float root = std::sqrt(discriminant);
+            if (-b + root < 0.0f) {
+                continue; // Behind the origin
+            }
+            float t = std::max(-b - root, 0.0f);
+            if (t <= hit.distance) {
+                hit.item = m_items[i];
+                hit.distance = t;
+            }
+        }
+    }
+    return hit;
+}
+
+} // namespace vks
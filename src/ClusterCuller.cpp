@@ -0,0 +1,212 @@
+#include <vks/ClusterCuller.hpp>
+
+#include <vks/Device.hpp>
+#include <vks/ShaderCode.hpp>
+#include <vks/ShaderReflection.hpp>
+#include <vks/Transform.hpp>
+
+#include <cluster_cull_comp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace vks;
+
+static_assert(sizeof(ClusterCuller::Object) == 80, "Object must match CullObject in cluster_cull.comp");
+static_assert(sizeof(ClusterCuller::Camera) + sizeof(uint32_t) <= 128,
+              "Camera and the first object must fit the guaranteed push constant size");
+
+// Minimum guaranteed maxComputeWorkGroupCount[0], one workgroup per object:
+// longer object lists are dispatched in batches
+static constexpr uint32_t MaxObjectsPerDispatch = 65535;
+
+ClusterCuller::ClusterCuller(const Device& device, uint32_t slotCount) : m_device(device) {
+    createPipeline();
+    createSlots(slotCount);
+}
+
+ClusterCuller::~ClusterCuller() {
+    m_slots.clear();
+    vkDestroyPipeline(m_device.logical(), m_pipeline, nullptr);
+    vkDestroyPipelineLayout(m_device.logical(), m_pipelineLayout, nullptr);
+}
+
+void ClusterCuller::resize(uint32_t slotCount) {
+    m_slots.clear();
+    createSlots(slotCount);
+}
+
+void ClusterCuller::createPipeline() {
+    // Same reflection-driven layout as the graphics pipelines
+    ShaderCode code(CLUSTER_CULL_COMP);
+    ShaderReflection reflection(code);
+    vks::DescriptorSetLayout::Builder builder(m_device);
+    for (const auto& [index, binding] : reflection.sets().at(0)) {
+        builder.addBinding(index, binding.descriptorType, binding.stageFlags, binding.descriptorCount);
+    }
+    m_setLayout = builder.build();
+    m_pushConstants = reflection.pushConstantRange();
+
+    VkDescriptorSetLayout setLayout = m_setLayout->getDescriptorSetLayout();
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &m_pushConstants;
+    if (vkCreatePipelineLayout(m_device.logical(), &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create the cluster culling pipeline layout!");
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.sizeBytes();
+    moduleInfo.pCode = code.data();
+    VkShaderModule module;
+    if (vkCreateShaderModule(m_device.logical(), &moduleInfo, nullptr, &module) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create the cluster culling shader module!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+    VkResult result = vkCreateComputePipelines(m_device.logical(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+                                               &m_pipeline);
+    vkDestroyShaderModule(m_device.logical(), module, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to create the cluster culling pipeline!");
+    }
+}
+
+void ClusterCuller::createSlots(uint32_t slotCount) {
+    m_descriptorPool = vks::DescriptorPool::Builder(m_device)
+        .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * slotCount)
+        .setMaxSets(slotCount)
+        .build();
+    m_slots.resize(slotCount);
+
+    // Sets are written by record(), once there are buffers to point to
+    for (Slot& slot : m_slots) {
+        if (!m_descriptorPool->allocateDescriptor(m_setLayout->getDescriptorSetLayout(), slot.descriptorSet)) {
+            throw std::runtime_error("failed to allocate the cluster culling descriptor sets!");
+        }
+    }
+}
+
+ClusterCuller::Camera ClusterCuller::makeCamera(const glm::mat4& view, const glm::mat4& projection,
+                                                bool coneCulling) {
+    Camera camera;
+    transform::extractFrustumPlanes(projection * view, camera.planes);
+    camera.position = glm::vec4(glm::vec3(glm::inverse(view)[3]), coneCulling ? 1.0f : 0.0f);
+    return camera;
+}
+
+void ClusterCuller::begin() {
+    m_objects.clear();
+    m_commandCount = 0;
+}
+
+ClusterCuller::Draw ClusterCuller::add(const glm::mat4& model, const mesh::MeshletRange& meshlets) {
+    Draw draw;
+    draw.firstCommand = m_commandCount;
+    draw.commandCount = meshlets.meshletCount;
+    m_objects.push_back({model, meshlets.firstMeshlet, meshlets.meshletCount, m_commandCount, 0});
+    m_commandCount += meshlets.meshletCount;
+    return draw;
+}
+
+void ClusterCuller::record(VkCommandBuffer cmd, uint32_t slotIndex, VkBuffer meshletBuffer, const Camera& camera) {
+    if (m_objects.empty() || m_commandCount == 0 || meshletBuffer == VK_NULL_HANDLE) {
+        return;
+    }
+    Slot& slot = m_slots[slotIndex];
+
+    // Grow the slot's buffers, its previous submission is done with them
+    bool rebind = slot.boundMeshlets != meshletBuffer;
+    if (slot.objectCapacity < m_objects.size()) {
+        slot.objectCapacity = std::max<uint32_t>(64, slot.objectCapacity);
+        while (slot.objectCapacity < m_objects.size()) {
+            slot.objectCapacity *= 2;
+        }
+        slot.objects = std::make_unique<vks::Buffer>(
+            m_device,
+            sizeof(Object) * slot.objectCapacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        slot.objects->map();
+        rebind = true;
+    }
+    if (slot.commandCapacity < m_commandCount) {
+        slot.commandCapacity = std::max<uint32_t>(1024, slot.commandCapacity);
+        while (slot.commandCapacity < m_commandCount) {
+            slot.commandCapacity *= 2;
+        }
+        slot.commands = std::make_unique<vks::Buffer>(
+            m_device,
+            sizeof(VkDrawIndexedIndirectCommand) * slot.commandCapacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        rebind = true;
+    }
+
+    if (rebind) {
+        VkDescriptorBufferInfo meshletInfo{meshletBuffer, 0, VK_WHOLE_SIZE};
+        VkDescriptorBufferInfo objectInfo = slot.objects->descriptorInfo();
+        VkDescriptorBufferInfo commandInfo = slot.commands->descriptorInfo();
+        vks::DescriptorWriter(m_setLayout, m_descriptorPool)
+            .writeBuffer(0, &meshletInfo)
+            .writeBuffer(1, &objectInfo)
+            .writeBuffer(2, &commandInfo)
+            .overwrite(slot.descriptorSet);
+        slot.boundMeshlets = meshletBuffer;
+    }
+
+    std::memcpy(slot.objects->getMappedMemory(), m_objects.data(), sizeof(Object) * m_objects.size());
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &slot.descriptorSet, 0,
+                            nullptr);
+    vkCmdPushConstants(cmd, m_pipelineLayout, m_pushConstants.stageFlags, 0, sizeof(Camera), &camera);
+    uint32_t objectCount = static_cast<uint32_t>(m_objects.size());
+    for (uint32_t firstObject = 0; firstObject < objectCount; firstObject += MaxObjectsPerDispatch) {
+        vkCmdPushConstants(cmd, m_pipelineLayout, m_pushConstants.stageFlags, sizeof(Camera), sizeof(uint32_t),
+                           &firstObject);
+        vkCmdDispatch(cmd, std::min(objectCount - firstObject, MaxObjectsPerDispatch), 1, 1);
+    }
+
+    // The draws of this frame read the commands as indirect arguments
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = slot.commands->getBuffer();
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 0,
+                         nullptr, 1, &barrier, 0, nullptr);
+}
+
+void ClusterCuller::draw(VkCommandBuffer cmd, uint32_t slot, const Draw& draw) const {
+    if (draw.commandCount == 0) {
+        return;
+    }
+    VkBuffer commands = m_slots[slot].commands->getBuffer();
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    VkDeviceSize offset = VkDeviceSize(stride) * draw.firstCommand;
+
+    if (m_device.multiDrawIndirect()) {
+        vkCmdDrawIndexedIndirect(cmd, commands, offset, draw.commandCount, stride);
+    } else {
+        for (uint32_t i = 0; i < draw.commandCount; ++i) {
+            vkCmdDrawIndexedIndirect(cmd, commands, offset + VkDeviceSize(stride) * i, 1, stride);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include <vks/DescriptorAllocator.hpp>
+
+#include <vks/Device.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace vks;
+
+DescriptorAllocator::DescriptorAllocator(const Device& device, uint32_t setsPerPool, uint32_t maxSetsPerPool)
+    : m_device(device), m_setsPerPool(std::max(1u, setsPerPool)),
+      m_maxSetsPerPool(std::max(m_setsPerPool, maxSetsPerPool)) {
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(const DescriptorSetLayout& layout) {
+    // Recorded first, so a new pool has room for this set
+    m_usage.record(layout.poolSizes());
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (m_current) {
+        VkResult result = m_current->allocate(layout.getDescriptorSetLayout(), set);
+        if (result == VK_SUCCESS) {
+            return set;
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            throw std::runtime_error("failed to allocate descriptor set!");
+        }
+        m_full.push_back(std::move(m_current));
+    }
+
+    // A reset pool may have been sized for other layouts: try each, then a new one
+    while (true) {
+        bool created = m_ready.empty();
+        nextPool(layout.poolSizes());
+        VkResult result = m_current->allocate(layout.getDescriptorSetLayout(), set);
+        if (result == VK_SUCCESS) {
+            return set;
+        }
+        if (created || (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)) {
+            throw std::runtime_error("failed to allocate descriptor set!");
+        }
+        m_full.push_back(std::move(m_current));
+    }
+}
+
+void DescriptorAllocator::reset() {
+    if (m_current) {
+        m_full.push_back(std::move(m_current));
+    }
+    for (Ref<DescriptorPool>& pool : m_full) {
+        pool->resetPool();
+        m_ready.push_back(std::move(pool));
+    }
+    m_full.clear();
+}
+
+void DescriptorAllocator::nextPool(const std::vector<VkDescriptorPoolSize>& atLeast) {
+    if (!m_ready.empty()) {
+        m_current = std::move(m_ready.back());
+        m_ready.pop_back();
+        return;
+    }
+
+    vks::DescriptorPool::Builder builder(m_device);
+    for (const VkDescriptorPoolSize& size : m_usage.poolSizes(m_setsPerPool, atLeast)) {
+        builder.addPoolSize(size.type, size.descriptorCount);
+    }
+    m_current = builder.setMaxSets(m_setsPerPool).build();
+    m_setsPerPool = std::min(m_setsPerPool * 2, m_maxSetsPerPool);
+}
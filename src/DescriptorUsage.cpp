@@ -0,0 +1,37 @@
+#include <vks/DescriptorUsage.hpp>
+
+#include <algorithm>
+
+using namespace vks;
+
+void DescriptorUsage::record(const std::vector<VkDescriptorPoolSize>& setSizes) {
+    for (const VkDescriptorPoolSize& size : setSizes) {
+        m_descriptors[size.type] += size.descriptorCount;
+    }
+    ++m_sets;
+}
+
+std::vector<VkDescriptorPoolSize> DescriptorUsage::poolSizes(uint32_t maxSets,
+                                                             const std::vector<VkDescriptorPoolSize>& atLeast) const {
+    std::map<VkDescriptorType, uint64_t> counts;
+    if (m_sets > 0) {
+        for (const auto& [type, descriptors] : m_descriptors) {
+            counts[type] = (descriptors * maxSets + m_sets - 1) / m_sets;
+        }
+    } else {
+        for (const VkDescriptorPoolSize& size : atLeast) {
+            counts[size.type] += uint64_t(size.descriptorCount) * maxSets;
+        }
+    }
+    for (const VkDescriptorPoolSize& size : atLeast) {
+        counts[size.type] = std::max<uint64_t>(counts[size.type], size.descriptorCount);
+    }
+
+    std::vector<VkDescriptorPoolSize> sizes;
+    for (const auto& [type, count] : counts) {
+        if (count > 0) {
+            sizes.push_back({type, static_cast<uint32_t>(std::min<uint64_t>(count, UINT32_MAX))});
+        }
+    }
+    return sizes;
+}
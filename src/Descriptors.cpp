@@ -1,6 +1,8 @@
 #include <cassert>
+#include <map>
 #include <stdexcept>
 #include <vks/Descriptors.hpp>
+#include <vks/DescriptorAllocator.hpp>
 
 namespace vks {
 
@@ -8,7 +10,8 @@ DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::addBinding(
     uint32_t binding,
     VkDescriptorType descriptorType,
     VkShaderStageFlags stageFlags,
-    uint32_t count) {
+    uint32_t count,
+    VkDescriptorBindingFlags bindingFlags) {
     assert(m_bindings.count(binding) == 0 && "Binding already in use");
     VkDescriptorSetLayoutBinding layoutBinding{};
     layoutBinding.binding = binding;
@@ -16,28 +19,57 @@ DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::addBinding(
     layoutBinding.descriptorCount = count;
     layoutBinding.stageFlags = stageFlags;
     m_bindings[binding] = layoutBinding;
+    if (bindingFlags != 0) {
+        m_bindingFlags[binding] = bindingFlags;
+    }
+    return *this;
+}
+
+DescriptorSetLayout::Builder& DescriptorSetLayout::Builder::setLayoutFlags(
+    VkDescriptorSetLayoutCreateFlags flags) {
+    m_layoutFlags = flags;
     return *this;
 }
 
 Ref<DescriptorSetLayout> DescriptorSetLayout::Builder::build() const {
-    return std::make_shared<DescriptorSetLayout>(m_device, m_bindings);
+    return std::make_shared<DescriptorSetLayout>(m_device, m_bindings, m_bindingFlags, m_layoutFlags);
 }
 
 // *************** Descriptor Set Layout *********************
 
 DescriptorSetLayout::DescriptorSetLayout(
     const vks::Device& device,
-    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings)
+    std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+    const std::unordered_map<uint32_t, VkDescriptorBindingFlags>& bindingFlags,
+    VkDescriptorSetLayoutCreateFlags layoutFlags)
     : m_device{device}, m_bindings{bindings} {
     std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings{};
+    std::vector<VkDescriptorBindingFlags> setBindingFlags{};
+    std::map<VkDescriptorType, uint32_t> descriptorCounts;
     for (auto kv : bindings) {
         setLayoutBindings.push_back(kv.second);
+        auto flags = bindingFlags.find(kv.first);
+        setBindingFlags.push_back(flags != bindingFlags.end() ? flags->second : 0);
+        descriptorCounts[kv.second.descriptorType] += kv.second.descriptorCount;
+    }
+    for (const auto& [type, count] : descriptorCounts) {
+        m_poolSizes.push_back({type, count});
     }
 
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
     descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
     descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
+    descriptorSetLayoutInfo.flags = layoutFlags;
+
+    // Same order as the bindings
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(setBindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = setBindingFlags.data();
+    if (!bindingFlags.empty()) {
+        descriptorSetLayoutInfo.pNext = &bindingFlagsInfo;
+    }
 
     if (vkCreateDescriptorSetLayout(
         m_device.logical(), // Use m_device.logical()
@@ -99,6 +131,11 @@ DescriptorPool::~DescriptorPool() {
 }
 
 bool DescriptorPool::allocateDescriptor(
+    const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor) const {
+    return allocate(descriptorSetLayout, descriptor) == VK_SUCCESS;
+}
+
+VkResult DescriptorPool::allocate(
     const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor) const {
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -106,10 +143,7 @@ bool DescriptorPool::allocateDescriptor(
     allocInfo.pSetLayouts = &descriptorSetLayout;
     allocInfo.descriptorSetCount = 1;
 
-    if (vkAllocateDescriptorSets(m_device.logical(), &allocInfo, &descriptor) != VK_SUCCESS) {
-        return false;
-    }
-    return true;
+    return vkAllocateDescriptorSets(m_device.logical(), &allocInfo, &descriptor);
 }
 
 void DescriptorPool::freeDescriptors(std::vector<VkDescriptorSet>& descriptors) const {
@@ -129,8 +163,11 @@ void DescriptorPool::resetPool() {
 DescriptorWriter::DescriptorWriter(Ref<DescriptorSetLayout> setLayout, Ref<DescriptorPool> pool)
     : m_setLayout{setLayout}, m_pool{pool} {}
 
+DescriptorWriter::DescriptorWriter(Ref<DescriptorSetLayout> setLayout, DescriptorAllocator& allocator)
+    : m_setLayout{setLayout}, m_allocator{&allocator} {}
+
 DescriptorWriter& DescriptorWriter::writeBuffer(
-    uint32_t binding, VkDescriptorBufferInfo* bufferInfo) {
+    uint32_t binding, VkDescriptorBufferInfo* bufferInfo, uint32_t arrayElement) {
     assert(m_setLayout->m_bindings.count(binding) == 1 && "Layout does not contain specified binding");
 
     auto& bindingDescription = m_setLayout->m_bindings[binding];
@@ -139,6 +176,7 @@ DescriptorWriter& DescriptorWriter::writeBuffer(
     write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     write.descriptorType = bindingDescription.descriptorType;
     write.dstBinding = binding;
+    write.dstArrayElement = arrayElement;
     write.pBufferInfo = bufferInfo;
     write.descriptorCount = 1;
 
@@ -147,7 +185,7 @@ DescriptorWriter& DescriptorWriter::writeBuffer(
 }
 
 DescriptorWriter& DescriptorWriter::writeImage(
-    uint32_t binding, VkDescriptorImageInfo* imageInfo) {
+    uint32_t binding, VkDescriptorImageInfo* imageInfo, uint32_t arrayElement) {
     assert(m_setLayout->m_bindings.count(binding) == 1 && "Layout does not contain specified binding");
 
     auto& bindingDescription = m_setLayout->m_bindings[binding];
@@ -156,6 +194,7 @@ DescriptorWriter& DescriptorWriter::writeImage(
     write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     write.descriptorType = bindingDescription.descriptorType;
     write.dstBinding = binding;
+    write.dstArrayElement = arrayElement;
     write.pImageInfo = imageInfo;
     write.descriptorCount = 1;
 
@@ -164,6 +203,11 @@ DescriptorWriter& DescriptorWriter::writeImage(
 }
 
 bool DescriptorWriter::build(VkDescriptorSet& set) {
+    if (m_allocator) {
+        set = m_allocator->allocate(*m_setLayout);
+        overwrite(set);
+        return true;
+    }
     bool success = m_pool->allocateDescriptor(m_setLayout->getDescriptorSetLayout(), set);
     if (!success) {
         return false;
@@ -176,7 +220,7 @@ void DescriptorWriter::overwrite(VkDescriptorSet& set) {
     for (auto& write : m_writes) {
         write.dstSet = set;
     }
-    vkUpdateDescriptorSets(m_pool->getDevice().logical(), m_writes.size(), m_writes.data(), 0, nullptr);
+    vkUpdateDescriptorSets(m_setLayout->m_device.logical(), m_writes.size(), m_writes.data(), 0, nullptr);
 }
 
 } // namespace vks
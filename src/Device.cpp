@@ -3,6 +3,7 @@
 #include <vks/Instance.hpp>
 #include <vks/Window.hpp>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <vector>
@@ -16,11 +17,17 @@ Device::Device(const Instance &instance, const Window &window,
                const std::vector<const char *> &extensions)
     : m_physical(VK_NULL_HANDLE), m_logical(VK_NULL_HANDLE), m_window(window),
       m_instance(instance), m_graphicsQueue(VK_NULL_HANDLE),
-      m_presentQueue(VK_NULL_HANDLE) {
+      m_presentQueue(VK_NULL_HANDLE), m_dynamicRendering(false),
+      m_multiDrawIndirect(false), m_descriptorIndexing(false),
+      m_vkCmdBeginRendering(nullptr), m_vkCmdEndRendering(nullptr) {
   m_physical =
       PickPhysicalDevice(m_instance.handle(), m_window.surface(), extensions);
   m_indices = QueueFamily::FindQueueFamilies(m_physical, m_window.surface());
 
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(m_physical, &properties);
+  m_apiVersion = std::min(m_instance.apiVersion(), properties.apiVersion);
+
   // Setup queue families for device
   std::set<uint32_t> uniqueQueueFamilies = {m_indices.graphicsFamily.value(),
                                             m_indices.presentFamily.value()};
@@ -38,6 +45,51 @@ Device::Device(const Instance &instance, const Window &window,
 
   VkPhysicalDeviceFeatures deviceFeatures = {};
 
+  // Optional: the cluster culler issues one indirect call per object with it,
+  // one per cluster without
+  VkPhysicalDeviceFeatures supportedFeatures = {};
+  vkGetPhysicalDeviceFeatures(m_physical, &supportedFeatures);
+  deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+  m_multiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+
+  // Dynamic rendering is core in 1.3, 1.2 devices may expose the KHR extension
+  // (its dependencies are core there). Older devices use render pass objects.
+  std::vector<const char *> enabledExtensions = extensions;
+  VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {};
+  dynamicRenderingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+  dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+
+  m_dynamicRendering = SupportsDynamicRendering(m_physical, m_apiVersion);
+  bool dynamicRenderingExtension =
+      m_dynamicRendering && m_apiVersion < VK_API_VERSION_1_3;
+  if (dynamicRenderingExtension) {
+    enabledExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+  }
+
+  // Bindless resources: large arrays, partially bound and written while
+  // frames in flight use other elements. Indexed with dynamically uniform
+  // values only, so the non-uniform indexing features are not needed.
+  VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures = {};
+  descriptorIndexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+  descriptorIndexingFeatures.pNext =
+      m_dynamicRendering ? &dynamicRenderingFeatures : nullptr;
+
+  m_descriptorIndexing = SupportsDescriptorIndexing(m_physical, m_apiVersion);
+  if (m_descriptorIndexing) {
+    descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind =
+        VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind =
+        VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending =
+        VK_TRUE;
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+    deviceFeatures.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+  }
+
   // Setup logical device
   VkDeviceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -47,9 +99,14 @@ Device::Device(const Instance &instance, const Window &window,
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
   createInfo.pEnabledFeatures = &deviceFeatures;
+  createInfo.pNext = m_descriptorIndexing
+                         ? static_cast<void *>(&descriptorIndexingFeatures)
+                         : m_dynamicRendering ? &dynamicRenderingFeatures
+                                              : nullptr;
 
-  createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
-  createInfo.ppEnabledExtensionNames = extensions.data();
+  createInfo.enabledExtensionCount =
+      static_cast<uint32_t>(enabledExtensions.size());
+  createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
   if (m_instance.validationLayersEnabled()) {
     createInfo.enabledLayerCount =
@@ -69,6 +126,78 @@ Device::Device(const Instance &instance, const Window &window,
                    &m_graphicsQueue);
   vkGetDeviceQueue(m_logical, m_indices.presentFamily.value(), 0,
                    &m_presentQueue);
+
+  if (m_dynamicRendering) {
+    m_vkCmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRendering>(
+        vkGetDeviceProcAddr(m_logical, dynamicRenderingExtension
+                                           ? "vkCmdBeginRenderingKHR"
+                                           : "vkCmdBeginRendering"));
+    m_vkCmdEndRendering = reinterpret_cast<PFN_vkCmdEndRendering>(
+        vkGetDeviceProcAddr(m_logical, dynamicRenderingExtension
+                                           ? "vkCmdEndRenderingKHR"
+                                           : "vkCmdEndRendering"));
+    if (m_vkCmdBeginRendering == nullptr || m_vkCmdEndRendering == nullptr) {
+      throw std::runtime_error("failed to load dynamic rendering commands!");
+    }
+  }
+}
+
+void Device::cmdBeginRendering(VkCommandBuffer cmd,
+                               const VkRenderingInfo &renderingInfo) const {
+  m_vkCmdBeginRendering(cmd, &renderingInfo);
+}
+
+void Device::cmdEndRendering(VkCommandBuffer cmd) const {
+  m_vkCmdEndRendering(cmd);
+}
+
+bool Device::SupportsDynamicRendering(const VkPhysicalDevice &device,
+                                      uint32_t apiVersion) {
+  if (apiVersion < VK_API_VERSION_1_2) {
+    return false;
+  }
+  if (apiVersion < VK_API_VERSION_1_3 &&
+      !CheckDeviceExtensionSupport(device,
+                                   {VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME})) {
+    return false;
+  }
+
+  VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {};
+  dynamicRenderingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+
+  VkPhysicalDeviceFeatures2 features = {};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &dynamicRenderingFeatures;
+  vkGetPhysicalDeviceFeatures2(device, &features);
+
+  return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+}
+
+bool Device::SupportsDescriptorIndexing(const VkPhysicalDevice &device,
+                                        uint32_t apiVersion) {
+  // Core in 1.2, the extension on older devices is not worth a fallback
+  if (apiVersion < VK_API_VERSION_1_2) {
+    return false;
+  }
+
+  VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures = {};
+  descriptorIndexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+  VkPhysicalDeviceFeatures2 features = {};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &descriptorIndexingFeatures;
+  vkGetPhysicalDeviceFeatures2(device, &features);
+
+  const VkPhysicalDeviceDescriptorIndexingFeatures &f =
+      descriptorIndexingFeatures;
+  return f.runtimeDescriptorArray && f.descriptorBindingPartiallyBound &&
+         f.descriptorBindingSampledImageUpdateAfterBind &&
+         f.descriptorBindingStorageBufferUpdateAfterBind &&
+         f.descriptorBindingUpdateUnusedWhilePending &&
+         features.features.shaderSampledImageArrayDynamicIndexing &&
+         features.features.shaderStorageBufferArrayDynamicIndexing;
 }
 
 Device::~Device() { vkDestroyDevice(m_logical, nullptr); }
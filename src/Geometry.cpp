@@ -1,6 +1,10 @@
 #include <array>
 #include <vks/Geometry.hpp>
+#include <vks/ThreadPool.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <utility>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -44,68 +48,666 @@ namespace vks
             return attributeDescriptions;
         }
 
+        VkVertexInputBindingDescription CompactVertex::getBindingDescription()
+        {
+            VkVertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 0;
+            bindingDescription.stride = sizeof(CompactVertex);
+            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+            return bindingDescription;
+        }
 
-        void createSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius, uint32_t sectors,
-                          uint32_t stacks)
+        std::array<VkVertexInputAttributeDescription, 3> CompactVertex::getAttributeDescriptions()
+        {
+            std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+            // Position, dequantized by the model matrix
+            attributeDescriptions[0].binding = 0;
+            attributeDescriptions[0].location = 0;
+            attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+            attributeDescriptions[0].offset = offsetof(CompactVertex, pos);
+
+            // Octahedral normal, decoded in the vertex shader
+            attributeDescriptions[1].binding = 0;
+            attributeDescriptions[1].location = 1;
+            attributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+            attributeDescriptions[1].offset = offsetof(CompactVertex, normal);
+
+            // UV/TexCoord
+            attributeDescriptions[2].binding = 0;
+            attributeDescriptions[2].location = 2;
+            attributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+            attributeDescriptions[2].offset = offsetof(CompactVertex, uv);
+
+            return attributeDescriptions;
+        }
+
+        VertexInputDescription getVertexInput(VertexFormat format, bool positionOnly)
+        {
+            VertexInputDescription input;
+            if (isCompact(format)) {
+                input.bindings[0] = CompactVertex::getBindingDescription();
+                input.attributes = CompactVertex::getAttributeDescriptions();
+            } else {
+                input.bindings[0] = Vertex::getBindingDescription();
+                input.attributes = Vertex::getAttributeDescriptions();
+            }
+
+            if (isSplit(format)) {
+                // Same attributes, the normal and UV moved to a tightly packed binding 1
+                uint32_t positionSize = positionStreamSize(format);
+                input.bindings[0].stride = positionSize;
+                input.bindings[1] = input.bindings[0];
+                input.bindings[1].binding = 1;
+                input.bindings[1].stride = vertexSize(format) - positionSize;
+                input.bindingCount = 2;
+                for (uint32_t i = 1; i < input.attributes.size(); ++i) {
+                    input.attributes[i].binding = 1;
+                    input.attributes[i].offset -= positionSize;
+                }
+            }
+
+            if (positionOnly) {
+                input.bindingCount = 1;
+                input.attributeCount = 1;
+            }
+            return input;
+        }
+
+        uint32_t vertexSize(VertexFormat format)
+        {
+            return isCompact(format) ? sizeof(CompactVertex) : sizeof(Vertex);
+        }
+
+        uint32_t positionStreamSize(VertexFormat format)
+        {
+            if (!isSplit(format)) {
+                return vertexSize(format);
+            }
+            return isCompact(format) ? sizeof(CompactVertex::pos) : sizeof(Vertex::pos);
+        }
+
+        void splitVertices(const void* interleaved, VertexFormat format, size_t vertexCount, void* out)
+        {
+            size_t stride = vertexSize(format);
+            size_t positionSize = positionStreamSize(format);
+            size_t attributeSize = stride - positionSize;
+            const uint8_t* src = static_cast<const uint8_t*>(interleaved);
+            uint8_t* positions = static_cast<uint8_t*>(out);
+            uint8_t* attributes = positions + positionSize * vertexCount;
+
+            // Positions lead both vertex structs
+            for (size_t i = 0; i < vertexCount; ++i) {
+                std::memcpy(positions + i * positionSize, src + i * stride, positionSize);
+                std::memcpy(attributes + i * attributeSize, src + i * stride + positionSize, attributeSize);
+            }
+        }
+
+
+        // Work below this many vertices per task is not worth a thread hop
+        static constexpr size_t VerticesPerTask = 4096;
+
+        static size_t rowsPerTask(size_t rowLength)
+        {
+            return std::max<size_t>(1, VerticesPerTask / std::max<size_t>(rowLength, 1));
+        }
+
+        static void setVertex(Vertex& v, float x, float y, float z, float nx, float ny, float nz, float s, float t)
+        {
+            v.pos[0] = x;
+            v.pos[1] = y;
+            v.pos[2] = z;
+            v.normal[0] = nx;
+            v.normal[1] = ny;
+            v.normal[2] = nz;
+            v.uv[0] = s;
+            v.uv[1] = t;
+        }
+
+        // Two triangles of the quad (a, a + 1, b, b + 1), b being the next row
+        static uint32_t* writeQuad(uint32_t* out, uint32_t a, uint32_t b)
+        {
+            out[0] = a;
+            out[1] = b;
+            out[2] = a + 1;
+            out[3] = a + 1;
+            out[4] = b;
+            out[5] = b + 1;
+            return out + 6;
+        }
+
+        template <typename Write>
+        static void createMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, MeshSize size,
+                               Write write)
         {
-            vertices.clear();
-            indices.clear();
+            vertices.resize(size.vertexCount);
+            indices.resize(size.indexCount);
+            write(vertices.data(), indices.data());
+        }
 
-            float x, y, z, xy;
-            float nx, ny, nz, lengthInv = 1.0f / radius;
-            float s, t;
+        // --- UV sphere ---
+
+        MeshSize sphereSize(uint32_t sectors, uint32_t stacks)
+        {
+            // The pole rows only have one triangle per sector
+            return {(sectors + 1) * (stacks + 1), stacks > 0 ? 6 * sectors * (stacks - 1) : 0};
+        }
+
+        float sphereTessellationError(uint32_t sectors, uint32_t stacks)
+        {
+            // Depth of an equatorial quad center below the sphere
+            return 1.0f - std::cos(float(M_PI) / sectors) * std::cos(float(M_PI) / (2 * stacks));
+        }
 
+        void writeSphere(Vertex* vertices, uint32_t* indices, float radius, uint32_t sectors, uint32_t stacks)
+        {
+            // The tables reproduce the float math of the original per-vertex
+            // loop exactly, the output is bit-identical.
+            float lengthInv = 1.0f / radius;
             float sectorStep = 2 * M_PI / sectors;
             float stackStep = M_PI / stacks;
-            float sectorAngle, stackAngle;
 
+            std::vector<float> sectorCos(sectors + 1), sectorSin(sectors + 1), sectorS(sectors + 1);
+            for (uint32_t j = 0; j <= sectors; ++j)
+            {
+                float sectorAngle = j * sectorStep;
+                sectorCos[j] = cosf(sectorAngle);
+                sectorSin[j] = sinf(sectorAngle);
+                sectorS[j] = (float)j / sectors;
+            }
+
+            std::vector<float> stackXY(stacks + 1), stackZ(stacks + 1);
             for (uint32_t i = 0; i <= stacks; ++i)
             {
-                stackAngle = M_PI / 2 - i * stackStep;
-                xy = radius * cosf(stackAngle);
-                z = radius * sinf(stackAngle);
+                float stackAngle = M_PI / 2 - i * stackStep;
+                stackXY[i] = radius * cosf(stackAngle);
+                stackZ[i] = radius * sinf(stackAngle);
+            }
 
-                for (uint32_t j = 0; j <= sectors; ++j)
+            uint32_t rowLength = sectors + 1;
+            parallelFor(0, stacks + 1, rowsPerTask(rowLength), [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
                 {
-                    sectorAngle = j * sectorStep;
+                    float xy = stackXY[i];
+                    float z = stackZ[i];
+                    float nz = z * lengthInv;
+                    float t = (float)i / stacks;
 
-                    x = xy * cosf(sectorAngle);
-                    y = xy * sinf(sectorAngle);
+                    Vertex* row = vertices + i * rowLength;
+                    for (uint32_t j = 0; j <= sectors; ++j)
+                    {
+                        float x = xy * sectorCos[j];
+                        float y = xy * sectorSin[j];
+                        setVertex(row[j], x, y, z, x * lengthInv, y * lengthInv, nz, sectorS[j], t);
+                    }
+                }
+            });
+
+            if (stacks < 2)
+            {
+                return;
+            }
 
-                    nx = x * lengthInv;
-                    ny = y * lengthInv;
-                    nz = z * lengthInv;
+            parallelFor(0, stacks, rowsPerTask(rowLength), [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    // Row 0 has 3 indices per sector, the next ones 6
+                    uint32_t* out = indices + (i == 0 ? 0 : (6 * i - 3) * sectors);
+                    uint32_t k1 = static_cast<uint32_t>(i) * rowLength;
+                    uint32_t k2 = k1 + rowLength;
 
-                    s = (float)j / sectors;
-                    t = (float)i / stacks;
+                    for (uint32_t j = 0; j < sectors; ++j, ++k1, ++k2)
+                    {
+                        if (i != 0)
+                        {
+                            *out++ = k1;
+                            *out++ = k2;
+                            *out++ = k1 + 1;
+                        }
 
-                    vertices.push_back({{x, y, z}, {nx, ny, nz}, {s, t}});
+                        if (i != (stacks - 1))
+                        {
+                            *out++ = k1 + 1;
+                            *out++ = k2;
+                            *out++ = k2 + 1;
+                        }
+                    }
                 }
+            });
+        }
+
+        void createSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius, uint32_t sectors,
+                          uint32_t stacks)
+        {
+            createMesh(vertices, indices, sphereSize(sectors, stacks), [&](Vertex* v, uint32_t* i)
+            {
+                writeSphere(v, i, radius, sectors, stacks);
+            });
+        }
+
+        // --- Icosphere ---
+
+        static const float GoldenRatio = 1.61803398874989484820f;
+
+        static const glm::vec3 IcosahedronVertices[12] = {
+            {-1, GoldenRatio, 0}, {1, GoldenRatio, 0}, {-1, -GoldenRatio, 0}, {1, -GoldenRatio, 0},
+            {0, -1, GoldenRatio}, {0, 1, GoldenRatio}, {0, -1, -GoldenRatio}, {0, 1, -GoldenRatio},
+            {GoldenRatio, 0, -1}, {GoldenRatio, 0, 1}, {-GoldenRatio, 0, -1}, {-GoldenRatio, 0, 1},
+        };
+
+        static const uint32_t IcosahedronFaces[20][3] = {
+            {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+            {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+            {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+            {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1},
+        };
+
+        static uint32_t icosphereFaceVertices(uint32_t frequency)
+        {
+            return (frequency + 1) * (frequency + 2) / 2;
+        }
+
+        MeshSize icosphereSize(uint32_t frequency)
+        {
+            return {20 * icosphereFaceVertices(frequency), 20 * 3 * frequency * frequency};
+        }
+
+        // Point k steps (out of n) from corner p to corner q. Evaluated from the
+        // lower corner index so both faces sharing the edge get the same bits.
+        static glm::vec3 icosahedronEdgePoint(uint32_t p, uint32_t q, uint32_t k, uint32_t n)
+        {
+            if (p > q)
+            {
+                std::swap(p, q);
+                k = n - k;
             }
+            return (IcosahedronVertices[p] * (float)(n - k) + IcosahedronVertices[q] * (float)k) / (float)n;
+        }
+
+        void writeIcosphere(Vertex* vertices, uint32_t* indices, float radius, uint32_t frequency)
+        {
+            const uint32_t n = frequency;
+            const uint32_t faceVertices = icosphereFaceVertices(n);
+            const uint32_t faceIndices = 3 * n * n;
+
+            // Offset of row j inside a face, row j holds n - j + 1 vertices
+            auto rowOffset = [n](uint32_t j) { return j * (n + 1) - j * (j - 1) / 2; };
 
-            uint32_t k1, k2;
-            for (uint32_t i = 0; i < stacks; ++i)
+            parallelFor(0, 20, 1, [&](size_t first, size_t last)
             {
-                k1 = i * (sectors + 1);
-                k2 = k1 + sectors + 1;
+                for (size_t face = first; face < last; ++face)
+                {
+                    const uint32_t a = IcosahedronFaces[face][0];
+                    const uint32_t b = IcosahedronFaces[face][1];
+                    const uint32_t c = IcosahedronFaces[face][2];
+                    const glm::vec3& A = IcosahedronVertices[a];
+                    const glm::vec3& B = IcosahedronVertices[b];
+                    const glm::vec3& C = IcosahedronVertices[c];
+
+                    const uint32_t base = static_cast<uint32_t>(face) * faceVertices;
+                    Vertex* out = vertices + base;
+                    for (uint32_t j = 0; j <= n; ++j)
+                    {
+                        for (uint32_t i = 0; i + j <= n; ++i)
+                        {
+                            glm::vec3 p;
+                            if (j == 0)
+                            {
+                                p = icosahedronEdgePoint(a, b, i, n);
+                            }
+                            else if (i == 0)
+                            {
+                                p = icosahedronEdgePoint(a, c, j, n);
+                            }
+                            else if (i + j == n)
+                            {
+                                p = icosahedronEdgePoint(b, c, j, n);
+                            }
+                            else
+                            {
+                                p = (A * (float)(n - i - j) + B * (float)i + C * (float)j) / (float)n;
+                            }
 
-                for (uint32_t j = 0; j < sectors; ++j, ++k1, ++k2)
+                            glm::vec3 normal = glm::normalize(p);
+                            float s = atan2f(normal.y, normal.x) / (2.0f * (float)M_PI);
+                            float t = acosf(glm::clamp(normal.z, -1.0f, 1.0f)) / (float)M_PI;
+                            glm::vec3 pos = normal * radius;
+                            setVertex(*out++, pos.x, pos.y, pos.z, normal.x, normal.y, normal.z,
+                                      s < 0.0f ? s + 1.0f : s, t);
+                        }
+                    }
+
+                    uint32_t* tri = indices + face * faceIndices;
+                    for (uint32_t j = 0; j < n; ++j)
+                    {
+                        uint32_t row = base + rowOffset(j);
+                        uint32_t next = base + rowOffset(j + 1);
+                        for (uint32_t i = 0; i + j < n; ++i)
+                        {
+                            *tri++ = row + i;
+                            *tri++ = row + i + 1;
+                            *tri++ = next + i;
+
+                            if (i + j + 1 < n)
+                            {
+                                *tri++ = row + i + 1;
+                                *tri++ = next + i + 1;
+                                *tri++ = next + i;
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        void createIcosphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius,
+                             uint32_t frequency)
+        {
+            createMesh(vertices, indices, icosphereSize(frequency), [&](Vertex* v, uint32_t* i)
+            {
+                writeIcosphere(v, i, radius, frequency);
+            });
+        }
+
+        // --- Cube sphere ---
+
+        struct CubeFace
+        {
+            // Axis and sign of the face normal, then of the u and v directions (u x v = normal)
+            int normalAxis, uAxis, vAxis;
+            float normalSign, uSign, vSign;
+        };
+
+        static const CubeFace CubeFaces[6] = {
+            {0, 1, 2, 1.0f, 1.0f, 1.0f},   // +X: u = +Y, v = +Z
+            {0, 1, 2, -1.0f, -1.0f, 1.0f}, // -X: u = -Y, v = +Z
+            {1, 2, 0, 1.0f, 1.0f, 1.0f},   // +Y: u = +Z, v = +X
+            {1, 2, 0, -1.0f, -1.0f, 1.0f}, // -Y: u = -Z, v = +X
+            {2, 0, 1, 1.0f, 1.0f, 1.0f},   // +Z: u = +X, v = +Y
+            {2, 0, 1, -1.0f, -1.0f, 1.0f}, // -Z: u = -X, v = +Y
+        };
+
+        MeshSize cubeSphereSize(uint32_t divisions)
+        {
+            return {6 * (divisions + 1) * (divisions + 1), 6 * 6 * divisions * divisions};
+        }
+
+        void writeCubeSphere(Vertex* vertices, uint32_t* indices, float radius, uint32_t divisions)
+        {
+            const uint32_t n = divisions;
+            const uint32_t rowLength = n + 1;
+            const uint32_t faceVertices = rowLength * rowLength;
+
+            // Symmetric grid coordinates, -coords[k] == coords[n - k] exactly,
+            // so vertices on the cube edges match between faces
+            std::vector<float> coords(rowLength), uvs(rowLength);
+            for (uint32_t k = 0; k <= n; ++k)
+            {
+                coords[k] = (float)(2 * (int)k - (int)n) / (float)n;
+                uvs[k] = (float)k / n;
+            }
+
+            parallelFor(0, 6 * rowLength, rowsPerTask(rowLength), [&](size_t first, size_t last)
+            {
+                for (size_t row = first; row < last; ++row)
                 {
-                    if (i != 0)
+                    const uint32_t face = static_cast<uint32_t>(row / rowLength);
+                    const uint32_t j = static_cast<uint32_t>(row % rowLength);
+                    const CubeFace& f = CubeFaces[face];
+
+                    Vertex* out = vertices + face * faceVertices + j * rowLength;
+                    for (uint32_t i = 0; i <= n; ++i)
                     {
-                        indices.push_back(k1);
-                        indices.push_back(k2);
-                        indices.push_back(k1 + 1);
+                        float cube[3];
+                        cube[f.normalAxis] = f.normalSign;
+                        cube[f.uAxis] = f.uSign * coords[i];
+                        cube[f.vAxis] = f.vSign * coords[j];
+
+                        // Spherified cube mapping (x * sqrt(1 - y^2/2 - z^2/2 + y^2 z^2/3), ...)
+                        float x2 = cube[0] * cube[0], y2 = cube[1] * cube[1], z2 = cube[2] * cube[2];
+                        glm::vec3 p(cube[0] * sqrtf(1.0f - y2 * 0.5f - z2 * 0.5f + y2 * z2 / 3.0f),
+                                    cube[1] * sqrtf(1.0f - z2 * 0.5f - x2 * 0.5f + z2 * x2 / 3.0f),
+                                    cube[2] * sqrtf(1.0f - x2 * 0.5f - y2 * 0.5f + x2 * y2 / 3.0f));
+
+                        glm::vec3 normal = glm::normalize(p);
+                        glm::vec3 pos = normal * radius;
+                        setVertex(out[i], pos.x, pos.y, pos.z, normal.x, normal.y, normal.z, uvs[i], uvs[j]);
                     }
 
-                    if (i != (stacks - 1))
+                    if (j < n)
                     {
-                        indices.push_back(k1 + 1);
-                        indices.push_back(k2);
-                        indices.push_back(k2 + 1);
+                        uint32_t* tri = indices + (face * n + j) * n * 6;
+                        uint32_t a = face * faceVertices + j * rowLength;
+                        for (uint32_t i = 0; i < n; ++i, ++a)
+                        {
+                            // (a, a + 1, b) is counter-clockwise around u x v
+                            tri[0] = a;
+                            tri[1] = a + 1;
+                            tri[2] = a + rowLength;
+                            tri[3] = a + 1;
+                            tri[4] = a + rowLength + 1;
+                            tri[5] = a + rowLength;
+                            tri += 6;
+                        }
                     }
                 }
+            });
+        }
+
+        void createCubeSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius,
+                              uint32_t divisions)
+        {
+            createMesh(vertices, indices, cubeSphereSize(divisions), [&](Vertex* v, uint32_t* i)
+            {
+                writeCubeSphere(v, i, radius, divisions);
+            });
+        }
+
+        // --- Plane ---
+
+        MeshSize planeSize(uint32_t xSegments, uint32_t ySegments)
+        {
+            return {(xSegments + 1) * (ySegments + 1), 6 * xSegments * ySegments};
+        }
+
+        void writePlane(Vertex* vertices, uint32_t* indices, float width, float height, uint32_t xSegments,
+                        uint32_t ySegments)
+        {
+            const uint32_t rowLength = xSegments + 1;
+
+            std::vector<float> xs(rowLength), us(rowLength);
+            for (uint32_t j = 0; j <= xSegments; ++j)
+            {
+                us[j] = (float)j / xSegments;
+                xs[j] = (us[j] - 0.5f) * width;
             }
+
+            parallelFor(0, ySegments + 1, rowsPerTask(rowLength), [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    float t = (float)i / ySegments;
+                    float y = (t - 0.5f) * height;
+
+                    Vertex* row = vertices + i * rowLength;
+                    for (uint32_t j = 0; j <= xSegments; ++j)
+                    {
+                        setVertex(row[j], xs[j], y, 0.0f, 0.0f, 0.0f, 1.0f, us[j], t);
+                    }
+
+                    if (i < ySegments)
+                    {
+                        uint32_t* tri = indices + i * xSegments * 6;
+                        uint32_t a = static_cast<uint32_t>(i) * rowLength;
+                        for (uint32_t j = 0; j < xSegments; ++j, ++a)
+                        {
+                            // +X then +Y is counter-clockwise seen from +Z
+                            tri[0] = a;
+                            tri[1] = a + 1;
+                            tri[2] = a + rowLength;
+                            tri[3] = a + 1;
+                            tri[4] = a + rowLength + 1;
+                            tri[5] = a + rowLength;
+                            tri += 6;
+                        }
+                    }
+                }
+            });
+        }
+
+        void createPlane(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float width, float height,
+                         uint32_t xSegments, uint32_t ySegments)
+        {
+            createMesh(vertices, indices, planeSize(xSegments, ySegments), [&](Vertex* v, uint32_t* i)
+            {
+                writePlane(v, i, width, height, xSegments, ySegments);
+            });
+        }
+
+        // --- Torus ---
+
+        MeshSize torusSize(uint32_t rings, uint32_t sides)
+        {
+            return {(rings + 1) * (sides + 1), 6 * rings * sides};
+        }
+
+        void writeTorus(Vertex* vertices, uint32_t* indices, float majorRadius, float minorRadius, uint32_t rings,
+                        uint32_t sides)
+        {
+            const uint32_t rowLength = sides + 1;
+
+            std::vector<float> tubeCos(rowLength), tubeSin(rowLength), tubeT(rowLength);
+            for (uint32_t j = 0; j <= sides; ++j)
+            {
+                float angle = j * (float)(2 * M_PI / sides);
+                tubeCos[j] = cosf(angle);
+                tubeSin[j] = sinf(angle);
+                tubeT[j] = (float)j / sides;
+            }
+
+            parallelFor(0, rings + 1, rowsPerTask(rowLength), [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    float angle = i * (float)(2 * M_PI / rings);
+                    float ringCos = cosf(angle);
+                    float ringSin = sinf(angle);
+                    float s = (float)i / rings;
+
+                    Vertex* row = vertices + i * rowLength;
+                    for (uint32_t j = 0; j <= sides; ++j)
+                    {
+                        float r = majorRadius + minorRadius * tubeCos[j];
+                        setVertex(row[j], r * ringCos, r * ringSin, minorRadius * tubeSin[j],
+                                  tubeCos[j] * ringCos, tubeCos[j] * ringSin, tubeSin[j], s, tubeT[j]);
+                    }
+
+                    if (i < rings)
+                    {
+                        uint32_t* tri = indices + i * sides * 6;
+                        uint32_t a = static_cast<uint32_t>(i) * rowLength;
+                        for (uint32_t j = 0; j < sides; ++j, ++a)
+                        {
+                            tri = writeQuad(tri, a, a + rowLength);
+                        }
+                    }
+                }
+            });
+        }
+
+        void createTorus(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float majorRadius,
+                         float minorRadius, uint32_t rings, uint32_t sides)
+        {
+            createMesh(vertices, indices, torusSize(rings, sides), [&](Vertex* v, uint32_t* i)
+            {
+                writeTorus(v, i, majorRadius, minorRadius, rings, sides);
+            });
+        }
+
+        // --- Cylinder ---
+
+        MeshSize cylinderSize(uint32_t sectors, uint32_t stacks)
+        {
+            // Side grid, then a center and a rim (with its own normals) per cap
+            return {(sectors + 1) * (stacks + 1) + 2 * (sectors + 2), 6 * sectors * stacks + 2 * 3 * sectors};
+        }
+
+        void writeCylinder(Vertex* vertices, uint32_t* indices, float radius, float height, uint32_t sectors,
+                           uint32_t stacks)
+        {
+            const uint32_t rowLength = sectors + 1;
+            const float halfHeight = height * 0.5f;
+
+            std::vector<float> sectorCos(rowLength), sectorSin(rowLength), sectorS(rowLength);
+            for (uint32_t j = 0; j <= sectors; ++j)
+            {
+                float angle = j * (float)(2 * M_PI / sectors);
+                sectorCos[j] = cosf(angle);
+                sectorSin[j] = sinf(angle);
+                sectorS[j] = (float)j / sectors;
+            }
+
+            // Side, top row first like the sphere
+            parallelFor(0, stacks + 1, rowsPerTask(rowLength), [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    float t = (float)i / stacks;
+                    float z = halfHeight - t * height;
+
+                    Vertex* row = vertices + i * rowLength;
+                    for (uint32_t j = 0; j <= sectors; ++j)
+                    {
+                        setVertex(row[j], radius * sectorCos[j], radius * sectorSin[j], z, sectorCos[j],
+                                  sectorSin[j], 0.0f, sectorS[j], t);
+                    }
+
+                    if (i < stacks)
+                    {
+                        uint32_t* tri = indices + i * sectors * 6;
+                        uint32_t a = static_cast<uint32_t>(i) * rowLength;
+                        for (uint32_t j = 0; j < sectors; ++j, ++a)
+                        {
+                            tri = writeQuad(tri, a, a + rowLength);
+                        }
+                    }
+                }
+            });
+
+            // Caps, small enough to stay on this thread
+            uint32_t* tri = indices + 6 * sectors * stacks;
+            uint32_t base = rowLength * (stacks + 1);
+            for (float side : {1.0f, -1.0f})
+            {
+                float z = side * halfHeight;
+                Vertex* cap = vertices + base;
+                setVertex(cap[0], 0.0f, 0.0f, z, 0.0f, 0.0f, side, 0.5f, 0.5f);
+                for (uint32_t j = 0; j <= sectors; ++j)
+                {
+                    setVertex(cap[j + 1], radius * sectorCos[j], radius * sectorSin[j], z, 0.0f, 0.0f, side,
+                              0.5f + 0.5f * sectorCos[j], 0.5f - 0.5f * side * sectorSin[j]);
+                }
+
+                for (uint32_t j = 0; j < sectors; ++j)
+                {
+                    // Counter-clockwise around +Z on top, reversed below
+                    *tri++ = base;
+                    *tri++ = base + 1 + (side > 0.0f ? j : j + 1);
+                    *tri++ = base + 1 + (side > 0.0f ? j + 1 : j);
+                }
+                base += sectors + 2;
+            }
+        }
+
+        void createCylinder(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float radius,
+                            float height, uint32_t sectors, uint32_t stacks)
+        {
+            createMesh(vertices, indices, cylinderSize(sectors, stacks), [&](Vertex* v, uint32_t* i)
+            {
+                writeCylinder(v, i, radius, height, sectors, stacks);
+            });
         }
     } // namespace geometry
 } // namespace vks
@@ -0,0 +1,212 @@
+#include <vks/GeometryArena.hpp>
+
+#include <vks/CommandBuffers.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace vks;
+
+// Meshlets are small, a few per thousand triangles
+static constexpr uint32_t InitialMeshlets = 1u << 12;
+
+GeometryArena::GeometryArena(const vks::Device& device, const vks::CommandPool& commandPool,
+                             uint32_t initialVertices, uint32_t initialIndices)
+    : m_device(device),
+      m_commandPool(commandPool),
+      m_initialVertices(std::max(initialVertices, 1u)),
+      m_initialIndices(std::max(initialIndices, 1u))
+{
+    for (size_t i = 0; i < m_vertexPools.size(); ++i) {
+        auto format = static_cast<geometry::VertexFormat>(i);
+        m_vertexPools[i].elementSize = geometry::positionStreamSize(format);
+        m_vertexPools[i].attributeSize = geometry::vertexSize(format) - m_vertexPools[i].elementSize;
+        m_vertexPools[i].usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    }
+    m_indexPools[0].elementSize = sizeof(uint16_t);
+    m_indexPools[1].elementSize = sizeof(uint32_t);
+    for (Pool& pool : m_indexPools) {
+        pool.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    }
+    m_meshletPool.elementSize = sizeof(mesh::Meshlet);
+    m_meshletPool.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+}
+
+GeometryAllocation GeometryArena::allocate(geometry::VertexFormat vertexFormat, uint32_t vertexCount,
+                                           VkIndexType indexType, uint32_t indexCount, uint32_t meshletCount)
+{
+    GeometryAllocation allocation;
+    allocation.vertexFormat = vertexFormat;
+    allocation.indexType = indexType;
+    allocation.vertexCount = vertexCount;
+    allocation.indexCount = indexCount;
+    allocation.vertexOffset = allocateFrom(vertexPool(vertexFormat), vertexCount, m_initialVertices);
+    allocation.firstIndex = allocateFrom(indexPool(indexType), indexCount, m_initialIndices);
+    allocation.meshletCount = meshletCount;
+    allocation.firstMeshlet = allocateFrom(m_meshletPool, meshletCount, InitialMeshlets);
+    return allocation;
+}
+
+void GeometryArena::free(const GeometryAllocation& allocation)
+{
+    vertexPool(allocation.vertexFormat).allocator.free(allocation.vertexOffset, allocation.vertexCount);
+    indexPool(allocation.indexType).allocator.free(allocation.firstIndex, allocation.indexCount);
+    m_meshletPool.allocator.free(allocation.firstMeshlet, allocation.meshletCount);
+}
+
+void GeometryArena::upload(const GeometryAllocation& allocation, const vks::Buffer& vertexStaging,
+                           const vks::Buffer& indexStaging, const vks::Buffer* meshletStaging)
+{
+    const Pool& vertices = vertexPool(allocation.vertexFormat);
+    const Pool& indices = indexPool(allocation.indexType);
+
+    CommandBuffers::SingleTimeCommands(m_device, m_commandPool, [&](const VkCommandBuffer& commandBuffer)
+    {
+        VkBufferCopy copyRegion{};
+        if (allocation.vertexCount > 0) {
+            copyRegion.dstOffset = vertices.elementSize * allocation.vertexOffset;
+            copyRegion.size = vertices.elementSize * allocation.vertexCount;
+            vkCmdCopyBuffer(commandBuffer, vertexStaging.getBuffer(), vertices.buffer->getBuffer(), 1, &copyRegion);
+        }
+        if (allocation.vertexCount > 0 && vertices.attributeBuffer) {
+            // The attribute plane follows the positions in the staging buffer
+            copyRegion.srcOffset = vertices.elementSize * allocation.vertexCount;
+            copyRegion.dstOffset = vertices.attributeSize * allocation.vertexOffset;
+            copyRegion.size = vertices.attributeSize * allocation.vertexCount;
+            vkCmdCopyBuffer(commandBuffer, vertexStaging.getBuffer(), vertices.attributeBuffer->getBuffer(), 1,
+                            &copyRegion);
+            copyRegion.srcOffset = 0;
+        }
+        if (allocation.indexCount > 0) {
+            copyRegion.dstOffset = indices.elementSize * allocation.firstIndex;
+            copyRegion.size = indices.elementSize * allocation.indexCount;
+            vkCmdCopyBuffer(commandBuffer, indexStaging.getBuffer(), indices.buffer->getBuffer(), 1, &copyRegion);
+        }
+        if (allocation.meshletCount > 0 && meshletStaging != nullptr) {
+            copyRegion.dstOffset = m_meshletPool.elementSize * allocation.firstMeshlet;
+            copyRegion.size = m_meshletPool.elementSize * allocation.meshletCount;
+            vkCmdCopyBuffer(commandBuffer, meshletStaging->getBuffer(), m_meshletPool.buffer->getBuffer(), 1,
+                            &copyRegion);
+        }
+    });
+}
+
+VkBuffer GeometryArena::getVertexBuffer(geometry::VertexFormat vertexFormat) const
+{
+    const Pool& pool = vertexPool(vertexFormat);
+    return pool.buffer ? pool.buffer->getBuffer() : VK_NULL_HANDLE;
+}
+
+VkBuffer GeometryArena::getAttributeBuffer(geometry::VertexFormat vertexFormat) const
+{
+    const Pool& pool = vertexPool(vertexFormat);
+    return pool.attributeBuffer ? pool.attributeBuffer->getBuffer() : VK_NULL_HANDLE;
+}
+
+VkBuffer GeometryArena::getIndexBuffer(VkIndexType indexType) const
+{
+    const Pool& pool = indexPool(indexType);
+    return pool.buffer ? pool.buffer->getBuffer() : VK_NULL_HANDLE;
+}
+
+VkBuffer GeometryArena::getMeshletBuffer() const
+{
+    return m_meshletPool.buffer ? m_meshletPool.buffer->getBuffer() : VK_NULL_HANDLE;
+}
+
+VkDeviceSize GeometryArena::getCapacity() const
+{
+    VkDeviceSize capacity = m_meshletPool.elementSize * m_meshletPool.allocator.capacity();
+    for (const Pool& pool : m_vertexPools) {
+        capacity += (pool.elementSize + pool.attributeSize) * pool.allocator.capacity();
+    }
+    for (const Pool& pool : m_indexPools) {
+        capacity += pool.elementSize * pool.allocator.capacity();
+    }
+    return capacity;
+}
+
+VkDeviceSize GeometryArena::getUsed() const
+{
+    VkDeviceSize used = m_meshletPool.elementSize * m_meshletPool.allocator.used();
+    for (const Pool& pool : m_vertexPools) {
+        used += (pool.elementSize + pool.attributeSize) * pool.allocator.used();
+    }
+    for (const Pool& pool : m_indexPools) {
+        used += pool.elementSize * pool.allocator.used();
+    }
+    return used;
+}
+
+uint32_t GeometryArena::allocateFrom(Pool& pool, uint32_t count, uint32_t initialCapacity)
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint32_t offset = pool.allocator.allocate(count);
+    if (offset == RangeAllocator::InvalidOffset) {
+        // Doubling keeps the copies amortized O(1) per element; the new tail
+        // alone is large enough for the request
+        uint64_t capacity = pool.allocator.capacity();
+        uint64_t newCapacity = std::max<uint64_t>({capacity * 2, capacity + count, initialCapacity});
+        if (newCapacity > UINT32_MAX) {
+            throw std::runtime_error("Geometry arena is full!");
+        }
+        grow(pool, static_cast<uint32_t>(newCapacity));
+        offset = pool.allocator.allocate(count);
+    }
+    return offset;
+}
+
+void GeometryArena::grow(Pool& pool, uint32_t newCapacity)
+{
+    VkBufferUsageFlags usage = pool.usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    auto buffer = std::make_unique<vks::Buffer>(m_device, pool.elementSize * newCapacity, usage,
+                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    std::unique_ptr<vks::Buffer> attributeBuffer;
+    if (pool.attributeSize > 0) {
+        attributeBuffer = std::make_unique<vks::Buffer>(m_device, pool.attributeSize * newCapacity, usage,
+                                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    // The copy waits for the graphics queue to be idle, so no frame in
+    // flight still reads the old buffer when it is destroyed
+    if (pool.buffer && pool.allocator.used() > 0) {
+        CommandBuffers::SingleTimeCommands(m_device, m_commandPool, [&](const VkCommandBuffer& commandBuffer)
+        {
+            VkBufferCopy copyRegion{};
+            copyRegion.size = pool.elementSize * pool.allocator.capacity();
+            vkCmdCopyBuffer(commandBuffer, pool.buffer->getBuffer(), buffer->getBuffer(), 1, &copyRegion);
+            if (attributeBuffer) {
+                copyRegion.size = pool.attributeSize * pool.allocator.capacity();
+                vkCmdCopyBuffer(commandBuffer, pool.attributeBuffer->getBuffer(), attributeBuffer->getBuffer(), 1,
+                                &copyRegion);
+            }
+        });
+    }
+
+    pool.buffer = std::move(buffer);
+    pool.attributeBuffer = std::move(attributeBuffer);
+    pool.allocator.grow(newCapacity);
+}
+
+GeometryArena::Pool& GeometryArena::vertexPool(geometry::VertexFormat vertexFormat)
+{
+    return m_vertexPools[static_cast<size_t>(vertexFormat)];
+}
+
+const GeometryArena::Pool& GeometryArena::vertexPool(geometry::VertexFormat vertexFormat) const
+{
+    return m_vertexPools[static_cast<size_t>(vertexFormat)];
+}
+
+GeometryArena::Pool& GeometryArena::indexPool(VkIndexType indexType)
+{
+    return m_indexPools[indexType == VK_INDEX_TYPE_UINT16 ? 0 : 1];
+}
+
+const GeometryArena::Pool& GeometryArena::indexPool(VkIndexType indexType) const
+{
+    return m_indexPools[indexType == VK_INDEX_TYPE_UINT16 ? 0 : 1];
+}
@@ -0,0 +1,117 @@
+#include <vks/GeometryCache.hpp>
+
+#include <iostream>
+
+using namespace vks;
+
+GeometryCache::GeometryCache(const vks::Device& device, const vks::CommandPool& commandPool,
+                             const std::string& directory)
+    : m_device(device), m_commandPool(commandPool)
+{
+    if (!directory.empty()) {
+        m_disk = std::make_unique<mesh::MeshDiskCache>(directory);
+    }
+}
+
+Model GeometryCache::acquire(const mesh::MeshKey& key, geometry::VertexFormat vertexFormat, uint32_t optimizations,
+                             const Generator& generate)
+{
+    // The same generated mesh gives different geometry per processing
+    uint64_t processing = (uint64_t(vertexFormat) << 32) | optimizations;
+    uint64_t entryKey = key.with(processing).hash;
+
+    auto it = m_entries.find(entryKey);
+    if (it != m_entries.end()) {
+        ++m_hits;
+        return it->second.share();
+    }
+
+    Model model(vertexFormat, optimizations);
+    std::unique_ptr<mesh::MeshFile> file = m_disk ? m_disk->load(key) : nullptr;
+    if (file) {
+        model.createMesh(m_device, m_commandPool.handle(), file->view());
+    } else {
+        mesh::GeneratedMesh generated;
+        generate(generated);
+        if (m_disk && !m_disk->store(key, generated.view())) {
+            std::cerr << "Failed to write " << m_disk->path(key) << std::endl;
+        }
+        model.createMesh(m_device, m_commandPool.handle(), generated.view());
+    }
+
+    return m_entries.emplace(entryKey, std::move(model)).first->second.share();
+}
+
+Model GeometryCache::acquire(const mesh::MeshKey& key, const mesh::MeshData& mesh)
+{
+    auto it = m_entries.find(key.hash);
+    if (it != m_entries.end()) {
+        ++m_hits;
+        return it->second.share();
+    }
+
+    Model model;
+    model.loadMesh(m_device, m_commandPool.handle(), mesh);
+    return m_entries.emplace(key.hash, std::move(model)).first->second.share();
+}
+
+Model GeometryCache::sphere(float radius, uint32_t sectors, uint32_t stacks, geometry::VertexFormat vertexFormat,
+                            uint32_t optimizations)
+{
+    return acquire(mesh::MeshKey::procedural("sphere", {radius, float(sectors), float(stacks)}), vertexFormat,
+                   optimizations, [&](mesh::GeneratedMesh& generated)
+                   {
+                       geometry::createSphere(generated.vertices, generated.indices, radius, sectors, stacks);
+                       generated.bounds = {glm::vec3(0.0f), radius};
+                   });
+}
+
+Model GeometryCache::torus(float majorRadius, float minorRadius, uint32_t rings, uint32_t sides,
+                           geometry::VertexFormat vertexFormat, uint32_t optimizations)
+{
+    return acquire(mesh::MeshKey::procedural("torus", {majorRadius, minorRadius, float(rings), float(sides)}),
+                   vertexFormat, optimizations, [&](mesh::GeneratedMesh& generated)
+                   {
+                       geometry::createTorus(generated.vertices, generated.indices, majorRadius, minorRadius,
+                                             rings, sides);
+                       generated.bounds = {glm::vec3(0.0f), majorRadius + minorRadius};
+                   });
+}
+
+Model GeometryCache::sphereLods(float radius, uint32_t sectors, uint32_t stacks, uint32_t lodCount,
+                                geometry::VertexFormat vertexFormat, uint32_t optimizations)
+{
+    return acquire(mesh::MeshKey::procedural("sphereLods", {radius, float(sectors), float(stacks), float(lodCount)}),
+                   vertexFormat, optimizations, [&](mesh::GeneratedMesh& generated)
+                   {
+                       mesh::generateSphereLods(generated, radius, sectors, stacks, lodCount);
+                   });
+}
+
+Model GeometryCache::torusLods(float majorRadius, float minorRadius, uint32_t rings, uint32_t sides,
+                               uint32_t maxLods, geometry::VertexFormat vertexFormat, uint32_t optimizations)
+{
+    mesh::MeshKey key = mesh::MeshKey::procedural(
+        "torusLods", {majorRadius, minorRadius, float(rings), float(sides), float(maxLods)});
+    return acquire(key, vertexFormat, optimizations, [&](mesh::GeneratedMesh& generated)
+    {
+        std::vector<geometry::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        geometry::createTorus(vertices, indices, majorRadius, minorRadius, rings, sides);
+        mesh::generateSimplifiedLods(generated, std::move(vertices), indices, maxLods);
+    });
+}
+
+size_t GeometryCache::trim()
+{
+    size_t dropped = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.getShareCount() <= 1) {
+            it = m_entries.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
@@ -0,0 +1,98 @@
+#include <vks/GpuTimer.hpp>
+
+#include <vks/Device.hpp>
+
+#include <stdexcept>
+
+using namespace vks;
+
+// Weight of a new sample in the moving average
+static constexpr double SmoothingFactor = 0.05;
+
+GpuTimer::GpuTimer(const Device& device, uint32_t slotCount) : m_device(device) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_device.physical(), &properties);
+    m_period = properties.limits.timestampPeriod;
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_device.physical(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_device.physical(), &familyCount, families.data());
+
+    uint32_t validBits = families[m_device.queueFamilyIndices().graphicsFamily.value()].timestampValidBits;
+    if (validBits == 0) {
+        return;
+    }
+    m_validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    createQueryPool(slotCount);
+}
+
+GpuTimer::~GpuTimer() {
+    destroyQueryPool();
+}
+
+void GpuTimer::resize(uint32_t slotCount) {
+    if (!supported()) {
+        return;
+    }
+    destroyQueryPool();
+    createQueryPool(slotCount);
+}
+
+void GpuTimer::createQueryPool(uint32_t slotCount) {
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = slotCount * 2;
+
+    if (vkCreateQueryPool(m_device.logical(), &poolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+    m_pending.assign(slotCount, false);
+}
+
+void GpuTimer::destroyQueryPool() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_device.logical(), m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+    }
+    m_pending.clear();
+}
+
+void GpuTimer::collect(uint32_t slot) {
+    if (!m_pending[slot]) {
+        return;
+    }
+
+    uint64_t timestamps[2];
+    VkResult result = vkGetQueryPoolResults(m_device.logical(), m_queryPool, slot * 2, 2,
+                                            sizeof(timestamps), timestamps, sizeof(uint64_t),
+                                            VK_QUERY_RESULT_64_BIT);
+    m_pending[slot] = false;
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    uint64_t ticks = (timestamps[1] - timestamps[0]) & m_validMask;
+    m_lastMs = static_cast<double>(ticks) * m_period * 1e-6;
+    m_averageMs = m_averageMs == 0.0 ? m_lastMs : m_averageMs + (m_lastMs - m_averageMs) * SmoothingFactor;
+}
+
+void GpuTimer::begin(VkCommandBuffer cmd, uint32_t slot) {
+    if (!supported()) {
+        return;
+    }
+    collect(slot);
+
+    vkCmdResetQueryPool(cmd, m_queryPool, slot * 2, 2);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, slot * 2);
+}
+
+void GpuTimer::end(VkCommandBuffer cmd, uint32_t slot) {
+    if (!supported()) {
+        return;
+    }
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, slot * 2 + 1);
+    m_pending[slot] = true;
+}
@@ -3,6 +3,8 @@
 // Include the shader byte code
 #include <base_frag.h>
 #include <base_vert.h>
+#include <depth_frag.h>
+#include <depth_vert.h>
 #include <sphere_frag.h>
 #include <sphere_vert.h>
 
@@ -17,6 +19,7 @@
 #include <vks/RenderPass.hpp>
 #include <vks/SwapChain.hpp>
 #include <vks/Descriptors.hpp>
+#include <vks/BindlessTable.hpp>
 
 #include "vks/Geometry.hpp"
 
@@ -26,8 +29,14 @@ GraphicsPipeline::GraphicsPipeline(const Device& device,
                                    const SwapChain& swapChain,
                                    const RenderPass& renderPass)
     : m_oldLayout(VK_NULL_HANDLE),
-      m_device(device), m_swapChain(swapChain), m_renderPass(renderPass)
+      m_device(device), m_swapChain(swapChain), m_renderPass(renderPass),
+      m_colorFormat(renderPass.colorFormat())
 {
+    if (m_device.descriptorIndexing())
+    {
+        m_bindlessLayout = BindlessTable::createSetLayout(m_device);
+    }
+
     // Call the main function to create ALL pipelines
     createPipelines();
     std::cout << "Successfully created the pipeline" << std::endl;
@@ -35,10 +44,10 @@ GraphicsPipeline::GraphicsPipeline(const Device& device,
 
 GraphicsPipeline::~GraphicsPipeline()
 {
-    // Clean up all pipelines and layouts in the maps
-    for (auto& pair : m_pipelines)
+    // Clean up all pipelines and layouts in the registries
+    for (auto& variant : m_variants)
     {
-        vkDestroyPipeline(m_device.logical(), pair.second, nullptr);
+        vkDestroyPipeline(m_device.logical(), variant.pipeline, nullptr);
     }
     for (auto& pair : m_pipelineLayouts)
     {
@@ -51,15 +60,37 @@ GraphicsPipeline::~GraphicsPipeline()
 
 VkPipeline GraphicsPipeline::getPipeline(const std::string& name) const
 {
-    // Use .at() for const-correctness and bounds checking
-    try
+    auto it = m_variantIds.find({name, 0});
+    if (it == m_variantIds.end())
     {
-        return m_pipelines.at(name);
+        throw std::runtime_error("Failed to find pipeline: " + name);
     }
-    catch (const std::out_of_range& e)
+    return m_variants[it->second].pipeline;
+}
+
+VkPipeline GraphicsPipeline::getPipeline(uint32_t variantId) const
+{
+    if (variantId >= m_variants.size())
     {
-        throw std::runtime_error("Failed to find pipeline: " + name);
+        throw std::runtime_error("Failed to find pipeline variant: " + std::to_string(variantId));
     }
+    return m_variants[variantId].pipeline;
+}
+
+uint32_t GraphicsPipeline::requestVariant(const std::string& name, uint32_t features)
+{
+    auto it = m_variantIds.find({name, features});
+    if (it != m_variantIds.end())
+    {
+        return it->second;
+    }
+
+    VkPipeline pipeline = compileVariant(name, features);
+
+    uint32_t variantId = static_cast<uint32_t>(m_variants.size());
+    m_variants.push_back({name, features, pipeline});
+    m_variantIds[{name, features}] = variantId;
+    return variantId;
 }
 
 VkPipelineLayout GraphicsPipeline::getLayout(const std::string& name) const
@@ -74,230 +105,256 @@ VkPipelineLayout GraphicsPipeline::getLayout(const std::string& name) const
     }
 }
 
-Ref<DescriptorSetLayout> GraphicsPipeline::getDescriptorSetLayout(const std::string& name) const
+Ref<DescriptorSetLayout> GraphicsPipeline::getDescriptorSetLayout(const std::string& name, uint32_t set) const
+{
+    auto it = m_pipelineSetLayouts.find(name);
+    if (it == m_pipelineSetLayouts.end() || set >= it->second.size())
+    {
+        throw std::runtime_error("Failed to find descriptor set layout: " + name + ", set " + std::to_string(set));
+    }
+    return it->second[set];
+}
+
+const ShaderReflection& GraphicsPipeline::getReflection(const std::string& name) const
 {
     try
     {
-        return m_descriptorSetLayouts.at(name);
+        return m_reflections.at(name);
     }
     catch (const std::out_of_range& e)
     {
-        throw std::runtime_error("Failed to find descriptor set layout: " + name);
+        throw std::runtime_error("Failed to find shader reflection: " + name);
     }
 }
 
 void GraphicsPipeline::recreate()
 {
-    // Clean up all pipelines and layouts in the maps
-    for (auto& pair : m_pipelines)
+    // With dynamic rendering pipelines only bake the attachment formats, which
+    // a resize normally keeps
+    if (m_renderPass.dynamic() && m_renderPass.colorFormat() == m_colorFormat)
     {
-        vkDestroyPipeline(m_device.logical(), pair.second, nullptr);
+        return;
     }
-    m_pipelines.clear();
+    m_colorFormat = m_renderPass.colorFormat();
 
-    for (auto& pair : m_pipelineLayouts)
+    // Legacy pipelines reference the render pass object that was just
+    // recreated: layouts are kept and every variant compiled so far is rebuilt
+    // under the same id.
+    for (auto& variant : m_variants)
     {
-        vkDestroyPipelineLayout(m_device.logical(), pair.second, nullptr);
+        vkDestroyPipeline(m_device.logical(), variant.pipeline, nullptr);
+        variant.pipeline = compileVariant(variant.name, variant.features);
     }
-    m_pipelineLayouts.clear();
-
-    // Clean up descriptor set layouts (just clear the map)
-    m_descriptorSetLayouts.clear();
-
-    // Re-create all
-    createPipelines();
 }
 
 void GraphicsPipeline::createPipelines()
 {
-    // --- Create Shared Descriptor Set Layouts ---
-    // Use your new vks::DescriptorSetLayout::Builder
-
-    // "global" layout (Set 0) for camera UBO
-    // Matches: layout(set = 0, binding = 0) uniform CameraUBO
-    m_descriptorSetLayouts["global"] = vks::DescriptorSetLayout::Builder(m_device)
-                                       .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
-                                       .build();
-
-    // "material" layout (Set 1) for material UBO
-    // Matches: layout(set = 1, binding = 0) uniform MaterialUBO
-    m_descriptorSetLayouts["material"] = vks::DescriptorSetLayout::Builder(m_device)
-                                         .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
-                                         // .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT) // For textures later
-                                         .build();
-
-    // --- Create Individual Pipelines ---
-    createBasePipeline();
-    createSpherePipeline();
+    // Descriptor set layouts and push-constant ranges are reflected from the
+    // shaders by each recipe, see createPipelineLayout()
+    PipelineDesc base{};
+    base.vertexShader = BASE_VERT;
+    base.fragmentShader = BASE_FRAG;
+    base.frontFace = VK_FRONT_FACE_CLOCKWISE; // Original
+    registerPipeline("base", base);
+
+    PipelineDesc sphere{};
+    sphere.vertexShader = SPHERE_VERT;
+    sphere.fragmentShader = SPHERE_FRAG;
+    sphere.meshVertexInput = true;
+    sphere.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // For 3D models
+    sphere.depthTest = true;
+    sphere.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL; // Passes over its own depth pre-pass
+    registerPipeline("sphere", sphere);
+
+    // Depth-only pass of the scene models (depth pre-pass, shadow maps)
+    PipelineDesc depth{};
+    depth.vertexShader = DEPTH_VERT;
+    depth.fragmentShader = DEPTH_FRAG;
+    depth.meshVertexInput = true;
+    depth.positionOnly = true;
+    depth.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    depth.depthTest = true;
+    depth.colorWrite = false;
+    registerPipeline("depth", depth);
+
+    // Default variants, materials request their own ones
+    requestVariant("base", 0);
+    requestVariant("sphere", 0);
 }
 
-void GraphicsPipeline::createBasePipeline()
+void GraphicsPipeline::registerPipeline(const std::string& name, const PipelineDesc& desc)
 {
-    VkShaderModule vertShaderModule = createShaderModule(BASE_VERT);
-    VkShaderModule fragShaderModule = createShaderModule(BASE_FRAG);
+    ShaderReflection reflection(desc.vertexShader);
+    reflection.merge(ShaderReflection(desc.fragmentShader));
 
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
-
-    // --- No Vertex Input ---
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 0;
-    vertexInputInfo.vertexAttributeDescriptionCount = 0;
-
-    // --- Standard Config (Input Assembly, Viewport, Rasterizer, etc.) ---
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(m_swapChain.extent().width);
-    viewport.height = static_cast<float>(m_swapChain.extent().height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor = {};
-    scissor.offset = {0, 0};
-    scissor.extent = m_swapChain.extent();
+    m_pipelineLayouts[name] = createPipelineLayout(name, reflection);
+    m_recipes[name] = desc;
+}
 
-    VkPipelineViewportStateCreateInfo viewportState = {};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+Ref<DescriptorSetLayout> GraphicsPipeline::getOrCreateSetLayout(const ReflectedSet& set)
+{
+    std::vector<uint32_t> key;
+    key.reserve(set.size() * 4);
+    for (const auto& [index, binding] : set)
+    {
+        key.insert(key.end(), {index, static_cast<uint32_t>(binding.descriptorType), binding.descriptorCount,
+                               binding.stageFlags});
+    }
 
-    VkPipelineRasterizationStateCreateInfo rasterizer = {};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE; // Original
-    rasterizer.depthBiasEnable = VK_FALSE;
+    Ref<DescriptorSetLayout>& layout = m_descriptorSetLayouts[key];
+    if (!layout)
+    {
+        vks::DescriptorSetLayout::Builder builder(m_device);
+        for (const auto& [index, binding] : set)
+        {
+            builder.addBinding(index, binding.descriptorType, binding.stageFlags, binding.descriptorCount);
+        }
+        layout = builder.build();
+    }
+    return layout;
+}
 
-    VkPipelineMultisampleStateCreateInfo multisampling = {};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-    multisampling.minSampleShading = 1.0f;
+Ref<DescriptorSetLayout> GraphicsPipeline::bindlessSetLayout(const std::string& name, const ReflectedSet& set) const
+{
+    if (!m_bindlessLayout)
+    {
+        throw std::runtime_error("Pipeline needs descriptor indexing for its bindless set: " + name);
+    }
+    for (const auto& [index, binding] : set)
+    {
+        VkDescriptorType expected = index == BindlessTable::ImageBinding   ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+                                    : index == BindlessTable::SamplerBinding ? VK_DESCRIPTOR_TYPE_SAMPLER
+                                    : index == BindlessTable::BufferBinding  ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                                                                              : VK_DESCRIPTOR_TYPE_MAX_ENUM;
+        if (binding.descriptorType != expected)
+        {
+            throw std::runtime_error("Bindless set binding " + std::to_string(index) +
+                                     " does not match the BindlessTable: " + name);
+        }
+    }
+    return m_bindlessLayout;
+}
 
-    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
+VkPipelineLayout GraphicsPipeline::createPipelineLayout(const std::string& name, const ShaderReflection& reflection)
+{
+    // Sets must be contiguous in the pipeline layout, holes get an empty layout
+    uint32_t setCount = reflection.sets().empty() ? 0 : reflection.sets().rbegin()->first + 1;
 
-    VkPipelineColorBlendStateCreateInfo colorBlending = {};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
+    std::vector<Ref<DescriptorSetLayout>> layouts(setCount);
+    std::vector<VkDescriptorSetLayout> setLayouts(setCount);
+    for (uint32_t set = 0; set < setCount; ++set)
+    {
+        auto it = reflection.sets().find(set);
+        if (set == BindlessSet && it != reflection.sets().end())
+        {
+            layouts[set] = bindlessSetLayout(name, it->second);
+        }
+        else
+        {
+            ReflectedSet reflected = it != reflection.sets().end() ? it->second : ReflectedSet{};
+            // One camera set is bound for every pipeline: its bindings are visible
+            // to both stages whichever read them, so all recipes share its layout
+            if (set == GlobalSet)
+            {
+                for (auto& [index, binding] : reflected)
+                {
+                    binding.stageFlags |= VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+                }
+            }
+            layouts[set] = getOrCreateSetLayout(reflected);
+        }
+        setLayouts[set] = layouts[set]->getDescriptorSetLayout();
+    }
 
-    // --- Empty Pipeline Layout ---
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
+    pipelineLayoutInfo.setLayoutCount = setCount;
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = reflection.hasPushConstants() ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = &reflection.pushConstantRange();
 
     VkPipelineLayout pipelineLayout;
     if (vkCreatePipelineLayout(m_device.logical(), &pipelineLayoutInfo, nullptr,
                                &pipelineLayout) != VK_SUCCESS)
     {
-        throw std::runtime_error("Base Pipeline Layout creation failed");
+        throw std::runtime_error("Pipeline Layout creation failed: " + name);
     }
 
-    // --- No Depth Test ---
-    VkPipelineDepthStencilStateCreateInfo depthStencil{};
-    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_FALSE; // No depth test
-    depthStencil.depthWriteEnable = VK_FALSE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-    depthStencil.depthBoundsTestEnable = VK_FALSE;
-    depthStencil.stencilTestEnable = VK_FALSE;
-
-    // --- Create Pipeline ---
-    VkGraphicsPipelineCreateInfo pipelineInfo = {};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = &depthStencil; // No depth
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = pipelineLayout;
-    pipelineInfo.renderPass = m_renderPass.handle();
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineInfo.basePipelineIndex = -1;
+    m_reflections[name] = reflection;
+    m_pipelineSetLayouts[name] = std::move(layouts);
+    return pipelineLayout;
+}
 
-    VkPipeline pipeline;
-    if (vkCreateGraphicsPipelines(m_device.logical(), VK_NULL_HANDLE, 1,
-                                  &pipelineInfo, nullptr,
-                                  &pipeline) != VK_SUCCESS)
+VkPipeline GraphicsPipeline::compileVariant(const std::string& name, uint32_t features)
+{
+    auto recipe = m_recipes.find(name);
+    if (recipe == m_recipes.end())
     {
-        throw std::runtime_error("Base Graphics Pipeline creation failed");
+        throw std::runtime_error("Failed to find pipeline recipe: " + name);
     }
+    const PipelineDesc& desc = recipe->second;
 
-    // --- Store in map ---
-    m_pipelines["base"] = pipeline;
-    m_pipelineLayouts["base"] = pipelineLayout;
-
-    for (auto& shader : shaderStages)
+    // --- Specialization (feature bit i -> constant_id = i) ---
+    // Entries for constants a shader doesn't declare are ignored by Vulkan.
+    std::array<VkBool32, MaxFeatureBits> featureValues{};
+    std::array<VkSpecializationMapEntry, MaxFeatureBits> featureEntries{};
+    for (uint32_t bit = 0; bit < MaxFeatureBits; ++bit)
     {
-        vkDestroyShaderModule(m_device.logical(), shader.module, nullptr);
+        featureValues[bit] = (features >> bit) & 1u ? VK_TRUE : VK_FALSE;
+        featureEntries[bit].constantID = bit;
+        featureEntries[bit].offset = bit * sizeof(VkBool32);
+        featureEntries[bit].size = sizeof(VkBool32);
     }
-}
 
-void GraphicsPipeline::createSpherePipeline()
-{
-    VkShaderModule vertShaderModule = createShaderModule(SPHERE_VERT);
-    VkShaderModule fragShaderModule = createShaderModule(SPHERE_FRAG);
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = MaxFeatureBits;
+    specializationInfo.pMapEntries = featureEntries.data();
+    specializationInfo.dataSize = sizeof(featureValues);
+    specializationInfo.pData = featureValues.data();
+
+    VkShaderModule vertShaderModule = createShaderModule(desc.vertexShader);
+    VkShaderModule fragShaderModule = createShaderModule(desc.fragmentShader);
 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
     vertShaderStageInfo.module = vertShaderModule;
     vertShaderStageInfo.pName = "main";
+    vertShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
     fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     fragShaderStageInfo.module = fragShaderModule;
     fragShaderStageInfo.pName = "main";
+    fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
-    // --- Vertex Input (from vks::geometry::Vertex) ---
-    auto bindingDescription = vks::geometry::Vertex::getBindingDescription();
-    auto attributeDescriptions = vks::geometry::Vertex::getAttributeDescriptions();
+    // --- Vertex Input (from the variant's vertex format, or none) ---
+    vks::geometry::VertexFormat vertexFormat;
+    if (features & SplitVertexFeature)
+    {
+        vertexFormat = (features & CompactVertexFeature) ? vks::geometry::VertexFormat::SplitCompact
+                                                         : vks::geometry::VertexFormat::SplitFloat;
+    }
+    else
+    {
+        vertexFormat = (features & CompactVertexFeature) ? vks::geometry::VertexFormat::Compact
+                                                         : vks::geometry::VertexFormat::Float;
+    }
+    vks::geometry::VertexInputDescription vertexInput =
+        vks::geometry::getVertexInput(vertexFormat, desc.positionOnly);
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+    if (desc.meshVertexInput)
+    {
+        vertexInputInfo.vertexBindingDescriptionCount = vertexInput.bindingCount;
+        vertexInputInfo.pVertexBindingDescriptions = vertexInput.bindings.data();
+        vertexInputInfo.vertexAttributeDescriptionCount = vertexInput.attributeCount;
+        vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
+    }
 
     // --- Standard Config (Input Assembly, Viewport, Rasterizer, etc.) ---
     VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
@@ -305,24 +362,18 @@ void GraphicsPipeline::createSpherePipeline()
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(m_swapChain.extent().width);
-    viewport.height = static_cast<float>(m_swapChain.extent().height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor = {};
-    scissor.offset = {0, 0};
-    scissor.extent = m_swapChain.extent();
-
+    // Viewport and scissor are set at record time, the pipeline doesn't
+    // depend on the swapchain extent
     VkPipelineViewportStateCreateInfo viewportState = {};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+
+    std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
 
     VkPipelineRasterizationStateCreateInfo rasterizer = {};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -331,7 +382,7 @@ void GraphicsPipeline::createSpherePipeline()
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
     rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // For 3D models
+    rasterizer.frontFace = desc.frontFace;
     rasterizer.depthBiasEnable = VK_FALSE;
 
     VkPipelineMultisampleStateCreateInfo multisampling = {};
@@ -341,9 +392,9 @@ void GraphicsPipeline::createSpherePipeline()
     multisampling.minSampleShading = 1.0f;
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.colorWriteMask = desc.colorWrite
+        ? VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        : 0;
     colorBlendAttachment.blendEnable = VK_FALSE;
 
     VkPipelineColorBlendStateCreateInfo colorBlending = {};
@@ -353,46 +404,27 @@ void GraphicsPipeline::createSpherePipeline()
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
-    // --- Pipeline Layout (with UBOs and Push Constants) ---
-    // Push Constant for the model matrix
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(glm::mat4); // Assumes you use GLM for matrices
-
-    // This pipeline uses TWO descriptor sets
-    // (Set 0 = "global", Set 1 = "material")
-    std::array<VkDescriptorSetLayout, 2> setLayouts = {
-        m_descriptorSetLayouts["global"]->getDescriptorSetLayout(),
-        m_descriptorSetLayouts["material"]->getDescriptorSetLayout()
-    };
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
-    pipelineLayoutInfo.pSetLayouts = setLayouts.data(); // Use both layouts
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-
-    VkPipelineLayout pipelineLayout;
-    if (vkCreatePipelineLayout(m_device.logical(), &pipelineLayoutInfo, nullptr,
-                               &pipelineLayout) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Sphere Pipeline Layout creation failed");
-    }
-
-    // --- Enable Depth Test ---
+    // --- Depth Test ---
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_TRUE; // Enable depth testing
-    depthStencil.depthWriteEnable = VK_TRUE; // Write to the depth buffer
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS; // Fragments in front pass
+    depthStencil.depthTestEnable = desc.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = desc.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = desc.depthCompareOp;
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.stencilTestEnable = VK_FALSE;
 
+    // --- Attachments (dynamic rendering has no render pass object) ---
+    VkFormat colorFormat = m_renderPass.colorFormat();
+    VkPipelineRenderingCreateInfo renderingInfo = {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &colorFormat;
+    renderingInfo.depthAttachmentFormat = m_renderPass.depthFormat();
+
     // --- Create Pipeline ---
     VkGraphicsPipelineCreateInfo pipelineInfo = {};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = m_renderPass.dynamic() ? &renderingInfo : nullptr;
     pipelineInfo.stageCount = 2;
     pipelineInfo.pStages = shaderStages;
     pipelineInfo.pVertexInputState = &vertexInputInfo;
@@ -401,42 +433,40 @@ void GraphicsPipeline::createSpherePipeline()
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = &depthStencil; // Set depth state
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayouts.at(name);
     pipelineInfo.renderPass = m_renderPass.handle();
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
     VkPipeline pipeline;
-    if (vkCreateGraphicsPipelines(m_device.logical(), VK_NULL_HANDLE, 1,
-                                  &pipelineInfo, nullptr,
-                                  &pipeline) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Sphere Graphics Pipeline creation failed");
-    }
-
-    // --- Store in map ---
-    m_pipelines["sphere"] = pipeline;
-    m_pipelineLayouts["sphere"] = pipelineLayout;
+    VkResult result = vkCreateGraphicsPipelines(m_device.logical(), VK_NULL_HANDLE, 1,
+                                                &pipelineInfo, nullptr, &pipeline);
 
     for (auto& shader : shaderStages)
     {
         vkDestroyShaderModule(m_device.logical(), shader.module, nullptr);
     }
+
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Graphics Pipeline creation failed: " + name);
+    }
+
+    return pipeline;
 }
 
 VkShaderModule
-GraphicsPipeline::createShaderModule(const std::vector<unsigned char>& code)
+GraphicsPipeline::createShaderModule(ShaderCode code)
 {
     VkShaderModuleCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
+    createInfo.codeSize = code.sizeBytes();
 
-    // Vector class already ensures that the data is correctly aligned,
-    // so no need to manually do it
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    // The code is already made of aligned 32-bit words
+    createInfo.pCode = code.data();
 
     VkShaderModule module;
     if (vkCreateShaderModule(m_device.logical(), &createInfo, nullptr, &module) !=
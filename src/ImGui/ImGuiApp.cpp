@@ -10,7 +10,7 @@ ImGuiApp::ImGuiApp(const Instance &instance, Window &window,
     commandPool(device, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
     commandBuffers(device, renderPass, swapChain, graphicsPipeline,
                    commandPool),
-    imGuiDescriptorPool(VK_NULL_HANDLE) {
+    imGuiDescriptorPool(VK_NULL_HANDLE), colorFormat(VK_FORMAT_UNDEFINED) {
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -29,6 +29,7 @@ ImGuiApp::ImGuiApp(const Instance &instance, Window &window,
     ImGui_ImplGlfw_InitForVulkan(window.window(), true);
     ImGui_ImplVulkan_InitInfo init_info = {};
 
+    init_info.ApiVersion = m_device.apiVersion();
     init_info.Instance = instance.handle();
     init_info.PhysicalDevice = m_device.physical();
     init_info.Device = m_device.logical();
@@ -37,7 +38,18 @@ ImGuiApp::ImGuiApp(const Instance &instance, Window &window,
     init_info.DescriptorPool = imGuiDescriptorPool;
     init_info.MinImageCount = swapChain.numImages();
     init_info.ImageCount = swapChain.numImages();
-    init_info.PipelineInfoMain.RenderPass = renderPass.handle();
+    if (renderPass.dynamic()) {
+        // No render pass object, the pipeline is built for the swapchain format
+        colorFormat = renderPass.colorFormat();
+        init_info.UseDynamicRendering = true;
+        VkPipelineRenderingCreateInfo &renderingInfo =
+            init_info.PipelineInfoMain.PipelineRenderingCreateInfo;
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachmentFormats = &colorFormat;
+    } else {
+        init_info.PipelineInfoMain.RenderPass = renderPass.handle();
+    }
     init_info.PipelineInfoMain.Subpass = 0;
     init_info.PipelineInfoMain.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     ImGui_ImplVulkan_Init(&init_info);
@@ -48,24 +48,14 @@ void ImGuiCommandBuffers::recordCommandBuffers(uint32_t bufferIdx) {
   }
 
   VkClearValue clearColor = {0.0f, 0.0f, 0.0f, 1.0f};
-  VkRenderPassBeginInfo renderPassBeginInfo = {};
-  renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-  renderPassBeginInfo.renderPass = m_renderPass.handle();
-  renderPassBeginInfo.framebuffer = m_renderPass.frameBuffer(bufferIdx);
-  renderPassBeginInfo.renderArea.extent.width = m_swapChain.extent().width;
-  renderPassBeginInfo.renderArea.extent.height = m_swapChain.extent().height;
-  renderPassBeginInfo.clearValueCount = 1;
-  renderPassBeginInfo.pClearValues = &clearColor;
-
-  vkCmdBeginRenderPass(m_commandBuffers[bufferIdx], &renderPassBeginInfo,
-                       VK_SUBPASS_CONTENTS_INLINE);
+  m_renderPass.begin(m_commandBuffers[bufferIdx], bufferIdx, clearColor);
 
   // Grab and record the draw data for Dear Imgui
   ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(),
                                   m_commandBuffers[bufferIdx]);
 
   // End and submit render pass
-  vkCmdEndRenderPass(m_commandBuffers[bufferIdx]);
+  m_renderPass.end(m_commandBuffers[bufferIdx], bufferIdx);
 
   if (vkEndCommandBuffer(m_commandBuffers[bufferIdx]) != VK_SUCCESS) {
     throw std::runtime_error("Failed to record command buffers!");
@@ -9,23 +9,30 @@ using namespace vks;
 ImGuiRenderPass::ImGuiRenderPass(const Device &device,
                                  const SwapChain &swapChain)
     : RenderPass(device, swapChain) {
-  createRenderPass();
-  createFrameBuffers();
+  if (!m_dynamic) {
+    createRenderPass();
+    createFrameBuffers();
+  }
 }
 
-void ImGuiRenderPass::createRenderPass() {
-  // Create an attachment description for the render pass
+VkAttachmentDescription ImGuiRenderPass::colorAttachment() const {
   VkAttachmentDescription attachmentDescription = {};
   attachmentDescription.format = m_swapChain.imageFormat();
   attachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
-  attachmentDescription.loadOp =
-      VK_ATTACHMENT_LOAD_OP_DONT_CARE; // Need UI to be drawn on top of main
-  attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  // Need UI to be drawn on top of main, which left the image ready to present
+  attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+  attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
   attachmentDescription.finalLayout =
       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // Last pass so we want to present after
   attachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
   attachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   attachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  return attachmentDescription;
+}
+
+void ImGuiRenderPass::createRenderPass() {
+  // Create an attachment description for the render pass
+  VkAttachmentDescription attachmentDescription = colorAttachment();
 
   // Create a color attachment reference
   VkAttachmentReference attachmentReference = {};
@@ -51,7 +58,8 @@ void ImGuiRenderPass::createRenderPass() {
       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
   subpassDependency.srcAccessMask =
       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; // Wait on writes
-  subpassDependency.dstStageMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
   // Finally create the UI render pass
   VkRenderPassCreateInfo createInfo = {};
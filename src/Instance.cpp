@@ -3,6 +3,8 @@
 #include <vks/DebugUtilsMessenger.hpp>
 #include <vks/Window.hpp>
 
+#include <algorithm>
+
 using namespace vks;
 
 const std::vector<const char *> Instance::ValidationLayers = {
@@ -12,7 +14,8 @@ const std::vector<const char *> Instance::DeviceExtensions = {
 
 Instance::Instance(const char *appName, const char *engineName,
                    bool validationLayers)
-    : m_instance(VK_NULL_HANDLE), m_enableValidationLayers(validationLayers) {
+    : m_instance(VK_NULL_HANDLE), m_enableValidationLayers(validationLayers),
+      m_apiVersion(ChooseApiVersion()) {
   if (validationLayers && !CheckValidationLayerSupport()) {
     throw std::runtime_error("validation layers requested, but not available!");
   }
@@ -23,7 +26,7 @@ Instance::Instance(const char *appName, const char *engineName,
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName = engineName;
   appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  appInfo.apiVersion = m_apiVersion;
 
   VkInstanceCreateInfo createInfo{};
   createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -55,6 +58,24 @@ Instance::Instance(const char *appName, const char *engineName,
 
 Instance::~Instance() { vkDestroyInstance(m_instance, nullptr); }
 
+uint32_t Instance::ChooseApiVersion() {
+  // vkEnumerateInstanceVersion only exists on 1.1+ loaders
+  auto enumerateInstanceVersion =
+      reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+          vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion"));
+
+  uint32_t version = VK_API_VERSION_1_0;
+  if (enumerateInstanceVersion != nullptr &&
+      enumerateInstanceVersion(&version) != VK_SUCCESS) {
+    version = VK_API_VERSION_1_0;
+  }
+
+  // 1.3 is the newest version the renderer makes use of (dynamic rendering)
+  version = VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(version),
+                                VK_API_VERSION_MINOR(version), 0);
+  return std::min(version, static_cast<uint32_t>(VK_API_VERSION_1_3));
+}
+
 bool Instance::CheckValidationLayerSupport() {
   uint32_t layerCount;
   vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
@@ -0,0 +1,147 @@
+#include <vks/MappedFile.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vks {
+
+namespace {
+
+size_t pageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(m_file, &size);
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_mapping = m_size > 0 ? CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    m_data = m_mapping ? static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size > 0) {
+        m_size = static_cast<size_t>(status.st_size);
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const uint8_t*>(data);
+            // Read once, front to back: read ahead aggressively
+            madvise(data, m_size, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd); // The mapping keeps the file referenced
+#endif
+
+    if (m_data == nullptr) {
+        unmap();
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::prefetch(size_t offset, size_t size) const
+{
+    if (offset >= m_size) {
+        return;
+    }
+    static const size_t page = pageSize();
+    size_t begin = offset - offset % page; // The hints want page aligned addresses
+    size_t end = offset + std::min(size, m_size - offset);
+
+    // Starts reading the whole range at once rather than a fault at a time
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<uint8_t*>(m_data) + begin, end - begin};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise(const_cast<uint8_t*>(m_data) + begin, end - begin, MADV_WILLNEED);
+#endif
+
+    // The hint is asynchronous: touching one byte per page waits for the reads
+    const volatile uint8_t* bytes = m_data;
+    uint8_t sum = 0;
+    for (size_t i = begin; i < end; i += page) {
+        sum ^= bytes[i];
+    }
+    (void) sum;
+}
+
+void MappedFile::unmap()
+{
+#ifdef _WIN32
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+} // namespace vks
@@ -0,0 +1,112 @@
+#include <vks/MaterialBuffer.hpp>
+
+#include <vks/Device.hpp>
+#include <vks/GraphicsPipeline.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace vks;
+
+static_assert(sizeof(MaterialParams) == 32, "MaterialParams must match MaterialParams in sphere.frag");
+static_assert(MaterialBuffer::IndexOffset + sizeof(uint32_t) <= 128,
+              "The draw push constants must fit the guaranteed push constant size");
+
+MaterialBuffer::MaterialBuffer(const Device& device, const GraphicsPipeline& pipelineManager,
+                               const std::string& pipelineName, uint32_t slotCount)
+    : m_device(device) {
+    const auto& sets = pipelineManager.getReflection(pipelineName).sets();
+    auto materialSet = sets.find(GraphicsPipeline::MaterialSet);
+    if (materialSet == sets.end() || materialSet->second.size() != 1 ||
+        materialSet->second.begin()->first != 0 ||
+        materialSet->second.begin()->second.descriptorType != VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+        throw std::runtime_error("The material set must be a single storage buffer: " + pipelineName);
+    }
+    m_setLayout = pipelineManager.getDescriptorSetLayout(pipelineName, GraphicsPipeline::MaterialSet);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_device.physical(), &properties);
+    m_atomSize = std::max<VkDeviceSize>(1, properties.limits.nonCoherentAtomSize);
+
+    createSlots(slotCount);
+}
+
+void MaterialBuffer::resize(uint32_t slotCount) {
+    m_slots.clear();
+    createSlots(slotCount);
+}
+
+void MaterialBuffer::createSlots(uint32_t slotCount) {
+    m_descriptorPool = vks::DescriptorPool::Builder(m_device)
+        .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, slotCount)
+        .setMaxSets(slotCount)
+        .build();
+    m_slots.resize(slotCount);
+    m_table.resize(slotCount);
+
+    // Sets are written by upload(), once there are buffers to point to
+    for (Slot& slot : m_slots) {
+        if (!m_descriptorPool->allocateDescriptor(m_setLayout->getDescriptorSetLayout(), slot.descriptorSet)) {
+            throw std::runtime_error("failed to allocate the material descriptor sets!");
+        }
+    }
+}
+
+void MaterialBuffer::upload(uint32_t slotIndex) {
+    Slot& slot = m_slots[slotIndex];
+
+    // Ranges closer than a flush atom are flushed together
+    uint32_t gap = static_cast<uint32_t>(m_atomSize / sizeof(MaterialParams));
+    m_table.takeDirtyRanges(slotIndex, m_ranges, gap);
+
+    // Grow the slot's buffer and copy the whole table, its previous
+    // submission is done with the old one
+    if (!slot.buffer || slot.capacity < m_table.size()) {
+        slot.capacity = std::max<uint32_t>(1024, slot.capacity);
+        while (slot.capacity < m_table.size()) {
+            slot.capacity *= 2;
+        }
+        slot.buffer = std::make_unique<vks::Buffer>(
+            m_device,
+            sizeof(MaterialParams) * slot.capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        );
+        slot.buffer->map();
+
+        VkDescriptorBufferInfo bufferInfo = slot.buffer->descriptorInfo();
+        vks::DescriptorWriter(m_setLayout, m_descriptorPool)
+            .writeBuffer(0, &bufferInfo)
+            .overwrite(slot.descriptorSet);
+
+        m_ranges.clear();
+        if (m_table.size() > 0) {
+            m_ranges.push_back({0, m_table.size()});
+        }
+    }
+
+    // The memory may not be coherent: flush what was written, in whole atoms
+    m_flushes.clear();
+    char* mapped = static_cast<char*>(slot.buffer->getMappedMemory());
+    for (const MaterialTable::Range& range : m_ranges) {
+        VkDeviceSize offset = sizeof(MaterialParams) * VkDeviceSize(range.first);
+        VkDeviceSize size = sizeof(MaterialParams) * VkDeviceSize(range.count);
+        std::memcpy(mapped + offset, m_table.data() + range.first, size);
+
+        VkMappedMemoryRange flush{};
+        flush.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        flush.memory = slot.buffer->getMemory();
+        flush.offset = offset / m_atomSize * m_atomSize;
+        flush.size = (offset + size - flush.offset + m_atomSize - 1) / m_atomSize * m_atomSize;
+        if (flush.offset + flush.size > slot.buffer->getSize()) {
+            flush.size = VK_WHOLE_SIZE; // The allocation may be smaller than a whole atom past the buffer
+        }
+        m_flushes.push_back(flush);
+    }
+    if (!m_flushes.empty() &&
+        vkFlushMappedMemoryRanges(m_device.logical(), static_cast<uint32_t>(m_flushes.size()),
+                                  m_flushes.data()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to flush the material buffer!");
+    }
+}
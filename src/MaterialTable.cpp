@@ -0,0 +1,72 @@
+#include <vks/MaterialTable.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace vks {
+
+// A slot that needs the whole table
+static constexpr size_t OutOfDate = std::numeric_limits<size_t>::max();
+
+MaterialTable::MaterialTable(uint32_t slotCount)
+{
+    resize(slotCount);
+}
+
+void MaterialTable::resize(uint32_t slotCount)
+{
+    m_edits.clear();
+    m_slotEdits.assign(slotCount, OutOfDate);
+}
+
+uint32_t MaterialTable::add(const MaterialParams& params)
+{
+    m_params.push_back(params);
+    m_edits.push_back(size() - 1);
+    return size() - 1;
+}
+
+void MaterialTable::set(uint32_t index, const MaterialParams& params)
+{
+    m_params[index] = params;
+    m_edits.push_back(index);
+}
+
+void MaterialTable::takeDirtyRanges(uint32_t slot, std::vector<Range>& ranges, uint32_t gap)
+{
+    ranges.clear();
+    size_t& seen = m_slotEdits[slot];
+    if (seen == OutOfDate) {
+        if (!m_params.empty()) {
+            ranges.push_back({0, size()});
+        }
+    } else {
+        m_sorted.assign(m_edits.begin() + seen, m_edits.end());
+        std::sort(m_sorted.begin(), m_sorted.end());
+        m_sorted.erase(std::unique(m_sorted.begin(), m_sorted.end()), m_sorted.end());
+        for (uint32_t index : m_sorted) {
+            if (!ranges.empty() && index - (ranges.back().first + ranges.back().count) <= gap) {
+                ranges.back().count = index + 1 - ranges.back().first;
+            } else {
+                ranges.push_back({index, 1});
+            }
+        }
+    }
+    seen = m_edits.size();
+
+    // Drop the edits every slot has seen, new slots take the whole table anyway
+    size_t oldest = seen;
+    for (size_t edits : m_slotEdits) {
+        if (edits != OutOfDate) {
+            oldest = std::min(oldest, edits);
+        }
+    }
+    m_edits.erase(m_edits.begin(), m_edits.begin() + oldest);
+    for (size_t& edits : m_slotEdits) {
+        if (edits != OutOfDate) {
+            edits -= oldest;
+        }
+    }
+}
+
+} // namespace vks
@@ -0,0 +1,183 @@
+#include <vks/Mesh/Cook.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace vks {
+namespace mesh {
+
+namespace {
+
+constexpr uint64_t HashMultiplier = 0x9E3779B97F4A7C15ull;
+
+uint64_t mix(uint64_t h)
+{
+    // MurmurHash3 finalizer
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+struct VertexHash
+{
+    size_t operator()(const geometry::Vertex& v) const
+    {
+        return static_cast<size_t>(hashContent(&v, sizeof(v)));
+    }
+};
+
+struct VertexEqual
+{
+    bool operator()(const geometry::Vertex& a, const geometry::Vertex& b) const
+    {
+        return std::memcmp(&a, &b, sizeof(a)) == 0;
+    }
+};
+
+} // namespace
+
+void weldVertices(std::vector<geometry::Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    std::unordered_map<geometry::Vertex, uint32_t, VertexHash, VertexEqual> unique;
+    unique.reserve(vertices.size());
+
+    std::vector<geometry::Vertex> welded;
+    welded.reserve(vertices.size());
+    std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            auto inserted = unique.emplace(vertices[index], static_cast<uint32_t>(welded.size()));
+            if (inserted.second) {
+                welded.push_back(vertices[index]);
+            }
+            remap[index] = inserted.first->second;
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(welded);
+}
+
+void generateNormals(std::vector<geometry::Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+    std::vector<glm::vec3> normals(vertices.size(), glm::vec3(0.0f));
+    auto position = [&](uint32_t i) { return glm::vec3(vertices[i].pos[0], vertices[i].pos[1], vertices[i].pos[2]); };
+
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+        // Unnormalized: the length is twice the triangle area
+        glm::vec3 faceNormal = glm::cross(position(b) - position(a), position(c) - position(a));
+        normals[a] += faceNormal;
+        normals[b] += faceNormal;
+        normals[c] += faceNormal;
+    }
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        float length = glm::length(normals[i]);
+        glm::vec3 n = length > 0.0f ? normals[i] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        vertices[i].normal[0] = n.x;
+        vertices[i].normal[1] = n.y;
+        vertices[i].normal[2] = n.z;
+    }
+}
+
+uint64_t hashContent(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t h = mix(seed ^ (size * HashMultiplier));
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        h = (h ^ mix(word)) * HashMultiplier;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + i, size - i);
+    return mix(h ^ mix(tail));
+}
+
+MeshData CookedMesh::view() const
+{
+    MeshData data;
+    data.vertexFormat = vertexFormat;
+    data.indexSize = indexSize;
+    data.vertices = vertexData.data();
+    data.vertexCount = vertexCount;
+    data.indices = indexData.data();
+    data.indexCount = indexCount;
+    data.lods = lods.data();
+    data.lodCount = static_cast<uint32_t>(lods.size());
+    data.bounds = bounds;
+    data.quantization = quantization;
+    return data;
+}
+
+CookedMesh cookMesh(std::vector<geometry::Vertex> vertices, std::vector<uint32_t> indices, bool hasNormals,
+                    const CookSettings& settings)
+{
+    CookedMesh cooked;
+    cooked.vertexFormat = settings.vertexFormat;
+
+    weldVertices(vertices, indices);
+    if (!hasNormals || settings.regenerateNormals) {
+        generateNormals(vertices, indices);
+    }
+    if (vertices.empty()) {
+        return cooked;
+    }
+
+    const float* positions = vertices[0].pos;
+    cooked.bounds = computeBoundingSphere(positions, vertices.size(), sizeof(geometry::Vertex));
+
+    std::vector<uint32_t> lodIndices;
+    if (settings.maxLods > 1) {
+        cooked.lods = buildLodChain(indices, positions, vertices.size(), sizeof(geometry::Vertex), settings.maxLods,
+                                    lodIndices);
+    } else {
+        cooked.lods.push_back({0, static_cast<uint32_t>(indices.size()), 0, 0.0f});
+        lodIndices = std::move(indices);
+    }
+
+    optimizeLods(vertices.data(), vertices.size(), sizeof(geometry::Vertex), lodIndices.data(), cooked.lods.data(),
+                 cooked.lods.size(), settings.optimizations);
+
+    cooked.vertexCount = static_cast<uint32_t>(vertices.size());
+    cooked.indexCount = static_cast<uint32_t>(lodIndices.size());
+    cooked.vertexData.resize(size_t(geometry::vertexSize(settings.vertexFormat)) * vertices.size());
+    if (geometry::isCompact(settings.vertexFormat)) {
+        cooked.quantization = computeQuantization(positions, vertices.size(), sizeof(geometry::Vertex));
+        std::vector<geometry::CompactVertex> compressed(vertices.size());
+        compressVertices(vertices.data(), vertices.size(), cooked.quantization, compressed.data());
+        if (geometry::isSplit(settings.vertexFormat)) {
+            geometry::splitVertices(compressed.data(), settings.vertexFormat, compressed.size(),
+                                    cooked.vertexData.data());
+        } else {
+            std::memcpy(cooked.vertexData.data(), compressed.data(), cooked.vertexData.size());
+        }
+    } else if (geometry::isSplit(settings.vertexFormat)) {
+        geometry::splitVertices(vertices.data(), settings.vertexFormat, vertices.size(), cooked.vertexData.data());
+    } else {
+        std::memcpy(cooked.vertexData.data(), vertices.data(), cooked.vertexData.size());
+    }
+
+    // All LODs share the vertices, so every index is below the vertex count
+    cooked.indexSize = cooked.vertexCount <= 0x10000u ? sizeof(uint16_t) : sizeof(uint32_t);
+    cooked.indexData.resize(size_t(cooked.indexSize) * lodIndices.size());
+    if (cooked.indexSize == sizeof(uint16_t)) {
+        narrowIndices(lodIndices.data(), lodIndices.size(), reinterpret_cast<uint16_t*>(cooked.indexData.data()));
+    } else {
+        std::memcpy(cooked.indexData.data(), lodIndices.data(), cooked.indexData.size());
+    }
+
+    return cooked;
+}
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,310 @@
+#include <vks/Mesh/Import.hpp>
+
+#define CGLTF_IMPLEMENTATION
+#include <cgltf.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <vks/ThreadPool.hpp>
+
+namespace vks {
+namespace mesh {
+
+namespace {
+
+// Vertices decoded per task of a glTF primitive
+constexpr size_t VerticesPerTask = 16384;
+
+// (position, uv, normal) indices of an OBJ face corner, 0 when absent
+struct ObjCorner
+{
+    int32_t position = 0;
+    int32_t uv = 0;
+    int32_t normal = 0;
+
+    bool operator==(const ObjCorner& other) const
+    {
+        return position == other.position && uv == other.uv && normal == other.normal;
+    }
+};
+
+struct ObjCornerHash
+{
+    size_t operator()(const ObjCorner& c) const
+    {
+        uint64_t h = uint64_t(uint32_t(c.position)) * 0x9E3779B97F4A7C15ull;
+        h ^= uint64_t(uint32_t(c.uv)) * 0xC2B2AE3D27D4EB4Full + (h << 6);
+        h ^= uint64_t(uint32_t(c.normal)) * 0x165667B19E3779F9ull + (h >> 2);
+        return static_cast<size_t>(h);
+    }
+};
+
+// OBJ indices are 1-based, negative ones count back from the last element
+int32_t resolveObjIndex(long index, size_t count)
+{
+    long resolved = index < 0 ? long(count) + index + 1 : index;
+    if (resolved <= 0 || resolved > long(count)) {
+        throw std::runtime_error("OBJ index out of range");
+    }
+    return static_cast<int32_t>(resolved);
+}
+
+std::string extensionOf(const std::string& path)
+{
+    size_t dot = path.find_last_of('.');
+    std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+} // namespace
+
+SourceMesh importObj(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open OBJ file: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> corners;
+    std::vector<uint32_t> polygon;
+
+    SourceMesh mesh;
+    mesh.name = path;
+    mesh.hasNormals = true;
+
+    const char* cursor = text.c_str();
+    const char* end = cursor + text.size();
+    while (cursor < end) {
+        const char* lineEnd = std::find(cursor, end, '\n');
+        const char* p = cursor;
+        while (p < lineEnd && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+
+        char* next = nullptr;
+        if (p[0] == 'v' && p[1] == ' ') {
+            glm::vec3 v;
+            v.x = std::strtof(p + 2, &next);
+            v.y = std::strtof(next, &next);
+            v.z = std::strtof(next, &next);
+            positions.push_back(v);
+        } else if (p[0] == 'v' && p[1] == 't') {
+            glm::vec2 uv;
+            uv.x = std::strtof(p + 2, &next);
+            uv.y = std::strtof(next, &next);
+            uvs.push_back(uv);
+        } else if (p[0] == 'v' && p[1] == 'n') {
+            glm::vec3 n;
+            n.x = std::strtof(p + 2, &next);
+            n.y = std::strtof(next, &next);
+            n.z = std::strtof(next, &next);
+            normals.push_back(n);
+        } else if (p[0] == 'f' && p[1] == ' ') {
+            polygon.clear();
+            p += 2;
+            while (p < lineEnd) {
+                long index = std::strtol(p, &next, 10);
+                if (next == p) {
+                    break; // Trailing spaces or '\r'
+                }
+
+                ObjCorner corner;
+                corner.position = resolveObjIndex(index, positions.size());
+                p = next;
+                if (*p == '/') {
+                    ++p;
+                    if (*p != '/') {
+                        corner.uv = resolveObjIndex(std::strtol(p, &next, 10), uvs.size());
+                        p = next;
+                    }
+                    if (*p == '/') {
+                        corner.normal = resolveObjIndex(std::strtol(p + 1, &next, 10), normals.size());
+                        p = next;
+                    }
+                }
+                mesh.hasNormals = mesh.hasNormals && corner.normal != 0;
+
+                auto inserted = corners.emplace(corner, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted.second) {
+                    geometry::Vertex vertex{};
+                    const glm::vec3& position = positions[corner.position - 1];
+                    vertex.pos[0] = position.x;
+                    vertex.pos[1] = position.y;
+                    vertex.pos[2] = position.z;
+                    if (corner.normal != 0) {
+                        const glm::vec3& normal = normals[corner.normal - 1];
+                        vertex.normal[0] = normal.x;
+                        vertex.normal[1] = normal.y;
+                        vertex.normal[2] = normal.z;
+                    }
+                    if (corner.uv != 0) {
+                        vertex.uv[0] = uvs[corner.uv - 1].x;
+                        vertex.uv[1] = 1.0f - uvs[corner.uv - 1].y;
+                    }
+                    mesh.vertices.push_back(vertex);
+                }
+                polygon.push_back(inserted.first->second);
+
+                while (p < lineEnd && (*p == ' ' || *p == '\t')) {
+                    ++p;
+                }
+            }
+
+            // Triangle fan
+            for (size_t i = 2; i < polygon.size(); ++i) {
+                mesh.indices.push_back(polygon[0]);
+                mesh.indices.push_back(polygon[i - 1]);
+                mesh.indices.push_back(polygon[i]);
+            }
+        }
+
+        cursor = lineEnd + 1;
+    }
+
+    mesh.hasNormals = mesh.hasNormals && !mesh.indices.empty();
+    return mesh;
+}
+
+void importGltf(const std::string& path, const MeshCallback& onMesh)
+{
+    cgltf_options options{};
+    cgltf_data* data = nullptr;
+    if (cgltf_parse_file(&options, path.c_str(), &data) != cgltf_result_success) {
+        throw std::runtime_error("Failed to parse glTF file: " + path);
+    }
+    std::unique_ptr<cgltf_data, void (*)(cgltf_data*)> owner(data, cgltf_free);
+    if (cgltf_load_buffers(&options, data, path.c_str()) != cgltf_result_success ||
+        cgltf_validate(data) != cgltf_result_success) {
+        throw std::runtime_error("Failed to load the glTF buffers: " + path);
+    }
+
+    // Triangle primitives with positions, in file order
+    struct Primitive
+    {
+        const cgltf_primitive* primitive;
+        const cgltf_accessor* positions;
+        const cgltf_accessor* normals;
+        const cgltf_accessor* uvs;
+        std::string name;
+    };
+    std::vector<Primitive> primitives;
+    for (cgltf_size m = 0; m < data->meshes_count; ++m) {
+        const cgltf_mesh& gltfMesh = data->meshes[m];
+        for (cgltf_size p = 0; p < gltfMesh.primitives_count; ++p) {
+            const cgltf_primitive& primitive = gltfMesh.primitives[p];
+            if (primitive.type != cgltf_primitive_type_triangles) {
+                continue;
+            }
+
+            Primitive entry{&primitive, nullptr, nullptr, nullptr,
+                            (gltfMesh.name ? gltfMesh.name : "mesh" + std::to_string(m)) + "." + std::to_string(p)};
+            for (cgltf_size a = 0; a < primitive.attributes_count; ++a) {
+                const cgltf_attribute& attribute = primitive.attributes[a];
+                if (attribute.type == cgltf_attribute_type_position) {
+                    entry.positions = attribute.data;
+                } else if (attribute.type == cgltf_attribute_type_normal) {
+                    entry.normals = attribute.data;
+                } else if (attribute.type == cgltf_attribute_type_texcoord && attribute.index == 0) {
+                    entry.uvs = attribute.data;
+                }
+            }
+            if (entry.positions != nullptr) {
+                primitives.push_back(std::move(entry));
+            }
+        }
+    }
+
+    // Accessor reads only touch the loaded buffers, so they are thread-safe
+    parallelFor(0, primitives.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Primitive& entry = primitives[i];
+            SourceMesh mesh;
+            mesh.name = entry.name;
+            mesh.hasNormals = entry.normals != nullptr;
+            mesh.vertices.resize(entry.positions->count);
+
+            parallelFor(0, mesh.vertices.size(), VerticesPerTask, [&](size_t first, size_t last) {
+                for (size_t v = first; v < last; ++v) {
+                    geometry::Vertex& vertex = mesh.vertices[v];
+                    cgltf_accessor_read_float(entry.positions, v, vertex.pos, 3);
+                    if (entry.normals != nullptr) {
+                        cgltf_accessor_read_float(entry.normals, v, vertex.normal, 3);
+                    }
+                    if (entry.uvs != nullptr) {
+                        cgltf_accessor_read_float(entry.uvs, v, vertex.uv, 2);
+                    }
+                }
+            });
+
+            const cgltf_accessor* indices = entry.primitive->indices;
+            mesh.indices.resize(indices ? indices->count : entry.positions->count);
+            parallelFor(0, mesh.indices.size(), VerticesPerTask * 3, [&](size_t first, size_t last) {
+                for (size_t index = first; index < last; ++index) {
+                    mesh.indices[index] = indices ? static_cast<uint32_t>(cgltf_accessor_read_index(indices, index))
+                                                  : static_cast<uint32_t>(index);
+                }
+            });
+
+            onMesh(i, std::move(mesh));
+        }
+    });
+}
+
+std::vector<SourceMesh> importGltf(const std::string& path)
+{
+    std::vector<SourceMesh> meshes;
+    std::mutex mutex;
+    importGltf(path, [&](size_t index, SourceMesh&& mesh) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (meshes.size() <= index) {
+            meshes.resize(index + 1);
+        }
+        meshes[index] = std::move(mesh);
+    });
+    return meshes;
+}
+
+void importMeshes(const std::string& path, const MeshCallback& onMesh)
+{
+    std::string extension = extensionOf(path);
+    if (extension == "obj") {
+        onMesh(0, importObj(path));
+    } else if (extension == "gltf" || extension == "glb") {
+        importGltf(path, onMesh);
+    } else {
+        throw std::runtime_error("Unsupported mesh file type: " + path);
+    }
+}
+
+std::vector<SourceMesh> importMeshes(const std::string& path)
+{
+    std::vector<SourceMesh> meshes;
+    std::mutex mutex;
+    importMeshes(path, [&](size_t index, SourceMesh&& mesh) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (meshes.size() <= index) {
+            meshes.resize(index + 1);
+        }
+        meshes[index] = std::move(mesh);
+    });
+    return meshes;
+}
+
+} // namespace mesh
+} // namespace vks
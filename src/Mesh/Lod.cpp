@@ -0,0 +1,139 @@
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Mesh/Simplify.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace vks {
+namespace mesh {
+
+// A level must remove at least this fraction of the triangles to be kept
+static constexpr float MinLodReduction = 0.1f;
+
+// Coarser levels would not resemble the mesh anymore (relative to the radius)
+static constexpr float MaxLodError = 0.25f;
+
+BoundingSphere computeBoundingSphere(const float* positions, size_t vertexCount, size_t stride)
+{
+    BoundingSphere sphere;
+    if (vertexCount == 0) {
+        return sphere;
+    }
+
+    const char* data = reinterpret_cast<const char*>(positions);
+    auto position = [&](size_t i) {
+        glm::vec3 p;
+        std::memcpy(&p, data + i * stride, sizeof(p));
+        return p;
+    };
+
+    glm::vec3 minimum = position(0);
+    glm::vec3 maximum = minimum;
+    for (size_t i = 1; i < vertexCount; ++i) {
+        glm::vec3 p = position(i);
+        minimum = glm::min(minimum, p);
+        maximum = glm::max(maximum, p);
+    }
+
+    sphere.center = (minimum + maximum) * 0.5f;
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        glm::vec3 d = position(i) - sphere.center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+    sphere.radius = std::sqrt(radius2);
+    return sphere;
+}
+
+std::vector<MeshLod> buildLodChain(const std::vector<uint32_t>& indices, const float* positions,
+                                   size_t vertexCount, size_t stride, uint32_t maxLods,
+                                   std::vector<uint32_t>& lodIndices)
+{
+    std::vector<MeshLod> lods;
+    lodIndices.assign(indices.begin(), indices.end());
+    lods.push_back({0, static_cast<uint32_t>(indices.size()), 0, 0.0f});
+
+    float radius = computeBoundingSphere(positions, vertexCount, stride).radius;
+    float scale = radius > 0.0f ? 1.0f / radius : 0.0f;
+
+    std::vector<uint32_t> previous(indices);
+    float previousError = 0.0f;
+
+    while (lods.size() < maxLods) {
+        size_t target = (previous.size() / 3 / 2) * 3;
+        if (target == 0) {
+            break;
+        }
+
+        // Simplifying the previous level is much cheaper than the full mesh.
+        // Its error adds up with the previous ones (triangle inequality).
+        float maxError = (MaxLodError - previousError) * radius;
+        if (maxError <= 0.0f) {
+            break;
+        }
+
+        float error = 0.0f;
+        std::vector<uint32_t> simplified = simplify(previous, positions, vertexCount, stride, target, maxError,
+                                                    &error);
+        if (simplified.size() > previous.size() * (1.0f - MinLodReduction)) {
+            break;
+        }
+
+        previousError += error * scale;
+
+        MeshLod lod;
+        lod.firstIndex = static_cast<uint32_t>(lodIndices.size());
+        lod.indexCount = static_cast<uint32_t>(simplified.size());
+        lod.error = previousError;
+        lods.push_back(lod);
+
+        lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+
+    return lods;
+}
+
+float projectedRadius(float radius, float distance, float projectionScale)
+{
+    if (distance <= radius) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return radius * projectionScale / distance;
+}
+
+uint32_t selectLod(const MeshLod* lods, uint32_t lodCount, float projectedRadius, uint32_t current,
+                   float thresholdPixels, float hysteresis)
+{
+    if (lodCount == 0) {
+        return 0;
+    }
+    current = std::min(current, lodCount - 1);
+
+    auto pixels = [&](uint32_t lod) { return lods[lod].error * projectedRadius; };
+
+    // The current level is kept inside the hysteresis band
+    float enter = thresholdPixels * (1.0f - hysteresis);
+    float leave = thresholdPixels * (1.0f + hysteresis);
+
+    if (pixels(current) > leave) {
+        // Too coarse: the coarsest finer level that is good enough
+        uint32_t lod = current;
+        while (lod > 0 && pixels(lod) > thresholdPixels) {
+            --lod;
+        }
+        return lod;
+    }
+
+    // Coarser levels are only entered once they are clearly good enough
+    uint32_t lod = current;
+    while (lod + 1 < lodCount && pixels(lod + 1) <= enter) {
+        ++lod;
+    }
+    return lod;
+}
+
+} // namespace mesh
+} // namespace vks
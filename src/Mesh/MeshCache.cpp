@@ -0,0 +1,169 @@
+#include <vks/Mesh/MeshCache.hpp>
+
+#include <vks/Mesh/Cook.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace vks {
+namespace mesh {
+
+MeshData GeneratedMesh::view() const
+{
+    MeshData data;
+    data.vertexFormat = geometry::VertexFormat::Float;
+    data.indexSize = sizeof(uint32_t);
+    data.vertices = vertices.data();
+    data.vertexCount = static_cast<uint32_t>(vertices.size());
+    data.indices = indices.data();
+    data.indexCount = static_cast<uint32_t>(indices.size());
+    data.lods = lods.data();
+    data.lodCount = static_cast<uint32_t>(lods.size());
+    data.bounds = bounds;
+    return data;
+}
+
+void generateSphereLods(GeneratedMesh& mesh, float radius, uint32_t sectors, uint32_t stacks, uint32_t lodCount)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> tessellations;
+    geometry::MeshSize size;
+    mesh.lods.clear();
+
+    for (uint32_t i = 0; i < lodCount; ++i) {
+        uint32_t levelSectors = std::max(sectors >> i, 4u);
+        uint32_t levelStacks = std::max(stacks >> i, 2u);
+        if (i > 0 && levelSectors == tessellations.back().first && levelStacks == tessellations.back().second) {
+            break;
+        }
+
+        geometry::MeshSize levelSize = geometry::sphereSize(levelSectors, levelStacks);
+
+        MeshLod lod;
+        lod.firstIndex = size.indexCount;
+        lod.indexCount = levelSize.indexCount;
+        lod.vertexOffset = static_cast<int32_t>(size.vertexCount);
+        lod.error = i == 0 ? 0.0f : geometry::sphereTessellationError(levelSectors, levelStacks);
+        mesh.lods.push_back(lod);
+        tessellations.emplace_back(levelSectors, levelStacks);
+
+        size.vertexCount += levelSize.vertexCount;
+        size.indexCount += levelSize.indexCount;
+    }
+
+    mesh.vertices.resize(size.vertexCount);
+    mesh.indices.resize(size.indexCount);
+    for (size_t i = 0; i < mesh.lods.size(); ++i) {
+        geometry::writeSphere(mesh.vertices.data() + mesh.lods[i].vertexOffset,
+                              mesh.indices.data() + mesh.lods[i].firstIndex, radius, tessellations[i].first,
+                              tessellations[i].second);
+    }
+    mesh.bounds = {glm::vec3(0.0f), radius};
+}
+
+void generateSimplifiedLods(GeneratedMesh& mesh, std::vector<geometry::Vertex> vertices,
+                            const std::vector<uint32_t>& indices, uint32_t maxLods)
+{
+    mesh.lods = buildLodChain(indices, vertices[0].pos, vertices.size(), sizeof(geometry::Vertex), maxLods,
+                              mesh.indices);
+    mesh.bounds = computeBoundingSphere(vertices[0].pos, vertices.size(), sizeof(geometry::Vertex));
+    mesh.vertices = std::move(vertices);
+}
+
+MeshKey MeshKey::procedural(const std::string& generator, std::initializer_list<float> parameters)
+{
+    MeshKey key;
+    key.hash = hashContent(generator.data(), generator.size(), GeneratedMeshVersion);
+    key.hash = hashContent(parameters.begin(), parameters.size() * sizeof(float), key.hash);
+    return key;
+}
+
+MeshKey MeshKey::content(const MeshData& mesh)
+{
+    uint32_t layout[2] = {static_cast<uint32_t>(mesh.vertexFormat), mesh.indexSize};
+    float bounds[4] = {mesh.bounds.center.x, mesh.bounds.center.y, mesh.bounds.center.z, mesh.bounds.radius};
+    float quantization[4] = {mesh.quantization.offset.x, mesh.quantization.offset.y, mesh.quantization.offset.z,
+                             mesh.quantization.scale};
+
+    MeshKey key;
+    key.hash = hashContent(layout, sizeof(layout));
+    key.hash = hashContent(bounds, sizeof(bounds), key.hash);
+    key.hash = hashContent(quantization, sizeof(quantization), key.hash);
+    key.hash = hashContent(mesh.lods, sizeof(MeshLod) * mesh.lodCount, key.hash);
+    key.hash = hashContent(mesh.vertices, size_t(geometry::vertexSize(mesh.vertexFormat)) * mesh.vertexCount,
+                           key.hash);
+    key.hash = hashContent(mesh.indices, size_t(mesh.indexSize) * mesh.indexCount, key.hash);
+    return key;
+}
+
+MeshKey MeshKey::with(uint64_t value) const
+{
+    MeshKey key;
+    key.hash = hashContent(&value, sizeof(value), hash);
+    return key;
+}
+
+MeshDiskCache::MeshDiskCache(std::string directory) : m_directory(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        throw std::runtime_error("Failed to create the mesh cache directory " + m_directory + ": " +
+                                 error.message());
+    }
+}
+
+std::string MeshDiskCache::path(const MeshKey& key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.vksmesh", static_cast<unsigned long long>(key.hash));
+    return m_directory + "/" + name;
+}
+
+std::unique_ptr<MeshFile> MeshDiskCache::load(const MeshKey& key) const
+{
+    std::string file = path(key);
+    std::error_code error;
+    if (!std::filesystem::exists(file, error)) {
+        return nullptr;
+    }
+
+    try {
+        auto mesh = std::make_unique<MeshFile>(file);
+        // Only generator output is stored here
+        if (mesh->vertexFormat() != geometry::VertexFormat::Float || mesh->indexSize() != sizeof(uint32_t)) {
+            return nullptr;
+        }
+        return mesh;
+    } catch (const std::runtime_error&) {
+        return nullptr; // Truncated or from another version: regenerated and replaced
+    }
+}
+
+bool MeshDiskCache::store(const MeshKey& key, const MeshData& mesh) const
+{
+    std::string file = path(key);
+    std::string temporary = file + ".tmp" + std::to_string(std::random_device{}());
+    try {
+        writeMeshFile(temporary, mesh);
+    } catch (const std::runtime_error&) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, file, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace mesh
+} // namespace vks
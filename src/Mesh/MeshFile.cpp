@@ -0,0 +1,148 @@
+#include <vks/Mesh/MeshFile.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace vks {
+namespace mesh {
+
+namespace {
+
+uint64_t alignUp(uint64_t value)
+{
+    return (value + MeshFileAlignment - 1) & ~(MeshFileAlignment - 1);
+}
+
+// Zeros up to the next section
+void writePadding(std::ofstream& file)
+{
+    static const char zeros[MeshFileAlignment] = {};
+    uint64_t position = static_cast<uint64_t>(file.tellp());
+    file.write(zeros, static_cast<std::streamsize>(alignUp(position) - position));
+}
+
+} // namespace
+
+void writeMeshFile(const std::string& path, const MeshData& mesh)
+{
+    if (mesh.indexSize != 2 && mesh.indexSize != 4) {
+        throw std::runtime_error("Mesh file indices must be 16 or 32 bits");
+    }
+
+    uint64_t vertexSize = uint64_t(geometry::vertexSize(mesh.vertexFormat)) * mesh.vertexCount;
+    uint64_t indexSize = uint64_t(mesh.indexSize) * mesh.indexCount;
+
+    MeshFileHeader header;
+    header.vertexFormat = static_cast<uint32_t>(mesh.vertexFormat);
+    header.indexSize = mesh.indexSize;
+    header.vertexCount = mesh.vertexCount;
+    header.indexCount = mesh.indexCount;
+    header.lodCount = mesh.lodCount;
+    header.bounds[0] = mesh.bounds.center.x;
+    header.bounds[1] = mesh.bounds.center.y;
+    header.bounds[2] = mesh.bounds.center.z;
+    header.bounds[3] = mesh.bounds.radius;
+    header.quantization[0] = mesh.quantization.offset.x;
+    header.quantization[1] = mesh.quantization.offset.y;
+    header.quantization[2] = mesh.quantization.offset.z;
+    header.quantization[3] = mesh.quantization.scale;
+    header.lodTableOffset = alignUp(sizeof(MeshFileHeader));
+    header.vertexDataOffset = alignUp(header.lodTableOffset + sizeof(MeshLod) * mesh.lodCount);
+    header.indexDataOffset = alignUp(header.vertexDataOffset + vertexSize);
+    header.fileSize = header.indexDataOffset + indexSize;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to create mesh file: " + path);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(file);
+    file.write(reinterpret_cast<const char*>(mesh.lods), std::streamsize(sizeof(MeshLod) * mesh.lodCount));
+    writePadding(file);
+    file.write(static_cast<const char*>(mesh.vertices), std::streamsize(vertexSize));
+    writePadding(file);
+    file.write(static_cast<const char*>(mesh.indices), std::streamsize(indexSize));
+
+    if (!file.flush()) {
+        throw std::runtime_error("Failed to write mesh file: " + path);
+    }
+}
+
+MeshFile::MeshFile(const std::string& path)
+    : m_file(path)
+{
+    // Validate everything the accessors rely on
+    const MeshFileHeader& h = header();
+    bool valid = m_file.size() >= sizeof(MeshFileHeader) && h.magic == MeshFileMagic;
+    if (valid && h.version != MeshFileVersion) {
+        throw std::runtime_error("Unsupported mesh file version " + std::to_string(h.version) + ": " + path);
+    }
+    valid = valid && h.fileSize <= m_file.size() && (h.indexSize == 2 || h.indexSize == 4) &&
+            h.vertexFormat < geometry::VertexFormatCount &&
+            h.lodTableOffset % MeshFileAlignment == 0 && h.vertexDataOffset % MeshFileAlignment == 0 &&
+            h.indexDataOffset % MeshFileAlignment == 0 &&
+            h.lodTableOffset + sizeof(MeshLod) * uint64_t(h.lodCount) <= h.vertexDataOffset &&
+            h.vertexDataOffset + vertexDataSize() <= h.indexDataOffset &&
+            h.indexDataOffset + indexDataSize() <= h.fileSize;
+
+    for (uint32_t i = 0; valid && i < h.lodCount; ++i) {
+        const MeshLod& lod = lods()[i];
+        valid = uint64_t(lod.firstIndex) + lod.indexCount <= h.indexCount && lod.vertexOffset >= 0 &&
+                uint32_t(lod.vertexOffset) <= h.vertexCount;
+    }
+
+    if (!valid) {
+        throw std::runtime_error("Invalid mesh file: " + path);
+    }
+}
+
+BoundingSphere MeshFile::bounds() const
+{
+    const float* bounds = header().bounds;
+    return {glm::vec3(bounds[0], bounds[1], bounds[2]), bounds[3]};
+}
+
+Quantization MeshFile::quantization() const
+{
+    const float* quantization = header().quantization;
+    Quantization result;
+    result.offset = glm::vec3(quantization[0], quantization[1], quantization[2]);
+    result.scale = quantization[3];
+    return result;
+}
+
+size_t MeshFile::vertexDataSize() const
+{
+    return size_t(geometry::vertexSize(vertexFormat())) * header().vertexCount;
+}
+
+size_t MeshFile::indexDataSize() const
+{
+    return size_t(header().indexSize) * header().indexCount;
+}
+
+void MeshFile::prefetch() const
+{
+    m_file.prefetch(header().vertexDataOffset, vertexDataSize());
+    m_file.prefetch(header().indexDataOffset, indexDataSize());
+}
+
+MeshData MeshFile::view() const
+{
+    MeshData data;
+    data.vertexFormat = vertexFormat();
+    data.indexSize = indexSize();
+    data.vertices = vertexData();
+    data.vertexCount = vertexCount();
+    data.indices = indexData();
+    data.indexCount = indexCount();
+    data.lods = lods();
+    data.lodCount = lodCount();
+    data.bounds = bounds();
+    data.quantization = quantization();
+    return data;
+}
+
+} // namespace mesh
+} // namespace vks
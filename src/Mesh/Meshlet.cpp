@@ -0,0 +1,205 @@
+#include <vks/Mesh/Meshlet.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace vks {
+namespace mesh {
+
+namespace {
+
+// Narrower normal cones than this (dot of a normal with the axis) are not
+// worth testing: nearly every view would see a front face
+constexpr float MinConeDot = 0.1f;
+
+constexpr uint32_t NotInMeshlet = UINT32_MAX;
+
+Meshlet computeMeshletBounds(const uint32_t* indices, size_t indexCount, const std::vector<uint32_t>& vertices,
+                             const float* positions, size_t stride)
+{
+    const char* data = reinterpret_cast<const char*>(positions);
+    auto position = [&](uint32_t i) {
+        glm::vec3 p;
+        std::memcpy(&p, data + size_t(i) * stride, sizeof(p));
+        return p;
+    };
+
+    Meshlet meshlet;
+    meshlet.indexCount = static_cast<uint32_t>(indexCount);
+    meshlet.vertexCount = static_cast<uint32_t>(vertices.size());
+
+    std::vector<glm::vec3> points(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        points[i] = position(vertices[i]);
+    }
+    BoundingSphere sphere = computeBoundingSphere(&points[0].x, points.size(), sizeof(glm::vec3));
+    meshlet.center = sphere.center;
+    meshlet.radius = sphere.radius;
+
+    // Normal cone around the average unit normal of the triangles
+    std::vector<glm::vec3> normals;
+    normals.reserve(indexCount / 3);
+    glm::vec3 axis(0.0f);
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+        glm::vec3 a = position(indices[t]);
+        glm::vec3 normal = glm::cross(position(indices[t + 1]) - a, position(indices[t + 2]) - a);
+        float length = glm::length(normal);
+        if (length > 0.0f) {
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+    }
+
+    float axisLength = glm::length(axis);
+    if (normals.empty() || axisLength == 0.0f) {
+        return meshlet; // Cutoff 1: never culled
+    }
+    meshlet.coneAxis = axis / axisLength;
+
+    float minDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+    }
+
+    // Back-facing when the view direction is within 90 degrees minus the
+    // cone angle of the axis: cos(90 - angle) = sin(angle)
+    meshlet.coneCutoff = minDot <= MinConeDot ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    return meshlet;
+}
+
+} // namespace
+
+std::vector<Meshlet> buildMeshlets(uint32_t* indices, size_t indexCount, const float* positions,
+                                   size_t vertexCount, size_t stride)
+{
+    std::vector<Meshlet> meshlets;
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return meshlets;
+    }
+
+    // Triangles around each vertex
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++adjacencyOffsets[indices[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<bool> placed(triangleCount, false);
+    std::vector<uint32_t> slot(vertexCount, NotInMeshlet); // Position in the current meshlet
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> ordered;
+    ordered.reserve(triangleCount * 3);
+
+    auto newVertices = [&](uint32_t triangle) {
+        const uint32_t* t = indices + size_t(triangle) * 3;
+        uint32_t count = slot[t[0]] == NotInMeshlet;
+        count += slot[t[1]] == NotInMeshlet && t[1] != t[0];
+        count += slot[t[2]] == NotInMeshlet && t[2] != t[0] && t[2] != t[1];
+        return count;
+    };
+
+    size_t seed = 0;
+    while (true) {
+        while (seed < triangleCount && placed[seed]) {
+            ++seed;
+        }
+        if (seed == triangleCount) {
+            break;
+        }
+
+        size_t firstIndex = ordered.size();
+        uint32_t triangles = 0;
+        candidates.assign(1, static_cast<uint32_t>(seed));
+
+        while (triangles < MaxMeshletTriangles) {
+            // Best neighbour, dropping the candidates placed meanwhile
+            uint32_t best = NotInMeshlet;
+            uint32_t bestCost = 4;
+            size_t kept = 0;
+            for (uint32_t candidate : candidates) {
+                if (placed[candidate]) {
+                    continue;
+                }
+                candidates[kept++] = candidate;
+
+                uint32_t cost = newVertices(candidate);
+                if (cost < bestCost && meshletVertices.size() + cost <= MaxMeshletVertices) {
+                    best = candidate;
+                    bestCost = cost;
+                }
+            }
+            candidates.resize(kept);
+            if (best == NotInMeshlet) {
+                break;
+            }
+
+            placed[best] = true;
+            ++triangles;
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                uint32_t v = indices[size_t(best) * 3 + corner];
+                ordered.push_back(v);
+                if (slot[v] == NotInMeshlet) {
+                    slot[v] = static_cast<uint32_t>(meshletVertices.size());
+                    meshletVertices.push_back(v);
+                    candidates.insert(candidates.end(), adjacency.begin() + adjacencyOffsets[v],
+                                      adjacency.begin() + adjacencyOffsets[v + 1]);
+                }
+            }
+        }
+
+        Meshlet meshlet = computeMeshletBounds(ordered.data() + firstIndex, ordered.size() - firstIndex,
+                                               meshletVertices, positions, stride);
+        meshlet.firstIndex = static_cast<uint32_t>(firstIndex);
+        meshlets.push_back(meshlet);
+
+        for (uint32_t v : meshletVertices) {
+            slot[v] = NotInMeshlet;
+        }
+        meshletVertices.clear();
+    }
+
+    std::copy(ordered.begin(), ordered.end(), indices);
+    return meshlets;
+}
+
+std::vector<Meshlet> buildLodMeshlets(uint32_t* indices, const float* positions, size_t vertexCount, size_t stride,
+                                      const MeshLod* lods, size_t lodCount, std::vector<MeshletRange>& ranges)
+{
+    std::vector<Meshlet> meshlets;
+    ranges.assign(lodCount, {});
+    for (size_t i = 0; i < lodCount; ++i) {
+        const MeshLod& lod = lods[i];
+        const float* lodPositions =
+            reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + size_t(lod.vertexOffset) * stride);
+        std::vector<Meshlet> lodMeshlets = buildMeshlets(indices + lod.firstIndex, lod.indexCount, lodPositions,
+                                                         vertexCount - lod.vertexOffset, stride);
+
+        ranges[i].firstMeshlet = static_cast<uint32_t>(meshlets.size());
+        ranges[i].meshletCount = static_cast<uint32_t>(lodMeshlets.size());
+        for (Meshlet& meshlet : lodMeshlets) {
+            meshlet.firstIndex += lod.firstIndex;
+            meshlet.vertexOffset = lod.vertexOffset;
+            meshlets.push_back(meshlet);
+        }
+    }
+    return meshlets;
+}
+
+bool isMeshletBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition)
+{
+    glm::vec3 view = meshlet.center - cameraPosition;
+    return glm::dot(view, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(view) + meshlet.radius;
+}
+
+} // namespace mesh
+} // namespace vks
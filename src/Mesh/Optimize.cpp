@@ -0,0 +1,400 @@
+#include <vks/Mesh/Optimize.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace vks {
+namespace mesh {
+
+namespace {
+
+// --- Forsyth vertex scoring ---
+constexpr uint32_t CacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+constexpr uint32_t ValenceTableSize = 64;
+
+struct ScoreTables
+{
+    float cache[CacheSize];
+    float valence[ValenceTableSize];
+
+    ScoreTables()
+    {
+        for (uint32_t i = 0; i < CacheSize; ++i) {
+            // The three vertices of the last triangle get a fixed score, so the
+            // next triangle doesn't just reuse its most recent edge
+            cache[i] = i < 3 ? LastTriangleScore
+                             : std::pow(1.0f - float(i - 3) / float(CacheSize - 3), CacheDecayPower);
+        }
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i < ValenceTableSize; ++i) {
+            valence[i] = ValenceBoostScale * std::pow(float(i), -ValenceBoostPower);
+        }
+    }
+};
+
+float vertexScore(const ScoreTables& tables, int cachePosition, uint32_t remaining)
+{
+    if (remaining == 0) {
+        return -1.0f; // No triangle left: never pick it again
+    }
+
+    float score = cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f;
+    score += remaining < ValenceTableSize ? tables.valence[remaining]
+                                          : ValenceBoostScale * std::pow(float(remaining), -ValenceBoostPower);
+    return score;
+}
+
+struct Float3
+{
+    float x, y, z;
+};
+
+Float3 loadPosition(const float* positions, size_t stride, uint32_t index)
+{
+    Float3 p;
+    std::memcpy(&p, reinterpret_cast<const char*>(positions) + index * stride, sizeof(p));
+    return p;
+}
+
+} // namespace
+
+VertexCacheStatistics analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                         uint32_t cacheSize)
+{
+    VertexCacheStatistics statistics;
+    if (indexCount < 3) {
+        return statistics;
+    }
+
+    // A vertex is in the FIFO if fewer than cacheSize misses happened since it was loaded
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    std::vector<bool> used(vertexCount, false);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0;
+    size_t usedCount = 0;
+
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t v = indices[i];
+        assert(v < vertexCount);
+        if (time - timestamps[v] > cacheSize) {
+            timestamps[v] = time++;
+            ++misses;
+        }
+        if (!used[v]) {
+            used[v] = true;
+            ++usedCount;
+        }
+    }
+
+    statistics.acmr = float(misses) / float(indexCount / 3);
+    statistics.atvr = float(misses) / float(usedCount);
+    return statistics;
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    static const ScoreTables tables;
+
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    std::vector<uint32_t> input(indices, indices + triangleCount * 3);
+
+    // Vertex -> live triangles (CSR). Emitted triangles are swapped out of the
+    // [offset, offset + remaining) slice of each vertex.
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (uint32_t v : input) {
+        ++remaining[v];
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    std::partial_sum(remaining.begin(), remaining.end(), offsets.begin() + 1);
+    std::vector<uint32_t> adjacency(input.size());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < input.size(); ++i) {
+            adjacency[fill[input[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        scores[v] = vertexScore(tables, -1, remaining[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = scores[input[t * 3]] + scores[input[t * 3 + 1]] + scores[input[t * 3 + 2]];
+    }
+
+    uint32_t cache[CacheSize + 3];
+    uint32_t cacheCount = 0;
+    size_t cursor = 0; // Fallback scan position when the cache has no candidates
+
+    uint32_t best = static_cast<uint32_t>(
+        std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+
+    for (size_t output = 0; output < triangleCount; ++output) {
+        if (best == ~0u) {
+            while (emitted[cursor]) {
+                ++cursor;
+            }
+            best = static_cast<uint32_t>(cursor);
+        }
+
+        const uint32_t* tri = &input[best * 3];
+        std::memcpy(indices + output * 3, tri, 3 * sizeof(uint32_t));
+        emitted[best] = true;
+
+        for (int c = 0; c < 3; ++c) {
+            uint32_t v = tri[c];
+            uint32_t* begin = adjacency.data() + offsets[v];
+            uint32_t* end = begin + remaining[v];
+            uint32_t* it = std::find(begin, end, best);
+            std::swap(*it, *(end - 1));
+            --remaining[v];
+        }
+
+        // New cache: the triangle first, then the previous entries
+        uint32_t newCache[CacheSize + 3];
+        uint32_t newCount = 0;
+        for (int c = 0; c < 3; ++c) {
+            newCache[newCount++] = tri[c];
+        }
+        for (uint32_t i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                newCache[newCount++] = v;
+            }
+        }
+
+        // Rescore the vertices that moved (including the evicted ones) and
+        // their remaining triangles, keeping the best triangle in the cache
+        best = ~0u;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < newCount; ++i) {
+            uint32_t v = newCache[i];
+            int position = i < CacheSize ? static_cast<int>(i) : -1;
+            cachePosition[v] = position;
+
+            float score = vertexScore(tables, position, remaining[v]);
+            float delta = score - scores[v];
+            scores[v] = score;
+
+            for (uint32_t k = 0; k < remaining[v]; ++k) {
+                uint32_t t = adjacency[offsets[v] + k];
+                triangleScores[t] += delta;
+            }
+        }
+        for (uint32_t i = 0; i < std::min(newCount, CacheSize); ++i) {
+            uint32_t v = newCache[i];
+            for (uint32_t k = 0; k < remaining[v]; ++k) {
+                uint32_t t = adjacency[offsets[v] + k];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, CacheSize);
+        std::memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+    }
+}
+
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+                      size_t stride)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Hard cluster boundaries: triangles missing the (simulated) cache entirely
+    const uint32_t cacheSize = 16;
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    std::vector<size_t> clusters;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int misses = 0;
+        for (int c = 0; c < 3; ++c) {
+            uint32_t v = indices[t * 3 + c];
+            if (time - timestamps[v] > cacheSize) {
+                timestamps[v] = time++;
+                ++misses;
+            }
+        }
+        if (t == 0 || misses == 3) {
+            clusters.push_back(t);
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // Area weighted centroid of the mesh, and per cluster
+    struct Cluster
+    {
+        size_t begin, end;
+        double centroid[3];
+        double normal[3];
+        double area;
+        double sortKey;
+    };
+    std::vector<Cluster> data(clusters.size() - 1);
+    double meshCentroid[3] = {0.0, 0.0, 0.0};
+    double meshArea = 0.0;
+
+    for (size_t c = 0; c + 1 < clusters.size(); ++c) {
+        Cluster& cluster = data[c];
+        cluster = {clusters[c], clusters[c + 1], {0, 0, 0}, {0, 0, 0}, 0.0, 0.0};
+
+        for (size_t t = cluster.begin; t < cluster.end; ++t) {
+            Float3 a = loadPosition(positions, stride, indices[t * 3]);
+            Float3 b = loadPosition(positions, stride, indices[t * 3 + 1]);
+            Float3 p = loadPosition(positions, stride, indices[t * 3 + 2]);
+
+            double e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+            double e2[3] = {p.x - a.x, p.y - a.y, p.z - a.z};
+            double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                           e1[0] * e2[1] - e1[1] * e2[0]};
+            double area = 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            double center[3] = {(a.x + b.x + p.x) / 3.0, (a.y + b.y + p.y) / 3.0, (a.z + b.z + p.z) / 3.0};
+
+            for (int k = 0; k < 3; ++k) {
+                cluster.centroid[k] += center[k] * area;
+                cluster.normal[k] += n[k];
+            }
+            cluster.area += area;
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            meshCentroid[k] += cluster.centroid[k];
+        }
+        meshArea += cluster.area;
+    }
+    if (meshArea == 0.0) {
+        return;
+    }
+    for (double& k : meshCentroid) {
+        k /= meshArea;
+    }
+
+    // Clusters far out along their normal occlude the others: draw them first
+    for (Cluster& cluster : data) {
+        double length = std::sqrt(cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] +
+                                  cluster.normal[2] * cluster.normal[2]);
+        if (cluster.area == 0.0 || length == 0.0) {
+            continue;
+        }
+        for (int k = 0; k < 3; ++k) {
+            cluster.sortKey += (cluster.centroid[k] / cluster.area - meshCentroid[k]) * cluster.normal[k] / length;
+        }
+    }
+    std::stable_sort(data.begin(), data.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> input(indices, indices + triangleCount * 3);
+    size_t write = 0;
+    for (const Cluster& cluster : data) {
+        size_t count = (cluster.end - cluster.begin) * 3;
+        std::memcpy(indices + write, input.data() + cluster.begin * 3, count * sizeof(uint32_t));
+        write += count;
+    }
+}
+
+size_t optimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexSize, uint32_t* indices,
+                           size_t indexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, ~0u);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t& target = remap[indices[i]];
+        if (target == ~0u) {
+            target = next++;
+        }
+        indices[i] = target;
+    }
+    size_t used = next;
+
+    for (uint32_t& target : remap) {
+        if (target == ~0u) {
+            target = next++;
+        }
+    }
+
+    std::vector<char> input(static_cast<char*>(vertices), static_cast<char*>(vertices) + vertexCount * vertexSize);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        std::memcpy(static_cast<char*>(vertices) + remap[v] * vertexSize, input.data() + v * vertexSize, vertexSize);
+    }
+    return used;
+}
+
+void optimizeLods(void* vertices, size_t vertexCount, size_t vertexSize, uint32_t* indices, const MeshLod* lods,
+                  size_t lodCount, uint32_t optimizations)
+{
+    uint8_t* vertexData = static_cast<uint8_t*>(vertices);
+
+    // LODs own the vertices from their vertexOffset to the next level's one
+    auto vertexRangeEnd = [&](int32_t offset) {
+        size_t end = vertexCount;
+        for (size_t i = 0; i < lodCount; ++i) {
+            if (lods[i].vertexOffset > offset) {
+                end = std::min(end, static_cast<size_t>(lods[i].vertexOffset));
+            }
+        }
+        return end;
+    };
+
+    // Triangle order, per LOD
+    for (size_t i = 0; i < lodCount; ++i) {
+        const MeshLod& lod = lods[i];
+        uint32_t* lodIndices = indices + lod.firstIndex;
+        size_t lodVertexCount = vertexRangeEnd(lod.vertexOffset) - lod.vertexOffset;
+
+        if (optimizations & MeshOptimizeVertexCache) {
+            optimizeVertexCache(lodIndices, lod.indexCount, lodVertexCount);
+        }
+        if (optimizations & MeshOptimizeOverdraw) {
+            const float* positions = reinterpret_cast<const float*>(vertexData + vertexSize * lod.vertexOffset);
+            optimizeOverdraw(lodIndices, lod.indexCount, positions, lodVertexCount, vertexSize);
+        }
+    }
+
+    // Vertex order, per group of consecutive LODs sharing their vertices
+    if (optimizations & MeshOptimizeVertexFetch) {
+        for (size_t first = 0; first < lodCount;) {
+            size_t last = first;
+            while (last + 1 < lodCount && lods[last + 1].vertexOffset == lods[first].vertexOffset) {
+                ++last;
+            }
+
+            const MeshLod& lod = lods[first];
+            size_t indexCount = lods[last].firstIndex + lods[last].indexCount - lod.firstIndex;
+            size_t groupVertexCount = vertexRangeEnd(lod.vertexOffset) - lod.vertexOffset;
+            optimizeVertexFetch(vertexData + vertexSize * lod.vertexOffset, groupVertexCount, vertexSize,
+                                indices + lod.firstIndex, indexCount);
+            first = last + 1;
+        }
+    }
+}
+
+void narrowIndices(const uint32_t* indices, size_t indexCount, uint16_t* narrowed)
+{
+    for (size_t i = 0; i < indexCount; ++i) {
+        assert(indices[i] <= 0xffffu);
+        narrowed[i] = static_cast<uint16_t>(indices[i]);
+    }
+}
+
+} // namespace mesh
+} // namespace vks
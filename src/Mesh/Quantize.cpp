@@ -0,0 +1,185 @@
+#include <vks/Mesh/Quantize.hpp>
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace vks {
+namespace mesh {
+
+// Vertices per parallelFor task
+static constexpr size_t VerticesPerTask = 4096;
+
+uint16_t quantizeHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    if (exponent == 0xffu) {
+        // Inf / NaN (keep NaNs quiet and non-zero)
+        return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u | (mantissa >> 13) : 0u));
+    }
+
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1f) {
+        return static_cast<uint16_t>(sign | 0x7c00u); // Overflow
+    }
+
+    if (halfExponent <= 0) {
+        // Subnormal half (or zero): shift the implicit bit into the mantissa
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (rest > halfway || (rest == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Normal: round the 23-bit mantissa to 10 bits, a carry bumps the exponent
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fffu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float dequantizeHalf(uint16_t value)
+{
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1fu;
+    uint32_t mantissa = value & 0x3ffu;
+
+    uint32_t bits;
+    if (exponent == 0x1fu) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        // Subnormal half: exact as a float
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static int16_t quantizeSnorm16(float value)
+{
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+static uint16_t quantizeUnorm16(float value)
+{
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+static float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+void encodeOctahedral(const float normal[3], int16_t encoded[2])
+{
+    float l1 = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    float inv = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+    float x = normal[0] * inv;
+    float y = normal[1] * inv;
+
+    if (normal[2] < 0.0f) {
+        float foldedX = (1.0f - std::fabs(y)) * signNotZero(x);
+        float foldedY = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    encoded[0] = quantizeSnorm16(x);
+    encoded[1] = quantizeSnorm16(y);
+}
+
+void decodeOctahedral(const int16_t encoded[2], float normal[3])
+{
+    // Same math as octDecode() in the vertex shader
+    float x = std::max(encoded[0] / 32767.0f, -1.0f);
+    float y = std::max(encoded[1] / 32767.0f, -1.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+    float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+
+    float length = std::sqrt(x * x + y * y + z * z);
+    normal[0] = x / length;
+    normal[1] = y / length;
+    normal[2] = z / length;
+}
+
+glm::mat4 Quantization::dequantization() const
+{
+    glm::mat4 m(scale);
+    m[3] = glm::vec4(offset, 1.0f);
+    return m;
+}
+
+Quantization computeQuantization(const float* positions, size_t vertexCount, size_t stride)
+{
+    Quantization quantization;
+    if (vertexCount == 0) {
+        return quantization;
+    }
+
+    const char* data = reinterpret_cast<const char*>(positions);
+    glm::vec3 minimum(INFINITY);
+    glm::vec3 maximum(-INFINITY);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        glm::vec3 p;
+        std::memcpy(&p, data + i * stride, sizeof(p));
+        minimum = glm::min(minimum, p);
+        maximum = glm::max(maximum, p);
+    }
+
+    glm::vec3 extent = maximum - minimum;
+    float scale = std::max(extent.x, std::max(extent.y, extent.z));
+
+    quantization.offset = minimum;
+    quantization.scale = scale > 0.0f ? scale : 1.0f;
+    return quantization;
+}
+
+void compressVertices(const geometry::Vertex* vertices, size_t vertexCount, const Quantization& quantization,
+                      geometry::CompactVertex* compressed)
+{
+    const float invScale = 1.0f / quantization.scale;
+    const glm::vec3 offset = quantization.offset;
+
+    parallelFor(0, vertexCount, VerticesPerTask, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const geometry::Vertex& v = vertices[i];
+            geometry::CompactVertex& c = compressed[i];
+
+            for (int axis = 0; axis < 3; ++axis) {
+                c.pos[axis] = quantizeUnorm16((v.pos[axis] - offset[axis]) * invScale);
+            }
+            c.pos[3] = 0;
+
+            encodeOctahedral(v.normal, c.normal);
+            c.uv[0] = quantizeHalf(v.uv[0]);
+            c.uv[1] = quantizeHalf(v.uv[1]);
+        }
+    });
+}
+
+} // namespace mesh
+} // namespace vks
@@ -0,0 +1,282 @@
+#include <vks/Mesh/Simplify.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace vks {
+namespace mesh {
+
+namespace {
+
+struct Vec3
+{
+    double x, y, z;
+};
+
+Vec3 sub(const Vec3& a, const Vec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+Vec3 cross(const Vec3& a, const Vec3& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+double dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+// Symmetric 4x4 plane quadric, weighted by the triangle areas it was built from
+struct Quadric
+{
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+    double weight = 0;
+
+    void addPlane(const Vec3& n, double d, double w)
+    {
+        a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+        b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+        c2 += w * n.z * n.z; cd += w * n.z * d;
+        d2 += w * d * d;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& q)
+    {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        weight += q.weight;
+        return *this;
+    }
+
+    // Area-weighted sum of squared distances to the planes
+    double evaluate(const Vec3& p) const
+    {
+        double r = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z + d2 +
+                   2.0 * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z + ad * p.x + bd * p.y + cd * p.z);
+        return std::max(r, 0.0);
+    }
+};
+
+struct Collapse
+{
+    uint32_t from;
+    uint32_t to;
+    double error; // Squared distance
+};
+
+std::vector<Vec3> loadPositions(const float* positions, size_t vertexCount, size_t stride)
+{
+    std::vector<Vec3> result(vertexCount);
+    const char* data = reinterpret_cast<const char*>(positions);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        float p[3];
+        std::memcpy(p, data + i * stride, sizeof(p));
+        result[i] = {p[0], p[1], p[2]};
+    }
+    return result;
+}
+
+// Locks vertices on open edges and vertices sharing their position with another one
+std::vector<bool> findLockedVertices(const std::vector<uint32_t>& indices, const std::vector<Vec3>& positions)
+{
+    size_t vertexCount = positions.size();
+    std::vector<bool> locked(vertexCount, false);
+
+    // An undirected edge used by exactly one triangle is a border (or a seam)
+    std::vector<uint64_t> edges;
+    edges.reserve(indices.size());
+    for (size_t t = 0; t < indices.size(); t += 3) {
+        for (int e = 0; e < 3; ++e) {
+            uint32_t a = indices[t + e];
+            uint32_t b = indices[t + (e + 1) % 3];
+            edges.push_back((uint64_t(std::min(a, b)) << 32) | std::max(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j] == edges[i]) {
+            ++j;
+        }
+        if (j - i == 1) {
+            locked[edges[i] >> 32] = true;
+            locked[edges[i] & 0xffffffffu] = true;
+        }
+        i = j;
+    }
+
+    // Attribute seams: split vertices must move together, keep them in place
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0u);
+    auto less = [&](uint32_t a, uint32_t b) {
+        const Vec3& p = positions[a];
+        const Vec3& q = positions[b];
+        return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+    };
+    std::sort(order.begin(), order.end(), less);
+    for (size_t i = 1; i < vertexCount; ++i) {
+        if (!less(order[i - 1], order[i])) {
+            locked[order[i - 1]] = true;
+            locked[order[i]] = true;
+        }
+    }
+
+    return locked;
+}
+
+// Whether replacing `from` by `to` flips or collapses one of the triangles kept around `from`
+bool flipsTriangle(const std::vector<uint32_t>& indices, const uint32_t* triangles, const uint32_t* trianglesEnd,
+                   const std::vector<Vec3>& positions, uint32_t from, uint32_t to)
+{
+    for (const uint32_t* t = triangles; t != trianglesEnd; ++t) {
+        const uint32_t* tri = &indices[*t * 3];
+        if (tri[0] == to || tri[1] == to || tri[2] == to) {
+            continue; // Removed by the collapse
+        }
+
+        int corner = tri[0] == from ? 0 : tri[1] == from ? 1 : 2;
+        const Vec3& b = positions[tri[(corner + 1) % 3]];
+        const Vec3& c = positions[tri[(corner + 2) % 3]];
+
+        Vec3 before = cross(sub(b, positions[from]), sub(c, positions[from]));
+        Vec3 after = cross(sub(b, positions[to]), sub(c, positions[to]));
+        if (dot(before, after) <= 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, const float* positions, size_t vertexCount,
+                               size_t stride, size_t targetIndexCount, float maxError, float* resultError)
+{
+    std::vector<uint32_t> result(indices);
+    double maxSquaredError = double(maxError) * double(maxError);
+    double reachedError = 0.0;
+
+    std::vector<Vec3> points = loadPositions(positions, vertexCount, stride);
+    std::vector<bool> locked = findLockedVertices(result, points);
+
+    // Each vertex starts with the planes of its triangles
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < result.size(); t += 3) {
+        const Vec3& p0 = points[result[t]];
+        Vec3 n = cross(sub(points[result[t + 1]], p0), sub(points[result[t + 2]], p0));
+        double length = std::sqrt(dot(n, n));
+        if (length == 0.0) {
+            continue;
+        }
+
+        n = {n.x / length, n.y / length, n.z / length};
+        double area = length * 0.5;
+        for (int c = 0; c < 3; ++c) {
+            quadrics[result[t + c]].addPlane(n, -dot(n, p0), area);
+        }
+    }
+
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+    std::vector<uint32_t> vertexTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+
+    // Collapses are done in passes: the cheapest non-overlapping edges first,
+    // then degenerate triangles are removed and the adjacency rebuilt
+    while (result.size() > targetIndexCount) {
+        // Vertex -> triangles adjacency (CSR)
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0u);
+        for (uint32_t index : result) {
+            ++triangleOffsets[index + 1];
+        }
+        std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(), triangleOffsets.begin());
+        vertexTriangles.resize(result.size());
+        std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (size_t i = 0; i < result.size(); ++i) {
+            vertexTriangles[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Candidate collapses along every edge, from an unlocked vertex
+        collapses.clear();
+        for (size_t t = 0; t < result.size(); t += 3) {
+            for (int e = 0; e < 3; ++e) {
+                uint32_t a = result[t + e];
+                uint32_t b = result[t + (e + 1) % 3];
+                for (int dir = 0; dir < 2; ++dir, std::swap(a, b)) {
+                    if (locked[a]) {
+                        continue;
+                    }
+                    Quadric q = quadrics[a];
+                    q += quadrics[b];
+                    double error = q.weight > 0.0 ? q.evaluate(points[b]) / q.weight : 0.0;
+                    collapses.push_back({a, b, error});
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(touched.begin(), touched.end(), false);
+
+        size_t triangleCount = result.size() / 3;
+        size_t targetTriangles = targetIndexCount / 3;
+        size_t collapsed = 0;
+
+        for (const Collapse& c : collapses) {
+            if (triangleCount <= targetTriangles || c.error > maxSquaredError) {
+                break;
+            }
+            if (touched[c.from] || touched[c.to]) {
+                continue;
+            }
+
+            const uint32_t* around = vertexTriangles.data() + triangleOffsets[c.from];
+            const uint32_t* aroundEnd = vertexTriangles.data() + triangleOffsets[c.from + 1];
+            if (flipsTriangle(result, around, aroundEnd, points, c.from, c.to)) {
+                continue;
+            }
+
+            // The one-ring of `from` changes: keep it out of this pass
+            for (const uint32_t* t = around; t != aroundEnd; ++t) {
+                const uint32_t* tri = &result[*t * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+                    --triangleCount;
+                }
+            }
+
+            remap[c.from] = c.to;
+            quadrics[c.to] += quadrics[c.from];
+            reachedError = std::max(reachedError, c.error);
+            ++collapsed;
+        }
+
+        if (collapsed == 0) {
+            break;
+        }
+
+        // Apply the collapses and drop the triangles that became degenerate
+        size_t write = 0;
+        for (size_t t = 0; t < result.size(); t += 3) {
+            uint32_t a = remap[result[t]], b = remap[result[t + 1]], c = remap[result[t + 2]];
+            if (a != b && b != c && c != a) {
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+        }
+        result.resize(write);
+    }
+
+    if (resultError != nullptr) {
+        *resultError = static_cast<float>(std::sqrt(reachedError));
+    }
+    return result;
+}
+
+} // namespace mesh
+} // namespace vks
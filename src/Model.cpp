@@ -3,8 +3,97 @@
 #include "vks/Application.hpp"
 #include "vks/CommandBuffers.hpp"
 #include "vks/Basic/BasicCommandBuffers.hpp"
+#include "vks/GraphicsPipeline.hpp"
+#include "vks/Mesh/MeshFile.hpp"
+#include "vks/Mesh/Optimize.hpp"
+#include "vks/Mesh/Quantize.hpp"
+#include "vks/Mesh/Simplify.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
 using namespace vks;
 
+Model::~Model()
+{
+    release();
+}
+
+Model::Model(Model&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+Model& Model::operator=(Model&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_geometry = std::move(other.m_geometry);
+        m_vertexCount = other.m_vertexCount;
+        m_indexCount = other.m_indexCount;
+        m_vertexFormat = other.m_vertexFormat;
+        m_optimizations = other.m_optimizations;
+        m_indexType = other.m_indexType;
+        m_dequantization = other.m_dequantization;
+        m_lods = std::move(other.m_lods);
+        m_bounds = other.m_bounds;
+        m_meshlets = std::move(other.m_meshlets);
+        m_meshletLods = std::move(other.m_meshletLods);
+    }
+    return *this;
+}
+
+void Model::release()
+{
+    m_geometry.reset();
+    m_meshlets.clear();
+    m_meshletLods.clear();
+}
+
+Model Model::share() const
+{
+    Model model(m_vertexFormat, m_optimizations);
+    model.m_geometry = m_geometry;
+    model.m_vertexCount = m_vertexCount;
+    model.m_indexCount = m_indexCount;
+    model.m_indexType = m_indexType;
+    model.m_dequantization = m_dequantization;
+    model.m_lods = m_lods;
+    model.m_bounds = m_bounds;
+    model.m_meshletLods = m_meshletLods;
+    return model;
+}
+
+const GeometryAllocation& Model::getAllocation() const
+{
+    static const GeometryAllocation empty;
+    return m_geometry ? *m_geometry : empty;
+}
+
+mesh::MeshletRange Model::getMeshlets(uint32_t lod) const
+{
+    if (lod >= m_meshletLods.size() || m_geometry == nullptr) {
+        return {};
+    }
+    mesh::MeshletRange range = m_meshletLods[lod];
+    range.firstMeshlet += m_geometry->firstMeshlet;
+    return range;
+}
+
+uint32_t Model::getVariantFeatures() const
+{
+    uint32_t features = 0;
+    if (isQuantized()) {
+        features |= GraphicsPipeline::CompactVertexFeature;
+    }
+    if (hasSplitStreams()) {
+        features |= GraphicsPipeline::SplitVertexFeature;
+    }
+    return features;
+}
+
 void Model::createSphere(
     const vks::Device& device,
     VkCommandPool commandPool,
@@ -12,72 +101,270 @@ void Model::createSphere(
     uint32_t sectors,
     uint32_t stacks)
 {
-    // 1. Generate the data on the CPU
-    std::vector<vks::geometry::Vertex> vertices;
-    std::vector<uint32_t> indices;
-    vks::geometry::createSphere(vertices, indices, radius, sectors, stacks);
+    createGeometry(device, commandPool, geometry::sphereSize(sectors, stacks),
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            geometry::writeSphere(vertices, indices, radius, sectors, stacks);
+        },
+        {glm::vec3(0.0f), radius});
+}
 
-    m_vertexCount = static_cast<uint32_t>(vertices.size());
-    m_indexCount = static_cast<uint32_t>(indices.size());
+void Model::createIcosphere(const vks::Device& device, VkCommandPool commandPool,
+                            float radius, uint32_t frequency)
+{
+    createGeometry(device, commandPool, geometry::icosphereSize(frequency),
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            geometry::writeIcosphere(vertices, indices, radius, frequency);
+        },
+        {glm::vec3(0.0f), radius});
+}
 
-    // 2. Upload vertex data to the GPU
-    VkDeviceSize vertexBufferSize = sizeof(vertices[0]) * m_vertexCount;
-    createBufferFromData(
-        device,
-        commandPool,
-        vertices.data(),
-        vertexBufferSize,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        m_vertexBuffer);
+void Model::createCubeSphere(const vks::Device& device, VkCommandPool commandPool,
+                             float radius, uint32_t divisions)
+{
+    createGeometry(device, commandPool, geometry::cubeSphereSize(divisions),
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            geometry::writeCubeSphere(vertices, indices, radius, divisions);
+        },
+        {glm::vec3(0.0f), radius});
+}
 
-    // 3. Upload index data to the GPU
-    VkDeviceSize indexBufferSize = sizeof(indices[0]) * m_indexCount;
-    createBufferFromData(
-        device,
-        commandPool,
-        indices.data(),
-        indexBufferSize,
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        m_indexBuffer);
+void Model::createPlane(const vks::Device& device, VkCommandPool commandPool,
+                        float width, float height, uint32_t xSegments, uint32_t ySegments)
+{
+    createGeometry(device, commandPool, geometry::planeSize(xSegments, ySegments),
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            geometry::writePlane(vertices, indices, width, height, xSegments, ySegments);
+        },
+        {glm::vec3(0.0f), 0.5f * std::sqrt(width * width + height * height)});
+}
+
+void Model::createTorus(const vks::Device& device, VkCommandPool commandPool,
+                        float majorRadius, float minorRadius, uint32_t rings, uint32_t sides)
+{
+    createGeometry(device, commandPool, geometry::torusSize(rings, sides),
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            geometry::writeTorus(vertices, indices, majorRadius, minorRadius, rings, sides);
+        },
+        {glm::vec3(0.0f), majorRadius + minorRadius});
+}
+
+void Model::createCylinder(const vks::Device& device, VkCommandPool commandPool,
+                           float radius, float height, uint32_t sectors, uint32_t stacks)
+{
+    createGeometry(device, commandPool, geometry::cylinderSize(sectors, stacks),
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            geometry::writeCylinder(vertices, indices, radius, height, sectors, stacks);
+        },
+        {glm::vec3(0.0f), std::sqrt(radius * radius + 0.25f * height * height)});
+}
+
+void Model::createSphereLods(const vks::Device& device, VkCommandPool commandPool,
+                             float radius, uint32_t sectors, uint32_t stacks, uint32_t lodCount)
+{
+    mesh::GeneratedMesh generated;
+    mesh::generateSphereLods(generated, radius, sectors, stacks, lodCount);
+    createMesh(device, commandPool, generated.view());
 }
 
-void Model::createBufferFromData(
+void Model::createSimplifiedLods(const vks::Device& device, VkCommandPool commandPool,
+                                 const std::vector<vks::geometry::Vertex>& vertices,
+                                 const std::vector<uint32_t>& indices, uint32_t maxLods)
+{
+    mesh::GeneratedMesh generated;
+    mesh::generateSimplifiedLods(generated, vertices, indices, maxLods);
+    createMesh(device, commandPool, generated.view());
+}
+
+void Model::createMesh(const vks::Device& device, VkCommandPool commandPool, const mesh::MeshData& mesh)
+{
+    if (mesh.vertexFormat != geometry::VertexFormat::Float || mesh.indexSize != sizeof(uint32_t)) {
+        throw std::runtime_error("Model::createMesh expects float vertices and 32-bit indices");
+    }
+
+    geometry::MeshSize size;
+    size.vertexCount = mesh.vertexCount;
+    size.indexCount = mesh.indexCount;
+
+    createGeometry(device, commandPool, size,
+        [&](geometry::Vertex* vertices, uint32_t* indices)
+        {
+            std::memcpy(vertices, mesh.vertices, size_t(mesh.vertexCount) * sizeof(geometry::Vertex));
+            std::memcpy(indices, mesh.indices, size_t(mesh.indexCount) * sizeof(uint32_t));
+        },
+        mesh.bounds, std::vector<mesh::MeshLod>(mesh.lods, mesh.lods + mesh.lodCount));
+}
+
+void Model::createGeometry(
     const vks::Device& device,
     VkCommandPool commandPool,
-    void* data,
-    VkDeviceSize size,
-    VkBufferUsageFlags usage,
-    std::unique_ptr<vks::Buffer>& outBuffer)
-{
-    // 1. Create a "staging" buffer on the CPU
-    // This is a temporary buffer that's host-visible (mappable)
-    vks::Buffer stagingBuffer{
+    vks::geometry::MeshSize size,
+    const GeometryWriter& writer,
+    const vks::mesh::BoundingSphere& bounds,
+    std::vector<vks::mesh::MeshLod> lods)
+{
+    release();
+    m_vertexCount = size.vertexCount;
+    m_indexCount = size.indexCount;
+
+    if (lods.empty()) {
+        lods.push_back({0, size.indexCount, 0, 0.0f});
+    }
+    m_lods = std::move(lods);
+    m_bounds = bounds;
+
+    // Indices are relative to the LOD's vertexOffset, so they never exceed the vertex count
+    m_indexType = m_vertexCount <= 0x10000u ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    m_dequantization = glm::mat4(1.0f);
+
+    uploadGeometry(device, [&](void* vertexData, void* indexData)
+    {
+        if (m_vertexFormat == geometry::VertexFormat::Float && m_optimizations == 0 &&
+            m_indexType == VK_INDEX_TYPE_UINT32) {
+            // Nothing to process: write straight into the staging buffers
+            writer(static_cast<geometry::Vertex*>(vertexData), static_cast<uint32_t*>(indexData));
+            return;
+        }
+
+        std::vector<geometry::Vertex> vertices(m_vertexCount);
+        std::vector<uint32_t> indices(m_indexCount);
+        writer(vertices.data(), indices.data());
+        mesh::optimizeLods(vertices.data(), vertices.size(), sizeof(geometry::Vertex), indices.data(),
+                           m_lods.data(), m_lods.size(), m_optimizations);
+        if (m_optimizations & ModelOptimizeMeshlets) {
+            // Bounds from the float positions, before quantization
+            m_meshlets = mesh::buildLodMeshlets(indices.data(), vertices[0].pos, vertices.size(),
+                                                sizeof(geometry::Vertex), m_lods.data(), m_lods.size(),
+                                                m_meshletLods);
+        }
+
+        if (isQuantized()) {
+            mesh::Quantization quantization =
+                mesh::computeQuantization(vertices[0].pos, vertices.size(), sizeof(geometry::Vertex));
+            m_dequantization = quantization.dequantization();
+            if (hasSplitStreams()) {
+                std::vector<geometry::CompactVertex> compressed(vertices.size());
+                mesh::compressVertices(vertices.data(), vertices.size(), quantization, compressed.data());
+                geometry::splitVertices(compressed.data(), m_vertexFormat, compressed.size(), vertexData);
+            } else {
+                mesh::compressVertices(vertices.data(), vertices.size(), quantization,
+                                       static_cast<geometry::CompactVertex*>(vertexData));
+            }
+        } else if (hasSplitStreams()) {
+            geometry::splitVertices(vertices.data(), m_vertexFormat, vertices.size(), vertexData);
+        } else {
+            std::memcpy(vertexData, vertices.data(), vertices.size() * sizeof(geometry::Vertex));
+        }
+
+        if (m_indexType == VK_INDEX_TYPE_UINT16) {
+            mesh::narrowIndices(indices.data(), indices.size(), static_cast<uint16_t*>(indexData));
+        } else {
+            std::memcpy(indexData, indices.data(), indices.size() * sizeof(uint32_t));
+        }
+    });
+}
+
+void Model::loadMesh(const vks::Device& device, VkCommandPool commandPool, const std::string& path)
+{
+    loadMesh(device, commandPool, mesh::MeshFile(path));
+}
+
+void Model::loadMesh(const vks::Device& device, VkCommandPool commandPool, const mesh::MeshFile& file)
+{
+    // Straight from the page cache to the staging memory
+    loadMesh(device, commandPool, file.view());
+}
+
+void Model::loadMesh(const vks::Device& device, VkCommandPool commandPool, const mesh::MeshData& mesh)
+{
+    release();
+
+    // The mesh decides the layout, it is already processed
+    m_vertexFormat = mesh.vertexFormat;
+    m_indexType = mesh.indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    m_vertexCount = mesh.vertexCount;
+    m_indexCount = mesh.indexCount;
+    m_lods.assign(mesh.lods, mesh.lods + mesh.lodCount);
+    if (m_lods.empty()) {
+        m_lods.push_back({0, m_indexCount, 0, 0.0f});
+    }
+    m_bounds = mesh.bounds;
+    m_dequantization = isQuantized() ? mesh.quantization.dequantization() : glm::mat4(1.0f);
+
+    uploadGeometry(device, [&](void* vertexData, void* indexData)
+    {
+        std::memcpy(vertexData, mesh.vertices, size_t(geometry::vertexSize(m_vertexFormat)) * m_vertexCount);
+        std::memcpy(indexData, mesh.indices, size_t(mesh.indexSize) * m_indexCount);
+    });
+}
+
+void Model::uploadGeometry(const vks::Device& device, const StagingWriter& writer)
+{
+    VkDeviceSize indexSize = m_indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    VkDeviceSize vertexBufferSize = VkDeviceSize(geometry::vertexSize(m_vertexFormat)) * m_vertexCount;
+    VkDeviceSize indexBufferSize = indexSize * m_indexCount;
+
+    // 1. Create the "staging" buffers on the CPU
+    // These are temporary buffers that are host-visible (mappable)
+    vks::Buffer vertexStaging{
         device,
-        size,
+        vertexBufferSize,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT, // It's a "source" for a transfer
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     };
+    vks::Buffer indexStaging{
+        device,
+        indexBufferSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
 
-    // 2. Map and copy data to the staging buffer
-    stagingBuffer.map();
-    stagingBuffer.writeToBuffer(data);
-    stagingBuffer.unmap();
+    // 2. Fill the mapped memory
+    vertexStaging.map();
+    indexStaging.map();
+    writer(vertexStaging.getMappedMemory(), indexStaging.getMappedMemory());
+    vertexStaging.unmap();
+    indexStaging.unmap();
 
-    // 3. Create the final "device" buffer
-    // This buffer is DEVICE_LOCAL (fast GPU memory) but not host-visible
-    outBuffer = std::make_unique<vks::Buffer>(
-        device,
-        size,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, // It's a "destination" AND its final usage
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-    );
+    // 3. Reserve the model's ranges in the shared buffers and copy the data
+    GeometryArena* arena = &Application::getInstance().getGeometryArena();
+    m_geometry = std::shared_ptr<const GeometryAllocation>(
+        new GeometryAllocation(arena->allocate(m_vertexFormat, m_vertexCount, m_indexType, m_indexCount,
+                                               static_cast<uint32_t>(m_meshlets.size()))),
+        [arena](const GeometryAllocation* allocation)
+        {
+            arena->free(*allocation);
+            delete allocation;
+        });
+    const GeometryAllocation& allocation = *m_geometry;
 
-    CommandBuffers::SingleTimeCommands(device, Application::getInstance().getCommandPool(), [&](const VkCommandBuffer& commandBuffer)
-    {
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        copyRegion.size = size;
-        vkCmdCopyBuffer(commandBuffer, stagingBuffer.getBuffer(), outBuffer->getBuffer(), 1, &copyRegion);
-    });
-}
\ No newline at end of file
+    std::unique_ptr<vks::Buffer> meshletStaging;
+    if (!m_meshlets.empty()) {
+        for (mesh::Meshlet& meshlet : m_meshlets) {
+            meshlet.firstIndex += allocation.firstIndex;
+            meshlet.vertexOffset += static_cast<int32_t>(allocation.vertexOffset);
+        }
+        meshletStaging = std::make_unique<vks::Buffer>(
+            device,
+            sizeof(mesh::Meshlet) * m_meshlets.size(),
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        meshletStaging->map();
+        meshletStaging->writeToBuffer(m_meshlets.data());
+        meshletStaging->unmap();
+    }
+    arena->upload(allocation, vertexStaging, indexStaging, meshletStaging.get());
+    m_meshlets = {};
+
+    // 4. Draw ranges relative to the arena buffers
+    for (mesh::MeshLod& lod : m_lods) {
+        lod.firstIndex += allocation.firstIndex;
+        lod.vertexOffset += static_cast<int32_t>(allocation.vertexOffset);
+    }
+}
@@ -0,0 +1,163 @@
+#include <vks/ModelLoader.hpp>
+
+#include <vks/Mesh/Import.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+
+using namespace vks;
+
+namespace
+{
+    bool hasExtension(const std::string& path, const std::string& extension)
+    {
+        return path.size() >= extension.size() &&
+               std::equal(extension.rbegin(), extension.rend(), path.rbegin(),
+                          [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+    }
+}
+
+struct ModelLoader::State
+{
+    // A mesh in GPU layout, either cooked in memory or mapped from its file
+    struct ReadyMesh
+    {
+        std::string name;
+        vks::mesh::CookedMesh cooked;
+        std::unique_ptr<vks::mesh::MeshFile> file;
+        vks::mesh::MeshKey key; // With a geometry cache
+
+        vks::mesh::MeshData view() const { return file ? file->view() : cooked.view(); }
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::deque<ReadyMesh> ready;
+    std::deque<std::string> errors;
+    size_t jobsInFlight = 0;
+
+    void push(ReadyMesh&& mesh)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(std::move(mesh));
+    }
+};
+
+ModelLoader::ModelLoader(const vks::Device& device, const vks::CommandPool& commandPool,
+                         vks::GeometryCache* geometryCache)
+    : m_device(device), m_commandPool(commandPool), m_geometryCache(geometryCache),
+      m_state(std::make_shared<State>())
+{
+}
+
+ModelLoader::~ModelLoader()
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->idle.wait(lock, [&] { return m_state->jobsInFlight == 0; });
+}
+
+void ModelLoader::load(const std::string& path, const std::string& name, const mesh::CookSettings& settings)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        ++m_state->jobsInFlight;
+    }
+
+    std::shared_ptr<State> state = m_state;
+    bool hashContent = m_geometryCache != nullptr;
+    ThreadPool::global().submit([state, path, name, settings, hashContent]()
+    {
+        try {
+            if (hasExtension(path, ".vksmesh")) {
+                State::ReadyMesh mesh;
+                mesh.name = name;
+                mesh.file = std::make_unique<mesh::MeshFile>(path);
+                if (hashContent) {
+                    // Reads every page as well
+                    mesh.key = mesh::MeshKey::content(mesh.view());
+                } else {
+                    // The upload then copies from memory, not from disk
+                    mesh.file->prefetch();
+                }
+                state->push(std::move(mesh));
+            } else {
+                // Each primitive is cooked by the task that decoded it and
+                // queued right away, before the rest of the file is done
+                mesh::importMeshes(path, [&](size_t index, mesh::SourceMesh&& source)
+                {
+                    State::ReadyMesh mesh;
+                    mesh.name = index == 0 ? name : name + "." + std::to_string(index);
+                    mesh.cooked = mesh::cookMesh(std::move(source.vertices), std::move(source.indices),
+                                                 source.hasNormals, settings);
+                    if (hashContent) {
+                        mesh.key = mesh::MeshKey::content(mesh.view());
+                    }
+                    state->push(std::move(mesh));
+                });
+            }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->errors.push_back(path + ": " + e.what());
+        }
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        --state->jobsInFlight;
+        state->idle.notify_all();
+    });
+}
+
+size_t ModelLoader::update(std::map<std::string, Model>& models, VkDeviceSize byteBudget)
+{
+    std::deque<State::ReadyMesh> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        for (const std::string& error : m_state->errors) {
+            std::cerr << "Failed to load " << error << std::endl;
+        }
+        m_state->errors.clear();
+
+        // Take meshes until the budget is spent, the first one regardless
+        VkDeviceSize bytes = 0;
+        while (!m_state->ready.empty()) {
+            mesh::MeshData view = m_state->ready.front().view();
+            VkDeviceSize size = VkDeviceSize(geometry::vertexSize(view.vertexFormat)) * view.vertexCount +
+                                VkDeviceSize(view.indexSize) * view.indexCount;
+            if (!batch.empty() && bytes + size > byteBudget) {
+                break;
+            }
+            bytes += size;
+            batch.push_back(std::move(m_state->ready.front()));
+            m_state->ready.pop_front();
+        }
+    }
+
+    // Uploads run outside the lock, so the workers keep queueing meshes
+    size_t uploaded = 0;
+    for (const State::ReadyMesh& mesh : batch) {
+        if (mesh.view().vertexCount == 0) {
+            std::cerr << "Skipped the empty mesh " << mesh.name << std::endl;
+            continue;
+        }
+        if (m_geometryCache != nullptr) {
+            // Assigned in place: render objects keep pointing at the entry
+            models[mesh.name] = m_geometryCache->acquire(mesh.key, mesh.view());
+        } else {
+            models[mesh.name].loadMesh(m_device, m_commandPool.handle(), mesh.view());
+        }
+        ++uploaded;
+    }
+    return uploaded;
+}
+
+size_t ModelLoader::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->jobsInFlight + m_state->ready.size();
+}
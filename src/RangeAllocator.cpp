@@ -0,0 +1,88 @@
+#include <vks/RangeAllocator.hpp>
+
+#include <cassert>
+#include <iterator>
+
+using namespace vks;
+
+RangeAllocator::RangeAllocator(uint32_t capacity) {
+    grow(capacity);
+}
+
+uint32_t RangeAllocator::allocate(uint32_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    // Smallest block that fits, lowest offset first among equal sizes
+    auto fit = m_freeBySize.lower_bound({size, 0});
+    if (fit == m_freeBySize.end()) {
+        return InvalidOffset;
+    }
+
+    uint32_t blockSize = fit->first;
+    uint32_t offset = fit->second;
+    eraseFreeBlock(m_freeByOffset.find(offset));
+    if (blockSize > size) {
+        insertFreeBlock(offset + size, blockSize - size);
+    }
+
+    m_used += size;
+    return offset;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+    assert(offset + size <= m_capacity && "Range outside of the allocator");
+    m_used -= size;
+
+    // Merge with the free block right after...
+    auto next = m_freeByOffset.find(offset + size);
+    if (next != m_freeByOffset.end()) {
+        size += next->second;
+        eraseFreeBlock(next);
+    }
+
+    // ... and the one right before
+    auto previous = m_freeByOffset.lower_bound(offset);
+    if (previous != m_freeByOffset.begin()) {
+        --previous;
+        assert(previous->first + previous->second <= offset && "Range freed twice");
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            eraseFreeBlock(previous);
+        }
+    }
+
+    insertFreeBlock(offset, size);
+}
+
+void RangeAllocator::grow(uint32_t newCapacity) {
+    if (newCapacity <= m_capacity) {
+        return;
+    }
+
+    uint32_t oldCapacity = m_capacity;
+    m_capacity = newCapacity;
+
+    // Freeing the new tail merges it with a free block ending at the old capacity
+    m_used += newCapacity - oldCapacity;
+    free(oldCapacity, newCapacity - oldCapacity);
+}
+
+uint32_t RangeAllocator::largestFreeBlock() const {
+    return m_freeBySize.empty() ? 0 : std::prev(m_freeBySize.end())->first;
+}
+
+void RangeAllocator::insertFreeBlock(uint32_t offset, uint32_t size) {
+    m_freeByOffset.emplace(offset, size);
+    m_freeBySize.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFreeBlock(std::map<uint32_t, uint32_t>::iterator block) {
+    m_freeBySize.erase({block->second, block->first});
+    m_freeByOffset.erase(block);
+}
@@ -1,22 +1,80 @@
 
 #include <iostream>
+#include <stdexcept>
 #include <vks/Device.hpp>
 #include <vks/RenderPass.hpp>
 #include <vks/SwapChain.hpp>
 
 using namespace vks;
 
-RenderPass::RenderPass(const Device &device, const SwapChain &swapChain)
+namespace {
+// The first depth format usable as an attachment with optimal tiling
+VkFormat chooseDepthFormat(VkPhysicalDevice physical) {
+  for (VkFormat format : {VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32,
+                          VK_FORMAT_D16_UNORM}) {
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(physical, format, &properties);
+    if (properties.optimalTilingFeatures &
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+      return format;
+    }
+  }
+  throw std::runtime_error("No supported depth attachment format");
+}
+
+uint32_t findMemoryType(VkPhysicalDevice physical, uint32_t typeFilter,
+                        VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(physical, &memProperties);
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((typeFilter & (1 << i)) &&
+        (memProperties.memoryTypes[i].propertyFlags & properties) ==
+            properties) {
+      return i;
+    }
+  }
+  throw std::runtime_error("Failed to find suitable memory type!");
+}
+} // namespace
+
+RenderPass::RenderPass(const Device &device, const SwapChain &swapChain,
+                       bool depthTarget)
     : m_renderPass(VK_NULL_HANDLE), m_oldRenderPass(VK_NULL_HANDLE),
-      m_device(device), m_swapChain(swapChain) {}
+      m_device(device), m_swapChain(swapChain),
+      m_dynamic(device.dynamicRendering()),
+      m_depthFormat(depthTarget ? chooseDepthFormat(device.physical())
+                                : VK_FORMAT_UNDEFINED),
+      m_depthImage(VK_NULL_HANDLE), m_depthMemory(VK_NULL_HANDLE),
+      m_depthView(VK_NULL_HANDLE) {
+  if (depthTarget) {
+    createDepthTarget();
+  }
+}
 
 RenderPass::~RenderPass() {
   destroyFrameBuffers();
+  destroyDepthTarget();
   vkDestroyRenderPass(m_device.logical(), m_renderPass, nullptr);
 }
 
+size_t RenderPass::size() const { return m_swapChain.numImages(); }
+
+VkFormat RenderPass::colorFormat() const { return m_swapChain.imageFormat(); }
+
 void RenderPass::recreate() {
   destroyFrameBuffers();
+  // The depth target follows the swapchain extent
+  if (m_depthFormat != VK_FORMAT_UNDEFINED) {
+    destroyDepthTarget();
+    createDepthTarget();
+  }
+
+  // Swapchain image views are looked up at record time
+  if (m_dynamic) {
+    return;
+  }
+
   m_oldRenderPass = m_renderPass;
   createRenderPass();
   createFrameBuffers();
@@ -36,12 +94,12 @@ void RenderPass::createFrameBuffers() {
 
   // Create a framebuffer for each image view
   for (size_t i = 0; i < numImages; ++i) {
-    VkImageView attachments[] = {m_swapChain.imageView(i)};
+    VkImageView attachments[] = {m_swapChain.imageView(i), m_depthView};
 
     VkFramebufferCreateInfo info = {};
     info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
     info.renderPass = m_renderPass;
-    info.attachmentCount = 1;
+    info.attachmentCount = m_depthView != VK_NULL_HANDLE ? 2 : 1;
     info.pAttachments = attachments;
     info.width = m_swapChain.extent().width;
     info.height = m_swapChain.extent().height;
@@ -58,4 +116,194 @@ void RenderPass::destroyFrameBuffers() {
   for (VkFramebuffer &fb : m_frameBuffers) {
     vkDestroyFramebuffer(m_device.logical(), fb, nullptr);
   }
+  m_frameBuffers.clear();
+}
+
+VkAttachmentDescription RenderPass::depthAttachment() const {
+  VkAttachmentDescription depthAttachment = {};
+  depthAttachment.format = m_depthFormat;
+  depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  // Cleared every pass, nothing reads it afterwards
+  depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  return depthAttachment;
+}
+
+void RenderPass::createDepthTarget() {
+  VkImageCreateInfo imageInfo = {};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = m_depthFormat;
+  imageInfo.extent = {m_swapChain.extent().width,
+                      m_swapChain.extent().height, 1};
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (vkCreateImage(m_device.logical(), &imageInfo, nullptr, &m_depthImage) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Depth image creation failed");
+  }
+
+  VkMemoryRequirements memRequirements;
+  vkGetImageMemoryRequirements(m_device.logical(), m_depthImage,
+                               &memRequirements);
+
+  VkMemoryAllocateInfo allocInfo = {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = memRequirements.size;
+  allocInfo.memoryTypeIndex =
+      findMemoryType(m_device.physical(), memRequirements.memoryTypeBits,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  if (vkAllocateMemory(m_device.logical(), &allocInfo, nullptr,
+                       &m_depthMemory) != VK_SUCCESS) {
+    throw std::runtime_error("Depth image allocation failed");
+  }
+  if (vkBindImageMemory(m_device.logical(), m_depthImage, m_depthMemory, 0) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("Depth image binding failed");
+  }
+
+  VkImageViewCreateInfo viewInfo = {};
+  viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  viewInfo.image = m_depthImage;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  viewInfo.format = m_depthFormat;
+  viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
+  if (vkCreateImageView(m_device.logical(), &viewInfo, nullptr,
+                        &m_depthView) != VK_SUCCESS) {
+    throw std::runtime_error("Depth image view creation failed");
+  }
+}
+
+void RenderPass::destroyDepthTarget() {
+  vkDestroyImageView(m_device.logical(), m_depthView, nullptr);
+  vkDestroyImage(m_device.logical(), m_depthImage, nullptr);
+  vkFreeMemory(m_device.logical(), m_depthMemory, nullptr);
+  m_depthView = VK_NULL_HANDLE;
+  m_depthImage = VK_NULL_HANDLE;
+  m_depthMemory = VK_NULL_HANDLE;
+}
+
+void RenderPass::begin(VkCommandBuffer cmd, uint32_t imageIndex,
+                       const VkClearValue &clearValue) const {
+  if (!m_dynamic) {
+    VkRenderPassBeginInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = m_renderPass;
+    renderPassInfo.framebuffer = m_frameBuffers[imageIndex];
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = m_swapChain.extent();
+    VkClearValue clearValues[2] = {clearValue, {}};
+    clearValues[1].depthStencil = {1.0f, 0};
+    renderPassInfo.clearValueCount = m_depthView != VK_NULL_HANDLE ? 2 : 1;
+    renderPassInfo.pClearValues = clearValues;
+
+    vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    return;
+  }
+
+  VkAttachmentDescription attachment = colorAttachment();
+  transitionImage(cmd, imageIndex, attachment.initialLayout,
+                  VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+  VkRenderingAttachmentInfo colorInfo = {};
+  colorInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+  colorInfo.imageView = m_swapChain.imageView(imageIndex);
+  colorInfo.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  colorInfo.loadOp = attachment.loadOp;
+  colorInfo.storeOp = attachment.storeOp;
+  colorInfo.clearValue = clearValue;
+
+  VkRenderingInfo renderingInfo = {};
+  renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+  renderingInfo.renderArea.offset = {0, 0};
+  renderingInfo.renderArea.extent = m_swapChain.extent();
+  renderingInfo.layerCount = 1;
+  renderingInfo.colorAttachmentCount = 1;
+  renderingInfo.pColorAttachments = &colorInfo;
+
+  VkRenderingAttachmentInfo depthInfo = {};
+  if (m_depthView != VK_NULL_HANDLE) {
+    transitionDepth(cmd);
+
+    VkAttachmentDescription depth = depthAttachment();
+    depthInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depthInfo.imageView = m_depthView;
+    depthInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthInfo.loadOp = depth.loadOp;
+    depthInfo.storeOp = depth.storeOp;
+    depthInfo.clearValue.depthStencil = {1.0f, 0};
+    renderingInfo.pDepthAttachment = &depthInfo;
+  }
+
+  m_device.cmdBeginRendering(cmd, renderingInfo);
+}
+
+void RenderPass::end(VkCommandBuffer cmd, uint32_t imageIndex) const {
+  if (!m_dynamic) {
+    vkCmdEndRenderPass(cmd);
+    return;
+  }
+
+  m_device.cmdEndRendering(cmd);
+  transitionImage(cmd, imageIndex, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                  colorAttachment().finalLayout);
+}
+
+void RenderPass::transitionImage(VkCommandBuffer cmd, uint32_t imageIndex,
+                                 VkImageLayout oldLayout,
+                                 VkImageLayout newLayout) const {
+  // Both sides are the color attachment stage: this orders the pass against
+  // the previous pass on the same image (and the acquire semaphore wait),
+  // like the external subpass dependencies of the legacy render passes.
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  barrier.dstAccessMask = newLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                              ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                              : 0;
+  barrier.oldLayout = oldLayout;
+  barrier.newLayout = newLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = m_swapChain.image(imageIndex);
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0,
+                       nullptr, 0, nullptr, 1, &barrier);
+}
+
+void RenderPass::transitionDepth(VkCommandBuffer cmd) const {
+  // The contents are discarded (cleared on load): this only waits for the
+  // previous frame's depth tests before the clear writes the image again
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = m_depthImage;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+
+  VkPipelineStageFlags stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+  vkCmdPipelineBarrier(cmd, stages, stages, 0, 0, nullptr, 0, nullptr, 1,
+                       &barrier);
 }
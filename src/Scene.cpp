@@ -0,0 +1,170 @@
+#include <vks/Scene.hpp>
+
+#include <stdexcept>
+
+namespace vks {
+
+SceneHandle Scene::create(const glm::mat4& transform, MeshId mesh, MaterialId material, uint32_t flags,
+                          TransformHierarchy::NodeId node)
+{
+    uint32_t slot = m_freeSlot;
+    if (slot != InvalidIndex) {
+        m_freeSlot = m_slots[slot].index;
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    uint32_t index = size();
+    m_slots[slot].index = index;
+
+    m_transforms.push_back(transform);
+    m_bounds.emplace_back();
+    m_meshes.push_back(mesh);
+    m_materials.push_back(material);
+    m_nodes.push_back(node);
+    m_flags.push_back(flags);
+    m_lods.push_back(0);
+    m_variants.push_back(0);
+    m_depthVariants.push_back(0);
+    m_slotOf.push_back(slot);
+
+    return {slot, m_slots[slot].generation};
+}
+
+uint32_t Scene::createBatch(uint32_t count)
+{
+    uint32_t first = size();
+    size_t total = size_t(first) + count;
+    m_transforms.resize(total);
+    m_bounds.resize(total);
+    m_meshes.resize(total);
+    m_materials.resize(total);
+    m_nodes.resize(total);
+    m_flags.resize(total, 0);
+    m_lods.resize(total, 0);
+    m_variants.resize(total, 0);
+    m_depthVariants.resize(total, 0);
+    m_slotOf.resize(total);
+
+    // Free slots first, then new ones in one go
+    uint32_t index = first;
+    for (; index < total && m_freeSlot != InvalidIndex; ++index) {
+        uint32_t slot = m_freeSlot;
+        m_freeSlot = m_slots[slot].index;
+        m_slots[slot].index = index;
+        m_slotOf[index] = slot;
+    }
+    uint32_t slot = static_cast<uint32_t>(m_slots.size());
+    m_slots.resize(m_slots.size() + (total - index));
+    for (; index < total; ++index, ++slot) {
+        m_slots[slot].index = index;
+        m_slotOf[index] = slot;
+    }
+    return first;
+}
+
+bool Scene::destroy(SceneHandle handle)
+{
+    uint32_t index = indexOf(handle);
+    if (index == InvalidIndex) {
+        return false;
+    }
+
+    // The last object moves into the hole
+    uint32_t last = size() - 1;
+    if (index != last) {
+        m_transforms[index] = m_transforms[last];
+        m_bounds[index] = m_bounds[last];
+        m_meshes[index] = m_meshes[last];
+        m_materials[index] = m_materials[last];
+        m_nodes[index] = m_nodes[last];
+        m_flags[index] = m_flags[last];
+        m_lods[index] = m_lods[last];
+        m_variants[index] = m_variants[last];
+        m_depthVariants[index] = m_depthVariants[last];
+        m_slotOf[index] = m_slotOf[last];
+        m_slots[m_slotOf[index]].index = index;
+    }
+    m_transforms.pop_back();
+    m_bounds.pop_back();
+    m_meshes.pop_back();
+    m_materials.pop_back();
+    m_nodes.pop_back();
+    m_flags.pop_back();
+    m_lods.pop_back();
+    m_variants.pop_back();
+    m_depthVariants.pop_back();
+    m_slotOf.pop_back();
+
+    Slot& slot = m_slots[handle.slot];
+    ++slot.generation;
+    slot.index = m_freeSlot;
+    m_freeSlot = handle.slot;
+    return true;
+}
+
+uint32_t Scene::indexOf(SceneHandle handle) const
+{
+    if (handle.slot >= m_slots.size()) {
+        return InvalidIndex;
+    }
+    // Destroying an object bumps its slot's generation
+    const Slot& slot = m_slots[handle.slot];
+    return slot.generation == handle.generation ? slot.index : InvalidIndex;
+}
+
+SceneHandle Scene::handleAt(uint32_t index) const
+{
+    if (index >= size()) {
+        return {};
+    }
+    uint32_t slot = m_slotOf[index];
+    return {slot, m_slots[slot].generation};
+}
+
+glm::mat4& Scene::transform(SceneHandle handle)
+{
+    uint32_t index = indexOf(handle);
+    if (index == InvalidIndex) {
+        throw std::runtime_error("Stale scene handle");
+    }
+    return m_transforms[index];
+}
+
+void Scene::reserve(size_t count)
+{
+    m_transforms.reserve(count);
+    m_bounds.reserve(count);
+    m_meshes.reserve(count);
+    m_materials.reserve(count);
+    m_nodes.reserve(count);
+    m_flags.reserve(count);
+    m_lods.reserve(count);
+    m_variants.reserve(count);
+    m_depthVariants.reserve(count);
+    m_slotOf.reserve(count);
+}
+
+void Scene::clear()
+{
+    // Every handle given out so far becomes stale
+    for (uint32_t index = 0; index < size(); ++index) {
+        Slot& slot = m_slots[m_slotOf[index]];
+        ++slot.generation;
+        slot.index = m_freeSlot;
+        m_freeSlot = m_slotOf[index];
+    }
+    m_transforms.clear();
+    m_bounds.clear();
+    m_meshes.clear();
+    m_materials.clear();
+    m_nodes.clear();
+    m_flags.clear();
+    m_lods.clear();
+    m_variants.clear();
+    m_depthVariants.clear();
+    m_slotOf.clear();
+}
+
+} // namespace vks
@@ -0,0 +1,224 @@
+#include <vks/SceneFile.hpp>
+
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace vks {
+
+// Per loading task: a few hundred kilobytes of each array
+static constexpr size_t ObjectsPerTask = 16384;
+
+namespace {
+
+uint64_t alignUp(uint64_t value)
+{
+    return (value + SceneFileAlignment - 1) & ~(SceneFileAlignment - 1);
+}
+
+// Zeros up to the next section
+void writePadding(std::ofstream& file)
+{
+    static const char zeros[SceneFileAlignment] = {};
+    uint64_t position = static_cast<uint64_t>(file.tellp());
+    file.write(zeros, static_cast<std::streamsize>(alignUp(position) - position));
+}
+
+template <typename T>
+void writeSection(std::ofstream& file, const T* data, size_t count)
+{
+    writePadding(file);
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+// Every index below count, or SceneFileNoIndex when allowed
+bool validIndices(const uint32_t* indices, uint32_t size, uint32_t count, bool allowNone)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        if (indices[i] >= count && !(allowNone && indices[i] == SceneFileNoIndex)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void writeSceneFile(const std::string& path, const Scene& scene, const TransformHierarchy& hierarchy,
+                    const std::vector<std::string>& meshNames, const std::vector<std::string>& materialNames)
+{
+    uint32_t objectCount = scene.size();
+    uint32_t nodeCount = hierarchy.size();
+
+    // Objects refer to nodes by index, which node i of the file keeps
+    std::vector<uint32_t> nodes(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        TransformHierarchy::NodeId node = scene.nodes()[i];
+        nodes[i] = node == TransformHierarchy::NoNode ? SceneFileNoIndex : hierarchy.indexOf(node);
+        if (node != TransformHierarchy::NoNode && nodes[i] == TransformHierarchy::InvalidIndex) {
+            throw std::runtime_error("Scene object refers to a destroyed node");
+        }
+    }
+    if (!validIndices(scene.meshes(), objectCount, static_cast<uint32_t>(meshNames.size()), true) ||
+        !validIndices(scene.materials(), objectCount, static_cast<uint32_t>(materialNames.size()), false)) {
+        throw std::runtime_error("Scene object refers to an unnamed mesh or material");
+    }
+
+    std::vector<SceneFileAsset> assets;
+    std::string names;
+    for (const std::vector<std::string>* table : {&meshNames, &materialNames}) {
+        for (const std::string& name : *table) {
+            SceneFileAsset asset;
+            asset.nameOffset = names.size();
+            asset.nameSize = static_cast<uint32_t>(name.size());
+            assets.push_back(asset);
+            names += name;
+        }
+    }
+
+    SceneFileHeader header;
+    header.objectCount = objectCount;
+    header.nodeCount = nodeCount;
+    header.meshCount = static_cast<uint32_t>(meshNames.size());
+    header.materialCount = static_cast<uint32_t>(materialNames.size());
+    header.assetTableOffset = alignUp(sizeof(SceneFileHeader));
+    header.nameDataOffset = alignUp(header.assetTableOffset + sizeof(SceneFileAsset) * assets.size());
+    header.localsOffset = alignUp(header.nameDataOffset + names.size());
+    header.parentsOffset = alignUp(header.localsOffset + sizeof(LocalTransform) * uint64_t(nodeCount));
+    header.transformsOffset = alignUp(header.parentsOffset + sizeof(uint32_t) * uint64_t(nodeCount));
+    header.meshesOffset = alignUp(header.transformsOffset + sizeof(glm::mat4) * uint64_t(objectCount));
+    header.materialsOffset = alignUp(header.meshesOffset + sizeof(uint32_t) * uint64_t(objectCount));
+    header.flagsOffset = alignUp(header.materialsOffset + sizeof(uint32_t) * uint64_t(objectCount));
+    header.nodesOffset = alignUp(header.flagsOffset + sizeof(uint32_t) * uint64_t(objectCount));
+    header.fileSize = header.nodesOffset + sizeof(uint32_t) * uint64_t(objectCount);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to create scene file: " + path);
+    }
+
+    // Scene::NoMesh and the hierarchy's InvalidIndex are SceneFileNoIndex
+    // already, the arrays are written as they are
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeSection(file, assets.data(), assets.size());
+    writeSection(file, names.data(), names.size());
+    writeSection(file, hierarchy.locals(), nodeCount);
+    writeSection(file, hierarchy.parents(), nodeCount);
+    writeSection(file, scene.transforms(), objectCount);
+    writeSection(file, scene.meshes(), objectCount);
+    writeSection(file, scene.materials(), objectCount);
+    writeSection(file, scene.flags(), objectCount);
+    writeSection(file, nodes.data(), objectCount);
+
+    if (!file.flush()) {
+        throw std::runtime_error("Failed to write scene file: " + path);
+    }
+}
+
+SceneFile::SceneFile(const std::string& path)
+    : m_file(path)
+{
+    // Validate everything the accessors and loadScene() rely on
+    const SceneFileHeader& h = header();
+    // No other header field is read before the header is known to be there
+    if (m_file.size() < sizeof(SceneFileHeader) || h.magic != SceneFileMagic) {
+        throw std::runtime_error("Invalid scene file: " + path);
+    }
+    if (h.version != SceneFileVersion) {
+        throw std::runtime_error("Unsupported scene file version " + std::to_string(h.version) + ": " + path);
+    }
+
+    uint64_t assetCount = uint64_t(h.meshCount) + h.materialCount;
+    struct Section
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+    const Section sections[] = {
+        {h.assetTableOffset, sizeof(SceneFileAsset) * assetCount},
+        {h.nameDataOffset, 0}, // Checked with the names
+        {h.localsOffset, sizeof(LocalTransform) * uint64_t(h.nodeCount)},
+        {h.parentsOffset, sizeof(uint32_t) * uint64_t(h.nodeCount)},
+        {h.transformsOffset, sizeof(glm::mat4) * uint64_t(h.objectCount)},
+        {h.meshesOffset, sizeof(uint32_t) * uint64_t(h.objectCount)},
+        {h.materialsOffset, sizeof(uint32_t) * uint64_t(h.objectCount)},
+        {h.flagsOffset, sizeof(uint32_t) * uint64_t(h.objectCount)},
+        {h.nodesOffset, sizeof(uint32_t) * uint64_t(h.objectCount)},
+    };
+    bool valid = h.fileSize <= m_file.size();
+    uint64_t end = sizeof(SceneFileHeader);
+    for (const Section& section : sections) {
+        valid = valid && section.offset % SceneFileAlignment == 0 && section.offset >= end &&
+                section.offset + section.size <= h.fileSize;
+        end = section.offset + section.size;
+    }
+
+    for (uint64_t i = 0; valid && i < assetCount; ++i) {
+        const SceneFileAsset& asset = section<SceneFileAsset>(h.assetTableOffset)[i];
+        valid = h.nameDataOffset + asset.nameOffset + asset.nameSize <= h.localsOffset;
+    }
+
+    // Parents before their children, as TransformHierarchy::assign() wants
+    for (uint32_t i = 0; valid && i < h.nodeCount; ++i) {
+        valid = parents()[i] < i || parents()[i] == SceneFileNoIndex;
+    }
+    valid = valid && validIndices(meshes(), h.objectCount, h.meshCount, true) &&
+            validIndices(materials(), h.objectCount, h.materialCount, false) &&
+            validIndices(nodes(), h.objectCount, h.nodeCount, true);
+
+    if (!valid) {
+        throw std::runtime_error("Invalid scene file: " + path);
+    }
+}
+
+std::string_view SceneFile::assetName(uint32_t asset) const
+{
+    const SceneFileAsset& entry = section<SceneFileAsset>(header().assetTableOffset)[asset];
+    return {section<char>(header().nameDataOffset + entry.nameOffset), entry.nameSize};
+}
+
+// Copies the objects of a file to [first, first + count) of a scene, apart
+// from the asset references going through the tables
+static void copyObjects(const SceneFile& file, const Scene::MeshId* meshes, const Scene::MaterialId* materials,
+                        Scene& scene, uint32_t first, bool withNodes)
+{
+    parallelFor(0, file.objectCount(), ObjectsPerTask, [&](size_t begin, size_t end)
+    {
+        size_t n = end - begin;
+        std::memcpy(scene.transforms() + first + begin, file.transforms() + begin, sizeof(glm::mat4) * n);
+        std::memcpy(scene.flags() + first + begin, file.flags() + begin, sizeof(uint32_t) * n);
+        if (withNodes) {
+            std::memcpy(scene.nodes() + first + begin, file.nodes() + begin, sizeof(uint32_t) * n);
+        } else {
+            std::fill(scene.nodes() + first + begin, scene.nodes() + first + end, TransformHierarchy::NoNode);
+        }
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t mesh = file.meshes()[i];
+            scene.meshes()[first + i] = mesh == SceneFileNoIndex ? Scene::NoMesh : meshes[mesh];
+            scene.materials()[first + i] = materials[file.materials()[i]];
+        }
+    });
+}
+
+void loadScene(const SceneFile& file, const Scene::MeshId* meshes, const Scene::MaterialId* materials,
+               Scene& scene, TransformHierarchy& hierarchy)
+{
+    hierarchy.assign(file.locals(), file.parents(), file.nodeCount());
+
+    // Node i of the file is NodeId i of the hierarchy now
+    scene.clear();
+    copyObjects(file, meshes, materials, scene, scene.createBatch(file.objectCount()), true);
+}
+
+uint32_t appendScene(const SceneFile& file, const Scene::MeshId* meshes, const Scene::MaterialId* materials,
+                     Scene& scene)
+{
+    uint32_t first = scene.createBatch(file.objectCount());
+    copyObjects(file, meshes, materials, scene, first, false);
+    return first;
+}
+
+} // namespace vks
@@ -0,0 +1,397 @@
+#include <vks/ShaderReflection.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace vks {
+
+namespace {
+
+// The subset of the SPIR-V specification the reflection relies on
+constexpr uint32_t SpirvMagic = 0x07230203;
+constexpr uint32_t SpirvHeaderWords = 5;
+constexpr uint32_t Unset = std::numeric_limits<uint32_t>::max();
+
+enum Op : uint32_t {
+    OpName = 5,
+    OpEntryPoint = 15,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpSpecConstant = 50,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+};
+
+enum Decoration : uint32_t {
+    DecorationBlock = 2,
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35,
+};
+
+enum StorageClass : uint32_t {
+    StorageClassUniformConstant = 0,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+};
+
+enum ImageDim : uint32_t {
+    DimBuffer = 5,
+    DimSubpassData = 6,
+};
+
+// Everything we remember about a single SPIR-V result id
+struct SpirvId {
+    uint32_t opcode = 0;
+    // Instruction words following the result id (type operands, constant value, ...)
+    std::vector<uint32_t> operands;
+    std::string name;
+
+    uint32_t set = Unset;
+    uint32_t binding = Unset;
+    uint32_t arrayStride = 0;
+    bool bufferBlock = false;
+
+    // Per-member decorations of OpTypeStruct
+    std::vector<uint32_t> memberOffsets;
+    std::vector<uint32_t> memberMatrixStrides;
+};
+
+VkShaderStageFlags executionModelToStage(uint32_t model) {
+    switch (model) {
+    case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+    case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+    case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+    case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+    default: return 0;
+    }
+}
+
+void setMember(std::vector<uint32_t>& values, uint32_t member, uint32_t value) {
+    if (values.size() <= member) {
+        values.resize(member + 1, Unset);
+    }
+    values[member] = value;
+}
+
+class Module {
+public:
+    Module(const uint32_t* code, size_t wordCount) {
+        if (code == nullptr || wordCount < SpirvHeaderWords || code[0] != SpirvMagic) {
+            throw std::runtime_error("Invalid SPIR-V module!");
+        }
+
+        m_ids.resize(code[3]); // The id bound
+
+        for (size_t i = SpirvHeaderWords; i < wordCount;) {
+            const uint32_t* insn = code + i;
+            uint32_t opcode = insn[0] & 0xFFFF;
+            uint32_t count = insn[0] >> 16;
+
+            if (count == 0 || i + count > wordCount) {
+                throw std::runtime_error("Truncated SPIR-V instruction!");
+            }
+
+            parseInstruction(opcode, insn, count);
+            i += count;
+        }
+    }
+
+    const SpirvId& id(uint32_t index) const {
+        if (index >= m_ids.size()) {
+            throw std::runtime_error("SPIR-V id out of bounds!");
+        }
+        return m_ids[index];
+    }
+
+    VkShaderStageFlags stages() const { return m_stages; }
+    const std::vector<uint32_t>& variables() const { return m_variables; }
+
+    uint32_t constantValue(uint32_t index) const {
+        const SpirvId& constant = id(index);
+        if ((constant.opcode != OpConstant && constant.opcode != OpSpecConstant) ||
+            constant.operands.size() < 2) {
+            throw std::runtime_error("SPIR-V array length is not a constant!");
+        }
+        return constant.operands[1];
+    }
+
+    // Size in bytes of a type as laid out in a block (matrixStride comes from the
+    // member decoration of the enclosing struct)
+    uint32_t typeSize(uint32_t index, uint32_t matrixStride = 0) const {
+        const SpirvId& type = id(index);
+        switch (type.opcode) {
+        case OpTypeBool:
+            return 4;
+        case OpTypeInt:
+        case OpTypeFloat:
+            return type.operands[0] / 8;
+        case OpTypeVector:
+            return typeSize(type.operands[0]) * type.operands[1];
+        case OpTypeMatrix: {
+            uint32_t columnSize = matrixStride ? matrixStride : typeSize(type.operands[0]);
+            return columnSize * type.operands[1];
+        }
+        case OpTypeArray: {
+            uint32_t length = constantValue(type.operands[1]);
+            uint32_t stride = type.arrayStride ? type.arrayStride : typeSize(type.operands[0], matrixStride);
+            return stride * length;
+        }
+        case OpTypeRuntimeArray:
+            return 0;
+        case OpTypeStruct: {
+            uint32_t size = 0;
+            for (uint32_t member = 0; member < type.operands.size(); ++member) {
+                uint32_t stride = member < type.memberMatrixStrides.size() ? type.memberMatrixStrides[member] : Unset;
+                uint32_t memberSize = typeSize(type.operands[member], stride == Unset ? 0 : stride);
+                uint32_t offset = member < type.memberOffsets.size() ? type.memberOffsets[member] : Unset;
+                size = offset == Unset ? size + memberSize : std::max(size, offset + memberSize);
+            }
+            return size;
+        }
+        default:
+            throw std::runtime_error("Unsupported type in SPIR-V block!");
+        }
+    }
+
+private:
+    std::vector<SpirvId> m_ids;
+    std::vector<uint32_t> m_variables;
+    VkShaderStageFlags m_stages = 0;
+
+    SpirvId& at(uint32_t index) {
+        if (index >= m_ids.size()) {
+            throw std::runtime_error("SPIR-V id out of bounds!");
+        }
+        return m_ids[index];
+    }
+
+    void parseInstruction(uint32_t opcode, const uint32_t* insn, uint32_t count) {
+        switch (opcode) {
+        case OpEntryPoint:
+            m_stages |= executionModelToStage(insn[1]);
+            break;
+
+        case OpName: {
+            const char* literal = reinterpret_cast<const char*>(insn + 2);
+            size_t maxLength = (count - 2) * sizeof(uint32_t);
+            at(insn[1]).name.assign(literal, strnlen(literal, maxLength));
+            break;
+        }
+
+        case OpDecorate: {
+            if (count < 3) break;
+            SpirvId& target = at(insn[1]);
+            uint32_t value = count > 3 ? insn[3] : 0;
+            switch (insn[2]) {
+            case DecorationDescriptorSet: target.set = value; break;
+            case DecorationBinding: target.binding = value; break;
+            case DecorationArrayStride: target.arrayStride = value; break;
+            case DecorationBufferBlock: target.bufferBlock = true; break;
+            default: break;
+            }
+            break;
+        }
+
+        case OpMemberDecorate: {
+            if (count < 5) break;
+            SpirvId& target = at(insn[1]);
+            if (insn[3] == DecorationOffset) {
+                setMember(target.memberOffsets, insn[2], insn[4]);
+            } else if (insn[3] == DecorationMatrixStride) {
+                setMember(target.memberMatrixStrides, insn[2], insn[4]);
+            }
+            break;
+        }
+
+        case OpTypeBool:
+        case OpTypeInt:
+        case OpTypeFloat:
+        case OpTypeVector:
+        case OpTypeMatrix:
+        case OpTypeImage:
+        case OpTypeSampler:
+        case OpTypeSampledImage:
+        case OpTypeArray:
+        case OpTypeRuntimeArray:
+        case OpTypeStruct:
+        case OpTypePointer: {
+            SpirvId& type = at(insn[1]);
+            type.opcode = opcode;
+            type.operands.assign(insn + 2, insn + count);
+            break;
+        }
+
+        case OpConstant:
+        case OpSpecConstant:
+        case OpVariable: {
+            // <result type> <result id> <operands...>
+            SpirvId& value = at(insn[2]);
+            value.opcode = opcode;
+            value.operands.assign({insn[1]});
+            value.operands.insert(value.operands.end(), insn + 3, insn + count);
+            if (opcode == OpVariable) {
+                m_variables.push_back(insn[2]);
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+};
+
+VkDescriptorType imageDescriptorType(const SpirvId& image) {
+    // Operands: <sampled type> <dim> <depth> <arrayed> <ms> <sampled> <format>
+    uint32_t dim = image.operands[1];
+    bool sampled = image.operands[5] == 1;
+
+    if (dim == DimBuffer) {
+        return sampled ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    }
+    if (dim == DimSubpassData) {
+        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    }
+    return sampled ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+}
+
+} // namespace
+
+ShaderReflection::ShaderReflection(const uint32_t* code, size_t wordCount) {
+    Module module(code, wordCount);
+    m_stages = module.stages();
+
+    for (uint32_t variableId : module.variables()) {
+        const SpirvId& variable = module.id(variableId);
+        uint32_t storageClass = variable.operands[1];
+
+        if (storageClass != StorageClassUniformConstant && storageClass != StorageClassUniform &&
+            storageClass != StorageClassStorageBuffer && storageClass != StorageClassPushConstant) {
+            continue;
+        }
+
+        // Variables are always pointers: <storage class> <pointee type>
+        const SpirvId& pointer = module.id(variable.operands[0]);
+        uint32_t typeId = pointer.operands[1];
+
+        if (storageClass == StorageClassPushConstant) {
+            const SpirvId& block = module.id(typeId);
+            uint32_t offset = 0;
+            if (!block.memberOffsets.empty()) {
+                offset = *std::min_element(block.memberOffsets.begin(), block.memberOffsets.end());
+            }
+            m_pushConstants.stageFlags = m_stages;
+            m_pushConstants.offset = offset;
+            m_pushConstants.size = module.typeSize(typeId) - offset;
+            continue;
+        }
+
+        if (variable.set == Unset || variable.binding == Unset) {
+            continue;
+        }
+
+        ReflectedBinding binding;
+        binding.binding = variable.binding;
+        binding.stageFlags = m_stages;
+        binding.name = variable.name;
+
+        // Unwrap descriptor arrays
+        while (module.id(typeId).opcode == OpTypeArray || module.id(typeId).opcode == OpTypeRuntimeArray) {
+            const SpirvId& array = module.id(typeId);
+            binding.descriptorCount = array.opcode == OpTypeArray
+                                          ? binding.descriptorCount * module.constantValue(array.operands[1])
+                                          : 0;
+            typeId = array.operands[0];
+        }
+
+        const SpirvId& type = module.id(typeId);
+        switch (type.opcode) {
+        case OpTypeStruct:
+            binding.descriptorType = (storageClass == StorageClassStorageBuffer || type.bufferBlock)
+                                         ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                                         : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            binding.blockSize = module.typeSize(typeId);
+            if (binding.name.empty()) {
+                binding.name = type.name;
+            }
+            break;
+        case OpTypeSampledImage: {
+            const SpirvId& image = module.id(type.operands[0]);
+            binding.descriptorType = image.operands[1] == DimBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+                                                                    : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            break;
+        }
+        case OpTypeSampler:
+            binding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+            break;
+        case OpTypeImage:
+            binding.descriptorType = imageDescriptorType(type);
+            break;
+        default:
+            throw std::runtime_error("Unsupported descriptor type in shader: " + binding.name);
+        }
+
+        m_sets[variable.set][binding.binding] = binding;
+    }
+}
+
+ShaderReflection& ShaderReflection::merge(const ShaderReflection& other) {
+    m_stages |= other.m_stages;
+
+    for (const auto& [setIndex, set] : other.m_sets) {
+        ReflectedSet& target = m_sets[setIndex];
+        for (const auto& [bindingIndex, binding] : set) {
+            auto it = target.find(bindingIndex);
+            if (it == target.end()) {
+                target[bindingIndex] = binding;
+                continue;
+            }
+
+            if (it->second.descriptorType != binding.descriptorType ||
+                it->second.descriptorCount != binding.descriptorCount) {
+                throw std::runtime_error("Shader stages disagree on set " + std::to_string(setIndex) +
+                                         ", binding " + std::to_string(bindingIndex));
+            }
+            it->second.stageFlags |= binding.stageFlags;
+            it->second.blockSize = std::max(it->second.blockSize, binding.blockSize);
+        }
+    }
+
+    if (other.hasPushConstants()) {
+        if (!hasPushConstants()) {
+            m_pushConstants = other.m_pushConstants;
+        } else {
+            uint32_t begin = std::min(m_pushConstants.offset, other.m_pushConstants.offset);
+            uint32_t end = std::max(m_pushConstants.offset + m_pushConstants.size,
+                                    other.m_pushConstants.offset + other.m_pushConstants.size);
+            m_pushConstants.stageFlags |= other.m_pushConstants.stageFlags;
+            m_pushConstants.offset = begin;
+            m_pushConstants.size = end - begin;
+        }
+    }
+
+    return *this;
+}
+
+} // namespace vks
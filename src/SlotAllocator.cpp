@@ -0,0 +1,48 @@
+#include <vks/SlotAllocator.hpp>
+
+#include <cassert>
+
+namespace vks {
+
+SlotAllocator::SlotAllocator(uint32_t capacity, uint32_t retireFrames)
+    : m_capacity(capacity), m_retireFrames(retireFrames)
+{
+}
+
+uint32_t SlotAllocator::allocate()
+{
+    uint32_t slot;
+    if (!m_free.empty()) {
+        slot = m_free.back();
+        m_free.pop_back();
+    } else if (m_highWater < m_capacity) {
+        slot = m_highWater++;
+    } else {
+        return InvalidSlot;
+    }
+    ++m_used;
+    return slot;
+}
+
+void SlotAllocator::free(uint32_t slot)
+{
+    assert(slot < m_highWater && m_used > 0 && "Slot was not allocated");
+    if (m_retireFrames == 0) {
+        m_free.push_back(slot);
+        --m_used;
+        return;
+    }
+    m_retiring.emplace_back(m_frame, slot);
+}
+
+void SlotAllocator::nextFrame()
+{
+    ++m_frame;
+    while (!m_retiring.empty() && m_retiring.front().first + m_retireFrames <= m_frame) {
+        m_free.push_back(m_retiring.front().second);
+        m_retiring.pop_front();
+        --m_used;
+    }
+}
+
+} // namespace vks
@@ -0,0 +1,273 @@
+#include <vks/SpatialGrid.hpp>
+
+#include <vks/ThreadPool.hpp>
+#include <vks/Transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vks {
+
+static constexpr size_t ItemsPerChunk = 16384;
+// Cell coordinates are packed in 21 bits each
+static constexpr int CellLimit = (1 << 20) - 1;
+// Frustum queries stop splitting cell ranges at this many cells
+static constexpr int64_t LeafCells = 8;
+// Frustum queries scan the items when there are more cells than this per item
+static constexpr int64_t SparseCells = 4;
+
+static uint64_t cellKey(int x, int y, int z)
+{
+    auto bits = [](int c) { return static_cast<uint64_t>(c + CellLimit + 1) & 0x1FFFFF; };
+    return (bits(x) << 42) | (bits(y) << 21) | bits(z);
+}
+
+static uint32_t bucketOf(uint64_t key, uint32_t mask)
+{
+    // Fibonacci hashing, the high bits mix every coordinate
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+static int64_t cellCount(const glm::ivec3& min, const glm::ivec3& max)
+{
+    return int64_t(max.x - min.x + 1) * (max.y - min.y + 1) * (max.z - min.z + 1);
+}
+
+static bool inFrustum(const glm::vec4 planes[6], const glm::vec4& sphere)
+{
+    for (int p = 0; p < 6; ++p) {
+        if (glm::dot(glm::vec3(planes[p]), glm::vec3(sphere)) + planes[p].w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
+
+glm::ivec3 SpatialGrid::cellOf(const glm::vec3& position) const
+{
+    glm::ivec3 cell;
+    for (int axis = 0; axis < 3; ++axis) {
+        float c = std::floor(position[axis] / m_cellSize);
+        cell[axis] = static_cast<int>(std::clamp(c, float(-CellLimit), float(CellLimit)));
+    }
+    return cell;
+}
+
+void SpatialGrid::rebuild(const vks::mesh::BoundingSphere* spheres, uint32_t count, float cellSize)
+{
+    m_cellSize = cellSize;
+    m_maxRadius = 0.0f;
+    m_items.resize(count);
+    m_spheres.resize(count);
+    m_cells.resize(count);
+    m_itemCells.resize(count);
+
+    // At least one bucket per item keeps collisions rare
+    uint32_t bucketCount = 1;
+    while (bucketCount < count) {
+        bucketCount <<= 1;
+    }
+    m_bucketMask = bucketCount - 1;
+    if (m_cursorCount != bucketCount) {
+        m_cursors.reset(new std::atomic<uint32_t>[bucketCount]);
+        m_cursorCount = bucketCount;
+    }
+    parallelFor(0, bucketCount, ItemsPerChunk, [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; ++b) {
+            m_cursors[b].store(0, std::memory_order_relaxed);
+        }
+    });
+
+    // 1. Cell of every item, counted into its bucket, with the occupied
+    // cells and the largest radius
+    struct Extent
+    {
+        CellRange cells{glm::ivec3(CellLimit), glm::ivec3(-CellLimit)};
+        float maxRadius = 0.0f;
+    };
+    size_t chunks = (count + ItemsPerChunk - 1) / ItemsPerChunk;
+    std::vector<Extent> extents(chunks);
+    parallelFor(0, chunks, 1, [&](size_t first, size_t last)
+    {
+        for (size_t c = first; c < last; ++c) {
+            Extent& extent = extents[c];
+            size_t end = std::min<size_t>(count, (c + 1) * ItemsPerChunk);
+            for (size_t i = c * ItemsPerChunk; i < end; ++i) {
+                glm::ivec3 cell = cellOf(spheres[i].center);
+                uint64_t key = cellKey(cell.x, cell.y, cell.z);
+                m_itemCells[i] = key;
+                m_cursors[bucketOf(key, m_bucketMask)].fetch_add(1, std::memory_order_relaxed);
+                for (int axis = 0; axis < 3; ++axis) {
+                    extent.cells.min[axis] = std::min(extent.cells.min[axis], cell[axis]);
+                    extent.cells.max[axis] = std::max(extent.cells.max[axis], cell[axis]);
+                }
+                extent.maxRadius = std::max(extent.maxRadius, spheres[i].radius);
+            }
+        }
+    });
+    m_occupied = Extent{}.cells;
+    for (const Extent& extent : extents) {
+        for (int axis = 0; axis < 3; ++axis) {
+            m_occupied.min[axis] = std::min(m_occupied.min[axis], extent.cells.min[axis]);
+            m_occupied.max[axis] = std::max(m_occupied.max[axis], extent.cells.max[axis]);
+        }
+        m_maxRadius = std::max(m_maxRadius, extent.maxRadius);
+    }
+
+    // 2. Exclusive prefix sum of the counts: per block, then the blocks
+    size_t blocks = (bucketCount + ItemsPerChunk - 1) / ItemsPerChunk;
+    std::vector<uint32_t> blockOffsets(blocks + 1, 0);
+    m_bucketStart.resize(size_t(bucketCount) + 1);
+    parallelFor(0, blocks, 1, [&](size_t first, size_t last)
+    {
+        for (size_t block = first; block < last; ++block) {
+            uint32_t sum = 0;
+            size_t end = std::min<size_t>(bucketCount, (block + 1) * ItemsPerChunk);
+            for (size_t b = block * ItemsPerChunk; b < end; ++b) {
+                m_bucketStart[b] = sum;
+                sum += m_cursors[b].load(std::memory_order_relaxed);
+            }
+            blockOffsets[block + 1] = sum;
+        }
+    });
+    for (size_t block = 0; block < blocks; ++block) {
+        blockOffsets[block + 1] += blockOffsets[block];
+    }
+    parallelFor(0, bucketCount, ItemsPerChunk, [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; ++b) {
+            m_bucketStart[b] += blockOffsets[b / ItemsPerChunk];
+            m_cursors[b].store(m_bucketStart[b], std::memory_order_relaxed);
+        }
+    });
+    m_bucketStart[bucketCount] = count;
+
+    // 3. Scatter. The order within a bucket depends on the threads, the
+    // queries don't mind.
+    parallelFor(0, count, ItemsPerChunk, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t key = m_itemCells[i];
+            uint32_t position = m_cursors[bucketOf(key, m_bucketMask)].fetch_add(1, std::memory_order_relaxed);
+            m_items[position] = static_cast<uint32_t>(i);
+            m_spheres[position] = glm::vec4(spheres[i].center, spheres[i].radius);
+            m_cells[position] = key;
+        }
+    });
+}
+
+void SpatialGrid::appendCells(const CellRange& range, const glm::vec4* planes, std::vector<uint32_t>& out) const
+{
+    for (int z = range.min.z; z <= range.max.z; ++z) {
+        for (int y = range.min.y; y <= range.max.y; ++y) {
+            for (int x = range.min.x; x <= range.max.x; ++x) {
+                uint64_t key = cellKey(x, y, z);
+                uint32_t bucket = bucketOf(key, m_bucketMask);
+                for (uint32_t i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; ++i) {
+                    if (m_cells[i] != key) {
+                        continue;
+                    }
+                    if (planes == nullptr || inFrustum(planes, m_spheres[i])) {
+                        out.push_back(m_items[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::queryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& out) const
+{
+    if (empty()) {
+        return;
+    }
+
+    // Cells too sparse to pay for visiting them: scan the items
+    if (cellCount(m_occupied.min, m_occupied.max) > SparseCells * int64_t(size())) {
+        for (uint32_t i = 0; i < size(); ++i) {
+            if (inFrustum(planes, m_spheres[i])) {
+                out.push_back(m_items[i]);
+            }
+        }
+        return;
+    }
+
+    // Splits the occupied cells in halves like an implicit octree, the
+    // boxes loosened by the largest radius
+    std::vector<CellRange> stack{m_occupied};
+    while (!stack.empty()) {
+        CellRange range = stack.back();
+        stack.pop_back();
+
+        glm::vec3 min = glm::vec3(range.min.x, range.min.y, range.min.z) * m_cellSize - m_maxRadius;
+        glm::vec3 max = glm::vec3(range.max.x + 1, range.max.y + 1, range.max.z + 1) * m_cellSize + m_maxRadius;
+        transform::FrustumOverlap overlap = transform::testBox(planes, min, max);
+        if (overlap == transform::FrustumOverlap::Outside) {
+            continue;
+        }
+        if (overlap == transform::FrustumOverlap::Inside || cellCount(range.min, range.max) <= LeafCells) {
+            appendCells(range, overlap == transform::FrustumOverlap::Inside ? nullptr : planes, out);
+            continue;
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; ++a) {
+            if (range.max[a] - range.min[a] > range.max[axis] - range.min[axis]) {
+                axis = a;
+            }
+        }
+        CellRange upper = range;
+        range.max[axis] = range.min[axis] + (range.max[axis] - range.min[axis]) / 2;
+        upper.min[axis] = range.max[axis] + 1;
+        stack.push_back(range);
+        stack.push_back(upper);
+    }
+}
+
+void SpatialGrid::queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const
+{
+    if (empty()) {
+        return;
+    }
+
+    // Only the occupied cells a sphere reaching this far can be centered in
+    CellRange range{cellOf(center - (radius + m_maxRadius)), cellOf(center + (radius + m_maxRadius))};
+    for (int axis = 0; axis < 3; ++axis) {
+        range.min[axis] = std::max(range.min[axis], m_occupied.min[axis]);
+        range.max[axis] = std::min(range.max[axis], m_occupied.max[axis]);
+        if (range.min[axis] > range.max[axis]) {
+            return;
+        }
+    }
+
+    // A query covering more cells than there are items scans the items
+    if (cellCount(range.min, range.max) > int64_t(size())) {
+        for (uint32_t i = 0; i < size(); ++i) {
+            glm::vec3 offset = glm::vec3(m_spheres[i]) - center;
+            float reach = radius + m_spheres[i].w;
+            if (glm::dot(offset, offset) <= reach * reach) {
+                out.push_back(m_items[i]);
+            }
+        }
+        return;
+    }
+
+    for (int z = range.min.z; z <= range.max.z; ++z) {
+        for (int y = range.min.y; y <= range.max.y; ++y) {
+            for (int x = range.min.x; x <= range.max.x; ++x) {
+                uint64_t key = cellKey(x, y, z);
+                uint32_t bucket = bucketOf(key, m_bucketMask);
+                for (uint32_t i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; ++i) {
+                    glm::vec3 offset = glm::vec3(m_spheres[i]) - center;
+                    float reach = radius + m_spheres[i].w;
+                    if (m_cells[i] == key && glm::dot(offset, offset) <= reach * reach) {
+                        out.push_back(m_items[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace vks
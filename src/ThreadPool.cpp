@@ -0,0 +1,151 @@
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+using namespace vks;
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+    if (m_workers.empty()) {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping && m_jobs.empty()) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+namespace {
+
+// Shared by the threads working on one parallelFor()
+struct ParallelForState {
+    size_t begin = 0;
+    size_t end = 0;
+    size_t chunkSize = 0;
+    size_t chunkCount = 0;
+    ThreadPool::RangeFunc func;
+
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> doneChunks{0};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+
+    // Claims and runs chunks until none is left
+    void run() {
+        for (;;) {
+            size_t chunk = nextChunk.fetch_add(1);
+            if (chunk >= chunkCount) {
+                return;
+            }
+
+            size_t chunkBegin = begin + chunk * chunkSize;
+            size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+            try {
+                func(chunkBegin, chunkEnd);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+
+            if (doneChunks.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grainSize, const RangeFunc& func) {
+    if (end <= begin) {
+        return;
+    }
+
+    size_t count = end - begin;
+    size_t threads = m_workers.size() + 1;
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // Small ranges don't pay for the synchronization
+    if (threads == 1 || count <= grainSize) {
+        func(begin, end);
+        return;
+    }
+
+    // A few chunks per thread to balance uneven rows
+    size_t chunkSize = std::max(grainSize, (count + threads * 4 - 1) / (threads * 4));
+
+    auto state = std::make_shared<ParallelForState>();
+    state->begin = begin;
+    state->end = end;
+    state->chunkSize = chunkSize;
+    state->chunkCount = (count + chunkSize - 1) / chunkSize;
+    state->func = func;
+
+    size_t helpers = std::min(m_workers.size(), state->chunkCount - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([state] { state->run(); });
+    }
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->doneChunks.load() == state->chunkCount; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
@@ -0,0 +1,153 @@
+#include <vks/Transform.hpp>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VKS_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace vks {
+namespace transform {
+
+// Determinants below this are treated as degenerate (flattened objects):
+// the cofactors still give a usable normal direction.
+static constexpr float DegenerateDeterminant = 1e-20f;
+
+#ifdef VKS_TRANSFORM_SSE
+
+// (a.y, a.z, a.x, a.w)
+static inline __m128 yzx(__m128 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)); }
+
+// cross(a, b) in xyz, 0 in w
+static inline __m128 cross(__m128 a, __m128 b) {
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, yzx(b)), _mm_mul_ps(yzx(a), b));
+    return yzx(c);
+}
+
+void computeObjectTransforms(const glm::mat4* models, ObjectTransform* out, size_t count) {
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+    for (size_t i = 0; i < count; ++i) {
+        const float* m = &models[i][0][0];
+        float* n = &out[i].normal[0][0];
+
+        __m128 c0 = _mm_and_ps(_mm_loadu_ps(m + 0), xyzMask);
+        __m128 c1 = _mm_and_ps(_mm_loadu_ps(m + 4), xyzMask);
+        __m128 c2 = _mm_and_ps(_mm_loadu_ps(m + 8), xyzMask);
+
+        // Columns of the inverse-transpose are the cofactors / det
+        __m128 n0 = cross(c1, c2);
+        __m128 n1 = cross(c2, c0);
+        __m128 n2 = cross(c0, c1);
+
+        __m128 d = _mm_mul_ps(c0, n0);
+        d = _mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)));
+        d = _mm_add_ss(d, _mm_movehl_ps(d, d));
+        float det = _mm_cvtss_f32(d);
+
+        __m128 invDet = _mm_set1_ps(std::fabs(det) > DegenerateDeterminant ? 1.0f / det : 1.0f);
+
+        std::memcpy(&out[i].model, &models[i], sizeof(glm::mat4));
+        _mm_storeu_ps(n + 0, _mm_mul_ps(n0, invDet));
+        _mm_storeu_ps(n + 4, _mm_mul_ps(n1, invDet));
+        _mm_storeu_ps(n + 8, _mm_mul_ps(n2, invDet));
+    }
+}
+
+void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+    const float* pa = &a[0][0];
+    const float* pb = &b[0][0];
+    float* po = &out[0][0];
+
+    // Every column of a is loaded before out is written
+    __m128 a0 = _mm_loadu_ps(pa + 0);
+    __m128 a1 = _mm_loadu_ps(pa + 4);
+    __m128 a2 = _mm_loadu_ps(pa + 8);
+    __m128 a3 = _mm_loadu_ps(pa + 12);
+    for (int c = 0; c < 4; ++c) {
+        const float* column = pb + 4 * c;
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(column[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+        _mm_storeu_ps(po + 4 * c, r);
+    }
+}
+
+#else
+
+void computeObjectTransforms(const glm::mat4* models, ObjectTransform* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const glm::mat4& m = models[i];
+        glm::vec3 c0(m[0]), c1(m[1]), c2(m[2]);
+
+        glm::vec3 n0 = glm::cross(c1, c2);
+        glm::vec3 n1 = glm::cross(c2, c0);
+        glm::vec3 n2 = glm::cross(c0, c1);
+
+        float det = glm::dot(c0, n0);
+        float invDet = std::fabs(det) > DegenerateDeterminant ? 1.0f / det : 1.0f;
+
+        out[i].model = m;
+        out[i].normal = glm::mat3x4(glm::vec4(n0 * invDet, 0.0f), glm::vec4(n1 * invDet, 0.0f),
+                                    glm::vec4(n2 * invDet, 0.0f));
+    }
+}
+
+void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+    out = a * b;
+}
+
+#endif
+
+glm::mat4 compose(const LocalTransform& local) {
+    const glm::quat& q = local.rotation;
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    // Rotation columns scaled by the per-axis scale, translation last
+    glm::mat4 m(1.0f);
+    m[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * local.scale.x;
+    m[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * local.scale.y;
+    m[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * local.scale.z;
+    m[3] = glm::vec4(local.translation, 1.0f);
+    return m;
+}
+
+void extractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]) {
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; ++r) {
+        rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+    }
+
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[2]; // 0 <= z
+    planes[5] = rows[3] - rows[2];
+    for (int p = 0; p < 6; ++p) {
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+    }
+}
+
+FrustumOverlap testBox(const glm::vec4 planes[6], const glm::vec3& min, const glm::vec3& max) {
+    // Outside when the corner furthest along a plane normal is behind it,
+    // inside when the nearest corner is in front of all of them
+    bool inside = true;
+    for (int p = 0; p < 6; ++p) {
+        glm::vec3 normal(planes[p]);
+        glm::bvec3 positive = glm::greaterThan(normal, glm::vec3(0.0f));
+        if (glm::dot(normal, glm::mix(min, max, positive)) + planes[p].w < 0.0f) {
+            return FrustumOverlap::Outside;
+        }
+        inside = inside && glm::dot(normal, glm::mix(max, min, positive)) + planes[p].w >= 0.0f;
+    }
+    return inside ? FrustumOverlap::Inside : FrustumOverlap::Intersects;
+}
+
+} // namespace transform
+} // namespace vks
@@ -0,0 +1,263 @@
+#include <vks/TransformHierarchy.hpp>
+
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace vks {
+
+// A node costs a TRS composition and a matrix product: below this many per
+// task the thread hop costs more
+static constexpr size_t NodesPerTask = 2048;
+
+TransformHierarchy::NodeId TransformHierarchy::create(NodeId parent, const LocalTransform& local)
+{
+    uint32_t parentIndex = InvalidIndex;
+    uint32_t depth = 0;
+    if (parent != NoNode) {
+        parentIndex = indexOf(parent);
+        if (parentIndex == InvalidIndex) {
+            throw std::runtime_error("Invalid transform hierarchy parent");
+        }
+        depth = m_depth[parentIndex] + 1;
+    }
+
+    NodeId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = static_cast<NodeId>(m_indexOf.size());
+        m_indexOf.push_back(InvalidIndex);
+    }
+
+    // Appending keeps the order breadth-first unless the node belongs to an
+    // earlier level; the parent still comes first either way
+    uint32_t index = size();
+    if (m_levelStart.empty()) {
+        m_levelStart.push_back(0);
+    }
+    if (!m_depth.empty() && depth < m_depth.back()) {
+        m_unsorted = true;
+    } else if (!m_unsorted) {
+        if (depth + 1 == m_levelStart.size()) {
+            m_levelStart.push_back(index + 1);
+        } else {
+            m_levelStart.back() = index + 1;
+        }
+    }
+
+    m_local.push_back(local);
+    m_world.emplace_back(1.0f);
+    m_parent.push_back(parentIndex);
+    m_depth.push_back(depth);
+    m_dirty.push_back(1);
+    m_ids.push_back(id);
+    m_indexOf[id] = index;
+    m_anyDirty = true;
+    return id;
+}
+
+void TransformHierarchy::assign(const LocalTransform* locals, const uint32_t* parents, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parents[i] != InvalidIndex && parents[i] >= i) {
+            throw std::runtime_error("Transform hierarchy parents must come before their children");
+        }
+    }
+
+    m_local.assign(locals, locals + count);
+    m_parent.assign(parents, parents + count);
+    m_world.assign(count, glm::mat4(1.0f));
+    m_dirty.assign(count, 1);
+    m_ids.resize(count);
+    m_indexOf.resize(count);
+    m_freeIds.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        m_ids[i] = i;
+        m_indexOf[i] = i;
+    }
+
+    // Breadth-first input keeps its order, anything else is sorted by the
+    // next update()
+    m_depth.resize(count);
+    m_levelStart.assign(1, 0);
+    m_unsorted = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t depth = parents[i] == InvalidIndex ? 0 : m_depth[parents[i]] + 1;
+        m_depth[i] = depth;
+        if (i > 0 && depth < m_depth[i - 1]) {
+            m_unsorted = true;
+        } else if (!m_unsorted) {
+            if (depth + 1 == m_levelStart.size()) {
+                m_levelStart.push_back(i + 1);
+            } else {
+                m_levelStart.back() = i + 1;
+            }
+        }
+    }
+    m_anyDirty = count > 0;
+}
+
+void TransformHierarchy::destroy(NodeId node)
+{
+    uint32_t root = indexOf(node);
+    if (root == InvalidIndex) {
+        return;
+    }
+
+    // Children come after their parent, one pass finds the whole subtree
+    std::vector<uint8_t> removed(size(), 0);
+    removed[root] = 1;
+    for (uint32_t i = root + 1; i < size(); ++i) {
+        removed[i] = m_parent[i] != InvalidIndex && removed[m_parent[i]];
+    }
+
+    std::vector<uint32_t> newIndex(size(), InvalidIndex);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < size(); ++i) {
+        if (removed[i]) {
+            m_indexOf[m_ids[i]] = InvalidIndex;
+            m_freeIds.push_back(m_ids[i]);
+            continue;
+        }
+        newIndex[i] = kept;
+        m_local[kept] = m_local[i];
+        m_world[kept] = m_world[i];
+        m_parent[kept] = m_parent[i] == InvalidIndex ? InvalidIndex : newIndex[m_parent[i]];
+        m_depth[kept] = m_depth[i];
+        m_dirty[kept] = m_dirty[i];
+        m_ids[kept] = m_ids[i];
+        m_indexOf[m_ids[i]] = kept;
+        ++kept;
+    }
+    m_local.resize(kept);
+    m_world.resize(kept);
+    m_parent.resize(kept);
+    m_depth.resize(kept);
+    m_dirty.resize(kept);
+    m_ids.resize(kept);
+
+    // Still sorted, but the level ranges moved
+    m_unsorted = true;
+}
+
+uint32_t TransformHierarchy::checkedIndex(NodeId node) const
+{
+    uint32_t index = indexOf(node);
+    if (index == InvalidIndex) {
+        throw std::runtime_error("Invalid transform hierarchy node");
+    }
+    return index;
+}
+
+void TransformHierarchy::setLocal(NodeId node, const LocalTransform& local)
+{
+    uint32_t index = checkedIndex(node);
+    m_local[index] = local;
+    m_dirty[index] = 1;
+    m_anyDirty = true;
+}
+
+TransformHierarchy::NodeId TransformHierarchy::getParent(NodeId node) const
+{
+    uint32_t parent = m_parent[checkedIndex(node)];
+    return parent == InvalidIndex ? NoNode : m_ids[parent];
+}
+
+uint32_t TransformHierarchy::levelCount() const
+{
+    if (m_depth.empty()) {
+        return 0;
+    }
+    return *std::max_element(m_depth.begin(), m_depth.end()) + 1;
+}
+
+size_t TransformHierarchy::update()
+{
+    if (!m_anyDirty) {
+        return 0;
+    }
+    if (m_unsorted) {
+        sortLevels();
+    }
+
+    // A level only reads the level above it, finished before it starts.
+    // Recomputed nodes stay flagged until the end, so their children follow.
+    std::atomic<size_t> updated{0};
+    for (size_t level = 0; level + 1 < m_levelStart.size(); ++level) {
+        parallelFor(m_levelStart[level], m_levelStart[level + 1], NodesPerTask, [&](size_t begin, size_t end)
+        {
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t parent = m_parent[i];
+                bool parentDirty = parent != InvalidIndex && m_dirty[parent];
+                if (!m_dirty[i] && !parentDirty) {
+                    continue;
+                }
+                m_dirty[i] = 1;
+
+                glm::mat4 local = transform::compose(m_local[i]);
+                if (parent == InvalidIndex) {
+                    m_world[i] = local;
+                } else {
+                    transform::multiply(m_world[parent], local, m_world[i]);
+                }
+                ++count;
+            }
+            updated += count;
+        });
+    }
+
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_anyDirty = false;
+    return updated;
+}
+
+void TransformHierarchy::sortLevels()
+{
+    uint32_t levels = levelCount();
+
+    // Counting sort by depth, stable so parents stay before their children
+    m_levelStart.assign(levels + 1, 0);
+    for (uint32_t depth : m_depth) {
+        ++m_levelStart[depth + 1];
+    }
+    for (uint32_t level = 0; level < levels; ++level) {
+        m_levelStart[level + 1] += m_levelStart[level];
+    }
+
+    std::vector<uint32_t> next(m_levelStart.begin(), m_levelStart.end() - 1);
+    std::vector<uint32_t> newIndex(size());
+    for (uint32_t i = 0; i < size(); ++i) {
+        newIndex[i] = next[m_depth[i]]++;
+    }
+
+    std::vector<LocalTransform> local(size());
+    std::vector<glm::mat4> world(size());
+    std::vector<uint32_t> parent(size());
+    std::vector<uint32_t> depth(size());
+    std::vector<uint8_t> dirty(size());
+    std::vector<NodeId> ids(size());
+    for (uint32_t i = 0; i < size(); ++i) {
+        uint32_t j = newIndex[i];
+        local[j] = m_local[i];
+        world[j] = m_world[i];
+        parent[j] = m_parent[i] == InvalidIndex ? InvalidIndex : newIndex[m_parent[i]];
+        depth[j] = m_depth[i];
+        dirty[j] = m_dirty[i];
+        ids[j] = m_ids[i];
+        m_indexOf[m_ids[i]] = j;
+    }
+    m_local = std::move(local);
+    m_world = std::move(world);
+    m_parent = std::move(parent);
+    m_depth = std::move(depth);
+    m_dirty = std::move(dirty);
+    m_ids = std::move(ids);
+    m_unsorted = false;
+}
+
+} // namespace vks
@@ -0,0 +1,469 @@
+#include <vks/WorldPartition.hpp>
+
+#include <vks/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace vks {
+
+namespace {
+
+std::string cellFileName(int x, int y)
+{
+    return "cell_" + std::to_string(x) + "_" + std::to_string(y) + ".vksscene";
+}
+
+} // namespace
+
+struct WorldPartition::State
+{
+    struct CellResult
+    {
+        size_t cell;
+        std::unique_ptr<SceneFile> file; // Null on failure
+        std::string error;
+    };
+
+    struct MeshResult
+    {
+        std::string name;
+        std::unique_ptr<mesh::MeshFile> file; // Null on failure
+        std::string error;
+    };
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::vector<CellResult> cells;
+    std::vector<MeshResult> meshes;
+    size_t jobsInFlight = 0;
+
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --jobsInFlight;
+        idle.notify_all();
+    }
+};
+
+WorldPartition::WorldPartition(const std::string& directory, const Settings& settings, Callbacks callbacks)
+    : m_directory(directory), m_settings(settings), m_callbacks(std::move(callbacks)),
+      m_state(std::make_shared<State>())
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        int x = 0;
+        int y = 0;
+        char end = 0;
+        std::string name = entry.path().filename().string();
+        if (std::sscanf(name.c_str(), "cell_%d_%d.vksscen%c", &x, &y, &end) != 3 || end != 'e' ||
+            name != cellFileName(x, y)) {
+            continue;
+        }
+        Cell cell;
+        cell.coord = glm::ivec2(x, y);
+        cell.path = entry.path().string();
+        cell.bytes = static_cast<size_t>(entry.file_size(error));
+        m_cells.push_back(std::move(cell));
+    }
+    if (error) {
+        throw std::runtime_error("Failed to list world directory " + directory + ": " + error.message());
+    }
+}
+
+WorldPartition::~WorldPartition()
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->idle.wait(lock, [&] { return m_state->jobsInFlight == 0; });
+}
+
+float WorldPartition::distanceTo(const Cell& cell) const
+{
+    // To the closest point of the cell's square
+    glm::vec2 min = glm::vec2(cell.coord) * m_settings.cellSize;
+    glm::vec2 max = min + m_settings.cellSize;
+    glm::vec2 closest = glm::clamp(m_camera, min, max);
+    return glm::length(m_camera - closest);
+}
+
+bool WorldPartition::update(const glm::vec3& camera, Scene& scene)
+{
+    m_camera = glm::vec2(camera);
+    size_t sceneSize = scene.size();
+    bool changed = false;
+
+    collectResults();
+
+    // Leaving cells, and cells whose meshes failed
+    for (Cell& cell : m_cells) {
+        bool loaded = cell.state == CellState::Waiting || cell.state == CellState::Resident;
+        if (!loaded) {
+            continue;
+        }
+        bool failed = std::any_of(cell.meshes.begin(), cell.meshes.end(),
+                                  [](const MeshEntry* mesh) { return mesh->state == MeshState::Failed; });
+        if (failed || distanceTo(cell) > m_settings.unloadRadius) {
+            changed |= cell.state == CellState::Resident;
+            evict(cell, scene);
+            cell.state = failed ? CellState::Failed : CellState::Unloaded;
+        }
+    }
+
+    uploadMeshes(scene);
+
+    for (Cell& cell : m_cells) {
+        if (cell.state == CellState::Waiting) {
+            changed |= instantiate(cell, scene);
+        }
+    }
+
+    // New cells in range, nearest first, while the budget allows
+    std::vector<std::pair<float, size_t>> wanted;
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        float distance = distanceTo(m_cells[i]);
+        if (m_cells[i].state == CellState::Unloaded && distance <= m_settings.loadRadius) {
+            wanted.emplace_back(distance, i);
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+    for (const auto& candidate : wanted) {
+        Cell& cell = m_cells[candidate.second];
+        if (m_loadsInFlight >= m_settings.maxLoadsInFlight) {
+            break;
+        }
+        if (m_cpuBytes + cell.bytes > m_settings.cpuBudget) {
+            size_t before = scene.size();
+            bool room = makeRoom(cell.bytes, false, scene);
+            changed |= scene.size() != before;
+            if (!room) {
+                break;
+            }
+        }
+
+        cell.state = CellState::Loading;
+        m_cpuBytes += cell.bytes;
+        ++m_loadsInFlight;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            ++m_state->jobsInFlight;
+        }
+        std::shared_ptr<State> state = m_state;
+        size_t index = candidate.second;
+        std::string path = cell.path;
+        ThreadPool::global().submit([state, index, path]()
+        {
+            State::CellResult result{index, nullptr, {}};
+            try {
+                result.file = std::make_unique<SceneFile>(path);
+                // The main thread then copies from memory, not from disk
+                result.file->prefetch();
+            } catch (const std::exception& e) {
+                result.file.reset();
+                result.error = path + ": " + e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cells.push_back(std::move(result));
+            }
+            state->finish();
+        });
+    }
+
+    return changed || scene.size() != sceneSize;
+}
+
+void WorldPartition::collectResults()
+{
+    std::vector<State::CellResult> cells;
+    std::vector<State::MeshResult> meshes;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        cells.swap(m_state->cells);
+        meshes.swap(m_state->meshes);
+    }
+
+    for (State::MeshResult& result : meshes) {
+        auto it = m_meshes.find(result.name);
+        MeshEntry& entry = it->second;
+        if (entry.refs == 0) {
+            // Every cell needing it left while it was loading
+            m_meshes.erase(it);
+            continue;
+        }
+        if (!result.file) {
+            std::cerr << "Failed to load " << result.error << std::endl;
+            entry.state = MeshState::Failed;
+            continue;
+        }
+        entry.fileBytes = result.file->vertexDataSize() + result.file->indexDataSize();
+        entry.gpuBytes = entry.fileBytes;
+        entry.file = std::move(result.file);
+        entry.state = MeshState::Ready;
+        m_cpuBytes += entry.fileBytes;
+        m_uploads.push_back(entry.name);
+    }
+
+    for (State::CellResult& result : cells) {
+        Cell& cell = m_cells[result.cell];
+        --m_loadsInFlight;
+        if (!result.file) {
+            std::cerr << "Failed to load " << result.error << std::endl;
+            cell.state = CellState::Failed;
+            m_cpuBytes -= cell.bytes;
+            continue;
+        }
+        // The camera may have moved away meanwhile
+        if (distanceTo(cell) > m_settings.unloadRadius) {
+            cell.state = CellState::Unloaded;
+            m_cpuBytes -= cell.bytes;
+            continue;
+        }
+        cell.file = std::move(result.file);
+        cell.state = CellState::Waiting;
+        requestMeshes(cell);
+    }
+}
+
+void WorldPartition::requestMeshes(Cell& cell)
+{
+    cell.meshes.clear();
+    for (uint32_t i = 0; i < cell.file->meshCount(); ++i) {
+        std::string name(cell.file->meshName(i));
+        auto inserted = m_meshes.try_emplace(name);
+        MeshEntry& entry = inserted.first->second;
+        ++entry.refs;
+        cell.meshes.push_back(&entry);
+        if (!inserted.second) {
+            continue;
+        }
+
+        entry.name = name;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            ++m_state->jobsInFlight;
+        }
+        std::shared_ptr<State> state = m_state;
+        std::string path = (std::filesystem::path(m_directory) / name).string();
+        ThreadPool::global().submit([state, name, path]()
+        {
+            State::MeshResult result{name, nullptr, {}};
+            try {
+                result.file = std::make_unique<mesh::MeshFile>(path);
+                result.file->prefetch();
+            } catch (const std::exception& e) {
+                result.file.reset();
+                result.error = path + ": " + e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->meshes.push_back(std::move(result));
+            }
+            state->finish();
+        });
+    }
+}
+
+void WorldPartition::releaseMesh(MeshEntry* entry)
+{
+    if (--entry->refs > 0) {
+        return;
+    }
+    switch (entry->state) {
+    case MeshState::Loading:
+        return; // Erased when its job is done
+    case MeshState::Ready:
+        m_cpuBytes -= entry->fileBytes;
+        break;
+    case MeshState::Uploaded:
+        m_gpuBytes -= entry->gpuBytes;
+        m_callbacks.releaseMesh(entry->name, entry->id);
+        break;
+    case MeshState::Failed:
+        break;
+    }
+    m_meshes.erase(entry->name);
+}
+
+void WorldPartition::evict(Cell& cell, Scene& scene)
+{
+    for (SceneHandle handle : cell.objects) {
+        scene.destroy(handle);
+    }
+    cell.objects.clear();
+    cell.file.reset();
+    for (MeshEntry* mesh : cell.meshes) {
+        releaseMesh(mesh);
+    }
+    cell.meshes.clear();
+    m_cpuBytes -= cell.bytes;
+    cell.state = CellState::Unloaded;
+}
+
+bool WorldPartition::makeRoom(size_t bytes, bool gpu, Scene& scene)
+{
+    auto fits = [&] {
+        return gpu ? m_gpuBytes + bytes <= m_settings.gpuBudget : m_cpuBytes + bytes <= m_settings.cpuBudget;
+    };
+
+    // Only cells the camera doesn't need, in the hysteresis band
+    std::vector<std::pair<float, size_t>> candidates;
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        const Cell& cell = m_cells[i];
+        float distance = distanceTo(cell);
+        bool loaded = cell.state == CellState::Waiting || cell.state == CellState::Resident;
+        if (loaded && distance > m_settings.loadRadius) {
+            candidates.emplace_back(distance, i);
+        }
+    }
+    std::sort(candidates.rbegin(), candidates.rend());
+    for (const auto& candidate : candidates) {
+        if (fits()) {
+            break;
+        }
+        evict(m_cells[candidate.second], scene);
+    }
+    return fits();
+}
+
+void WorldPartition::uploadMeshes(Scene& scene)
+{
+    size_t uploaded = 0;
+    while (!m_uploads.empty()) {
+        auto it = m_meshes.find(m_uploads.front());
+        if (it == m_meshes.end() || it->second.state != MeshState::Ready) {
+            m_uploads.pop_front(); // Released while waiting
+            continue;
+        }
+        MeshEntry& entry = it->second;
+        if (uploaded > 0 && uploaded + entry.gpuBytes > m_settings.uploadBudget) {
+            break;
+        }
+        if (m_gpuBytes + entry.gpuBytes > m_settings.gpuBudget && !makeRoom(entry.gpuBytes, true, scene)) {
+            break;
+        }
+        // makeRoom() may have released this very mesh
+        if (m_meshes.count(m_uploads.front()) == 0) {
+            m_uploads.pop_front();
+            continue;
+        }
+
+        entry.id = m_callbacks.uploadMesh(entry.name, entry.file->view());
+        entry.file.reset();
+        entry.state = MeshState::Uploaded;
+        m_cpuBytes -= entry.fileBytes;
+        m_gpuBytes += entry.gpuBytes;
+        uploaded += entry.gpuBytes;
+        m_uploads.pop_front();
+    }
+}
+
+bool WorldPartition::instantiate(Cell& cell, Scene& scene)
+{
+    std::vector<Scene::MeshId> meshes;
+    for (const MeshEntry* mesh : cell.meshes) {
+        if (mesh->state != MeshState::Uploaded) {
+            return false;
+        }
+        meshes.push_back(mesh->id);
+    }
+    std::vector<Scene::MaterialId> materials;
+    for (uint32_t i = 0; i < cell.file->materialCount(); ++i) {
+        materials.push_back(m_callbacks.resolveMaterial(std::string(cell.file->materialName(i))));
+    }
+
+    uint32_t first = appendScene(*cell.file, meshes.data(), materials.data(), scene);
+    cell.objects.resize(cell.file->objectCount());
+    for (uint32_t i = 0; i < cell.file->objectCount(); ++i) {
+        cell.objects[i] = scene.handleAt(first + i);
+    }
+    // The objects are in the scene, the file's pages can go
+    cell.file.reset();
+    cell.state = CellState::Resident;
+    return true;
+}
+
+void WorldPartition::unloadAll(Scene& scene)
+{
+    for (Cell& cell : m_cells) {
+        if (cell.state == CellState::Waiting || cell.state == CellState::Resident) {
+            evict(cell, scene);
+        }
+    }
+}
+
+WorldPartition::Stats WorldPartition::getStats() const
+{
+    Stats stats;
+    stats.cellCount = static_cast<uint32_t>(m_cells.size());
+    for (const Cell& cell : m_cells) {
+        stats.residentCells += cell.state == CellState::Resident;
+        stats.loadingCells += cell.state == CellState::Loading || cell.state == CellState::Waiting;
+    }
+    for (const auto& pair : m_meshes) {
+        stats.meshCount += pair.second.state == MeshState::Uploaded;
+    }
+    stats.cpuBytes = m_cpuBytes;
+    stats.gpuBytes = m_gpuBytes;
+    return stats;
+}
+
+uint32_t writeWorldPartition(const std::string& directory, float cellSize, const Scene& scene,
+                             const std::vector<std::string>& meshNames,
+                             const std::vector<std::string>& materialNames)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Objects by cell of their position
+    std::map<std::pair<int, int>, std::vector<uint32_t>> cells;
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+        const glm::vec4& position = scene.transforms()[i][3];
+        int x = static_cast<int>(std::floor(position.x / cellSize));
+        int y = static_cast<int>(std::floor(position.y / cellSize));
+        cells[{x, y}].push_back(i);
+    }
+
+    TransformHierarchy noHierarchy;
+    for (const auto& pair : cells) {
+        // Tables of the assets the cell uses, in order of first use
+        Scene cell;
+        std::vector<std::string> meshes;
+        std::vector<std::string> materials;
+        std::unordered_map<uint32_t, uint32_t> meshIndex;
+        std::unordered_map<uint32_t, uint32_t> materialIndex;
+        auto remap = [](uint32_t id, std::unordered_map<uint32_t, uint32_t>& index,
+                        std::vector<std::string>& names, const std::vector<std::string>& allNames)
+        {
+            auto inserted = index.try_emplace(id, static_cast<uint32_t>(names.size()));
+            if (inserted.second) {
+                if (id >= allNames.size()) {
+                    throw std::runtime_error("Scene object refers to an unnamed mesh or material");
+                }
+                names.push_back(allNames[id]);
+            }
+            return inserted.first->second;
+        };
+
+        for (uint32_t i : pair.second) {
+            Scene::MeshId mesh = scene.meshes()[i];
+            if (mesh != Scene::NoMesh) {
+                mesh = remap(mesh, meshIndex, meshes, meshNames);
+            }
+            Scene::MaterialId material = remap(scene.materials()[i], materialIndex, materials, materialNames);
+            cell.create(scene.transforms()[i], mesh, material, scene.flags()[i]);
+        }
+        writeSceneFile((std::filesystem::path(directory) / cellFileName(pair.first.first, pair.first.second)).string(),
+                       cell, noHierarchy, meshes, materials);
+    }
+    return static_cast<uint32_t>(cells.size());
+}
+
+} // namespace vks
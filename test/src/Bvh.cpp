@@ -0,0 +1,158 @@
+#include <doctest/doctest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vks/Bvh.hpp>
+#include <vks/Transform.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using vks::mesh::BoundingSphere;
+
+static std::vector<BoundingSphere> randomSpheres(size_t count,
+                                                 std::mt19937 &rng) {
+  std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> radius(0.1f, 2.0f);
+  std::vector<BoundingSphere> spheres(count);
+  for (BoundingSphere &sphere : spheres) {
+    sphere.center = {position(rng), position(rng), position(rng) * 0.1f};
+    sphere.radius = radius(rng);
+  }
+  return spheres;
+}
+
+static std::vector<uint32_t>
+linearFrustum(const std::vector<BoundingSphere> &spheres,
+              const glm::vec4 planes[6]) {
+  std::vector<uint32_t> visible;
+  for (uint32_t i = 0; i < spheres.size(); ++i) {
+    bool inside = true;
+    for (int p = 0; p < 6; ++p) {
+      inside = inside && glm::dot(glm::vec3(planes[p]), spheres[i].center) +
+                                 planes[p].w >=
+                             -spheres[i].radius;
+    }
+    if (inside) {
+      visible.push_back(i);
+    }
+  }
+  return visible;
+}
+
+static vks::Bvh::Hit linearRaycast(const std::vector<BoundingSphere> &spheres,
+                                   glm::vec3 origin, glm::vec3 direction) {
+  vks::Bvh::Hit hit;
+  for (uint32_t i = 0; i < spheres.size(); ++i) {
+    glm::vec3 offset = origin - spheres[i].center;
+    float b = glm::dot(offset, direction);
+    float c = glm::dot(offset, offset) - spheres[i].radius * spheres[i].radius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0f || -b + std::sqrt(discriminant) < 0.0f) {
+      continue;
+    }
+    float t = std::max(-b - std::sqrt(discriminant), 0.0f);
+    if (t < hit.distance) {
+      hit = {i, t};
+    }
+  }
+  return hit;
+}
+
+static void checkQueries(const vks::Bvh &bvh,
+                         const std::vector<BoundingSphere> &spheres,
+                         std::mt19937 &rng) {
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  for (int i = 0; i < 20; ++i) {
+    glm::vec3 eye(unit(rng) * 50.0f, unit(rng) * 50.0f, 20.0f);
+    glm::vec3 target(unit(rng) * 50.0f, unit(rng) * 50.0f, 0.0f);
+    glm::mat4 viewProjection =
+        glm::perspectiveRH_ZO(glm::radians(45.0f), 1.5f, 0.1f, 80.0f) *
+        glm::lookAt(eye, target, glm::vec3(0.0f, 0.0f, 1.0f));
+    glm::vec4 planes[6];
+    vks::transform::extractFrustumPlanes(viewProjection, planes);
+
+    std::vector<uint32_t> visible;
+    bvh.queryFrustum(planes, visible);
+    std::sort(visible.begin(), visible.end());
+    CHECK(visible == linearFrustum(spheres, planes));
+
+    glm::vec3 direction = glm::normalize(target - eye);
+    vks::Bvh::Hit hit = bvh.raycast(eye, direction);
+    vks::Bvh::Hit expected = linearRaycast(spheres, eye, direction);
+    CHECK(hit.item == expected.item);
+    if (expected.item != vks::Bvh::InvalidIndex) {
+      CHECK(hit.distance == doctest::Approx(expected.distance));
+    }
+  }
+}
+
+// Every node bounds the items below it
+static void checkBounds(const vks::Bvh &bvh,
+                        const std::vector<BoundingSphere> &spheres) {
+  const std::vector<vks::Bvh::Node> &nodes = bvh.nodes();
+  std::vector<uint32_t> stack{0};
+  size_t items = 0;
+  while (!stack.empty()) {
+    const vks::Bvh::Node &node = nodes[stack.back()];
+    stack.pop_back();
+    if (node.count == 0) {
+      for (uint32_t child : {node.first, node.first + 1}) {
+        REQUIRE(glm::all(glm::lessThanEqual(node.min, nodes[child].min)));
+        REQUIRE(glm::all(glm::greaterThanEqual(node.max, nodes[child].max)));
+        stack.push_back(child);
+      }
+      continue;
+    }
+    CHECK(node.count <= 4);
+    items += node.count;
+  }
+  CHECK(items == spheres.size());
+}
+
+TEST_CASE("BVH queries match a linear scan") {
+  std::mt19937 rng(47);
+  std::vector<BoundingSphere> spheres = randomSpheres(50000, rng);
+  vks::Bvh bvh;
+  bvh.build(spheres.data(), static_cast<uint32_t>(spheres.size()));
+  CHECK(bvh.size() == spheres.size());
+  checkBounds(bvh, spheres);
+  checkQueries(bvh, spheres, rng);
+
+  // Refitting after a move answers like a rebuild
+  std::uniform_real_distribution<float> step(-5.0f, 5.0f);
+  for (BoundingSphere &sphere : spheres) {
+    sphere.center += glm::vec3(step(rng), step(rng), 0.0f);
+  }
+  bvh.refit(spheres.data());
+  checkBounds(bvh, spheres);
+  checkQueries(bvh, spheres, rng);
+}
+
+TEST_CASE("BVH of coincident and tiny sets") {
+  vks::Bvh bvh;
+  std::vector<uint32_t> visible;
+  glm::vec4 planes[6];
+  vks::transform::extractFrustumPlanes(
+      glm::perspectiveRH_ZO(glm::radians(90.0f), 1.0f, 0.1f, 100.0f), planes);
+
+  bvh.build(nullptr, 0);
+  bvh.queryFrustum(planes, visible);
+  CHECK(visible.empty());
+  CHECK(bvh.raycast({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}).item ==
+        vks::Bvh::InvalidIndex);
+
+  // Every center in the same place still splits down to small leaves
+  std::vector<BoundingSphere> spheres(100, {glm::vec3(0.0f, 0.0f, -10.0f), 1.0f});
+  bvh.build(spheres.data(), static_cast<uint32_t>(spheres.size()));
+  checkBounds(bvh, spheres);
+  bvh.queryFrustum(planes, visible);
+  CHECK(visible.size() == spheres.size());
+
+  // Axis aligned ray, from inside one sphere
+  vks::Bvh::Hit hit = bvh.raycast({0.0f, 0.0f, -10.5f}, {0.0f, 0.0f, -1.0f});
+  CHECK(hit.item != vks::Bvh::InvalidIndex);
+  CHECK(hit.distance == 0.0f);
+  CHECK(bvh.raycast({0.0f, 0.0f, -12.0f}, {0.0f, 0.0f, -1.0f}).item ==
+        vks::Bvh::InvalidIndex);
+}
@@ -0,0 +1,184 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Cook.hpp>
+#include <vks/Mesh/Import.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+using vks::geometry::Vertex;
+
+TEST_CASE("Weld duplicated vertices") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createPlane(vertices, indices, 1.0f, 1.0f, 4, 4);
+  size_t uniqueCount = vertices.size();
+
+  // One copy of every vertex per triangle corner, plus an unused one
+  std::vector<Vertex> unwelded;
+  std::vector<uint32_t> unweldedIndices;
+  for (uint32_t index : indices) {
+    unweldedIndices.push_back(static_cast<uint32_t>(unwelded.size()));
+    unwelded.push_back(vertices[index]);
+  }
+  unwelded.push_back(Vertex{});
+
+  vks::mesh::weldVertices(unwelded, unweldedIndices);
+  CHECK(unwelded.size() == uniqueCount);
+  REQUIRE(unweldedIndices.size() == indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    CHECK(unwelded[unweldedIndices[i]].pos[0] == vertices[indices[i]].pos[0]);
+    CHECK(unwelded[unweldedIndices[i]].pos[2] == vertices[indices[i]].pos[2]);
+  }
+}
+
+TEST_CASE("Generated normals of a sphere point outwards") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 64, 32);
+  std::vector<Vertex> reference = vertices;
+
+  vks::mesh::generateNormals(vertices, indices);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    if (std::fabs(reference[i].pos[2]) > 0.999f) {
+      continue; // Pole vertices only touch degenerate triangles (if any)
+    }
+    float dot = vertices[i].normal[0] * reference[i].normal[0] +
+                vertices[i].normal[1] * reference[i].normal[1] +
+                vertices[i].normal[2] * reference[i].normal[2];
+    // Seam vertices only see part of their neighbourhood
+    CHECK(dot > 0.7f);
+  }
+}
+
+TEST_CASE("Content hash") {
+  std::vector<uint8_t> bytes(1000);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(i * 7);
+  }
+  uint64_t hash = vks::mesh::hashContent(bytes.data(), bytes.size());
+  CHECK(hash == vks::mesh::hashContent(bytes.data(), bytes.size()));
+  CHECK(hash != vks::mesh::hashContent(bytes.data(), bytes.size(), 1));
+  CHECK(hash != vks::mesh::hashContent(bytes.data(), bytes.size() - 1));
+
+  bytes[997] ^= 1;
+  CHECK(hash != vks::mesh::hashContent(bytes.data(), bytes.size()));
+}
+
+TEST_CASE("Cook a torus") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createTorus(vertices, indices, 0.7f, 0.3f, 48, 24);
+
+  vks::mesh::CookSettings settings;
+  vks::mesh::CookedMesh cooked =
+      vks::mesh::cookMesh(vertices, indices, true, settings);
+
+  CHECK(cooked.vertexFormat == vks::geometry::VertexFormat::Compact);
+  CHECK(cooked.indexSize == 2);
+  CHECK(cooked.vertexCount <= vertices.size());
+  CHECK(cooked.vertexData.size() == cooked.vertexCount * 16);
+  CHECK(cooked.indexData.size() == cooked.indexCount * 2);
+  CHECK(cooked.bounds.radius == doctest::Approx(1.0f).epsilon(0.01));
+  REQUIRE(cooked.lods.size() > 1);
+
+  const uint16_t *cookedIndices =
+      reinterpret_cast<const uint16_t *>(cooked.indexData.data());
+  uint32_t end = 0;
+  for (const vks::mesh::MeshLod &lod : cooked.lods) {
+    CHECK(lod.firstIndex == end);
+    end += lod.indexCount;
+    for (uint32_t i = lod.firstIndex; i < lod.firstIndex + lod.indexCount; ++i) {
+      CHECK(cookedIndices[i] < cooked.vertexCount);
+    }
+  }
+  CHECK(end == cooked.indexCount);
+
+  SUBCASE("Float vertices, single level") {
+    settings.vertexFormat = vks::geometry::VertexFormat::Float;
+    settings.maxLods = 1;
+    cooked = vks::mesh::cookMesh(vertices, indices, true, settings);
+    CHECK(cooked.lods.size() == 1);
+    CHECK(cooked.indexCount == indices.size());
+    CHECK(cooked.vertexData.size() == cooked.vertexCount * sizeof(Vertex));
+  }
+}
+
+TEST_CASE("Import an OBJ file") {
+  const char *path = "vks_test_quad.obj";
+  {
+    std::ofstream obj(path);
+    obj << "# Quad with a shared edge, no normals\n"
+           "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+           "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+           "f 1/1 2/2 3/3 4/4\r\n"
+           "f -4/-4 -2/-2 -1/-1 \n";
+  }
+
+  vks::mesh::SourceMesh mesh = vks::mesh::importObj(path);
+  std::remove(path);
+
+  CHECK_FALSE(mesh.hasNormals);
+  CHECK(mesh.vertices.size() == 4);
+  REQUIRE(mesh.indices.size() == 9);
+  CHECK(mesh.indices[0] == 0);
+  CHECK(mesh.indices[4] == 2);
+  CHECK(mesh.indices[5] == 3);
+  // V flipped to a top-left origin
+  CHECK(mesh.vertices[2].uv[1] == 0.0f);
+  CHECK(mesh.vertices[0].uv[1] == 1.0f);
+
+  CHECK_THROWS(vks::mesh::importObj("does_not_exist.obj"));
+  CHECK_THROWS(vks::mesh::importMeshes("mesh.fbx"));
+}
+
+TEST_CASE("Stream the primitives of a glTF file") {
+  // One triangle, drawn by an indexed and a non-indexed primitive
+  const char *path = "vks_test_triangle.gltf";
+  {
+    std::ofstream gltf(path);
+    gltf << R"({
+  "asset": {"version": "2.0"},
+  "buffers": [{"byteLength": 44, "uri": "data:application/octet-stream;base64,AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAAAAABAAIAAAA="}],
+  "bufferViews": [{"buffer": 0, "byteOffset": 0, "byteLength": 36},
+                  {"buffer": 0, "byteOffset": 36, "byteLength": 6}],
+  "accessors": [{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3",
+                 "min": [0, 0, 0], "max": [1, 1, 0]},
+                {"bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR"}],
+  "meshes": [{"name": "tri", "primitives": [{"attributes": {"POSITION": 0}, "indices": 1},
+                                            {"attributes": {"POSITION": 0}}]}]
+})";
+  }
+
+  std::mutex mutex;
+  std::vector<vks::mesh::SourceMesh> meshes(2);
+  std::vector<bool> received(2, false);
+  vks::mesh::importMeshes(path, [&](size_t index, vks::mesh::SourceMesh &&mesh) {
+    std::lock_guard<std::mutex> lock(mutex);
+    REQUIRE(index < 2);
+    CHECK_FALSE(received[index]);
+    received[index] = true;
+    meshes[index] = std::move(mesh);
+  });
+
+  // The collecting overload keeps the file order
+  std::vector<vks::mesh::SourceMesh> ordered = vks::mesh::importMeshes(path);
+  std::remove(path);
+
+  CHECK(received[0]);
+  CHECK(received[1]);
+  REQUIRE(ordered.size() == 2);
+  CHECK(ordered[0].name == "tri.0");
+  CHECK(ordered[1].name == "tri.1");
+  for (const vks::mesh::SourceMesh &mesh : meshes) {
+    CHECK_FALSE(mesh.hasNormals);
+    REQUIRE(mesh.vertices.size() == 3);
+    CHECK(mesh.vertices[1].pos[0] == 1.0f);
+    CHECK(mesh.vertices[2].pos[1] == 1.0f);
+    CHECK(mesh.indices == std::vector<uint32_t>{0, 1, 2});
+  }
+}
@@ -0,0 +1,54 @@
+#include <doctest/doctest.h>
+
+#include <vks/DescriptorUsage.hpp>
+
+#include <utility>
+#include <vector>
+
+using vks::DescriptorUsage;
+
+using Sizes = std::vector<std::pair<VkDescriptorType, uint32_t>>;
+
+static Sizes sizes(const std::vector<VkDescriptorPoolSize> &poolSizes) {
+  Sizes result;
+  for (const VkDescriptorPoolSize &size : poolSizes) {
+    result.emplace_back(size.type, size.descriptorCount);
+  }
+  return result;
+}
+
+TEST_CASE("Pools follow the observed descriptor ratios") {
+  DescriptorUsage usage;
+  CHECK(usage.setCount() == 0);
+
+  // Nothing observed yet: the ratios of the set being allocated
+  CHECK(sizes(usage.poolSizes(8, {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2}})) ==
+        Sizes{{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16}});
+
+  // 3 camera-like sets for 1 material-like set
+  for (int i = 0; i < 3; ++i) {
+    usage.record({{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}});
+  }
+  usage.record({{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1}, {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2}});
+  CHECK(usage.setCount() == 4);
+
+  CHECK(sizes(usage.poolSizes(64)) == Sizes{{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 32},
+                                            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 48},
+                                            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16}});
+
+  // Rounded up
+  CHECK(sizes(usage.poolSizes(2)) == Sizes{{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
+                                           {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+                                           {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1}});
+}
+
+TEST_CASE("A pool always fits the set being allocated") {
+  DescriptorUsage usage;
+  for (int i = 0; i < 100; ++i) {
+    usage.record({{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}});
+  }
+
+  // A type never seen before, and more of it than the ratios give
+  CHECK(sizes(usage.poolSizes(4, {{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 10}, {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}})) ==
+        Sizes{{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 10}, {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4}});
+}
@@ -0,0 +1,256 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using vks::geometry::Vertex;
+
+// The scalar sphere generator the table-driven one replaced, kept verbatim as
+// the reference for bit-exact output
+static void legacySphere(std::vector<Vertex> &vertices,
+                         std::vector<uint32_t> &indices, float radius,
+                         uint32_t sectors, uint32_t stacks) {
+  float x, y, z, xy;
+  float nx, ny, nz, lengthInv = 1.0f / radius;
+  float s, t;
+
+  float sectorStep = 2 * M_PI / sectors;
+  float stackStep = M_PI / stacks;
+  float sectorAngle, stackAngle;
+
+  for (uint32_t i = 0; i <= stacks; ++i) {
+    stackAngle = M_PI / 2 - i * stackStep;
+    xy = radius * cosf(stackAngle);
+    z = radius * sinf(stackAngle);
+
+    for (uint32_t j = 0; j <= sectors; ++j) {
+      sectorAngle = j * sectorStep;
+
+      x = xy * cosf(sectorAngle);
+      y = xy * sinf(sectorAngle);
+
+      nx = x * lengthInv;
+      ny = y * lengthInv;
+      nz = z * lengthInv;
+
+      s = (float)j / sectors;
+      t = (float)i / stacks;
+
+      vertices.push_back({{x, y, z}, {nx, ny, nz}, {s, t}});
+    }
+  }
+
+  uint32_t k1, k2;
+  for (uint32_t i = 0; i < stacks; ++i) {
+    k1 = i * (sectors + 1);
+    k2 = k1 + sectors + 1;
+
+    for (uint32_t j = 0; j < sectors; ++j, ++k1, ++k2) {
+      if (i != 0) {
+        indices.push_back(k1);
+        indices.push_back(k2);
+        indices.push_back(k1 + 1);
+      }
+
+      if (i != (stacks - 1)) {
+        indices.push_back(k1 + 1);
+        indices.push_back(k2);
+        indices.push_back(k2 + 1);
+      }
+    }
+  }
+}
+
+static glm::vec3 position(const Vertex &v) {
+  return {v.pos[0], v.pos[1], v.pos[2]};
+}
+
+static glm::vec3 normal(const Vertex &v) {
+  return {v.normal[0], v.normal[1], v.normal[2]};
+}
+
+// Indices in range, unit normals, and every triangle facing its vertex normals
+static void checkMesh(const std::vector<Vertex> &vertices,
+                      const std::vector<uint32_t> &indices,
+                      vks::geometry::MeshSize size) {
+  REQUIRE(vertices.size() == size.vertexCount);
+  REQUIRE(indices.size() == size.indexCount);
+  REQUIRE(indices.size() % 3 == 0);
+
+  size_t outOfRange = 0;
+  for (uint32_t index : indices) {
+    outOfRange += index >= vertices.size();
+  }
+  REQUIRE(outOfRange == 0);
+
+  size_t badNormals = 0;
+  for (const Vertex &v : vertices) {
+    badNormals += std::fabs(glm::length(normal(v)) - 1.0f) > 1e-4f;
+  }
+  CHECK(badNormals == 0);
+
+  size_t inverted = 0;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const Vertex &a = vertices[indices[i]];
+    const Vertex &b = vertices[indices[i + 1]];
+    const Vertex &c = vertices[indices[i + 2]];
+    glm::vec3 faceNormal =
+        glm::cross(position(b) - position(a), position(c) - position(a));
+    glm::vec3 vertexNormals = normal(a) + normal(b) + normal(c);
+    inverted += glm::dot(faceNormal, vertexNormals) < 0.0f;
+  }
+  CHECK(inverted == 0);
+}
+
+TEST_CASE("Sphere output is identical to the scalar generator") {
+  const uint32_t shapes[][2] = {{32, 16}, {3, 2}, {7, 5}, {256, 128}};
+  for (const auto &shape : shapes) {
+    std::vector<Vertex> expectedVertices, vertices;
+    std::vector<uint32_t> expectedIndices, indices;
+    legacySphere(expectedVertices, expectedIndices, 1.5f, shape[0], shape[1]);
+    vks::geometry::createSphere(vertices, indices, 1.5f, shape[0], shape[1]);
+
+    REQUIRE(vertices.size() == expectedVertices.size());
+    REQUIRE(indices.size() == expectedIndices.size());
+    CHECK(std::memcmp(vertices.data(), expectedVertices.data(),
+                      vertices.size() * sizeof(Vertex)) == 0);
+    CHECK(indices == expectedIndices);
+
+    checkMesh(vertices, indices,
+              vks::geometry::sphereSize(shape[0], shape[1]));
+  }
+}
+
+TEST_CASE("Generators fill the exact sizes they report") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+
+  SUBCASE("Icosphere") {
+    for (uint32_t frequency : {1u, 2u, 5u, 16u}) {
+      vks::geometry::createIcosphere(vertices, indices, 2.0f, frequency);
+      checkMesh(vertices, indices, vks::geometry::icosphereSize(frequency));
+      for (const Vertex &v : vertices) {
+        CHECK(glm::length(position(v)) == doctest::Approx(2.0f));
+      }
+    }
+  }
+
+  SUBCASE("Cube sphere") {
+    for (uint32_t divisions : {1u, 4u, 33u}) {
+      vks::geometry::createCubeSphere(vertices, indices, 1.0f, divisions);
+      checkMesh(vertices, indices, vks::geometry::cubeSphereSize(divisions));
+    }
+  }
+
+  SUBCASE("Plane") {
+    vks::geometry::createPlane(vertices, indices, 4.0f, 2.0f, 8, 3);
+    checkMesh(vertices, indices, vks::geometry::planeSize(8, 3));
+    CHECK(vertices.front().pos[0] == doctest::Approx(-2.0f));
+    CHECK(vertices.back().pos[1] == doctest::Approx(1.0f));
+  }
+
+  SUBCASE("Torus") {
+    vks::geometry::createTorus(vertices, indices, 1.0f, 0.25f, 48, 24);
+    checkMesh(vertices, indices, vks::geometry::torusSize(48, 24));
+  }
+
+  SUBCASE("Cylinder") {
+    vks::geometry::createCylinder(vertices, indices, 0.5f, 2.0f, 24, 4);
+    checkMesh(vertices, indices, vks::geometry::cylinderSize(24, 4));
+  }
+}
+
+TEST_CASE("Seam vertices of faceted spheres match exactly") {
+  // Unwelded faces must still meet without cracks: every position generated
+  // on a face border appears bit-identically on the neighbouring face
+  auto countUnmatched = [](const std::vector<Vertex> &vertices) {
+    std::vector<glm::vec3> positions;
+    for (const Vertex &v : vertices) {
+      positions.push_back(position(v));
+    }
+
+    size_t unmatched = 0;
+    for (size_t i = 0; i < positions.size(); ++i) {
+      size_t copies = 0;
+      for (size_t j = 0; j < positions.size(); ++j) {
+        copies += positions[j] == positions[i];
+      }
+      // Interior vertices are unique, seams have several copies, but a seam
+      // vertex off by one ulp would also be unique: look for near misses
+      if (copies == 1) {
+        for (size_t j = 0; j < positions.size(); ++j) {
+          if (j != i && glm::length(positions[j] - positions[i]) < 1e-5f) {
+            ++unmatched;
+            break;
+          }
+        }
+      }
+    }
+    return unmatched;
+  };
+
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createIcosphere(vertices, indices, 1.0f, 6);
+  CHECK(countUnmatched(vertices) == 0);
+
+  vks::geometry::createCubeSphere(vertices, indices, 1.0f, 7);
+  CHECK(countUnmatched(vertices) == 0);
+}
+
+TEST_CASE("Split vertex streams") {
+  using vks::geometry::VertexFormat;
+
+  // A position-only pass fetches 12 of 32 bytes (8 of 16 when compact)
+  // per vertex once positions have their own stream
+  CHECK(vks::geometry::positionStreamSize(VertexFormat::Float) == 32);
+  CHECK(vks::geometry::positionStreamSize(VertexFormat::Compact) == 16);
+  CHECK(vks::geometry::positionStreamSize(VertexFormat::SplitFloat) == 12);
+  CHECK(vks::geometry::positionStreamSize(VertexFormat::SplitCompact) == 8);
+  CHECK(vks::geometry::vertexSize(VertexFormat::SplitFloat) == 32);
+  CHECK(vks::geometry::vertexSize(VertexFormat::SplitCompact) == 16);
+
+  vks::geometry::VertexInputDescription input =
+      vks::geometry::getVertexInput(VertexFormat::SplitFloat);
+  REQUIRE(input.bindingCount == 2);
+  CHECK(input.bindings[0].stride == 12);
+  CHECK(input.bindings[1].binding == 1);
+  CHECK(input.bindings[1].stride == 20);
+  CHECK(input.attributes[0].binding == 0);
+  CHECK(input.attributes[0].offset == 0);
+  CHECK(input.attributes[1].binding == 1);
+  CHECK(input.attributes[1].offset == 0);
+  CHECK(input.attributes[2].binding == 1);
+  CHECK(input.attributes[2].offset == 12);
+
+  vks::geometry::VertexInputDescription depth =
+      vks::geometry::getVertexInput(VertexFormat::SplitCompact, true);
+  CHECK(depth.bindingCount == 1);
+  CHECK(depth.attributeCount == 1);
+  CHECK(depth.bindings[0].stride == 8);
+  CHECK(depth.attributes[0].format == VK_FORMAT_R16G16B16A16_UNORM);
+
+  // Interleaved formats keep their single binding in position-only passes
+  CHECK(vks::geometry::getVertexInput(VertexFormat::Float, true).bindings[0].stride == 32);
+
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 8, 4);
+  std::vector<uint8_t> split(vertices.size() * sizeof(Vertex));
+  vks::geometry::splitVertices(vertices.data(), VertexFormat::SplitFloat,
+                               vertices.size(), split.data());
+
+  const uint8_t *attributes = split.data() + vertices.size() * 12;
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    CHECK(std::memcmp(split.data() + i * 12, vertices[i].pos, 12) == 0);
+    CHECK(std::memcmp(attributes + i * 20, vertices[i].normal, 12) == 0);
+    CHECK(std::memcmp(attributes + i * 20 + 12, vertices[i].uv, 8) == 0);
+  }
+}
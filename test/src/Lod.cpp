@@ -0,0 +1,185 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Lod.hpp>
+#include <vks/Mesh/Simplify.hpp>
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+using vks::geometry::Vertex;
+
+static const float *positionsOf(const std::vector<Vertex> &vertices) {
+  return vertices[0].pos;
+}
+
+static void checkTriangles(const std::vector<uint32_t> &indices,
+                           size_t vertexCount) {
+  REQUIRE(indices.size() % 3 == 0);
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    CHECK(indices[t] < vertexCount);
+    CHECK(indices[t + 1] < vertexCount);
+    CHECK(indices[t + 2] < vertexCount);
+    CHECK(indices[t] != indices[t + 1]);
+    CHECK(indices[t + 1] != indices[t + 2]);
+    CHECK(indices[t + 2] != indices[t]);
+  }
+}
+
+TEST_CASE("Simplify a UV sphere") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 64, 32);
+
+  float halfError = 0.0f;
+  std::vector<uint32_t> half = vks::mesh::simplify(
+      indices, positionsOf(vertices), vertices.size(), sizeof(Vertex),
+      indices.size() / 2, 1.0f, &halfError);
+
+  checkTriangles(half, vertices.size());
+  CHECK(half.size() <= indices.size() / 2);
+  CHECK(halfError > 0.0f);
+  CHECK(halfError < 0.05f);
+
+  float quarterError = 0.0f;
+  std::vector<uint32_t> quarter = vks::mesh::simplify(
+      indices, positionsOf(vertices), vertices.size(), sizeof(Vertex),
+      indices.size() / 4, 1.0f, &quarterError);
+  CHECK(quarter.size() <= indices.size() / 4);
+  CHECK(quarterError >= halfError);
+
+  // The UV seam (first and last sector of every stack) is locked
+  std::set<uint32_t> used(quarter.begin(), quarter.end());
+  for (uint32_t i = 1; i < 32; ++i) {
+    CHECK(used.count(i * 65) == 1);
+    CHECK(used.count(i * 65 + 64) == 1);
+  }
+
+  SUBCASE("error bound") {
+    float error = 0.0f;
+    std::vector<uint32_t> bounded = vks::mesh::simplify(
+        indices, positionsOf(vertices), vertices.size(), sizeof(Vertex), 0,
+        halfError * 0.5f, &error);
+    CHECK(error <= halfError * 0.5f);
+    CHECK(bounded.size() > half.size());
+  }
+}
+
+TEST_CASE("Simplify a plane keeps its border") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createPlane(vertices, indices, 2.0f, 2.0f, 16, 16);
+
+  float error = 1.0f;
+  std::vector<uint32_t> simplified = vks::mesh::simplify(
+      indices, positionsOf(vertices), vertices.size(), sizeof(Vertex), 0,
+      0.0f, &error);
+
+  // Flat: everything but the border collapses without error
+  checkTriangles(simplified, vertices.size());
+  CHECK(error == 0.0f);
+  CHECK(simplified.size() < indices.size() / 4);
+
+  std::set<uint32_t> used(simplified.begin(), simplified.end());
+  for (uint32_t i = 0; i <= 16; ++i) {
+    CHECK(used.count(i) == 1);
+    CHECK(used.count(16 * 17 + i) == 1);
+    CHECK(used.count(i * 17) == 1);
+    CHECK(used.count(i * 17 + 16) == 1);
+  }
+
+  // Winding is preserved
+  for (size_t t = 0; t < simplified.size(); t += 3) {
+    const float *a = vertices[simplified[t]].pos;
+    const float *b = vertices[simplified[t + 1]].pos;
+    const float *c = vertices[simplified[t + 2]].pos;
+    float z = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    CHECK(z > 0.0f);
+  }
+}
+
+TEST_CASE("LOD chain") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 2.0f, 64, 32);
+
+  std::vector<uint32_t> lodIndices;
+  std::vector<vks::mesh::MeshLod> lods = vks::mesh::buildLodChain(
+      indices, positionsOf(vertices), vertices.size(), sizeof(Vertex), 5,
+      lodIndices);
+
+  REQUIRE(lods.size() >= 3);
+  CHECK(lods.size() <= 5);
+  CHECK(lods[0].firstIndex == 0);
+  CHECK(lods[0].indexCount == indices.size());
+  CHECK(lods[0].error == 0.0f);
+
+  for (size_t i = 1; i < lods.size(); ++i) {
+    CHECK(lods[i].firstIndex == lods[i - 1].firstIndex + lods[i - 1].indexCount);
+    CHECK(lods[i].indexCount < lods[i - 1].indexCount);
+    CHECK(lods[i].error <= 0.25f);
+    CHECK(lods[i].error > lods[i - 1].error);
+    CHECK(lods[i].vertexOffset == 0);
+  }
+  const vks::mesh::MeshLod &last = lods.back();
+  CHECK(last.firstIndex + last.indexCount == lodIndices.size());
+  checkTriangles(lodIndices, vertices.size());
+}
+
+TEST_CASE("Bounding sphere") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createTorus(vertices, indices, 2.0f, 0.5f, 32, 16);
+
+  vks::mesh::BoundingSphere sphere = vks::mesh::computeBoundingSphere(
+      positionsOf(vertices), vertices.size(), sizeof(Vertex));
+  CHECK(std::fabs(sphere.center.x) < 1e-5f);
+  CHECK(std::fabs(sphere.center.y) < 1e-5f);
+  CHECK(std::fabs(sphere.center.z) < 1e-5f);
+  CHECK(sphere.radius == doctest::Approx(2.5f).epsilon(1e-4));
+}
+
+TEST_CASE("Screen space error LOD selection") {
+  // Relative errors of a 4 level chain
+  std::vector<vks::mesh::MeshLod> lods(4);
+  lods[1].error = 0.01f;
+  lods[2].error = 0.04f;
+  lods[3].error = 0.16f;
+
+  const float threshold = 1.0f;
+  const float hysteresis = 0.2f;
+  auto select = [&](float radiusPixels, uint32_t current) {
+    return vks::mesh::selectLod(lods.data(), 4, radiusPixels, current,
+                                threshold, hysteresis);
+  };
+
+  CHECK(vks::mesh::projectedRadius(1.0f, 0.5f, 500.0f) == INFINITY);
+  CHECK(vks::mesh::projectedRadius(1.0f, 10.0f, 500.0f) == 50.0f);
+
+  SUBCASE("coarsest level below the threshold") {
+    CHECK(select(1000.0f, 0) == 0);
+    CHECK(select(50.0f, 0) == 1);
+    CHECK(select(20.0f, 0) == 2);
+    CHECK(select(4.0f, 0) == 3);
+    CHECK(select(INFINITY, 3) == 0);
+  }
+
+  SUBCASE("hysteresis") {
+    // LOD 2 costs 1 pixel at a 25 pixel radius: entered below 20, left above 30
+    CHECK(select(24.0f, 1) == 1);
+    CHECK(select(19.0f, 1) == 2);
+    CHECK(select(26.0f, 2) == 2);
+    CHECK(select(29.0f, 2) == 2);
+    CHECK(select(31.0f, 2) == 1);
+
+    // Oscillating around the transition does not pop
+    uint32_t lod = 2;
+    for (int i = 0; i < 10; ++i) {
+      lod = select(i % 2 ? 23.0f : 27.0f, lod);
+      CHECK(lod == 2);
+    }
+  }
+
+  SUBCASE("out of range current level") { CHECK(select(4.0f, 10) == 3); }
+}
@@ -0,0 +1,85 @@
+#include <doctest/doctest.h>
+
+#include <vks/MaterialTable.hpp>
+
+#include <utility>
+#include <vector>
+
+using vks::MaterialParams;
+using vks::MaterialTable;
+
+namespace {
+
+using Ranges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// The dirty ranges of a slot, as (first, count) pairs
+Ranges take(MaterialTable &table, uint32_t slot, uint32_t gap = 0) {
+  std::vector<MaterialTable::Range> ranges;
+  table.takeDirtyRanges(slot, ranges, gap);
+  Ranges pairs;
+  for (const MaterialTable::Range &range : ranges) {
+    pairs.emplace_back(range.first, range.count);
+  }
+  return pairs;
+}
+
+} // namespace
+
+TEST_CASE("Material table slots catch up on their own") {
+  MaterialTable table(2);
+  for (uint32_t i = 0; i < 100; ++i) {
+    CHECK(table.add(MaterialParams{glm::vec4(float(i))}) == i);
+  }
+  CHECK(table.size() == 100);
+
+  // New slots take the whole table, once
+  CHECK(take(table, 0) == Ranges{{0, 100}});
+  CHECK(take(table, 0).empty());
+
+  table.set(42, MaterialParams{glm::vec4(1.0f)});
+  CHECK(table.get(42).color == glm::vec4(1.0f));
+  CHECK(take(table, 0) == Ranges{{42, 1}});
+
+  // Slot 1 was never uploaded: it still needs everything
+  CHECK(take(table, 1) == Ranges{{0, 100}});
+
+  // An edit reaches every slot, once each
+  table.set(7, MaterialParams{glm::vec4(2.0f)});
+  CHECK(take(table, 1) == Ranges{{7, 1}});
+  table.set(8, MaterialParams{glm::vec4(3.0f)});
+  CHECK(take(table, 0) == Ranges{{7, 2}});
+  CHECK(take(table, 1) == Ranges{{8, 1}});
+  CHECK(take(table, 0).empty());
+  CHECK(take(table, 1).empty());
+
+  // Resized slots start over
+  table.resize(3);
+  for (uint32_t slot = 0; slot < 3; ++slot) {
+    CHECK(take(table, slot) == Ranges{{0, 100}});
+  }
+}
+
+TEST_CASE("Material table merges close edits") {
+  MaterialTable table(1);
+  for (uint32_t i = 0; i < 100; ++i) {
+    table.add(MaterialParams{glm::vec4(0.0f)});
+  }
+  take(table, 0);
+
+  const uint32_t edits[] = {50, 10, 11, 10, 14, 90, 53};
+  for (uint32_t i : edits) {
+    table.set(i, MaterialParams{glm::vec4(1.0f)});
+  }
+  CHECK(take(table, 0) == Ranges{{10, 2}, {14, 1}, {50, 1}, {53, 1}, {90, 1}});
+
+  // Holes of up to 3 materials are taken along
+  for (uint32_t i : edits) {
+    table.set(i, MaterialParams{glm::vec4(2.0f)});
+  }
+  CHECK(take(table, 0, 3) == Ranges{{10, 5}, {50, 4}, {90, 1}});
+
+  // Added materials are edits too
+  table.add(MaterialParams{glm::vec4(3.0f)});
+  table.add(MaterialParams{glm::vec4(3.0f)});
+  CHECK(take(table, 0) == Ranges{{100, 2}});
+}
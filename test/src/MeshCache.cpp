@@ -0,0 +1,92 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/MeshCache.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using vks::mesh::MeshKey;
+
+TEST_CASE("Mesh keys identify generators and content") {
+  MeshKey sphere = MeshKey::procedural("sphere", {1.0f, 32, 16});
+  CHECK(sphere == MeshKey::procedural("sphere", {1.0f, 32, 16}));
+  CHECK(sphere != MeshKey::procedural("sphere", {1.0f, 16, 32}));
+  CHECK(sphere != MeshKey::procedural("icosphere", {1.0f, 32, 16}));
+  CHECK(sphere.with(1) != sphere.with(2));
+  CHECK(sphere.with(1) == sphere.with(1));
+
+  vks::mesh::GeneratedMesh mesh;
+  vks::geometry::createSphere(mesh.vertices, mesh.indices, 1.0f, 16, 8);
+  MeshKey content = MeshKey::content(mesh.view());
+  CHECK(content == MeshKey::content(mesh.view()));
+
+  mesh.vertices[3].pos[1] += 0.001f;
+  CHECK(content != MeshKey::content(mesh.view()));
+}
+
+TEST_CASE("Generated sphere LODs are laid out one after the other") {
+  vks::mesh::GeneratedMesh mesh;
+  vks::mesh::generateSphereLods(mesh, 1.0f, 32, 16, 8);
+
+  // 32x16, 16x8, 8x4, 4x2: the tessellation stops shrinking
+  REQUIRE(mesh.lods.size() == 4);
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+  for (size_t i = 0; i < mesh.lods.size(); ++i) {
+    vks::geometry::MeshSize size =
+        vks::geometry::sphereSize(32u >> i, 16u >> i);
+    CHECK(mesh.lods[i].firstIndex == firstIndex);
+    CHECK(mesh.lods[i].indexCount == size.indexCount);
+    CHECK(mesh.lods[i].vertexOffset == vertexOffset);
+    firstIndex += size.indexCount;
+    vertexOffset += static_cast<int32_t>(size.vertexCount);
+  }
+  CHECK(mesh.indices.size() == firstIndex);
+  CHECK(mesh.vertices.size() == static_cast<size_t>(vertexOffset));
+  CHECK(mesh.lods[0].error == 0.0f);
+  CHECK(mesh.lods[3].error > mesh.lods[1].error);
+}
+
+TEST_CASE("Disk cache round trip") {
+  std::string directory = "vks_test_mesh_cache";
+  std::filesystem::remove_all(directory);
+  vks::mesh::MeshDiskCache cache(directory);
+
+  MeshKey key = MeshKey::procedural("torusLods", {0.7f, 0.3f, 24, 12, 3});
+  CHECK(cache.load(key) == nullptr);
+
+  vks::mesh::GeneratedMesh mesh;
+  std::vector<vks::geometry::Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createTorus(vertices, indices, 0.7f, 0.3f, 24, 12);
+  vks::mesh::generateSimplifiedLods(mesh, vertices, indices, 3);
+  REQUIRE(mesh.lods.size() > 1);
+  REQUIRE(cache.store(key, mesh.view()));
+
+  std::unique_ptr<vks::mesh::MeshFile> file = cache.load(key);
+  REQUIRE(file != nullptr);
+  CHECK(MeshKey::content(file->view()) == MeshKey::content(mesh.view()));
+  CHECK(file->lodCount() == mesh.lods.size());
+  CHECK(file->bounds().radius == doctest::Approx(mesh.bounds.radius));
+
+  // Only the final file is left behind
+  size_t files = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+    CHECK(entry.path().extension() == ".vksmesh");
+    ++files;
+  }
+  CHECK(files == 1);
+  file.reset();
+
+  // A damaged entry is a miss, regenerated by the caller
+  std::ofstream(cache.path(key), std::ios::binary | std::ios::trunc)
+      << "not a mesh";
+  CHECK(cache.load(key) == nullptr);
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,143 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/Mesh/Optimize.hpp>
+#include <vks/Mesh/Quantize.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using vks::geometry::Vertex;
+
+static std::string tempPath(const char *name) {
+  return std::string("vks_test_") + name + ".vksmesh";
+}
+
+TEST_CASE("Mesh file round trip") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 2.0f, 32, 16);
+
+  std::vector<uint16_t> narrow(indices.size());
+  vks::mesh::narrowIndices(indices.data(), indices.size(), narrow.data());
+
+  vks::mesh::MeshLod lods[2] = {
+      {0, static_cast<uint32_t>(indices.size()), 0, 0.0f},
+      {0, static_cast<uint32_t>(indices.size() / 2), 0, 0.1f}};
+
+  vks::mesh::MeshData mesh;
+  mesh.vertexFormat = vks::geometry::VertexFormat::Float;
+  mesh.indexSize = sizeof(uint16_t);
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = narrow.data();
+  mesh.indexCount = static_cast<uint32_t>(narrow.size());
+  mesh.lods = lods;
+  mesh.lodCount = 2;
+  mesh.bounds = {glm::vec3(0.0f, 1.0f, 0.0f), 2.0f};
+  mesh.quantization.offset = glm::vec3(-2.0f);
+  mesh.quantization.scale = 4.0f;
+
+  std::string path = tempPath("roundtrip");
+  vks::mesh::writeMeshFile(path, mesh);
+
+  {
+    vks::mesh::MeshFile file(path);
+    CHECK(file.vertexFormat() == vks::geometry::VertexFormat::Float);
+    CHECK(file.indexSize() == 2);
+    CHECK(file.vertexCount() == vertices.size());
+    CHECK(file.indexCount() == narrow.size());
+    REQUIRE(file.lodCount() == 2);
+    CHECK(file.lods()[1].indexCount == lods[1].indexCount);
+    CHECK(file.lods()[1].error == doctest::Approx(0.1f));
+    CHECK(file.bounds().center.y == 1.0f);
+    CHECK(file.bounds().radius == 2.0f);
+    CHECK(file.quantization().scale == 4.0f);
+
+    // Blobs are aligned and byte-identical
+    CHECK(reinterpret_cast<uintptr_t>(file.vertexData()) %
+              vks::mesh::MeshFileAlignment == 0);
+    CHECK(reinterpret_cast<uintptr_t>(file.indexData()) %
+              vks::mesh::MeshFileAlignment == 0);
+    REQUIRE(file.vertexDataSize() == vertices.size() * sizeof(Vertex));
+    REQUIRE(file.indexDataSize() == narrow.size() * sizeof(uint16_t));
+    CHECK(std::memcmp(file.vertexData(), vertices.data(),
+                      file.vertexDataSize()) == 0);
+    CHECK(std::memcmp(file.indexData(), narrow.data(), file.indexDataSize()) ==
+          0);
+
+    // The view points into the mapping
+    vks::mesh::MeshData view = file.view();
+    CHECK(view.vertices == file.vertexData());
+    CHECK(view.indices == file.indexData());
+    CHECK(view.lods == file.lods());
+    CHECK(view.lodCount == 2);
+    CHECK(view.bounds.radius == 2.0f);
+
+    // The mapping moves with the object
+    vks::mesh::MeshFile moved(std::move(file));
+    CHECK(moved.vertexCount() == vertices.size());
+    moved.prefetch();
+    CHECK(std::memcmp(moved.indexData(), narrow.data(), moved.indexDataSize()) ==
+          0);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Invalid mesh files are rejected") {
+  std::vector<Vertex> vertices(3);
+  uint32_t indices[3] = {0, 1, 2};
+  vks::mesh::MeshData mesh;
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = 3;
+  mesh.indices = indices;
+  mesh.indexCount = 3;
+
+  std::string path = tempPath("invalid");
+  vks::mesh::writeMeshFile(path, mesh);
+  std::vector<char> bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  auto rewrite = [&](const std::vector<char> &data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  };
+
+  CHECK_NOTHROW(vks::mesh::MeshFile{path});
+
+  SUBCASE("Bad magic") {
+    std::vector<char> data = bytes;
+    data[0] = 'X';
+    rewrite(data);
+    CHECK_THROWS_AS(vks::mesh::MeshFile{path}, std::runtime_error);
+  }
+
+  SUBCASE("Newer version") {
+    std::vector<char> data = bytes;
+    vks::mesh::MeshFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    header.version = vks::mesh::MeshFileVersion + 1;
+    std::memcpy(data.data(), &header, sizeof(header));
+    rewrite(data);
+    CHECK_THROWS_AS(vks::mesh::MeshFile{path}, std::runtime_error);
+  }
+
+  SUBCASE("Truncated") {
+    std::vector<char> data(bytes.begin(), bytes.end() - 4);
+    rewrite(data);
+    CHECK_THROWS_AS(vks::mesh::MeshFile{path}, std::runtime_error);
+  }
+
+  CHECK_THROWS_AS(vks::mesh::MeshFile{"does_not_exist.vksmesh"},
+                  std::runtime_error);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,148 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Meshlet.hpp>
+#include <vks/Mesh/Optimize.hpp>
+
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+
+using vks::geometry::Vertex;
+
+static std::vector<std::array<uint32_t, 3>>
+sortedTriangles(const std::vector<uint32_t> &indices) {
+  std::vector<std::array<uint32_t, 3>> triangles;
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    std::array<uint32_t, 3> tri = {indices[t], indices[t + 1], indices[t + 2]};
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()),
+                tri.end());
+    triangles.push_back(tri);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+static glm::vec3 position(const Vertex &v) {
+  return glm::vec3(v.pos[0], v.pos[1], v.pos[2]);
+}
+
+TEST_CASE("Meshlets partition the triangles within the limits") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 64, 32);
+  vks::mesh::optimizeVertexCache(indices.data(), indices.size(),
+                                 vertices.size());
+  std::vector<uint32_t> original = indices;
+
+  std::vector<vks::mesh::Meshlet> meshlets = vks::mesh::buildMeshlets(
+      indices.data(), indices.size(), vertices[0].pos, vertices.size(),
+      sizeof(Vertex));
+
+  // Same triangles, same windings
+  CHECK(sortedTriangles(indices) == sortedTriangles(original));
+
+  REQUIRE_FALSE(meshlets.empty());
+  uint32_t next = 0;
+  for (const vks::mesh::Meshlet &meshlet : meshlets) {
+    CHECK(meshlet.firstIndex == next);
+    CHECK(meshlet.indexCount % 3 == 0);
+    CHECK(meshlet.indexCount / 3 <= vks::mesh::MaxMeshletTriangles);
+    next += meshlet.indexCount;
+
+    std::set<uint32_t> unique(indices.begin() + meshlet.firstIndex,
+                              indices.begin() + meshlet.firstIndex +
+                                  meshlet.indexCount);
+    CHECK(unique.size() == meshlet.vertexCount);
+    CHECK(meshlet.vertexCount <= vks::mesh::MaxMeshletVertices);
+
+    // The sphere holds every vertex
+    for (uint32_t v : unique) {
+      CHECK(glm::length(position(vertices[v]) - meshlet.center) <=
+            meshlet.radius * 1.0001f + 1e-6f);
+    }
+  }
+  CHECK(next == indices.size());
+
+  // Compact clusters: close to the triangle limit on average
+  float averageTriangles =
+      float(indices.size() / 3) / static_cast<float>(meshlets.size());
+  MESSAGE("meshlets: " << meshlets.size() << ", " << averageTriangles
+                       << " triangles each");
+  CHECK(averageTriangles > vks::mesh::MaxMeshletTriangles * 0.6f);
+}
+
+TEST_CASE("Cone culling only rejects back-facing meshlets") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 64, 32);
+
+  std::vector<vks::mesh::Meshlet> meshlets = vks::mesh::buildMeshlets(
+      indices.data(), indices.size(), vertices[0].pos, vertices.size(),
+      sizeof(Vertex));
+
+  const glm::vec3 camera(0.0f, 0.0f, 6.0f);
+  size_t culled = 0;
+  for (const vks::mesh::Meshlet &meshlet : meshlets) {
+    if (!vks::mesh::isMeshletBackfacing(meshlet, camera)) {
+      continue;
+    }
+    ++culled;
+
+    // Conservative: no triangle of a culled meshlet faces the camera
+    for (uint32_t t = meshlet.firstIndex;
+         t < meshlet.firstIndex + meshlet.indexCount; t += 3) {
+      glm::vec3 a = position(vertices[indices[t]]);
+      glm::vec3 b = position(vertices[indices[t + 1]]);
+      glm::vec3 c = position(vertices[indices[t + 2]]);
+      glm::vec3 normal = glm::cross(b - a, c - a);
+      CHECK(glm::dot(normal, camera - a) <= 1e-5f);
+    }
+  }
+
+  // Roughly the far half of the sphere, minus the clusters along the horizon
+  MESSAGE("back-facing meshlets: " << culled << " of " << meshlets.size());
+  CHECK(culled > meshlets.size() / 4);
+  CHECK(culled < meshlets.size() / 2 + 1);
+}
+
+TEST_CASE("Meshlets of each LOD stay in its ranges") {
+  // Two spheres one after the other, as Model::createSphereLods() lays them out
+  std::vector<Vertex> vertices, coarseVertices;
+  std::vector<uint32_t> indices, coarseIndices;
+  vks::geometry::createSphere(vertices, indices, 1.0f, 32, 16);
+  vks::geometry::createSphere(coarseVertices, coarseIndices, 1.0f, 8, 4);
+
+  vks::mesh::MeshLod lods[2] = {
+      {0, static_cast<uint32_t>(indices.size()), 0, 0.0f},
+      {static_cast<uint32_t>(indices.size()),
+       static_cast<uint32_t>(coarseIndices.size()),
+       static_cast<int32_t>(vertices.size()), 0.1f}};
+  indices.insert(indices.end(), coarseIndices.begin(), coarseIndices.end());
+  vertices.insert(vertices.end(), coarseVertices.begin(), coarseVertices.end());
+
+  std::vector<vks::mesh::MeshletRange> ranges;
+  std::vector<vks::mesh::Meshlet> meshlets = vks::mesh::buildLodMeshlets(
+      indices.data(), vertices[0].pos, vertices.size(), sizeof(Vertex), lods, 2,
+      ranges);
+
+  REQUIRE(ranges.size() == 2);
+  CHECK(ranges[0].firstMeshlet == 0);
+  CHECK(ranges[1].firstMeshlet == ranges[0].meshletCount);
+  CHECK(ranges[1].meshletCount == 1); // 64 triangles
+  CHECK(meshlets.size() == ranges[0].meshletCount + ranges[1].meshletCount);
+
+  for (size_t i = 0; i < 2; ++i) {
+    for (uint32_t m = 0; m < ranges[i].meshletCount; ++m) {
+      const vks::mesh::Meshlet &meshlet = meshlets[ranges[i].firstMeshlet + m];
+      CHECK(meshlet.vertexOffset == lods[i].vertexOffset);
+      CHECK(meshlet.firstIndex >= lods[i].firstIndex);
+      CHECK(meshlet.firstIndex + meshlet.indexCount <=
+            lods[i].firstIndex + lods[i].indexCount);
+    }
+  }
+
+  // The coarse sphere's bounds are in its own vertices
+  CHECK(meshlets.back().radius == doctest::Approx(1.0f).epsilon(0.01));
+}
@@ -0,0 +1,134 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Optimize.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using vks::geometry::Vertex;
+
+// Triangles as sorted rotations, to compare index buffers as sets
+static std::vector<std::array<uint32_t, 3>>
+triangleSet(const std::vector<uint32_t> &indices,
+            const std::vector<Vertex> *vertices = nullptr) {
+  std::vector<std::array<uint32_t, 3>> triangles;
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    std::array<uint32_t, 3> tri = {indices[t], indices[t + 1], indices[t + 2]};
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()),
+                tri.end());
+    triangles.push_back(tri);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+static void report(const char *name, const std::vector<uint32_t> &indices,
+                   size_t vertexCount, vks::mesh::VertexCacheStatistics &out) {
+  out = vks::mesh::analyzeVertexCache(indices.data(), indices.size(),
+                                      vertexCount);
+  MESSAGE(name << ": ACMR " << out.acmr << ", ATVR " << out.atvr);
+}
+
+TEST_CASE("Vertex cache statistics") {
+  // Two triangles sharing an edge: 4 misses
+  std::vector<uint32_t> quad = {0, 1, 2, 2, 1, 3};
+  vks::mesh::VertexCacheStatistics stats =
+      vks::mesh::analyzeVertexCache(quad.data(), quad.size(), 4);
+  CHECK(stats.acmr == 2.0f);
+  CHECK(stats.atvr == 1.0f);
+
+  // A 2-entry FIFO has evicted vertex 0 when it comes back
+  std::vector<uint32_t> fan = {0, 1, 2, 0, 2, 3};
+  stats = vks::mesh::analyzeVertexCache(fan.data(), fan.size(), 4, 2);
+  CHECK(stats.acmr == 2.5f);
+  CHECK(stats.atvr == 1.25f);
+}
+
+TEST_CASE("Vertex cache optimization") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+
+  SUBCASE("sphere") {
+    vks::geometry::createSphere(vertices, indices, 1.0f, 64, 32);
+  }
+  SUBCASE("torus") {
+    vks::geometry::createTorus(vertices, indices, 1.0f, 0.3f, 96, 48);
+  }
+  SUBCASE("shuffled plane") {
+    vks::geometry::createPlane(vertices, indices, 1.0f, 1.0f, 64, 64);
+    std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+    std::memcpy(triangles.data(), indices.data(), indices.size() * 4);
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(3));
+    std::memcpy(indices.data(), triangles.data(), indices.size() * 4);
+  }
+
+  vks::mesh::VertexCacheStatistics before, after;
+  report("before", indices, vertices.size(), before);
+
+  std::vector<uint32_t> optimized = indices;
+  vks::mesh::optimizeVertexCache(optimized.data(), optimized.size(),
+                                 vertices.size());
+  report("after", optimized, vertices.size(), after);
+
+  // Same triangles (windings included), better cache use
+  CHECK(triangleSet(optimized) == triangleSet(indices));
+  CHECK(after.acmr < before.acmr * 0.8f);
+  CHECK(after.acmr < 0.8f);
+  CHECK(after.atvr < 1.4f);
+
+  SUBCASE("overdraw clusters keep the cache order") {
+    std::vector<uint32_t> sorted = optimized;
+    vks::mesh::optimizeOverdraw(sorted.data(), sorted.size(),
+                                vertices[0].pos, vertices.size(),
+                                sizeof(Vertex));
+    vks::mesh::VertexCacheStatistics overdraw;
+    report("after overdraw", sorted, vertices.size(), overdraw);
+
+    CHECK(triangleSet(sorted) == triangleSet(indices));
+    CHECK(overdraw.acmr <= after.acmr * 1.05f);
+  }
+}
+
+TEST_CASE("Vertex fetch optimization") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createTorus(vertices, indices, 1.0f, 0.3f, 32, 16);
+  vks::mesh::optimizeVertexCache(indices.data(), indices.size(),
+                                 vertices.size());
+
+  // Drop the first triangles so some vertices become unused
+  indices.erase(indices.begin(), indices.begin() + 30);
+
+  std::vector<Vertex> reordered = vertices;
+  std::vector<uint32_t> remapped = indices;
+  size_t used = vks::mesh::optimizeVertexFetch(
+      reordered.data(), reordered.size(), sizeof(Vertex), remapped.data(),
+      remapped.size());
+
+  CHECK(used < vertices.size());
+
+  // Vertices appear in first-use order
+  uint32_t next = 0;
+  for (uint32_t index : remapped) {
+    CHECK(index <= next);
+    next = std::max(next, index + 1);
+  }
+  CHECK(next == used);
+
+  // Same geometry
+  for (size_t i = 0; i < indices.size(); ++i) {
+    CHECK(std::memcmp(&reordered[remapped[i]], &vertices[indices[i]],
+                      sizeof(Vertex)) == 0);
+  }
+}
+
+TEST_CASE("16-bit indices") {
+  std::vector<uint32_t> indices = {0, 1, 65535, 42};
+  std::vector<uint16_t> narrowed(indices.size());
+  vks::mesh::narrowIndices(indices.data(), indices.size(), narrowed.data());
+  CHECK(narrowed == std::vector<uint16_t>({0, 1, 65535, 42}));
+}
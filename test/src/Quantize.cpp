@@ -0,0 +1,144 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/Quantize.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using vks::geometry::CompactVertex;
+using vks::geometry::Vertex;
+
+static const double Pi = 3.14159265358979323846;
+
+TEST_CASE("Compact vertex layout") {
+  CHECK(sizeof(CompactVertex) == 16);
+  CHECK(vks::geometry::vertexSize(vks::geometry::VertexFormat::Compact) == 16);
+  CHECK(vks::geometry::vertexSize(vks::geometry::VertexFormat::Float) == 32);
+
+  vks::geometry::VertexInputDescription input =
+      vks::geometry::getVertexInput(vks::geometry::VertexFormat::Compact);
+  CHECK(input.bindings[0].stride == sizeof(CompactVertex));
+  CHECK(input.attributes[0].format == VK_FORMAT_R16G16B16A16_UNORM);
+  CHECK(input.attributes[1].format == VK_FORMAT_R16G16_SNORM);
+  CHECK(input.attributes[2].format == VK_FORMAT_R16G16_SFLOAT);
+}
+
+TEST_CASE("Half floats") {
+  using vks::mesh::dequantizeHalf;
+  using vks::mesh::quantizeHalf;
+
+  CHECK(quantizeHalf(0.0f) == 0x0000);
+  CHECK(quantizeHalf(-0.0f) == 0x8000);
+  CHECK(quantizeHalf(1.0f) == 0x3c00);
+  CHECK(quantizeHalf(-2.0f) == 0xc000);
+  CHECK(quantizeHalf(0.5f) == 0x3800);
+  CHECK(quantizeHalf(65504.0f) == 0x7bff);
+  CHECK(quantizeHalf(65536.0f) == 0x7c00);
+  CHECK(quantizeHalf(INFINITY) == 0x7c00);
+  CHECK(std::isnan(dequantizeHalf(quantizeHalf(NAN))));
+  CHECK(quantizeHalf(std::ldexp(1.0f, -24)) == 0x0001);
+  CHECK(quantizeHalf(std::ldexp(1.0f, -26)) == 0x0000);
+
+  // Every half value survives a round trip
+  for (uint32_t h = 0; h < 0x10000; ++h) {
+    if ((h & 0x7c00) == 0x7c00 && (h & 0x3ff)) {
+      continue; // NaN
+    }
+    if (quantizeHalf(dequantizeHalf(uint16_t(h))) != h) {
+      FAIL("half " << h);
+    }
+  }
+
+  // UVs in [0, 1]: half an ulp of 2^-11 at most
+  float maxError = 0.0f;
+  for (int i = 0; i <= 100000; ++i) {
+    float uv = i / 100000.0f;
+    maxError = std::max(maxError, std::fabs(dequantizeHalf(quantizeHalf(uv)) - uv));
+  }
+  CHECK(maxError <= std::ldexp(1.0f, -12));
+}
+
+TEST_CASE("Octahedral normals") {
+  std::mt19937 random(7);
+  std::normal_distribution<float> gaussian;
+
+  double maxAngle = 0.0;
+  for (int i = 0; i < 100000; ++i) {
+    float n[3] = {gaussian(random), gaussian(random), gaussian(random)};
+    float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (float &c : n) {
+      c /= length;
+    }
+
+    int16_t encoded[2];
+    float decoded[3];
+    vks::mesh::encodeOctahedral(n, encoded);
+    vks::mesh::decodeOctahedral(encoded, decoded);
+
+    // atan2 of |cross| and dot stays accurate for tiny angles
+    double cx = double(n[1]) * decoded[2] - double(n[2]) * decoded[1];
+    double cy = double(n[2]) * decoded[0] - double(n[0]) * decoded[2];
+    double cz = double(n[0]) * decoded[1] - double(n[1]) * decoded[0];
+    double d = double(n[0]) * decoded[0] + double(n[1]) * decoded[1] +
+               double(n[2]) * decoded[2];
+    maxAngle = std::max(
+        maxAngle, std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), d));
+  }
+  MESSAGE("max octahedral error: " << maxAngle * 180.0 / Pi << " degrees");
+  // 2 x 16 bits: well under a hundredth of a degree
+  CHECK(maxAngle < 0.01 * Pi / 180.0);
+
+  // Axes and the fold are exact
+  const float axes[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0},
+                            {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+  for (const auto &axis : axes) {
+    int16_t encoded[2];
+    float decoded[3];
+    vks::mesh::encodeOctahedral(axis, encoded);
+    vks::mesh::decodeOctahedral(encoded, decoded);
+    for (int c = 0; c < 3; ++c) {
+      CHECK(decoded[c] == doctest::Approx(axis[c]).epsilon(1e-6));
+    }
+  }
+}
+
+TEST_CASE("Compress a mesh") {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vks::geometry::createTorus(vertices, indices, 3.0f, 0.5f, 64, 32);
+
+  vks::mesh::Quantization quantization = vks::mesh::computeQuantization(
+      vertices[0].pos, vertices.size(), sizeof(Vertex));
+  CHECK(quantization.scale == doctest::Approx(7.0f).epsilon(1e-5));
+
+  std::vector<CompactVertex> compact(vertices.size());
+  vks::mesh::compressVertices(vertices.data(), vertices.size(), quantization,
+                              compact.data());
+
+  // Positions: half a unorm16 step of the largest extent (+ float rounding)
+  const float positionBound = quantization.scale / 65535.0f * 0.5f + 1e-6f;
+  glm::mat4 dequantize = quantization.dequantization();
+
+  float maxPosition = 0.0f;
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    glm::vec4 unorm(compact[i].pos[0] / 65535.0f, compact[i].pos[1] / 65535.0f,
+                    compact[i].pos[2] / 65535.0f, 1.0f);
+    glm::vec4 p = dequantize * unorm;
+    for (int c = 0; c < 3; ++c) {
+      maxPosition = std::max(maxPosition, std::fabs(p[c] - vertices[i].pos[c]));
+    }
+
+    float normal[3];
+    vks::mesh::decodeOctahedral(compact[i].normal, normal);
+    for (int c = 0; c < 3; ++c) {
+      CHECK(std::fabs(normal[c] - vertices[i].normal[c]) < 2e-4f);
+    }
+    for (int c = 0; c < 2; ++c) {
+      CHECK(std::fabs(vks::mesh::dequantizeHalf(compact[i].uv[c]) -
+                      vertices[i].uv[c]) <= std::ldexp(1.0f, -12));
+    }
+  }
+  CHECK(maxPosition <= positionBound);
+}
@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>
+
+#include <vks/RangeAllocator.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using vks::RangeAllocator;
+
+TEST_CASE("Allocate and free ranges") {
+  RangeAllocator allocator(100);
+  CHECK(allocator.capacity() == 100);
+  CHECK(allocator.largestFreeBlock() == 100);
+
+  uint32_t a = allocator.allocate(30);
+  uint32_t b = allocator.allocate(30);
+  uint32_t c = allocator.allocate(30);
+  CHECK(a == 0);
+  CHECK(b == 30);
+  CHECK(c == 60);
+  CHECK(allocator.used() == 90);
+  CHECK(allocator.allocate(20) == RangeAllocator::InvalidOffset);
+
+  SUBCASE("Neighbours merge") {
+    allocator.free(a, 30);
+    allocator.free(c, 30);
+    CHECK(allocator.freeBlockCount() == 2);
+    CHECK(allocator.largestFreeBlock() == 40);
+
+    allocator.free(b, 30);
+    CHECK(allocator.freeBlockCount() == 1);
+    CHECK(allocator.largestFreeBlock() == 100);
+    CHECK(allocator.used() == 0);
+  }
+}
+
+TEST_CASE("Best fit keeps large blocks") {
+  RangeAllocator allocator(100);
+  uint32_t a = allocator.allocate(10);
+  allocator.allocate(5);
+  uint32_t c = allocator.allocate(40);
+  allocator.allocate(5);
+  allocator.free(a, 10);
+  allocator.free(c, 40);
+
+  // The 10-unit hole is used before the 40-unit one
+  CHECK(allocator.allocate(8) == a);
+  CHECK(allocator.allocate(40) == c);
+}
+
+TEST_CASE("Grow extends the last free block") {
+  RangeAllocator allocator(64);
+  allocator.allocate(48);
+  CHECK(allocator.allocate(32) == RangeAllocator::InvalidOffset);
+
+  allocator.grow(128);
+  CHECK(allocator.capacity() == 128);
+  CHECK(allocator.freeBlockCount() == 1);
+  CHECK(allocator.largestFreeBlock() == 80);
+  CHECK(allocator.allocate(32) == 48);
+
+  // Growing a full allocator adds a separate block
+  RangeAllocator full(16);
+  full.allocate(16);
+  full.grow(32);
+  CHECK(full.allocate(16) == 16);
+}
+
+TEST_CASE("Random allocations never overlap") {
+  RangeAllocator allocator(1 << 16);
+  std::mt19937 rng(7);
+  std::vector<std::pair<uint32_t, uint32_t>> live;
+  std::vector<uint8_t> owner(1 << 16, 0);
+
+  for (int step = 0; step < 4000; ++step) {
+    if (live.empty() || rng() % 3 != 0) {
+      uint32_t size = 1 + rng() % 300;
+      uint32_t offset = allocator.allocate(size);
+      if (offset == RangeAllocator::InvalidOffset) {
+        continue;
+      }
+      for (uint32_t i = offset; i < offset + size; ++i) {
+        REQUIRE(owner[i] == 0);
+        owner[i] = 1;
+      }
+      live.emplace_back(offset, size);
+    } else {
+      size_t pick = rng() % live.size();
+      auto range = live[pick];
+      live[pick] = live.back();
+      live.pop_back();
+      std::fill(owner.begin() + range.first,
+                owner.begin() + range.first + range.second, 0);
+      allocator.free(range.first, range.second);
+    }
+  }
+
+  uint32_t used = 0;
+  for (const auto &range : live) {
+    used += range.second;
+  }
+  CHECK(allocator.used() == used);
+
+  for (const auto &range : live) {
+    allocator.free(range.first, range.second);
+  }
+  CHECK(allocator.used() == 0);
+  CHECK(allocator.freeBlockCount() == 1);
+  CHECK(allocator.largestFreeBlock() == allocator.capacity());
+}
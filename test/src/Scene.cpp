@@ -0,0 +1,96 @@
+#include <doctest/doctest.h>
+
+#include <vks/Scene.hpp>
+
+#include <random>
+#include <vector>
+
+using vks::Scene;
+using vks::SceneHandle;
+
+static glm::mat4 translation(float x) {
+  glm::mat4 m(1.0f);
+  m[3][0] = x;
+  return m;
+}
+
+TEST_CASE("Scene handles survive other objects being destroyed") {
+  Scene scene;
+  SceneHandle a = scene.create(translation(1.0f), 0, 0);
+  SceneHandle b = scene.create(translation(2.0f), 1, 0);
+  SceneHandle c = scene.create(translation(3.0f), 2, 1, vks::SceneObjectHidden);
+  CHECK(scene.size() == 3);
+
+  // The last object fills the hole, its handle follows it
+  CHECK(scene.destroy(a));
+  CHECK(scene.size() == 2);
+  CHECK(scene.indexOf(c) == 0);
+  CHECK(scene.transform(c)[3][0] == 3.0f);
+  CHECK(scene.meshes()[scene.indexOf(c)] == 2);
+  CHECK(scene.materials()[scene.indexOf(c)] == 1);
+  CHECK(scene.flags()[scene.indexOf(c)] == vks::SceneObjectHidden);
+  CHECK(scene.handleAt(scene.indexOf(b)) == b);
+
+  // Stale handles are detected, even after their slot is reused
+  CHECK_FALSE(scene.alive(a));
+  CHECK_FALSE(scene.destroy(a));
+  CHECK_THROWS(scene.transform(a));
+  SceneHandle d = scene.create(translation(4.0f), 3, 0);
+  CHECK(d.slot == a.slot);
+  CHECK(d != a);
+  CHECK_FALSE(scene.alive(a));
+  CHECK(scene.alive(d));
+  CHECK_FALSE(scene.alive(SceneHandle{}));
+
+  scene.clear();
+  CHECK(scene.empty());
+  CHECK_FALSE(scene.alive(b));
+  CHECK_FALSE(scene.alive(d));
+}
+
+TEST_CASE("Scene stays dense under random churn") {
+  Scene scene;
+  std::vector<std::pair<SceneHandle, float>> live;
+  std::mt19937 random(7);
+
+  for (int step = 0; step < 5000; ++step) {
+    if (live.empty() || random() % 3 != 0) {
+      float x = static_cast<float>(step);
+      live.emplace_back(scene.create(translation(x), step, 0), x);
+    } else {
+      size_t victim = random() % live.size();
+      CHECK(scene.destroy(live[victim].first));
+      live[victim] = live.back();
+      live.pop_back();
+    }
+  }
+
+  REQUIRE(scene.size() == live.size());
+  std::vector<bool> seen(scene.size(), false);
+  for (const auto &[handle, x] : live) {
+    uint32_t index = scene.indexOf(handle);
+    REQUIRE(index < scene.size());
+    CHECK_FALSE(seen[index]);
+    seen[index] = true;
+    CHECK(scene.transforms()[index][3][0] == x);
+    CHECK(scene.meshes()[index] == static_cast<uint32_t>(x));
+  }
+}
+
+TEST_CASE("Scene batches reuse free slots") {
+  Scene scene;
+  SceneHandle a = scene.create(translation(1.0f), 0, 0);
+  SceneHandle b = scene.create(translation(2.0f), 0, 0);
+  scene.destroy(a);
+
+  uint32_t first = scene.createBatch(3);
+  CHECK(first == 1);
+  REQUIRE(scene.size() == 4);
+  CHECK(scene.handleAt(first).slot == a.slot);
+  CHECK(scene.handleAt(first) != a);
+  for (uint32_t i = first; i < scene.size(); ++i) {
+    CHECK(scene.indexOf(scene.handleAt(i)) == i);
+    CHECK(scene.flags()[i] == 0);
+  }
+  CHECK(scene.indexOf(b) == 0);
+}
@@ -0,0 +1,185 @@
+#include <doctest/doctest.h>
+
+#include <vks/SceneFile.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using vks::LocalTransform;
+using vks::Scene;
+using vks::TransformHierarchy;
+
+static std::string tempPath(const char *name) {
+  return std::string("vks_test_") + name + ".vksscene";
+}
+
+// A few roots with children, objects on some nodes
+static void buildScene(Scene &scene, TransformHierarchy &hierarchy) {
+  std::mt19937 random(3);
+  std::uniform_real_distribution<float> unit(-10.0f, 10.0f);
+  std::vector<TransformHierarchy::NodeId> nodes;
+  for (int i = 0; i < 200; ++i) {
+    LocalTransform local;
+    local.translation = {unit(random), unit(random), unit(random)};
+    local.scale = glm::vec3(1.0f + 0.01f * i);
+    TransformHierarchy::NodeId parent =
+        i < 4 ? TransformHierarchy::NoNode : nodes[random() % nodes.size()];
+    nodes.push_back(hierarchy.create(parent, local));
+  }
+  hierarchy.update();
+
+  for (uint32_t i = 0; i < 1000; ++i) {
+    TransformHierarchy::NodeId node =
+        i % 3 == 0 ? TransformHierarchy::NoNode : nodes[i % nodes.size()];
+    glm::mat4 transform(1.0f);
+    transform[3] = glm::vec4(float(i), 0.0f, 0.0f, 1.0f);
+    scene.create(transform, i % 7 == 0 ? Scene::NoMesh : i % 2, i % 3,
+                 i % 5 == 0 ? vks::SceneObjectHidden : 0, node);
+  }
+}
+
+TEST_CASE("Scene file round trip") {
+  Scene scene;
+  TransformHierarchy hierarchy;
+  buildScene(scene, hierarchy);
+
+  std::string path = tempPath("roundtrip");
+  vks::writeSceneFile(path, scene, hierarchy, {"sphere", "torus"},
+                      {"red", "blue", "green"});
+
+  {
+    vks::SceneFile file(path);
+    CHECK(file.objectCount() == scene.size());
+    CHECK(file.nodeCount() == hierarchy.size());
+    REQUIRE(file.meshCount() == 2);
+    REQUIRE(file.materialCount() == 3);
+    CHECK(file.meshName(1) == "torus");
+    CHECK(file.materialName(0) == "red");
+    CHECK(file.materialName(2) == "green");
+
+    // Sections are aligned and hold the arrays as they are in memory
+    CHECK(reinterpret_cast<uintptr_t>(file.transforms()) %
+              vks::SceneFileAlignment == 0);
+    CHECK(reinterpret_cast<uintptr_t>(file.locals()) %
+              vks::SceneFileAlignment == 0);
+    CHECK(std::memcmp(file.transforms(), scene.transforms(),
+                      sizeof(glm::mat4) * scene.size()) == 0);
+
+    // Loaded into a scene with other IDs for the same assets
+    Scene loaded;
+    loaded.create(glm::mat4(1.0f), 0, 0); // Replaced
+    TransformHierarchy loadedHierarchy;
+    Scene::MeshId meshes[2] = {10, 11};
+    Scene::MaterialId materials[3] = {20, 21, 22};
+    vks::loadScene(file, meshes, materials, loaded, loadedHierarchy);
+    loadedHierarchy.update();
+
+    REQUIRE(loaded.size() == scene.size());
+    REQUIRE(loadedHierarchy.size() == hierarchy.size());
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+      CHECK(loaded.transforms()[i] == scene.transforms()[i]);
+      CHECK(loaded.flags()[i] == scene.flags()[i]);
+      CHECK(loaded.materials()[i] == 20 + scene.materials()[i]);
+      if (scene.meshes()[i] == Scene::NoMesh) {
+        CHECK(loaded.meshes()[i] == Scene::NoMesh);
+      } else {
+        CHECK(loaded.meshes()[i] == 10 + scene.meshes()[i]);
+      }
+
+      // Same node, by its new ID
+      TransformHierarchy::NodeId node = scene.nodes()[i];
+      TransformHierarchy::NodeId loadedNode = loaded.nodes()[i];
+      if (node == TransformHierarchy::NoNode) {
+        CHECK(loadedNode == TransformHierarchy::NoNode);
+      } else {
+        REQUIRE(loadedHierarchy.contains(loadedNode));
+        const glm::mat4 &a = hierarchy.world(node);
+        const glm::mat4 &b = loadedHierarchy.world(loadedNode);
+        for (int c = 0; c < 4; ++c) {
+          for (int r = 0; r < 4; ++r) {
+            CHECK(b[c][r] == doctest::Approx(a[c][r]).epsilon(1e-4));
+          }
+        }
+      }
+
+      // Handles work as for created objects
+      CHECK(loaded.indexOf(loaded.handleAt(i)) == i);
+    }
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Invalid scene files are rejected") {
+  Scene scene;
+  TransformHierarchy hierarchy;
+  buildScene(scene, hierarchy);
+
+  // Objects must refer to named assets
+  CHECK_THROWS_AS(vks::writeSceneFile(tempPath("unnamed"), scene, hierarchy,
+                                      {"sphere"}, {"red", "blue", "green"}),
+                  std::runtime_error);
+  std::remove(tempPath("unnamed").c_str());
+
+  std::string path = tempPath("invalid");
+  vks::writeSceneFile(path, scene, hierarchy, {"sphere", "torus"},
+                      {"red", "blue", "green"});
+  std::vector<char> bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  vks::SceneFileHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  auto rewrite = [&](const std::vector<char> &data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  };
+
+  CHECK_NOTHROW(vks::SceneFile{path});
+
+  SUBCASE("Bad magic") {
+    std::vector<char> data = bytes;
+    data[0] = 'X';
+    rewrite(data);
+    CHECK_THROWS_AS(vks::SceneFile{path}, std::runtime_error);
+  }
+
+  SUBCASE("Shorter than the header") {
+    std::vector<char> data(bytes.begin(), bytes.begin() + sizeof(header) / 2);
+    rewrite(data);
+    CHECK_THROWS_AS(vks::SceneFile{path}, std::runtime_error);
+  }
+
+  SUBCASE("Truncated") {
+    std::vector<char> data(bytes.begin(), bytes.end() - 4);
+    rewrite(data);
+    CHECK_THROWS_AS(vks::SceneFile{path}, std::runtime_error);
+  }
+
+  SUBCASE("Material out of range") {
+    std::vector<char> data = bytes;
+    uint32_t material = 3;
+    std::memcpy(data.data() + header.materialsOffset, &material,
+                sizeof(material));
+    rewrite(data);
+    CHECK_THROWS_AS(vks::SceneFile{path}, std::runtime_error);
+  }
+
+  SUBCASE("Parent after its child") {
+    std::vector<char> data = bytes;
+    uint32_t parent = 5;
+    std::memcpy(data.data() + header.parentsOffset + 4 * sizeof(uint32_t),
+                &parent, sizeof(parent));
+    rewrite(data);
+    CHECK_THROWS_AS(vks::SceneFile{path}, std::runtime_error);
+  }
+
+  std::remove(path.c_str());
+}
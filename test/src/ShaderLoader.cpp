@@ -2,15 +2,13 @@
 
 #include <base_frag.h>
 
-#include <iostream>
+#include <vks/ShaderCode.hpp>
 
 // Obvious test, you can remove
 TEST_CASE("Load Shader") {
-  try {
-    auto vertShaderCode = BASE_FRAG;
-    CHECK(vertShaderCode.size() > 0);
-  } catch (std::exception &e) {
-    std::cout << e.what() << std::endl;
-    CHECK(false);
-  }
+  vks::ShaderCode fragShaderCode = BASE_FRAG;
+  CHECK(fragShaderCode.size() > 0);
+  CHECK(fragShaderCode.sizeBytes() == sizeof(BASE_FRAG));
+  // SPIR-V magic number
+  CHECK(fragShaderCode.data()[0] == 0x07230203u);
 }
@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+
+#include <sphere_frag.h>
+#include <sphere_vert.h>
+
+#include <vks/ShaderReflection.hpp>
+
+static vks::ShaderReflection reflect(vks::ShaderCode code) {
+  return vks::ShaderReflection(code);
+}
+
+TEST_CASE("Reflect sphere shaders") {
+  vks::ShaderReflection vert = reflect(SPHERE_VERT);
+  vks::ShaderReflection frag = reflect(SPHERE_FRAG);
+
+  CHECK(vert.stages() == VK_SHADER_STAGE_VERTEX_BIT);
+  CHECK(frag.stages() == VK_SHADER_STAGE_FRAGMENT_BIT);
+
+  // Camera UBO: layout(set = 0, binding = 0) { mat4 view; mat4 proj; }
+  REQUIRE(vert.sets().count(0) == 1);
+  const vks::ReflectedBinding &camera = vert.sets().at(0).at(0);
+  CHECK(camera.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+  CHECK(camera.descriptorCount == 1);
+  CHECK(camera.blockSize == 128);
+
+  // ObjectTransform push constant: { mat4 model; mat3x4 normal; }
+  REQUIRE(vert.hasPushConstants());
+  CHECK(vert.pushConstantRange().offset == 0);
+  CHECK(vert.pushConstantRange().size == 112);
+  CHECK(vert.pushConstantRange().stageFlags == VK_SHADER_STAGE_VERTEX_BIT);
+
+  // The fragment stage reads the camera UBO up to the eye position
+  REQUIRE(frag.sets().count(0) == 1);
+  CHECK(frag.sets().at(0).at(0).blockSize == 144);
+
+  // Materials: layout(set = 1, binding = 0) buffer { MaterialParams materials[]; }
+  REQUIRE(frag.sets().count(1) == 1);
+  const vks::ReflectedBinding &material = frag.sets().at(1).at(0);
+  CHECK(material.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+  CHECK(material.stageFlags == VK_SHADER_STAGE_FRAGMENT_BIT);
+  CHECK(material.blockSize == 0); // Runtime sized
+
+  // Bindless textures and samplers: unsized arrays in set 2
+  REQUIRE(frag.sets().count(2) == 1);
+  const vks::ReflectedSet &bindless = frag.sets().at(2);
+  CHECK(bindless.at(0).descriptorType == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE);
+  CHECK(bindless.at(0).descriptorCount == 0);
+  CHECK(bindless.at(1).descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER);
+  CHECK(bindless.at(1).descriptorCount == 0);
+
+  // DrawData push constant: { layout(offset = 112) uint materialIndex; }
+  REQUIRE(frag.hasPushConstants());
+  CHECK(frag.pushConstantRange().offset == 112);
+  CHECK(frag.pushConstantRange().size == 4);
+
+  vks::ShaderReflection pipeline = vert;
+  pipeline.merge(frag);
+  CHECK(pipeline.stages() ==
+        (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT));
+  CHECK(pipeline.sets().size() == 3);
+  CHECK(pipeline.sets().at(0).at(0).stageFlags ==
+        (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT));
+  CHECK(pipeline.sets().at(0).at(0).blockSize == 144);
+  CHECK(pipeline.pushConstantRange().offset == 0);
+  CHECK(pipeline.pushConstantRange().size == 116);
+}
+
+TEST_CASE("Merging stages combines stage flags") {
+  vks::ShaderReflection vert = reflect(SPHERE_VERT);
+  vks::ShaderReflection merged = vert;
+  merged.merge(vert);
+
+  CHECK(merged.sets().at(0).size() == 1);
+  CHECK(merged.sets().at(0).at(0).stageFlags == VK_SHADER_STAGE_VERTEX_BIT);
+}
+
+TEST_CASE("Reject invalid SPIR-V") {
+  const uint32_t garbage[] = {0xdeadbeef, 0, 0, 0, 0};
+  CHECK_THROWS(vks::ShaderReflection(garbage, 5));
+}
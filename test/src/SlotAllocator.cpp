@@ -0,0 +1,54 @@
+#include <doctest/doctest.h>
+
+#include <vks/SlotAllocator.hpp>
+
+#include <set>
+
+using vks::SlotAllocator;
+
+TEST_CASE("Slots are recycled through the free list") {
+  SlotAllocator slots(4);
+  CHECK(slots.allocate() == 0);
+  CHECK(slots.allocate() == 1);
+  CHECK(slots.allocate() == 2);
+  CHECK(slots.used() == 3);
+
+  // Freed slots come back before new ones
+  slots.free(1);
+  CHECK(slots.used() == 2);
+  CHECK(slots.allocate() == 1);
+  CHECK(slots.allocate() == 3);
+  CHECK(slots.allocate() == SlotAllocator::InvalidSlot);
+  CHECK(slots.used() == 4);
+
+  slots.free(0);
+  slots.free(2);
+  std::set<uint32_t> reused{slots.allocate(), slots.allocate()};
+  CHECK(reused == std::set<uint32_t>{0, 2});
+}
+
+TEST_CASE("Freed slots retire for the frames in flight") {
+  SlotAllocator slots(2, 2);
+  uint32_t a = slots.allocate();
+  uint32_t b = slots.allocate();
+  CHECK(slots.allocate() == SlotAllocator::InvalidSlot);
+
+  slots.free(a);
+  CHECK(slots.retiringCount() == 1);
+  CHECK(slots.used() == 2);
+  CHECK(slots.allocate() == SlotAllocator::InvalidSlot);
+
+  // Still readable by the previous frame
+  slots.nextFrame();
+  CHECK(slots.allocate() == SlotAllocator::InvalidSlot);
+
+  slots.free(b);
+  slots.nextFrame();
+  CHECK(slots.retiringCount() == 1);
+  CHECK(slots.used() == 1);
+  CHECK(slots.allocate() == a);
+
+  slots.nextFrame();
+  CHECK(slots.retiringCount() == 0);
+  CHECK(slots.allocate() == b);
+}
@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vks/SpatialGrid.hpp>
+#include <vks/Transform.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using vks::mesh::BoundingSphere;
+
+static std::vector<uint32_t>
+linearRadius(const std::vector<BoundingSphere> &spheres, glm::vec3 center,
+             float radius) {
+  std::vector<uint32_t> found;
+  for (uint32_t i = 0; i < spheres.size(); ++i) {
+    glm::vec3 offset = spheres[i].center - center;
+    float reach = radius + spheres[i].radius;
+    if (glm::dot(offset, offset) <= reach * reach) {
+      found.push_back(i);
+    }
+  }
+  return found;
+}
+
+static std::vector<uint32_t>
+linearFrustum(const std::vector<BoundingSphere> &spheres,
+              const glm::vec4 planes[6]) {
+  std::vector<uint32_t> visible;
+  for (uint32_t i = 0; i < spheres.size(); ++i) {
+    bool inside = true;
+    for (int p = 0; p < 6 && inside; ++p) {
+      inside = glm::dot(glm::vec3(planes[p]), spheres[i].center) +
+                   planes[p].w >=
+               -spheres[i].radius;
+    }
+    if (inside) {
+      visible.push_back(i);
+    }
+  }
+  return visible;
+}
+
+TEST_CASE("Spatial grid queries match a linear scan") {
+  std::mt19937 rng(53);
+  std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+  std::uniform_real_distribution<float> radius(0.1f, 1.5f);
+  std::vector<BoundingSphere> spheres(30000);
+  for (BoundingSphere &sphere : spheres) {
+    sphere.center = {position(rng), position(rng), position(rng) * 0.2f};
+    sphere.radius = radius(rng);
+  }
+  // One big object reaches far outside its cell
+  spheres[17].radius = 12.0f;
+
+  vks::SpatialGrid grid;
+  // Rebuilt every frame, as the spheres move
+  for (int frame = 0; frame < 3; ++frame) {
+    grid.rebuild(spheres.data(), static_cast<uint32_t>(spheres.size()), 2.0f);
+    CHECK(grid.size() == spheres.size());
+
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int i = 0; i < 20; ++i) {
+      glm::vec3 center(position(rng), position(rng), 0.0f);
+      float queryRadius = 1.0f + 10.0f * (unit(rng) + 1.0f);
+      std::vector<uint32_t> found;
+      grid.queryRadius(center, queryRadius, found);
+      std::sort(found.begin(), found.end());
+      CHECK(found == linearRadius(spheres, center, queryRadius));
+
+      glm::vec3 eye(unit(rng) * 50.0f, unit(rng) * 50.0f, 15.0f);
+      glm::mat4 viewProjection =
+          glm::perspectiveRH_ZO(glm::radians(45.0f), 1.5f, 0.1f, 60.0f) *
+          glm::lookAt(eye, center, glm::vec3(0.0f, 0.0f, 1.0f));
+      glm::vec4 planes[6];
+      vks::transform::extractFrustumPlanes(viewProjection, planes);
+      std::vector<uint32_t> visible;
+      grid.queryFrustum(planes, visible);
+      std::sort(visible.begin(), visible.end());
+      CHECK(visible == linearFrustum(spheres, planes));
+    }
+
+    for (BoundingSphere &sphere : spheres) {
+      sphere.center += glm::vec3(unit(rng), unit(rng), 0.0f);
+    }
+  }
+}
+
+TEST_CASE("Spatial grid of sparse and empty sets") {
+  vks::SpatialGrid grid;
+  std::vector<uint32_t> found;
+  grid.rebuild(nullptr, 0, 1.0f);
+  grid.queryRadius({0.0f, 0.0f, 0.0f}, 100.0f, found);
+  CHECK(found.empty());
+
+  // Far apart: more cells than items, the queries scan
+  std::vector<BoundingSphere> spheres = {{{-5000.0f, 0.0f, 0.0f}, 1.0f},
+                                         {{5000.0f, 0.0f, 0.0f}, 1.0f},
+                                         {{0.0f, 0.0f, -10.0f}, 1.0f}};
+  grid.rebuild(spheres.data(), 3, 1.0f);
+  grid.queryRadius({4990.0f, 0.0f, 0.0f}, 9.5f, found);
+  CHECK(found == std::vector<uint32_t>{1});
+
+  glm::vec4 planes[6];
+  vks::transform::extractFrustumPlanes(
+      glm::perspectiveRH_ZO(glm::radians(90.0f), 1.0f, 0.1f, 100.0f), planes);
+  found.clear();
+  grid.queryFrustum(planes, found);
+  CHECK(found == std::vector<uint32_t>{2});
+}
@@ -0,0 +1,114 @@
+#include <doctest/doctest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vks/Transform.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+static void checkNormalMatrix(const glm::mat4 &model,
+                              const vks::ObjectTransform &block) {
+  glm::mat3 expected = glm::transpose(glm::inverse(glm::mat3(model)));
+  for (int c = 0; c < 3; ++c) {
+    for (int r = 0; r < 3; ++r) {
+      CHECK(block.normal[c][r] ==
+            doctest::Approx(expected[c][r]).epsilon(1e-4));
+    }
+  }
+  CHECK(block.model == model);
+}
+
+TEST_CASE("Normal matrices match the inverse-transpose") {
+  std::mt19937 rng(29);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+  std::vector<glm::mat4> models;
+  for (int i = 0; i < 257; ++i) {
+    glm::mat4 m = glm::translate(glm::mat4(1.0f),
+                                 {unit(rng) * 10, unit(rng) * 10, unit(rng)});
+    m = glm::rotate(m, unit(rng) * 3.14f,
+                    glm::vec3(unit(rng), unit(rng), unit(rng) + 2.0f));
+    // Non-uniform and mirrored scales are where mat3(model) is wrong
+    m = glm::scale(m, {scale(rng), scale(rng), -scale(rng)});
+    models.push_back(m);
+  }
+
+  std::vector<vks::ObjectTransform> blocks(models.size());
+  vks::transform::computeObjectTransforms(models.data(), blocks.data(),
+                                          models.size());
+
+  for (size_t i = 0; i < models.size(); ++i) {
+    checkNormalMatrix(models[i], blocks[i]);
+  }
+}
+
+TEST_CASE("Degenerate scale keeps a finite normal matrix") {
+  glm::mat4 flat = glm::scale(glm::mat4(1.0f), {1.0f, 1.0f, 0.0f});
+  vks::ObjectTransform block;
+  vks::transform::computeObjectTransforms(&flat, &block, 1);
+
+  // Everything collapses onto the plane, whose normal is the flattened axis
+  CHECK(block.normal[2][2] == doctest::Approx(1.0f));
+  CHECK(block.normal[0][0] == doctest::Approx(0.0f));
+}
+
+TEST_CASE("Frustum planes of a perspective projection") {
+  // Looking down -Z from the origin, 90 degrees, depth in [0, 1]
+  glm::mat4 projection =
+      glm::perspectiveRH_ZO(glm::radians(90.0f), 1.0f, 1.0f, 10.0f);
+  glm::vec4 planes[6];
+  vks::transform::extractFrustumPlanes(projection, planes);
+
+  auto distance = [&](int plane, glm::vec3 p) {
+    return glm::dot(glm::vec3(planes[plane]), p) + planes[plane].w;
+  };
+
+  glm::vec3 inside(0.0f, 0.0f, -5.0f);
+  for (int p = 0; p < 6; ++p) {
+    CHECK(distance(p, inside) > 0.0f);
+  }
+  CHECK(distance(0, inside) == doctest::Approx(5.0f / std::sqrt(2.0f)));
+  CHECK(distance(4, inside) == doctest::Approx(4.0f)); // Near
+  CHECK(distance(5, inside) == doctest::Approx(5.0f)); // Far
+
+  CHECK(distance(4, {0.0f, 0.0f, -0.5f}) < 0.0f);
+  CHECK(distance(1, {20.0f, 0.0f, -5.0f}) < 0.0f);
+  CHECK(distance(3, {0.0f, 20.0f, -5.0f}) < 0.0f);
+}
+
+TEST_CASE("Matrix products and TRS composition match glm") {
+  std::mt19937 rng(31);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+  for (int i = 0; i < 64; ++i) {
+    vks::LocalTransform local;
+    local.translation = {unit(rng) * 10, unit(rng) * 10, unit(rng) * 10};
+    local.rotation = glm::angleAxis(
+        unit(rng) * 3.14f,
+        glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng) + 2.0f)));
+    local.scale = {unit(rng) + 2.0f, unit(rng) + 2.0f, unit(rng) + 2.0f};
+
+    glm::mat4 expected = glm::translate(glm::mat4(1.0f), local.translation) *
+                         glm::mat4_cast(local.rotation) *
+                         glm::scale(glm::mat4(1.0f), local.scale);
+    glm::mat4 composed = vks::transform::compose(local);
+    glm::mat4 parent = glm::rotate(
+        glm::translate(glm::mat4(1.0f), {unit(rng), unit(rng), unit(rng)}),
+        unit(rng), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    // Aliasing the output with an input is allowed
+    glm::mat4 product = parent;
+    vks::transform::multiply(product, composed, product);
+    glm::mat4 reference = parent * expected;
+    for (int c = 0; c < 4; ++c) {
+      for (int r = 0; r < 4; ++r) {
+        CHECK(composed[c][r] ==
+              doctest::Approx(expected[c][r]).epsilon(1e-4));
+        CHECK(product[c][r] ==
+              doctest::Approx(reference[c][r]).epsilon(1e-4));
+      }
+    }
+  }
+}
@@ -0,0 +1,139 @@
+#include <doctest/doctest.h>
+
+#include <vks/TransformHierarchy.hpp>
+
+#include <random>
+#include <vector>
+
+using vks::LocalTransform;
+using vks::TransformHierarchy;
+
+static LocalTransform randomLocal(std::mt19937 &rng) {
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  LocalTransform local;
+  local.translation = {unit(rng), unit(rng), unit(rng)};
+  local.rotation = glm::angleAxis(unit(rng) * 3.14f,
+                                  glm::normalize(glm::vec3(
+                                      unit(rng), unit(rng), unit(rng) + 2.0f)));
+  local.scale = glm::vec3(1.0f + 0.2f * unit(rng));
+  return local;
+}
+
+// Walks up to the root, the definition update() must match
+static glm::mat4 naiveWorld(const TransformHierarchy &hierarchy,
+                            TransformHierarchy::NodeId node) {
+  glm::mat4 world = vks::transform::compose(hierarchy.getLocal(node));
+  for (TransformHierarchy::NodeId parent = hierarchy.getParent(node);
+       parent != TransformHierarchy::NoNode;
+       parent = hierarchy.getParent(parent)) {
+    world = vks::transform::compose(hierarchy.getLocal(parent)) * world;
+  }
+  return world;
+}
+
+static void checkWorlds(const TransformHierarchy &hierarchy,
+                        const std::vector<TransformHierarchy::NodeId> &nodes) {
+  for (TransformHierarchy::NodeId node : nodes) {
+    if (!hierarchy.contains(node)) {
+      continue;
+    }
+    glm::mat4 expected = naiveWorld(hierarchy, node);
+    const glm::mat4 &world = hierarchy.world(node);
+    CHECK(hierarchy.worldMatrices()[hierarchy.indexOf(node)] == world);
+    for (int c = 0; c < 4; ++c) {
+      for (int r = 0; r < 4; ++r) {
+        REQUIRE(world[c][r] ==
+                doctest::Approx(expected[c][r]).epsilon(1e-3));
+      }
+    }
+  }
+}
+
+TEST_CASE("Only dirty subtrees are recomputed") {
+  TransformHierarchy hierarchy;
+  TransformHierarchy::NodeId a = hierarchy.create();
+  TransformHierarchy::NodeId b = hierarchy.create();
+  std::vector<TransformHierarchy::NodeId> underA, underB;
+  for (int i = 0; i < 10; ++i) {
+    underA.push_back(hierarchy.create(a));
+    underB.push_back(hierarchy.create(b));
+  }
+  TransformHierarchy::NodeId leaf = hierarchy.create(underA[3]);
+  CHECK(hierarchy.levelCount() == 3);
+
+  CHECK(hierarchy.update() == 23);
+  CHECK(hierarchy.update() == 0);
+
+  // A root drags its 10 children and the grandchild along, b is untouched
+  LocalTransform moved;
+  moved.translation = {5.0f, 0.0f, 0.0f};
+  hierarchy.setLocal(a, moved);
+  CHECK(hierarchy.update() == 12);
+  CHECK(hierarchy.world(leaf)[3][0] == doctest::Approx(5.0f));
+  CHECK(hierarchy.world(underB[0])[3][0] == doctest::Approx(0.0f));
+
+  hierarchy.setLocal(leaf, moved);
+  CHECK(hierarchy.update() == 1);
+  CHECK(hierarchy.world(leaf)[3][0] == doctest::Approx(10.0f));
+}
+
+TEST_CASE("Hierarchy matches a walk to the root") {
+  std::mt19937 rng(43);
+  TransformHierarchy hierarchy;
+  std::vector<TransformHierarchy::NodeId> nodes;
+  // Parents picked at random, so deep nodes are often followed by shallow
+  // ones and the levels have to be re-sorted
+  for (int i = 0; i < 5000; ++i) {
+    TransformHierarchy::NodeId parent =
+        nodes.empty() || rng() % 16 == 0 ? TransformHierarchy::NoNode
+                                         : nodes[rng() % nodes.size()];
+    nodes.push_back(hierarchy.create(parent, randomLocal(rng)));
+  }
+  CHECK(hierarchy.update() == nodes.size());
+  checkWorlds(hierarchy, nodes);
+
+  // Breadth-first: every parent comes before its children
+  for (TransformHierarchy::NodeId node : nodes) {
+    TransformHierarchy::NodeId parent = hierarchy.getParent(node);
+    if (parent != TransformHierarchy::NoNode) {
+      CHECK(hierarchy.indexOf(parent) < hierarchy.indexOf(node));
+    }
+  }
+
+  for (int i = 0; i < 50; ++i) {
+    hierarchy.setLocal(nodes[rng() % nodes.size()], randomLocal(rng));
+  }
+  CHECK(hierarchy.update() < nodes.size());
+  checkWorlds(hierarchy, nodes);
+}
+
+TEST_CASE("Destroying a node removes its subtree") {
+  TransformHierarchy hierarchy;
+  TransformHierarchy::NodeId root = hierarchy.create();
+  TransformHierarchy::NodeId a = hierarchy.create(root);
+  TransformHierarchy::NodeId b = hierarchy.create(root);
+  TransformHierarchy::NodeId underA = hierarchy.create(a);
+  TransformHierarchy::NodeId underB = hierarchy.create(b);
+  hierarchy.update();
+
+  hierarchy.destroy(a);
+  CHECK(hierarchy.size() == 3);
+  CHECK_FALSE(hierarchy.contains(a));
+  CHECK_FALSE(hierarchy.contains(underA));
+  CHECK(hierarchy.contains(underB));
+  CHECK(hierarchy.getParent(underB) == b);
+  CHECK_THROWS(hierarchy.create(a));
+  CHECK_THROWS(hierarchy.setLocal(underA, {}));
+  CHECK_THROWS(hierarchy.getParent(a));
+  CHECK_THROWS(hierarchy.world(TransformHierarchy::NoNode));
+
+  // Freed ids are reused, under a parent shallower than the last level
+  LocalTransform local;
+  local.translation = {0.0f, 1.0f, 0.0f};
+  TransformHierarchy::NodeId c = hierarchy.create(root, local);
+  CHECK(hierarchy.getParent(c) == root);
+  hierarchy.setLocal(root, local);
+  CHECK(hierarchy.update() == 4);
+  CHECK(hierarchy.world(c)[3][1] == doctest::Approx(2.0f));
+  checkWorlds(hierarchy, {root, b, c, underB});
+}
@@ -0,0 +1,204 @@
+#include <doctest/doctest.h>
+
+#include <vks/Geometry.hpp>
+#include <vks/Mesh/MeshFile.hpp>
+#include <vks/WorldPartition.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using vks::Scene;
+using vks::WorldPartition;
+
+namespace {
+
+// Meshes uploaded by the partition, as the application's registry sees them
+struct Registry {
+  std::map<std::string, Scene::MeshId> uploaded;
+  std::vector<std::string> names; // By MeshId
+  size_t releases = 0;
+
+  WorldPartition::Callbacks callbacks() {
+    WorldPartition::Callbacks callbacks;
+    callbacks.uploadMesh = [this](const std::string &name,
+                                  const vks::mesh::MeshData &mesh) {
+      CHECK(mesh.vertexCount > 0);
+      CHECK(uploaded.count(name) == 0);
+      names.push_back(name);
+      uploaded[name] = static_cast<Scene::MeshId>(names.size() - 1);
+      return uploaded[name];
+    };
+    callbacks.releaseMesh = [this](const std::string &name,
+                                   Scene::MeshId mesh) {
+      CHECK(uploaded.at(name) == mesh);
+      uploaded.erase(name);
+      ++releases;
+    };
+    callbacks.resolveMaterial = [](const std::string &name) {
+      return static_cast<Scene::MaterialId>(name == "blue");
+    };
+    return callbacks;
+  }
+};
+
+// A 4 x 4 cells world of 16 units per cell, 5 objects per cell, on two
+// meshes: the left half uses "a.vksmesh", the right half "b.vksmesh"
+std::string writeWorld() {
+  std::string directory = "vks_test_world";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  std::vector<vks::geometry::Vertex> vertices;
+  std::vector<uint32_t> indices;
+  // Smaller than a cell file, for the CPU budget test
+  vks::geometry::createSphere(vertices, indices, 1.0f, 4, 2);
+  vks::mesh::MeshData mesh;
+  mesh.vertices = vertices.data();
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indices = indices.data();
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  vks::mesh::writeMeshFile(directory + "/a.vksmesh", mesh);
+  vks::mesh::writeMeshFile(directory + "/b.vksmesh", mesh);
+
+  Scene scene;
+  for (int x = 0; x < 4; ++x) {
+    for (int y = 0; y < 4; ++y) {
+      for (int i = 0; i < 5; ++i) {
+        glm::mat4 transform(1.0f);
+        transform[3] = glm::vec4(x * 16.0f + 2.0f + i, y * 16.0f + 8.0f,
+                                 0.0f, 1.0f);
+        scene.create(transform, x < 2 ? 0 : 1, i % 2);
+      }
+    }
+  }
+  CHECK(vks::writeWorldPartition(directory, 16.0f, scene,
+                                 {"a.vksmesh", "b.vksmesh"},
+                                 {"red", "blue"}) == 16);
+  return directory;
+}
+
+// Updates until nothing is loading anymore
+void settle(WorldPartition &world, const glm::vec3 &camera, Scene &scene) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  do {
+    world.update(camera, scene);
+    if (world.getStats().loadingCells == 0) {
+      world.update(camera, scene); // Nothing left to request either
+      if (world.getStats().loadingCells == 0) {
+        return;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  } while (std::chrono::steady_clock::now() < deadline);
+  FAIL("The world did not settle");
+}
+
+// Cells of the objects in the scene
+std::set<std::pair<int, int>> residentCells(const Scene &scene) {
+  std::set<std::pair<int, int>> cells;
+  for (uint32_t i = 0; i < scene.size(); ++i) {
+    const glm::vec4 &position = scene.transforms()[i][3];
+    cells.insert({int(position.x / 16.0f), int(position.y / 16.0f)});
+  }
+  return cells;
+}
+
+} // namespace
+
+TEST_CASE("World partition streams cells around the camera") {
+  std::string directory = writeWorld();
+  Registry registry;
+  WorldPartition::Settings settings;
+  settings.cellSize = 16.0f;
+  settings.loadRadius = 10.0f;
+  settings.unloadRadius = 18.0f;
+  Scene scene;
+  {
+    WorldPartition world(directory, settings, registry.callbacks());
+    CHECK(world.getStats().cellCount == 16);
+
+    // The cells within 10 units
+    settle(world, glm::vec3(12.0f, 12.0f, 5.0f), scene);
+    CHECK(residentCells(scene) ==
+          std::set<std::pair<int, int>>{{0, 0}, {0, 1}, {1, 0}, {1, 1}});
+    CHECK(scene.size() == 20);
+    CHECK(registry.uploaded.size() == 1); // Only the left half's mesh
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+      CHECK(scene.meshes()[i] == registry.uploaded.at("a.vksmesh"));
+      CHECK(scene.nodes()[i] == vks::TransformHierarchy::NoNode);
+    }
+
+    // A small step stays within the hysteresis band: nothing leaves
+    settle(world, glm::vec3(4.0f, 4.0f, 5.0f), scene);
+    CHECK(residentCells(scene).count({1, 1}) == 1);
+
+    // Far away: the left half leaves, its mesh is released
+    settle(world, glm::vec3(52.0f, 52.0f, 5.0f), scene);
+    CHECK(residentCells(scene) ==
+          std::set<std::pair<int, int>>{{2, 2}, {2, 3}, {3, 2}, {3, 3}});
+    CHECK(registry.uploaded.count("a.vksmesh") == 0);
+    CHECK(registry.uploaded.count("b.vksmesh") == 1);
+    CHECK(registry.releases == 1);
+    CHECK(world.getStats().residentCells == 4);
+    CHECK(world.getStats().gpuBytes > 0);
+
+    world.unloadAll(scene);
+    CHECK(scene.empty());
+    CHECK(registry.uploaded.empty());
+    CHECK(world.getStats().cpuBytes == 0);
+    CHECK(world.getStats().gpuBytes == 0);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("World partition keeps to its memory budgets") {
+  std::string directory = writeWorld();
+  WorldPartition::Settings settings;
+  settings.cellSize = 16.0f;
+  settings.loadRadius = 10.0f;
+  settings.unloadRadius = 100.0f; // Only the budgets evict
+
+  size_t cellBytes = std::filesystem::file_size(directory + "/cell_0_0.vksscene");
+  size_t meshBytes = vks::mesh::MeshFile(directory + "/a.vksmesh").vertexDataSize() +
+                     vks::mesh::MeshFile(directory + "/a.vksmesh").indexDataSize();
+
+  SUBCASE("GPU") {
+    // One mesh at a time: the far cells make room for the near ones
+    settings.gpuBudget = meshBytes;
+    Registry registry;
+    Scene scene;
+    WorldPartition world(directory, settings, registry.callbacks());
+    settle(world, glm::vec3(12.0f, 12.0f, 5.0f), scene);
+    CHECK(residentCells(scene).count({0, 0}) == 1);
+    settle(world, glm::vec3(52.0f, 52.0f, 5.0f), scene);
+    CHECK(residentCells(scene) ==
+          std::set<std::pair<int, int>>{{2, 2}, {2, 3}, {3, 2}, {3, 3}});
+    CHECK(world.getStats().gpuBytes <= settings.gpuBudget);
+    CHECK(registry.uploaded.size() == 1);
+  }
+
+  SUBCASE("CPU") {
+    // Two cells and the mesh file before its upload, not three cells
+    REQUIRE(meshBytes < cellBytes);
+    settings.cpuBudget = 2 * cellBytes + meshBytes;
+    Registry registry;
+    Scene scene;
+    WorldPartition world(directory, settings, registry.callbacks());
+    settle(world, glm::vec3(12.0f, 12.0f, 5.0f), scene);
+    CHECK(residentCells(scene).size() == 2);
+    CHECK(residentCells(scene).count({0, 0}) == 1);
+    CHECK(world.getStats().cpuBytes <= settings.cpuBudget);
+
+    // Loads resume once far cells can be evicted
+    settle(world, glm::vec3(52.0f, 52.0f, 5.0f), scene);
+    CHECK(residentCells(scene).size() == 2);
+    CHECK(residentCells(scene).count({3, 3}) == 1);
+  }
+
+  std::filesystem::remove_all(directory);
+}